@@ -19,4 +19,10 @@
  */
 // PyTypeObject *get_QBAFArgumentType(void);
 
+/**
+ * @brief Free the QBAFArgument objects kept in the free list for reuse.
+ * 
+ */
+void QBAFArgument_ClearFreeList(void);
+
 #endif
\ No newline at end of file
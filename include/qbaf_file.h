@@ -0,0 +1,104 @@
+/**
+ * @file qbaf_file.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that saves a compiled QBAFramework (QBAFGraph) in a binary file
+ * and maps it back into memory without copying its arrays
+ */
+
+#ifndef _QBAF_FILE_H_
+#define _QBAF_FILE_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+
+#include "qbaf_graph.h"
+
+#define QBAF_FILE_MAGIC             "QBAFBIN\0"             /* first 8 bytes of every file */
+#define QBAF_FILE_VERSION           1                       /* version of the format */
+#define QBAF_FILE_BYTE_ORDER        0x0102030405060708ULL   /* written in the byte order of the machine */
+#define QBAF_FILE_DISJOINT_RELATIONS 0x1                    /* flag: the Attack and Support relations must be disjoint */
+#define QBAF_FILE_EXTERNAL_NAMES    0x2                     /* flag: the string table is empty, the arguments are stored elsewhere */
+#define QBAF_FILE_SEMANTICS_SIZE    32                      /* bytes reserved for the name of the semantics */
+#define QBAF_FILE_SECTIONS          13                      /* number of sections (the header included) */
+
+/**
+ * @brief Header at the beginning of a QBAF binary file. It is followed by these sections
+ * (all the integers are int64 and all the reals are float64, in the byte order of the header):
+ * initial strengths [size], attackers offsets [size + 1], attackers [attacks],
+ * supporters offsets [size + 1], supporters [supports], dependents offsets [size + 1],
+ * dependents [attacks + supports], order [ordered], positions [size], level offsets [levels + 1],
+ * name offsets [size + 1] and the string table of the arguments [names_size bytes].
+ * Every section starts at a multiple of 8 bytes, so they can be used in place once the file is mapped.
+ *
+ */
+typedef struct {
+    char     magic[8];          /* QBAF_FILE_MAGIC */
+    uint32_t version;           /* QBAF_FILE_VERSION */
+    uint32_t flags;             /* QBAF_FILE_DISJOINT_RELATIONS or 0 */
+    uint64_t byte_order;        /* QBAF_FILE_BYTE_ORDER */
+    int64_t  size;              /* number of arguments */
+    int64_t  attacks;           /* number of Attack relations */
+    int64_t  supports;          /* number of Support relations */
+    int64_t  ordered;           /* number of arguments in topological order (size if acyclic) */
+    int64_t  levels;            /* number of topological levels */
+    int64_t  names_size;        /* number of bytes of the string table */
+    char     semantics[QBAF_FILE_SEMANTICS_SIZE];   /* name of the predefined semantics (NUL-terminated) */
+} QBAFFileHeader;
+
+/**
+ * @brief Save the QBAFGraph graph, with the name of its semantics, in the binary file at path.
+ * Every argument must be a str, an int or a QBAFArgument.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param path a path-like object
+ * @param graph a compiled QBAFGraph (not NULL)
+ * @param semantics the name of a predefined semantics
+ * @param disjoint_relations 1 if the Attack and Support relations must be disjoint, 0 if not
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFFile_Save(PyObject *path, QBAFGraph *graph, const char *semantics, int disjoint_relations);
+
+/**
+ * @brief Map the binary file at path into memory (read-only) and return a new QBAFGraph whose CSR arrays,
+ * schedule and initial strengths are read directly from the mapped pages.
+ * The arrays are validated in O(size + relations): they must be within bounds, the dependents must mirror
+ * the attackers and supporters, and the schedule must be topological.
+ * The header of the file is copied into header. Return NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param path a path-like object
+ * @param header a pointer where the header of the file is copied
+ * @return QBAFGraph* a new QBAFGraph, NULL if an error occurred
+ */
+QBAFGraph *QBAFFile_Map(PyObject *path, QBAFFileHeader *header);
+
+/**
+ * @brief Return a new bytes object with the binary image of the QBAFGraph graph (the same contents as QBAFFile_Save),
+ * NULL (with the corresponding exception) if an error has occurred.
+ * If external_names is 1, the string table is left empty, so the arguments can be of any type
+ * and must be given to QBAFFile_Loads.
+ *
+ * @param graph a compiled QBAFGraph (not NULL)
+ * @param semantics the name of a predefined semantics ("" if it is not predefined)
+ * @param disjoint_relations 1 if the Attack and Support relations must be disjoint, 0 if not
+ * @param external_names 1 if the arguments are not stored in the image, 0 if they are
+ * @return PyObject* a new bytes object, NULL if an error occurred
+ */
+PyObject *QBAFFile_Dumps(QBAFGraph *graph, const char *semantics, int disjoint_relations, int external_names);
+
+/**
+ * @brief Return a new QBAFGraph whose CSR arrays, schedule and initial strengths are read directly from
+ * the binary image (any object supporting the buffer protocol). The image is only used in place if it is
+ * an 8-byte aligned bytes object (e.g. a PickleBuffer of bytes), otherwise it is copied into a bytearray
+ * owned by the graph. The arrays are validated like in QBAFFile_Map.
+ * The graph keeps a reference to the image (or its copy). The header of the image is copied into header.
+ * Return NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param image a bytes-like object returned by QBAFFile_Dumps
+ * @param arguments a PyList with the arguments if the image was dumped with external_names, NULL if not
+ * @param header a pointer where the header of the image is copied
+ * @return QBAFGraph* a new QBAFGraph, NULL if an error occurred
+ */
+QBAFGraph *QBAFFile_Loads(PyObject *image, PyObject *arguments, QBAFFileHeader *header);
+
+#endif
@@ -40,6 +40,50 @@ double product(PyObject *attacker_strengths, PyObject *supporter_strengths);
  */
 double top(PyObject *attacker_strengths, PyObject *supporter_strengths);
 
+/**
+ * @brief Aggregation function over arrays with the final strengths of the attackers and the supporters.
+ *
+ */
+typedef double (*QBAFArrayAggregation)(const double *attacker_strengths, Py_ssize_t attackers_size,
+                                       const double *supporter_strengths, Py_ssize_t supporters_size);
+
+/**
+ * @brief Given the final strengths of attackers and supporters, return the result of the aggregation function 'sum'.
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @return double the result of the aggregation function 'sum'
+ */
+double sum_array(const double *attacker_strengths, Py_ssize_t attackers_size,
+                 const double *supporter_strengths, Py_ssize_t supporters_size);
+
+/**
+ * @brief Given the final strengths of attackers and supporters, return the result of the aggregation function 'product'.
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @return double the result of the aggregation function 'product'
+ */
+double product_array(const double *attacker_strengths, Py_ssize_t attackers_size,
+                     const double *supporter_strengths, Py_ssize_t supporters_size);
+
+/**
+ * @brief Given the final strengths of attackers and supporters, return the result of the aggregation function 'top'.
+ * As top, it returns -1 if the strength of an attacker is not in [-1, 1].
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @return double the result of the aggregation function 'top'
+ */
+double top_array(const double *attacker_strengths, Py_ssize_t attackers_size,
+                 const double *supporter_strengths, Py_ssize_t supporters_size);
+
 /**
  * @brief Return the influence result of the basic model.
  * 
@@ -85,4 +129,201 @@ double max_2_1(double w, double s);
  */
 double max_1_1(double w, double s);
 
+/**
+ * @brief Batched influence function: result[i] = influence(w[i], s[i]) for every i in [0, size).
+ *
+ */
+typedef void (*QBAFBatchInfluence)(const double *w, const double *s, double *result, Py_ssize_t size);
+
+/**
+ * @brief Batched version of simple_influence (vectorized if the CPU supports it).
+ * 
+ * @param w the initial strengths
+ * @param s the results of applying the aggregation function
+ * @param result the array where the results are stored
+ * @param size the number of elements
+ */
+void simple_influence_batch(const double *w, const double *s, double *result, Py_ssize_t size);
+
+/**
+ * @brief Batched version of linear_1 (vectorized if the CPU supports it).
+ * 
+ * @param w the initial strengths
+ * @param s the results of applying the aggregation function
+ * @param result the array where the results are stored
+ * @param size the number of elements
+ */
+void linear_1_batch(const double *w, const double *s, double *result, Py_ssize_t size);
+
+/**
+ * @brief Batched version of euler_based (vectorized if the CPU supports it).
+ * The vectorized exp is within 2 ULP of the correctly rounded result, so it is only used on request
+ * (see batch_influence_function).
+ * 
+ * @param w the initial strengths
+ * @param s the results of applying the aggregation function
+ * @param result the array where the results are stored
+ * @param size the number of elements
+ */
+void euler_based_batch(const double *w, const double *s, double *result, Py_ssize_t size);
+
+/**
+ * @brief Batched version of max_2_1 (vectorized if the CPU supports it).
+ * 
+ * @param w the initial strengths
+ * @param s the results of applying the aggregation function
+ * @param result the array where the results are stored
+ * @param size the number of elements
+ */
+void max_2_1_batch(const double *w, const double *s, double *result, Py_ssize_t size);
+
+/**
+ * @brief Batched version of max_1_1 (vectorized if the CPU supports it).
+ * 
+ * @param w the initial strengths
+ * @param s the results of applying the aggregation function
+ * @param result the array where the results are stored
+ * @param size the number of elements
+ */
+void max_1_1_batch(const double *w, const double *s, double *result, Py_ssize_t size);
+
+/**
+ * @brief Return the batched version of a built-in influence function, NULL if influence is not built-in.
+ * The batched euler_based is only vectorized if approximate is 1, otherwise it uses the exp of libm
+ * (and yields exactly the same results as euler_based).
+ * 
+ * @param influence an influence function
+ * @param approximate 1 if the vectorized approximation of exp may be used, 0 if not
+ * @return QBAFBatchInfluence the batched influence function, NULL if there is none
+ */
+QBAFBatchInfluence batch_influence_function(double (*influence)(double, double), int approximate);
+
+/**
+ * @brief Partial derivatives of an aggregation function over arrays w.r.t. the strength of every attacker
+ * and every supporter. At the points where it is not differentiable, a one-sided derivative is chosen.
+ *
+ */
+typedef void (*QBAFArrayAggregationDerivative)(const double *attacker_strengths, Py_ssize_t attackers_size,
+                                               const double *supporter_strengths, Py_ssize_t supporters_size,
+                                               double *attacker_derivatives, double *supporter_derivatives);
+
+/**
+ * @brief Partial derivatives of an influence function w.r.t. the initial strength w and the aggregation s.
+ * At the points where it is not differentiable, the right derivative is chosen.
+ *
+ */
+typedef void (*QBAFInfluenceDerivative)(double w, double s, double *dw, double *ds);
+
+/**
+ * @brief Store in attacker_derivatives and supporter_derivatives the partial derivatives of sum_array.
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @param attacker_derivatives array (size attackers_size) where the derivatives w.r.t. the attackers are stored
+ * @param supporter_derivatives array (size supporters_size) where the derivatives w.r.t. the supporters are stored
+ */
+void sum_array_derivative(const double *attacker_strengths, Py_ssize_t attackers_size,
+                          const double *supporter_strengths, Py_ssize_t supporters_size,
+                          double *attacker_derivatives, double *supporter_derivatives);
+
+/**
+ * @brief Store in attacker_derivatives and supporter_derivatives the partial derivatives of product_array
+ * (computed with prefix and suffix products, so no division is needed).
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @param attacker_derivatives array (size attackers_size) where the derivatives w.r.t. the attackers are stored
+ * @param supporter_derivatives array (size supporters_size) where the derivatives w.r.t. the supporters are stored
+ */
+void product_array_derivative(const double *attacker_strengths, Py_ssize_t attackers_size,
+                              const double *supporter_strengths, Py_ssize_t supporters_size,
+                              double *attacker_derivatives, double *supporter_derivatives);
+
+/**
+ * @brief Store in attacker_derivatives and supporter_derivatives the partial derivatives of top_array.
+ * Only the strongest attacker/supporter has a non-zero derivative. If several of them are tied,
+ * the derivative of all of them is 0 (decreasing one of them does not change the maximum).
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @param attacker_derivatives array (size attackers_size) where the derivatives w.r.t. the attackers are stored
+ * @param supporter_derivatives array (size supporters_size) where the derivatives w.r.t. the supporters are stored
+ */
+void top_array_derivative(const double *attacker_strengths, Py_ssize_t attackers_size,
+                          const double *supporter_strengths, Py_ssize_t supporters_size,
+                          double *attacker_derivatives, double *supporter_derivatives);
+
+/**
+ * @brief Store in dw and ds the partial derivatives of simple_influence.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void simple_influence_derivative(double w, double s, double *dw, double *ds);
+
+/**
+ * @brief Store in dw and ds the partial derivatives of linear_1.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void linear_1_derivative(double w, double s, double *dw, double *ds);
+
+/**
+ * @brief Store in dw and ds the partial derivatives of euler_based.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void euler_based_derivative(double w, double s, double *dw, double *ds);
+
+/**
+ * @brief Store in dw and ds the partial derivatives of max_2_1.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void max_2_1_derivative(double w, double s, double *dw, double *ds);
+
+/**
+ * @brief Store in dw and ds the partial derivatives of max_1_1.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void max_1_1_derivative(double w, double s, double *dw, double *ds);
+
+/**
+ * @brief Return the partial derivatives of the aggregation function over arrays aggregation,
+ * NULL if there are none.
+ * 
+ * @param aggregation an aggregation function over arrays
+ * @return QBAFArrayAggregationDerivative the derivatives, NULL if there are none
+ */
+QBAFArrayAggregationDerivative aggregation_derivative_function(QBAFArrayAggregation aggregation);
+
+/**
+ * @brief Return the partial derivatives of the influence function influence, NULL if there are none.
+ * 
+ * @param influence an influence function
+ * @return QBAFInfluenceDerivative the derivatives, NULL if there are none
+ */
+QBAFInfluenceDerivative influence_derivative_function(double (*influence)(double, double));
+
 #endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+/**
+ * @file qbaf_gradient.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that differentiates the final strengths of an acyclic QBAFGraph w.r.t. the initial strengths
+ */
+
+#ifndef _QBAF_GRADIENT_H_
+#define _QBAF_GRADIENT_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "qbaf_graph.h"
+#include "qbaf_functions.h"
+
+/**
+ * @brief Store in gradient[i] the derivative of the final strength of the argument with index topic
+ * w.r.t. the initial strength of the argument with index i, for every argument (reverse mode:
+ * a single backward sweep of the topological order).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic and evaluated QBAFGraph (not NULL)
+ * @param topic the index of the topic argument
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param aggregation_derivative the partial derivatives of aggregation
+ * @param influence_derivative the partial derivatives of the influence function
+ * @param gradient an array of size graph->size where the result is stored
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFGradient_Reverse(QBAFGraph *graph, Py_ssize_t topic, QBAFArrayAggregation aggregation,
+                         QBAFArrayAggregationDerivative aggregation_derivative,
+                         QBAFInfluenceDerivative influence_derivative, double *gradient);
+
+/**
+ * @brief Store in tangent[i] the derivative of the final strength of the argument with index i
+ * w.r.t. the initial strength of the argument with index argument, for every argument (forward mode:
+ * a single forward sweep of the topological order).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic and evaluated QBAFGraph (not NULL)
+ * @param argument the index of the perturbed argument
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param aggregation_derivative the partial derivatives of aggregation
+ * @param influence_derivative the partial derivatives of the influence function
+ * @param tangent an array of size graph->size where the result is stored
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFGradient_Forward(QBAFGraph *graph, Py_ssize_t argument, QBAFArrayAggregation aggregation,
+                         QBAFArrayAggregationDerivative aggregation_derivative,
+                         QBAFInfluenceDerivative influence_derivative, double *tangent);
+
+#endif
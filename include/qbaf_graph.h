@@ -0,0 +1,244 @@
+/**
+ * @file qbaf_graph.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that defines the compiled representation of a QBAFramework
+ */
+
+#ifndef _QBAF_GRAPH_H_
+#define _QBAF_GRAPH_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "relations.h"
+#include "qbaf_functions.h"
+
+/**
+ * @brief Struct that defines a compiled snapshot of the arguments, the initial strengths
+ * and the Attack/Support relations of a QBAFramework.
+ * Every argument is identified by a dense index in [0, size) and the attackers/supporters
+ * of every argument are stored in CSR (compressed sparse row) arrays.
+ * The arguments are also scheduled in topological levels (Kahn's algorithm): every argument
+ * of a level only depends on arguments of previous levels.
+ * The strengths are stored in bytearrays that can be shared with copies and exported read-only snapshots,
+ * so they must be unshared (QBAFGraph_Unshare) before being modified.
+ * The arguments whose final strength must be recalculated after a change are marked as dirty,
+ * so that only them and the arguments that depend on them are evaluated again.
+ * The CSR arrays and the schedule may be borrowed from a mapping (see qbaf_file.h), in which case
+ * they are read-only and shared with the copies of the graph.
+ *
+ */
+typedef struct {
+    Py_ssize_t  size;                   /* number of arguments */
+    PyObject   *arguments;              /* PyList of QBAFArgument, the position of each argument is its index */
+    PyObject   *indices;                /* dictionary of (key, value) = (QBAFArgument, index: PyLong) */
+    Py_ssize_t *attackers_offsets;      /* attackers of argument i are attackers[attackers_offsets[i]:attackers_offsets[i+1]] */
+    Py_ssize_t *attackers;              /* indices of the attackers */
+    Py_ssize_t *supporters_offsets;     /* supporters of argument i are supporters[supporters_offsets[i]:supporters_offsets[i+1]] */
+    Py_ssize_t *supporters;             /* indices of the supporters */
+    Py_ssize_t *dependents_offsets;     /* arguments attacked/supported by argument i are dependents[dependents_offsets[i]:dependents_offsets[i+1]] */
+    Py_ssize_t *dependents;             /* indices of the attacked/supported arguments */
+    Py_ssize_t *order;                  /* indices of the arguments in topological order (only the first ordered are valid) */
+    Py_ssize_t *positions;              /* position of every argument in order, -1 if it is not scheduled */
+    Py_ssize_t  ordered;                /* number of scheduled arguments, size if and only if the graph is acyclic */
+    Py_ssize_t *level_offsets;          /* arguments of level l are order[level_offsets[l]:level_offsets[l+1]] */
+    Py_ssize_t  levels;                 /* number of levels */
+    double     *initial_strengths;      /* initial strength of every argument */
+    double     *final_strengths;        /* final strength of every argument (only valid if evaluated) */
+    PyObject   *initial_strengths_buffer;   /* bytearray that owns initial_strengths (it may be shared) */
+    PyObject   *final_strengths_buffer;     /* bytearray that owns final_strengths (it may be shared) */
+    int         evaluated;              /* 1 if final_strengths have been calculated, 0 if not */
+    char       *dirty;                  /* 1 if the final strength of the argument must be recalculated, 0 if not */
+    Py_ssize_t  dirty_count;            /* number of dirty arguments */
+    Py_ssize_t  dirty_first;            /* no dirty argument has a position in order lower than dirty_first */
+    Py_ssize_t *components;             /* strongly connected component of every argument (NULL until they are computed) */
+    Py_ssize_t *component_offsets;      /* arguments of component c are component_members[component_offsets[c]:component_offsets[c+1]] */
+    Py_ssize_t *component_members;      /* indices of the arguments grouped by component */
+    Py_ssize_t  component_count;        /* number of strongly connected components */
+    Py_ssize_t  max_agents;             /* maximum number of attackers plus supporters of an argument */
+    double     *buffer;                 /* scratch array (size max_agents) to gather the strengths of the agents */
+    PyObject   *mapping;                /* object that owns the CSR arrays, order, positions and level_offsets
+                                           (e.g. a mapped file), NULL if they are owned by the graph */
+} QBAFGraph;
+
+/**
+ * @brief Return 1 if the QBAFGraph graph is acyclic, 0 if it is not.
+ *
+ */
+#define QBAFGraph_IsAcyclic(graph) ((graph)->ordered == (graph)->size)
+
+/**
+ * @brief Return 1 if some final strengths of the QBAFGraph graph must be recalculated, 0 if not.
+ *
+ */
+#define QBAFGraph_IsDirty(graph) ((graph)->dirty_count > 0)
+
+/**
+ * @brief Return a new QBAFGraph compiled from the components of a QBAFramework,
+ * NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param arguments a PySet of QBAFArgument
+ * @param initial_strengths a PyDict of (QBAFArgument, PyFloat) containing every argument
+ * @param attack_relations a QBAFARelations whose arguments are contained in arguments
+ * @param support_relations a QBAFARelations whose arguments are contained in arguments
+ * @return QBAFGraph* a new QBAFGraph, NULL if an error occurred
+ */
+QBAFGraph *QBAFGraph_New(PyObject *arguments, PyObject *initial_strengths,
+                         QBAFARelationsObject *attack_relations, QBAFARelationsObject *support_relations);
+
+/**
+ * @brief Return a deep copy of the QBAFGraph graph (the QBAFArgument objects are shared),
+ * NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return QBAFGraph* a new QBAFGraph, NULL if an error occurred
+ */
+QBAFGraph *QBAFGraph_Copy(QBAFGraph *graph);
+
+/**
+ * @brief Free the memory of a QBAFGraph and release its references. It does nothing if graph is NULL.
+ *
+ * @param graph a QBAFGraph
+ */
+void QBAFGraph_Free(QBAFGraph *graph);
+
+/**
+ * @brief Make sure that the strengths of the QBAFGraph graph are not shared with another graph
+ * or an exported memoryview before modifying them (copy-on-write).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFGraph_Unshare(QBAFGraph *graph);
+
+/**
+ * @brief Return a new read-only memoryview of doubles over the initial strengths of the QBAFGraph graph
+ * (without copying them), NULL if an error has occurred. It is a snapshot: it keeps a reference
+ * to the strengths, so the graph copies them before modifying them (see QBAFGraph_Unshare).
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new memoryview, NULL if an error occurred
+ */
+PyObject *QBAFGraph_InitialStrengthsView(QBAFGraph *graph);
+
+/**
+ * @brief Return a new read-only memoryview of doubles over the final strengths of the QBAFGraph graph
+ * (without copying them), NULL if an error has occurred. It is a snapshot: it keeps a reference
+ * to the strengths, so the graph copies them before modifying them (see QBAFGraph_Unshare).
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new memoryview, NULL if an error occurred
+ */
+PyObject *QBAFGraph_FinalStrengthsView(QBAFGraph *graph);
+
+/**
+ * @brief Return the index of the argument in the QBAFGraph graph,
+ * -1 if it is not contained, and -2 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param argument a QBAFArgument
+ * @return Py_ssize_t the index of the argument, -1 if not contained, -2 if an error occurred
+ */
+Py_ssize_t QBAFGraph_IndexOf(QBAFGraph *graph, PyObject *argument);
+
+/**
+ * @brief Return a new PyDict of (QBAFArgument, PyFloat) with the values of strengths (an array of size graph->size),
+ * NULL if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param strengths an array of doubles indexed like the arguments of the graph
+ * @return PyObject* a new PyDict, NULL if an error occurred
+ */
+PyObject *QBAFGraph_StrengthsAsDict(QBAFGraph *graph, const double *strengths);
+
+/**
+ * @brief Return the result of applying the aggregation function to the strengths of the attackers
+ * and supporters of the argument with index index. The strengths are gathered in buffer.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param index the index of the argument
+ * @param strengths the strengths of the arguments (size graph->size)
+ * @param aggregation an aggregation function over arrays
+ * @param buffer a scratch array of size graph->max_agents
+ * @return double the result of the aggregation function
+ */
+double QBAFGraph_Aggregate(QBAFGraph *graph, Py_ssize_t index, const double *strengths,
+                           QBAFArrayAggregation aggregation, double *buffer);
+
+/**
+ * @brief Return the result of applying the aggregation function to the strengths of the attackers
+ * and supporters of the argument with index index, where the strength of argument i is strengths[i * stride].
+ * The strengths are gathered in buffer.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param index the index of the argument
+ * @param strengths the strengths of the arguments (size graph->size * stride)
+ * @param stride the distance between the strengths of consecutive arguments
+ * @param aggregation an aggregation function over arrays
+ * @param buffer a scratch array of size graph->max_agents
+ * @return double the result of the aggregation function
+ */
+double QBAFGraph_AggregateStrided(QBAFGraph *graph, Py_ssize_t index, const double *strengths, Py_ssize_t stride,
+                                  QBAFArrayAggregation aggregation, double *buffer);
+
+/**
+ * @brief Mark the argument with index index as dirty, i.e. its final strength must be recalculated.
+ * If the graph is not acyclic, the final strengths of all the arguments are invalidated instead.
+ * It does nothing if the final strengths have not been calculated.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param index the index of the argument
+ */
+void QBAFGraph_MarkDirty(QBAFGraph *graph, Py_ssize_t index);
+
+/**
+ * @brief Unmark every dirty argument of the QBAFGraph graph.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ */
+void QBAFGraph_ClearDirty(QBAFGraph *graph);
+
+/**
+ * @brief Reuse the final strengths of the QBAFGraph previous (compiled before a change of the framework) in graph.
+ * It is only possible if both graphs are acyclic and have the same arguments with the same indices.
+ * Then, every argument whose initial strength, attackers or supporters have changed
+ * (or that was already dirty in previous) is marked as dirty. Otherwise, it does nothing.
+ *
+ * @param graph a new QBAFGraph (not NULL) that has not been evaluated
+ * @param previous a QBAFGraph, or NULL
+ */
+void QBAFGraph_Inherit(QBAFGraph *graph, QBAFGraph *previous);
+
+/**
+ * @brief Compute the strongly connected components of the QBAFGraph graph (w.r.t. the attack and support relations)
+ * with an iterative version of Tarjan's algorithm, if they have not been computed yet.
+ * The components are numbered in topological order: the agents of an argument of a component
+ * belong to the same component or to previous ones.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFGraph_ComputeComponents(QBAFGraph *graph);
+
+/**
+ * @brief Return a new PyList with the arguments of a cycle of the QBAFGraph graph (every argument attacks
+ * or supports the next one, and the last one attacks or supports the first one), Py_None if it is acyclic,
+ * NULL if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new PyList of QBAFArgument or Py_None, NULL if an error occurred
+ */
+PyObject *QBAFGraph_FindCycle(QBAFGraph *graph);
+
+/**
+ * @brief Return a new PyList with a PyList of QBAFArgument for every topological level of the QBAFGraph graph,
+ * NULL if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new PyList of PyList, NULL if an error occurred
+ */
+PyObject *QBAFGraph_LevelsAsList(QBAFGraph *graph);
+
+#endif
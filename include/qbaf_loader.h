@@ -0,0 +1,48 @@
+/**
+ * @file qbaf_loader.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that loads the arguments and relations of a QBAFramework from a JSON or CSV text source,
+ * reading it in chunks and inserting every argument and relation as soon as it is parsed
+ */
+
+#ifndef _QBAF_LOADER_H_
+#define _QBAF_LOADER_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "relations.h"
+
+/**
+ * @brief Struct with the storage of a QBAFramework where the loaded arguments and relations are inserted.
+ *
+ */
+typedef struct {
+    PyObject             *arguments;            /* PySet of QBAFArgument */
+    PyObject             *initial_strengths;    /* PyDict of (QBAFArgument, PyFloat) */
+    QBAFARelationsObject *attack_relations;     /* the Attack relations, whose symbol table contains the arguments */
+    QBAFARelationsObject *support_relations;    /* the Support relations, sharing the symbol table of attack_relations */
+} QBAFLoaderTarget;
+
+/**
+ * @brief Load the arguments and relations of source into target.
+ * The source is a path (str, bytes or os.PathLike) or an object with a read method that returns bytes or str.
+ * The format is "json" or "csv" (if NULL, it is inferred from the extension of the path).
+ *
+ * JSON: an object {"arguments": [[name, initial_strength] or {"name": name, "initial_strength": initial_strength}, ...],
+ * "attacks": [[attacker, attacked], ...], "supports": [[supporter, supported], ...]} (other keys are ignored).
+ * CSV: rows "argument,name,initial_strength", "attack,attacker,attacked" or "support,supporter,supported"
+ * (an optional first row starting with "kind" and the rows starting with '#' are skipped).
+ * Every argument must be declared before it is used in a relation.
+ *
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ * Malformed input raises ValueError with the line and the column (in bytes) where the error was found.
+ *
+ * @param source a path or a file-like object
+ * @param format "json", "csv" or NULL
+ * @param target the storage of a QBAFramework (not NULL)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFLoader_Load(PyObject *source, const char *format, QBAFLoaderTarget *target);
+
+#endif
@@ -24,6 +24,14 @@ PyTypeObject *get_QBAFArgumentType(void);
  */
 PyTypeObject *get_QBAFARelationsType(void);
 
+/**
+ * @brief Get the QBAFANeighboursIteratorType object that defines the (internal) class of the iterators
+ * returned by QBAFARelations.patients_view and QBAFARelations.agents_view
+ * 
+ * @return PyTypeObject* a pointer to the QBAFANeighboursIterator class definition
+ */
+PyTypeObject *get_QBAFANeighboursIteratorType(void);
+
 /**
  * @brief Get the QBAFrameworkType object that defines the class QBAFramework
  * 
@@ -31,4 +39,20 @@ PyTypeObject *get_QBAFARelationsType(void);
  */
 PyTypeObject *get_QBAFrameworkType(void);
 
+/**
+ * @brief Get the QBAFExplanationIteratorType object that defines the (internal) class of the iterators
+ * returned by QBAFramework.iter_minimal_ssi_explanations, iter_minimal_csi_explanations and iter_minimal_nsi_explanations
+ * 
+ * @return PyTypeObject* a pointer to the QBAFExplanationIterator class definition
+ */
+PyTypeObject *get_QBAFExplanationIteratorType(void);
+
+/**
+ * @brief Get the QBAFStrengthsType object that defines the (internal) class of the read-only buffers
+ * exported by QBAFramework.final_strengths_array and QBAFramework.initial_strengths_array
+ * 
+ * @return PyTypeObject* a pointer to the QBAFStrengths class definition
+ */
+PyTypeObject *get_QBAFStrengthsType(void);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,101 @@
+/**
+ * @file qbaf_order.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that maintains a topological order of the arguments of an acyclic QBAFramework
+ * while its relations are added (Pearce-Kelly algorithm)
+ */
+
+#ifndef _QBAF_ORDER_H_
+#define _QBAF_ORDER_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "relations.h"
+#include "qbaf_graph.h"
+
+/**
+ * @brief Struct that defines a topological order of the arguments of an acyclic QBAFramework:
+ * every argument has a distinct rank, and the rank of an attacker/supporter is lower than
+ * the rank of the argument it attacks/supports.
+ * The arguments are identified by their ids in the symbol table of the relations of the framework
+ * (QBAFARelations_Intern), so the ranks are stored in an array indexed by id.
+ * When a relation (agent, patient) with rank(agent) > rank(patient) is added, only the arguments
+ * reachable from the patient with a rank lower than the agent and the arguments that reach the agent
+ * with a rank greater than the patient are visited and reordered (Pearce-Kelly algorithm).
+ *
+ */
+typedef struct {
+    Py_ssize_t *ranks;      /* ranks[id] is the rank of the argument with id id, -1 if it is not ordered */
+    char       *marks;      /* marks[id] is 1 while a search has visited the argument with id id, 0 otherwise */
+    Py_ssize_t  capacity;   /* number of allocated ranks and marks */
+    Py_ssize_t  next;       /* rank of the next added argument (greater than every rank) */
+} QBAFOrder;
+
+/**
+ * @brief Return a new QBAFOrder with the topological order of the acyclic QBAFGraph graph,
+ * NULL (with the corresponding exception) if an error has occurred.
+ * The arguments of graph are interned in the symbol table of relations.
+ *
+ * @param graph an acyclic QBAFGraph (not NULL)
+ * @param relations the relations of the framework (the Attack and the Support relations share their symbol table)
+ * @return QBAFOrder* a new QBAFOrder, NULL if an error occurred
+ */
+QBAFOrder *QBAFOrder_New(QBAFGraph *graph, QBAFARelationsObject *relations);
+
+/**
+ * @brief Return a copy of the QBAFOrder order, NULL (with the corresponding exception) if an error has occurred.
+ * The copy is only valid for relations with the same ids (e.g. the copies of the relations).
+ *
+ * @param order a QBAFOrder (not NULL)
+ * @return QBAFOrder* a new QBAFOrder, NULL if an error occurred
+ */
+QBAFOrder *QBAFOrder_Copy(QBAFOrder *order);
+
+/**
+ * @brief Free the memory of a QBAFOrder. It does nothing if order is NULL.
+ *
+ * @param order a QBAFOrder
+ */
+void QBAFOrder_Free(QBAFOrder *order);
+
+/**
+ * @brief Add an argument (without relations) at the end of the QBAFOrder order,
+ * interning it in the symbol table of relations.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param order a QBAFOrder (not NULL)
+ * @param relations the relations of the framework
+ * @param argument a QBAFArgument that is not contained in order
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFOrder_AddArgument(QBAFOrder *order, QBAFARelationsObject *relations, PyObject *argument);
+
+/**
+ * @brief Remove an argument (without relations) from the QBAFOrder order.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param order a QBAFOrder (not NULL)
+ * @param relations the relations of the framework
+ * @param argument a QBAFArgument contained in order
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFOrder_RemoveArgument(QBAFOrder *order, QBAFARelationsObject *relations, PyObject *argument);
+
+/**
+ * @brief Reorder the QBAFOrder order so that it stays topological after adding the relation (agent, patient)
+ * to the attack/support relations. If the relation would create a cycle, the order is not modified.
+ * Return 1 if the order has been updated, 0 if the relation would create a cycle,
+ * -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param order a QBAFOrder of the arguments of the relations (not NULL)
+ * @param attack_relations the Attack relations of the framework
+ * @param support_relations the Support relations of the framework (they share the symbol table of attack_relations)
+ * @param agent a QBAFArgument contained in order
+ * @param patient a QBAFArgument contained in order
+ * @return int 1 if updated, 0 if the relation would create a cycle, -1 if an error occurred
+ */
+int QBAFOrder_AddRelation(QBAFOrder *order, QBAFARelationsObject *attack_relations,
+                          QBAFARelationsObject *support_relations, PyObject *agent, PyObject *patient);
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file qbaf_overlay.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that evaluates the reversals of a QBAFramework into another one
+ * without building them, from the compiled graphs of both frameworks
+ */
+
+#ifndef _QBAF_OVERLAY_H_
+#define _QBAF_OVERLAY_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "qbaf_graph.h"
+
+/**
+ * @brief Struct that overlays the compiled graphs of QBF' (self) and QBF (other) over the union of their arguments,
+ * so that the reversal of self to other w.r.t. any set of arguments can be compiled into plain arrays.
+ * The arguments of self keep their index and the arguments that are only in other follow them.
+ * In the reversal, an argument taken from other exists if it is in other, has the initial strength of other
+ * and the attacks/supports of other towards the existing arguments (plus those of self towards the arguments
+ * that are not in other); any other argument is taken from self as it is.
+ * Every array is allocated once, so selecting and scheduling a reversal does not allocate memory.
+ *
+ */
+typedef struct QBAFOverlay {
+    Py_ssize_t  size;               /* number of arguments in the union of both frameworks */
+    QBAFGraph  *self;               /* copy of the compiled graph of self */
+    QBAFGraph  *other;              /* copy of the compiled graph of other */
+    Py_ssize_t *other_of;           /* index in other of every argument, -1 if it is not in other */
+    Py_ssize_t *other_indices;      /* overlay index of every argument of other (indexed like other) */
+    struct QBAFOverlay *base;       /* the QBAFOverlay that owns self, other, other_of and other_indices
+                                       if this one is a fork of it (QBAFOverlay_Fork), NULL if they are its own */
+    char       *from_other;         /* 1 if the argument is taken from other in the selected reversal, 0 if from self */
+    char       *present;            /* 1 if the argument exists in the selected reversal, 0 if not */
+    double     *initial_strengths;  /* initial strength of every argument in the selected reversal */
+    double     *final_strengths;    /* final strength of every scheduled argument in the selected reversal */
+    QBAFGraph   view;               /* attackers/supporters (CSR) of the selected reversal, only the relation arrays
+                                       and the scratch buffer are valid */
+    Py_ssize_t *order;              /* the ancestors of the roots in topological order (after QBAFOverlay_Schedule) */
+    Py_ssize_t  ordered;            /* number of arguments of order */
+    char       *state;              /* depth-first search state of every argument (0 new, 1 visiting, 2 visited) */
+    Py_ssize_t *cursor;             /* next agent to visit of every argument in the depth-first search */
+    Py_ssize_t *stack;              /* depth-first search stack */
+} QBAFOverlay;
+
+/**
+ * @brief Return a new QBAFOverlay of the compiled graphs self and other (they are copied),
+ * NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param self the compiled graph of the framework that is reversed (QBF')
+ * @param other the compiled graph of the framework it is reversed into (QBF)
+ * @return QBAFOverlay* a new QBAFOverlay, NULL if an error occurred
+ */
+QBAFOverlay *QBAFOverlay_New(QBAFGraph *self, QBAFGraph *other);
+
+/**
+ * @brief Return a new QBAFOverlay that shares the graphs and indices of the QBAFOverlay overlay
+ * but has its own arrays of the reversals, so both can select and evaluate reversals concurrently.
+ * The fork must be freed before overlay. Return NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param overlay a QBAFOverlay
+ * @return QBAFOverlay* a new QBAFOverlay, NULL if an error occurred
+ */
+QBAFOverlay *QBAFOverlay_Fork(QBAFOverlay *overlay);
+
+/**
+ * @brief Free the memory of a QBAFOverlay. It does nothing if overlay is NULL.
+ *
+ * @param overlay a QBAFOverlay
+ */
+void QBAFOverlay_Free(QBAFOverlay *overlay);
+
+/**
+ * @brief Return the index of the argument in the QBAFOverlay overlay,
+ * -1 if it is in neither framework, and -2 (with the corresponding exception) if an error has occurred.
+ *
+ * @param overlay a QBAFOverlay
+ * @param argument a QBAFArgument
+ * @return Py_ssize_t the index of the argument, -1 if not contained, -2 if an error occurred
+ */
+Py_ssize_t QBAFOverlay_IndexOf(QBAFOverlay *overlay, PyObject *argument);
+
+/**
+ * @brief Select (and compile) the reversal of self to other w.r.t. the arguments with indices members
+ * (complement = 0) or w.r.t. every argument except them (complement = 1).
+ *
+ * @param overlay a QBAFOverlay
+ * @param members the indices of the arguments (without repetitions)
+ * @param count the number of members
+ * @param complement 1 if the reversal is w.r.t. the complement of members, 0 if w.r.t. members
+ */
+void QBAFOverlay_Select(QBAFOverlay *overlay, const Py_ssize_t *members, Py_ssize_t count, int complement);
+
+/**
+ * @brief Store in overlay->order the ancestors of the arguments roots (included) in the selected reversal
+ * in topological order, checking that the whole reversal is acyclic.
+ * Return 1 if the reversal is acyclic, 0 if it is not (order is not valid then).
+ *
+ * @param overlay a QBAFOverlay with a selected reversal
+ * @param roots the indices of arguments that exist in the reversal
+ * @param count the number of roots
+ * @return int 1 if acyclic, 0 if not
+ */
+int QBAFOverlay_Schedule(QBAFOverlay *overlay, const Py_ssize_t *roots, Py_ssize_t count);
+
+#endif
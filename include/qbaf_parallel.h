@@ -0,0 +1,105 @@
+/**
+ * @file qbaf_parallel.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that evaluates a compiled QBAFGraph without Python objects, optionally in parallel
+ */
+
+#ifndef _QBAF_PARALLEL_H_
+#define _QBAF_PARALLEL_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "qbaf_graph.h"
+#include "qbaf_functions.h"
+
+/**
+ * @brief Calculate the final strengths of an acyclic QBAFGraph level by level with threads threads.
+ * The arguments of every level are distributed dynamically in chunks among the threads,
+ * and the influence function is applied to every chunk with its batched (SIMD) version if there is one.
+ * The GIL is only released if it is evaluated by more than one thread, so the graph must not be modified
+ * or freed concurrently then (see QBAFrameworkObject.busy). If threads cannot be created, it evaluates
+ * the graph with the threads that could be created.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic QBAFGraph (not NULL)
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param influence an influence function of qbaf_functions.h
+ * @param approximate 1 if the batched influence may approximate exp, 0 if not (see batch_influence_function)
+ * @param threads the number of threads (at least 1)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFParallel_Evaluate(QBAFGraph *graph, QBAFArrayAggregation aggregation,
+                          double (*influence)(double, double), int approximate, int threads);
+
+/**
+ * @brief Calculate the final strengths of an acyclic QBAFGraph for every row of a batch of initial strengths
+ * (the initial strengths of the graph are ignored). The rows are evaluated in blocks, storing the strengths
+ * of a block column by column, and the blocks are distributed dynamically among threads threads.
+ * The GIL is only released if there is more than one thread, so the graph must not be modified
+ * or freed concurrently then (see QBAFrameworkObject.busy).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic QBAFGraph (not NULL)
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param influence an influence function of qbaf_functions.h
+ * @param approximate 1 if the batched influence may approximate exp, 0 if not (see batch_influence_function)
+ * @param initial_strengths the initial strengths of every row (rows x graph->size, row-major)
+ * @param final_strengths where the final strengths of every row are stored (rows x graph->size, row-major)
+ * @param rows the number of rows
+ * @param threads the number of threads (at least 1)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFParallel_EvaluateBatch(QBAFGraph *graph, QBAFArrayAggregation aggregation,
+                               double (*influence)(double, double), int approximate,
+                               const double *initial_strengths, double *final_strengths,
+                               Py_ssize_t rows, int threads);
+
+/**
+ * @brief Function that processes the items [start, end) of a QBAFParallel_For loop in the thread with number thread
+ * (from 0 to the number of threads - 1, 0 is the thread that called QBAFParallel_For).
+ * It is called with the GIL released, so it must not use Python objects.
+ */
+typedef void (*QBAFParallelBody)(void *task, int thread, Py_ssize_t start, Py_ssize_t end);
+
+/**
+ * @brief Struct that defines a pool of threads that run QBAFParallel_For loops. The workers are created once
+ * and wait for the next loop until the pool is freed, so a search that runs many short loops does not create
+ * and join threads for every loop.
+ *
+ */
+typedef struct QBAFParallelPool QBAFParallelPool;
+
+/**
+ * @brief Return a new QBAFParallelPool of threads threads: the thread that calls QBAFParallel_For
+ * and threads - 1 workers. If workers cannot be created, the pool has the workers that could be created.
+ * Return NULL (with the corresponding exception) if there is no memory left.
+ *
+ * @param threads the number of threads (at least 1)
+ * @return QBAFParallelPool* a new QBAFParallelPool (free it with QBAFParallelPool_Free), NULL if an error occurred
+ */
+QBAFParallelPool *QBAFParallelPool_New(int threads);
+
+/**
+ * @brief Stop the workers of the QBAFParallelPool pool and free its memory. It does nothing if pool is NULL.
+ * It must not be called during a loop of the pool.
+ *
+ * @param pool a QBAFParallelPool
+ */
+void QBAFParallelPool_Free(QBAFParallelPool *pool);
+
+/**
+ * @brief Call body on the items [0, size) of task in chunks of at most chunk items,
+ * which are distributed dynamically among the threads of the QBAFParallelPool pool. The GIL is released during the loop.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param pool the QBAFParallelPool that runs the loop (one loop at a time)
+ * @param body the function that processes a chunk of items
+ * @param task the argument of body
+ * @param size the number of items
+ * @param chunk the number of items that a thread claims each time (at least 1)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFParallel_For(QBAFParallelPool *pool, QBAFParallelBody body, void *task, Py_ssize_t size, Py_ssize_t chunk);
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file qbaf_simd_kernels.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Template of the batched influence functions (qbaf_functions.c includes it once per instruction set).
+ *
+ * Before including this file the following macros must be defined:
+ *  - QBAF_VD: vector type of QBAF_WIDTH doubles (GCC/Clang vector extension)
+ *  - QBAF_VI: vector type of QBAF_WIDTH 64-bit integers
+ *  - QBAF_WIDTH: number of lanes
+ *  - QBAF_TARGET: the target attribute of the instruction set
+ *  - QBAF_NAME(name): the name of a function for the instruction set
+ *
+ * The kernels only use IEEE additions, multiplications and divisions (compiled without contraction),
+ * so every lane computes exactly the same value as the scalar influence functions, except euler_based:
+ * exp is approximated (see vexp) within 2 ULP of the correctly rounded result.
+ * The elements that do not fill a vector are computed in a padded vector, so the result of an element
+ * does not depend on its position in the batch.
+ */
+
+/**
+ * @brief Return the vector with the elements of a if a > b, and b otherwise (like the macro max).
+ *
+ * @param a a vector
+ * @param b a vector
+ * @return QBAF_VD the maximum of every pair of elements
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(vmax)(QBAF_VD a, QBAF_VD b)
+{
+    QBAF_VI mask = (QBAF_VI) (a > b);
+    return (QBAF_VD) ((mask & (QBAF_VI) a) | (~mask & (QBAF_VI) b));
+}
+
+/**
+ * @brief Return the vector with 2^n for every element of n (an integer in [-1022, 1023] stored as a double).
+ *
+ * @param n a vector of integers
+ * @return QBAF_VD the powers of 2
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(vexp2i)(QBAF_VD n)
+{
+    // The integer n is in the lowest bits of n + 1.5 * 2^52
+    QBAF_VD t = n + EXP_ROUND_MAGIC;
+    return (QBAF_VD) (((QBAF_VI) t - EXP_ROUND_MAGIC_BITS + 1023) << 52);
+}
+
+/**
+ * @brief Return an approximation of exp(x) for every element of x, within 2 ULP of the correctly rounded result
+ * (exp(x) = 2^n * exp(r), |r| <= ln(2)/2, with a degree 13 polynomial for exp(r)).
+ * It returns +inf if it overflows, 0 if x < -745.2 and NaN if x is NaN.
+ *
+ * @param x a vector
+ * @return QBAF_VD the exponential of every element
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(vexp)(QBAF_VD x)
+{
+    // Clamp x (NaN is kept) so that the exponent cannot overflow the integer arithmetic
+    const QBAF_VD zero = {0};
+    QBAF_VD upper = zero + EXP_MAX_INPUT, lower = zero + EXP_MIN_INPUT;
+    x = QBAF_NAME(vmax)(lower, x);
+    x = -QBAF_NAME(vmax)(-upper, -x);
+
+    // n = round(x / ln(2)), r = x - n * ln(2) (Cody-Waite)
+    QBAF_VD n = (x * EXP_LOG2E + EXP_ROUND_MAGIC) - EXP_ROUND_MAGIC;
+    QBAF_VD r = (x - n * EXP_LN2_HI) - n * EXP_LN2_LO;
+
+    // exp(r) = 1 + r + r^2 * q(r)
+    QBAF_VD q = r * EXP_C13 + EXP_C12;
+    q = q * r + EXP_C11;
+    q = q * r + EXP_C10;
+    q = q * r + EXP_C9;
+    q = q * r + EXP_C8;
+    q = q * r + EXP_C7;
+    q = q * r + EXP_C6;
+    q = q * r + EXP_C5;
+    q = q * r + EXP_C4;
+    q = q * r + EXP_C3;
+    q = q * r + EXP_C2;
+    QBAF_VD e = 1.0 + (r + (r * r) * q);
+
+    // 2^n is applied in two steps so that both factors are normal numbers
+    QBAF_VD n1 = ((n * 0.5) + EXP_ROUND_MAGIC) - EXP_ROUND_MAGIC;
+    return (e * QBAF_NAME(vexp2i)(n1)) * QBAF_NAME(vexp2i)(n - n1);
+}
+
+/**
+ * @brief Vector version of simple_influence.
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(vsimple_influence)(QBAF_VD w, QBAF_VD s)
+{
+    return w + s;
+}
+
+/**
+ * @brief Vector version of linear_1.
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(vlinear_1)(QBAF_VD w, QBAF_VD s)
+{
+    const QBAF_VD zero = {0};
+    return (w - w * QBAF_NAME(vmax)(zero, -s)) + (1.0 - w) * QBAF_NAME(vmax)(zero, s);
+}
+
+/**
+ * @brief Vector version of euler_based.
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(veuler_based)(QBAF_VD w, QBAF_VD s)
+{
+    return 1.0 - (1.0 - w * w) / (1.0 + w * QBAF_NAME(vexp)(s));
+}
+
+/**
+ * @brief Vector version of max_2_1.
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(vmax_2_1)(QBAF_VD w, QBAF_VD s)
+{
+    const QBAF_VD zero = {0};
+    QBAF_VD attack = QBAF_NAME(vmax)(zero, -s), support = QBAF_NAME(vmax)(zero, s);
+    attack = attack * attack;
+    support = support * support;
+    return (w - w * (attack / (1.0 + attack))) + (1.0 - w) * (support / (1.0 + support));
+}
+
+/**
+ * @brief Vector version of max_1_1.
+ */
+static inline QBAF_TARGET QBAF_VD
+QBAF_NAME(vmax_1_1)(QBAF_VD w, QBAF_VD s)
+{
+    const QBAF_VD zero = {0};
+    QBAF_VD attack = QBAF_NAME(vmax)(zero, -s), support = QBAF_NAME(vmax)(zero, s);
+    return (w - w * (attack / (1.0 + attack))) + (1.0 - w) * (support / (1.0 + support));
+}
+
+/**
+ * @brief Define the batched version of the vector influence function vfunction:
+ * result[i] = function(w[i], s[i]) for every i in [0, size).
+ */
+#define QBAF_DEFINE_BATCH(function)                                                         \
+static QBAF_TARGET void                                                                     \
+QBAF_NAME(function)(const double *w, const double *s, double *result, Py_ssize_t size)     \
+{                                                                                           \
+    QBAF_VD vw, vs, vr;                                                                     \
+    Py_ssize_t i = 0;                                                                       \
+    for (; i + QBAF_WIDTH <= size; i += QBAF_WIDTH) {                                       \
+        memcpy(&vw, w + i, sizeof(vw));                                                     \
+        memcpy(&vs, s + i, sizeof(vs));                                                     \
+        vr = QBAF_NAME(v##function)(vw, vs);                                                \
+        memcpy(result + i, &vr, sizeof(vr));                                                \
+    }                                                                                       \
+    if (i < size) {                                                                         \
+        double pw[QBAF_WIDTH] = {0}, ps[QBAF_WIDTH] = {0}, pr[QBAF_WIDTH];                  \
+        memcpy(pw, w + i, (size - i) * sizeof(double));                                     \
+        memcpy(ps, s + i, (size - i) * sizeof(double));                                     \
+        memcpy(&vw, pw, sizeof(vw));                                                        \
+        memcpy(&vs, ps, sizeof(vs));                                                        \
+        vr = QBAF_NAME(v##function)(vw, vs);                                                \
+        memcpy(pr, &vr, sizeof(vr));                                                        \
+        memcpy(result + i, pr, (size - i) * sizeof(double));                                \
+    }                                                                                       \
+}
+
+QBAF_DEFINE_BATCH(simple_influence)
+QBAF_DEFINE_BATCH(linear_1)
+QBAF_DEFINE_BATCH(euler_based)
+QBAF_DEFINE_BATCH(max_2_1)
+QBAF_DEFINE_BATCH(max_1_1)
+
+#undef QBAF_DEFINE_BATCH
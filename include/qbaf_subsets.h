@@ -0,0 +1,253 @@
+/**
+ * @file qbaf_subsets.h
+ * @author Jose Ruiz Alarcon
+ * @brief  Module that enumerates lazily the non-empty subsets of a list of candidate arguments,
+ * represented as bitsets over their indices, in ascending order of size
+ */
+
+#ifndef _QBAF_SUBSETS_H_
+#define _QBAF_SUBSETS_H_
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+
+/**
+ * @brief A word of a bitset. A set of candidates is an array of QBAFBitsetWord (as many as QBAFBitset_Words
+ * of the number of candidates): the bit i % QBAF_BITSET_WORD_BITS of the word i / QBAF_BITSET_WORD_BITS is set
+ * if the candidate with index i is contained.
+ *
+ */
+typedef uint64_t QBAFBitsetWord;
+
+#define QBAF_BITSET_WORD_BITS 64    /* number of bits of a QBAFBitsetWord */
+
+/**
+ * @brief Return the number of QBAFBitsetWord of a set of size candidates (at least 1).
+ *
+ * @param size the number of candidates
+ * @return Py_ssize_t the number of words
+ */
+static inline Py_ssize_t
+QBAFBitset_Words(Py_ssize_t size)
+{
+    return size > 0 ? (size + QBAF_BITSET_WORD_BITS - 1) / QBAF_BITSET_WORD_BITS : 1;
+}
+
+/**
+ * @brief Return 1 if the candidate with index index is contained in the bitset set, 0 if not.
+ *
+ * @param set an array of QBAFBitsetWord
+ * @param index the index of a candidate
+ * @return int 1 if it is contained, 0 if not
+ */
+static inline int
+QBAFBitset_Contains(const QBAFBitsetWord *set, Py_ssize_t index)
+{
+    return (set[index / QBAF_BITSET_WORD_BITS] >> (index % QBAF_BITSET_WORD_BITS)) & 1;
+}
+
+/**
+ * @brief Add the candidate with index index to the bitset set.
+ *
+ * @param set an array of QBAFBitsetWord
+ * @param index the index of a candidate
+ */
+static inline void
+QBAFBitset_Add(QBAFBitsetWord *set, Py_ssize_t index)
+{
+    set[index / QBAF_BITSET_WORD_BITS] |= (QBAFBitsetWord) 1 << (index % QBAF_BITSET_WORD_BITS);
+}
+
+/**
+ * @brief A node of a QBAFSetTrie. The children of a node are linked through sibling in ascending order of bit.
+ *
+ */
+typedef struct {
+    int         bit;            /* index of the candidate added by this node (-1 in the root) */
+    int         terminal;       /* 1 if the path from the root to this node is a stored set, 0 if not */
+    Py_ssize_t  child;          /* index of the first child, -1 if none */
+    Py_ssize_t  sibling;        /* index of the next sibling, -1 if none */
+} QBAFSetTrieNode;
+
+/**
+ * @brief Set-trie of bitsets: every stored set is a path from the root following its candidates in ascending order.
+ * It answers whether a stored set is a subset of a given set visiting only the paths contained in that set.
+ *
+ */
+typedef struct {
+    QBAFSetTrieNode *nodes;     /* the nodes, nodes[0] is the root */
+    Py_ssize_t       size;      /* number of nodes */
+    Py_ssize_t       capacity;  /* allocated size of nodes */
+    Py_ssize_t       count;     /* number of stored sets */
+    Py_ssize_t       words;     /* number of words of the sets */
+} QBAFSetTrie;
+
+/**
+ * @brief Initialize the empty QBAFSetTrie trie of bitsets of words words.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ *
+ * @param trie a QBAFSetTrie
+ * @param words the number of words of the sets
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFSetTrie_Init(QBAFSetTrie *trie, Py_ssize_t words);
+
+/**
+ * @brief Free the memory of the QBAFSetTrie trie.
+ *
+ * @param trie a QBAFSetTrie
+ */
+void QBAFSetTrie_Free(QBAFSetTrie *trie);
+
+/**
+ * @brief Store the bitset set in the QBAFSetTrie trie.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ *
+ * @param trie a QBAFSetTrie
+ * @param set an array of trie->words QBAFBitsetWord
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFSetTrie_Insert(QBAFSetTrie *trie, const QBAFBitsetWord *set);
+
+/**
+ * @brief Return 1 if a set stored in the QBAFSetTrie trie is a subset of the bitset set, 0 if not.
+ *
+ * @param trie a QBAFSetTrie
+ * @param set an array of trie->words QBAFBitsetWord
+ * @return int 1 if a stored set is a subset of set, 0 if not
+ */
+int QBAFSetTrie_ContainsSubsetOf(const QBAFSetTrie *trie, const QBAFBitsetWord *set);
+
+/**
+ * @brief Struct that enumerates the non-empty subsets of size candidates by size (in lexicographic order
+ * of their indices within each size), skipping the supersets of the subsets that have been accepted
+ * (minimality pruning) and the subsets that do not intersect every required mask. When a prefix of the indices
+ * already contains an accepted subset, or cannot be extended to intersect every mask, none of the subsets
+ * that extend it are visited.
+ *
+ */
+typedef struct {
+    int             size;           /* number of candidates */
+    int             cardinality;    /* number of candidates of current */
+    int             depth;          /* last position of indices that has been set */
+    Py_ssize_t      words;          /* number of words of every bitset (QBAFBitset_Words of size) */
+    int            *indices;        /* indices of the candidates of current, ascending (size of them) */
+    QBAFBitsetWord *prefixes;       /* the words from i * words are the bitset of indices[0..i] */
+    Py_ssize_t      depths;         /* number of bitsets allocated in prefixes (at least cardinality) */
+    QBAFBitsetWord *reach;          /* workspace: a prefix and every greater index */
+    QBAFBitsetWord *current;        /* the last subset enumerated (QBAFSubsets_Next or QBAFSubsets_NextOfSize),
+                                       empty before the first one */
+    QBAFSetTrie     accepted;       /* the accepted subsets */
+    const QBAFBitsetWord *masks;    /* every enumerated subset intersects each of them: the words from i * words
+                                       are the mask i (borrowed) */
+    Py_ssize_t      count;          /* number of masks */
+} QBAFSubsets;
+
+/**
+ * @brief Initialize the QBAFSubsets subsets to enumerate the subsets of size candidates
+ * that have a non-empty intersection with every bitset of masks. The masks must outlive subsets.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred
+ * (OverflowError if size does not fit in an int).
+ *
+ * @param subsets a QBAFSubsets
+ * @param size the number of candidates
+ * @param masks an array of count bitsets of QBAFBitset_Words(size) words each (it can be NULL if count is 0)
+ * @param count the number of masks
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFSubsets_Init(QBAFSubsets *subsets, Py_ssize_t size, const QBAFBitsetWord *masks, Py_ssize_t count);
+
+/**
+ * @brief Free the memory of the QBAFSubsets subsets.
+ *
+ * @param subsets a QBAFSubsets
+ */
+void QBAFSubsets_Free(QBAFSubsets *subsets);
+
+/**
+ * @brief Advance the QBAFSubsets subsets to the next subset that does not contain an accepted subset
+ * and intersects every mask, and store it in subsets->current. Return 1 if there is a next subset, 0 if all of them have been enumerated,
+ * -1 (with the corresponding exception) if there is no memory left.
+ *
+ * @param subsets a QBAFSubsets
+ * @return int 1 if there is a next subset, 0 if not, -1 if an error occurred
+ */
+int QBAFSubsets_Next(QBAFSubsets *subsets);
+
+/**
+ * @brief Like QBAFSubsets_Next, but it does not advance to a greater size: return 0 (and leave subsets
+ * ready to continue with the next size) if the subsets of the size of subsets->current have been enumerated
+ (it never fails).
+ * The subsets of the same size cannot contain each other, so they can be checked in a batch
+ * and accepted afterwards without enumerating any superset of them.
+ *
+ * @param subsets a QBAFSubsets that has enumerated at least one subset
+ * @return int 1 if there is a next subset of the same size, 0 if not
+ */
+int QBAFSubsets_NextOfSize(QBAFSubsets *subsets);
+
+/**
+ * @brief Accept the subset set enumerated by the QBAFSubsets subsets, so none of its supersets is enumerated.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ *
+ * @param subsets a QBAFSubsets
+ * @param set a bitset enumerated by subsets
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFSubsets_Accept(QBAFSubsets *subsets, const QBAFBitsetWord *set);
+
+/**
+ * @brief Return 1 if the bitset set has a non-empty intersection with every bitset of masks, 0 if not.
+ *
+ * @param set an array of words QBAFBitsetWord
+ * @param masks an array of count bitsets of words words each
+ * @param count the number of masks
+ * @param words the number of words of every bitset
+ * @return int 1 if set intersects every mask, 0 if not
+ */
+static inline int
+QBAFBitset_IntersectsAll(const QBAFBitsetWord *set, const QBAFBitsetWord *masks, Py_ssize_t count, Py_ssize_t words)
+{
+    for (Py_ssize_t i = 0; i < count; i++) {
+        const QBAFBitsetWord *mask = masks + i * words;
+        Py_ssize_t word = 0;
+        while (word < words && (set[word] & mask[word]) == 0)
+            word++;
+        if (word == words)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Return a new PySet with the candidates of the bitset set, NULL if an error has occurred.
+ *
+ * @param set an array of QBAFBitset_Words(PyList_GET_SIZE(candidates)) QBAFBitsetWord
+ * @param candidates a PyList with the candidates (the index of a candidate is its position)
+ * @return PyObject* a new PySet, NULL if an error occurred
+ */
+PyObject *QBAFBitset_ToSet(const QBAFBitsetWord *set, PyObject *candidates);
+
+/**
+ * @brief Add to the bitset result the candidates contained in the iterable set.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred
+ * (also if an element of set is not a candidate).
+ *
+ * @param set an iterable of candidates
+ * @param indices a PyDict of (candidate, index: PyLong)
+ * @param result an array of QBAFBitsetWord (as many as QBAFBitset_Words of the number of candidates)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFBitset_FromSet(PyObject *set, PyObject *indices, QBAFBitsetWord *result);
+
+/**
+ * @brief Return a new PyDict of (candidate, index: PyLong) with the position of every candidate of the PyList candidates,
+ * NULL if an error has occurred.
+ *
+ * @param candidates a PyList of distinct candidates
+ * @return PyObject* a new PyDict, NULL if an error occurred
+ */
+PyObject *QBAFBitset_Indices(PyObject *candidates);
+
+#endif
@@ -9,6 +9,7 @@
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <stdint.h>
 
 #include "qbaf_module.h"
 
@@ -19,18 +20,127 @@
  */
 // PyTypeObject *get_QBAFARelationsType(void);
 
+/**
+ * @brief Vector of argument ids (the agents or the patients of an argument).
+ * 
+ */
+typedef struct {
+    int32_t    *ids;        /* ids of the arguments, in the order they were added */
+    int32_t     size;       /* number of ids */
+    int32_t     capacity;   /* number of allocated ids */
+} QBAFIdVector;
+
 /**
  * @brief Struct that defines the Object Type ARelations in a QBAF.
+ * Every argument is interned into a symbol table and identified by its id. The Attack and the Support
+ * relations of a QBAFramework share their symbol table, which keeps its arguments until the framework
+ * removes them (QBAFARelations_Release); the instances that can be modified from python have their own
+ * symbol table, which drops the arguments that are no longer part of any relation. The ids of the released
+ * arguments are reused. The relations are stored as vectors of ids (the patients and the agents
+ * of every argument) and as a hash set of pairs of ids, so the Python objects (tuples, sets)
+ * are only created when they are requested.
  * 
  */
 typedef struct {
     PyObject_HEAD
-    PyObject *relations;        /* set of tuples (Agent: QBAFArgument, Patient: QBAFArgument) */
-    PyObject *agent_patients;   /* dictonary of (key, value) = (Agent, set of Patients) */
-    PyObject *patient_agents;   /* dictonary of (key, value) = (Patient, set of Agents) */
+    PyObject     *symbols;      /* dictionary of (key, value) = (QBAFArgument, id: PyLong), it may be shared */
+    PyObject     *arguments;    /* PyList of QBAFArgument (None if released), the position of every argument
+                                   is its id (shared like symbols) */
+    PyObject     *released;     /* PyList of the ids (PyLong) of the released arguments, reused by
+                                   QBAFARelations_Intern (shared like symbols) */
+    QBAFIdVector *patients;     /* patients[id] are the patients of the argument id (only if id < capacity) */
+    QBAFIdVector *agents;       /* agents[id] are the agents of the argument id (only if id < capacity) */
+    Py_ssize_t    capacity;     /* number of allocated vectors in patients and agents */
+    uint64_t     *table;        /* open addressing hash set of the relations (agent id << 32 | patient id) */
+    Py_ssize_t    table_size;   /* number of slots of table (0 or a power of 2) */
+    Py_ssize_t    size;         /* number of relations */
     int modifiable;             /* 1 if this object can be modified through python, 0 otherwise */
 } QBAFARelationsObject;
 
+/**
+ * @brief Return the vector with the agents of the argument with id id in the QBAFARelations self.
+ * The id must be obtained from QBAFARelations_IdOf.
+ * 
+ */
+#define QBAFARelations_AgentIds(self, id) \
+    ((id) < (self)->capacity ? &(self)->agents[id] : &QBAFIdVector_Empty)
+
+/**
+ * @brief Return the vector with the patients of the argument with id id in the QBAFARelations self.
+ * The id must be obtained from QBAFARelations_IdOf.
+ * 
+ */
+#define QBAFARelations_PatientIds(self, id) \
+    ((id) < (self)->capacity ? &(self)->patients[id] : &QBAFIdVector_Empty)
+
+/**
+ * @brief Return the argument (borrowed reference) with id id in the QBAFARelations self.
+ * 
+ */
+#define QBAFARelations_ArgumentOf(self, id) PyList_GET_ITEM((self)->arguments, id)
+
+/**
+ * @brief A vector without ids.
+ * 
+ */
+extern const QBAFIdVector QBAFIdVector_Empty;
+
+/**
+ * @brief Return the id of the argument in the symbol table of the QBAFARelations self,
+ * -1 if it has not been interned (it has never been part of a relation), and -2 if an error has occurred.
+ * 
+ * @param self an instance of QBAFARelations
+ * @param argument a QBAFArgument
+ * @return Py_ssize_t the id, -1 if not interned, -2 if an error occurred
+ */
+Py_ssize_t QBAFARelations_IdOf(QBAFARelationsObject *self, PyObject *argument);
+
+/**
+ * @brief Return the id of the argument in the symbol table of the QBAFARelations self, adding it if it has not been interned yet.
+ * The id of the last released argument is reused if there is one. Otherwise the ids are assigned consecutively from 0.
+ * Return -1 (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self an instance of QBAFARelations
+ * @param argument a QBAFArgument
+ * @return Py_ssize_t the id, -1 if an error occurred
+ */
+Py_ssize_t QBAFARelations_Intern(QBAFARelationsObject *self, PyObject *argument);
+
+/**
+ * @brief Drop the argument from the symbol table of the QBAFARelations self (and of the instances that share it),
+ * so that interning an equal argument later stores the new object, and its id can be reused. It does nothing if it is not interned.
+ * The argument must not be part of any relation of the instances that share the symbol table.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self an instance of QBAFARelations
+ * @param argument a QBAFArgument
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFARelations_Release(QBAFARelationsObject *self, PyObject *argument);
+
+/**
+ * @brief Add the relation between the interned arguments with ids agent and patient to the QBAFARelations self.
+ * It does nothing if it is contained. Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ * 
+ * @param self an instance of QBAFARelations
+ * @param agent the id of the agent
+ * @param patient the id of the patient
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFARelations_AddIds(QBAFARelationsObject *self, Py_ssize_t agent, Py_ssize_t patient);
+
+/**
+ * @brief Reserve memory in the QBAFARelations self for the vectors of the ids lower than arguments
+ * and for a total of relations relations, so that adding them does not reallocate.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ * 
+ * @param self an instance of QBAFARelations
+ * @param arguments the number of ids
+ * @param relations the number of relations
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFARelations_Reserve(QBAFARelationsObject *self, Py_ssize_t arguments, Py_ssize_t relations);
+
 /**
  * @brief Create a new object QBAFARelations. It cannot be modified from python.
  * 
@@ -39,6 +149,15 @@ typedef struct {
  */
 PyObject *QBAFARelations_Create(PyObject *relations);
 
+/**
+ * @brief Create a new object QBAFARelations that shares the symbol table of other. It cannot be modified from python.
+ * 
+ * @param relations a set/list of tuples (Agent: QBAFArgument, Patient QBAFArgument), or NULL
+ * @param other an instance of QBAFARelations
+ * @return PyObject* New reference
+ */
+PyObject *QBAFARelations_CreateWithSymbols(PyObject *relations, QBAFARelationsObject *other);
+
 /**
  * @brief Return a copy of this instance.
  * New references are created for the copy, except for the QBAFArgument objects.
@@ -49,6 +168,17 @@ PyObject *QBAFARelations_Create(PyObject *relations);
  */
 PyObject *QBAFARelations_copy(QBAFARelationsObject *self, PyObject *Py_UNUSED(ignored));
 
+/**
+ * @brief Return a copy of self that cannot be modified from python, with the symbol table of other
+ * (which must give the arguments of self the same ids, e.g. a copy of the symbol table of self),
+ * or with its own copy of the symbol table of self if other is NULL.
+ * 
+ * @param self instance of QBAFARelations
+ * @param other instance of QBAFARelations, or NULL
+ * @return PyObject* new instance of QBAFARelations, NULL if an error occurred
+ */
+PyObject *QBAFARelations_CopyWithSymbols(QBAFARelationsObject *self, QBAFARelationsObject *other);
+
 /**
  * @brief Return 1 if their relations are disjoint, 0 if they are not, and -1 if an error is encountered.
  * 
@@ -128,6 +258,53 @@ PyObject *_QBAFARelations_patients(QBAFARelationsObject *self, PyObject *agent);
  */
 PyObject *_QBAFARelations_agents(QBAFARelationsObject *self, PyObject *patient);
 
+/**
+ * @brief Borrowed view of the patients (or the agents) of an argument in a QBAFARelations.
+ * It walks the vector of ids of the argument without allocating any object, and the
+ * QBAFArgument objects it returns are borrowed from the symbol table of the relations
+ * (they stay alive as long as the relations are not modified).
+ * The relations must not be modified while the view is used.
+ * 
+ */
+typedef struct {
+    QBAFARelationsObject *relations;    /* the relations that are walked (borrowed reference) */
+    Py_ssize_t            id;           /* id of the argument, -1 if it is not part of any relation */
+    int                   patients;     /* 1 if the patients are walked, 0 if the agents are walked */
+    int32_t               position;     /* position of the next id in the vector */
+} QBAFANeighbours;
+
+/**
+ * @brief Initialize the QBAFANeighbours view with the patients (if patients is 1) or the agents (if patients is 0)
+ * of the argument in the QBAFARelations relations.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ * 
+ * @param view the QBAFANeighbours to initialize
+ * @param relations an instance of QBAFARelations
+ * @param argument a QBAFArgument
+ * @param patients 1 to walk the patients of argument, 0 to walk its agents
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int QBAFANeighbours_Init(QBAFANeighbours *view, QBAFARelationsObject *relations, PyObject *argument, int patients);
+
+/**
+ * @brief Return the next argument (borrowed reference) of the QBAFANeighbours view, NULL if there are no more.
+ * It never sets an exception.
+ * 
+ * @param view an initialized QBAFANeighbours
+ * @return PyObject* a borrowed QBAFArgument, NULL if the view is exhausted
+ */
+static inline PyObject *
+QBAFANeighbours_Next(QBAFANeighbours *view)
+{
+    if (view->id < 0)
+        return NULL;
+    const QBAFIdVector *vector = view->patients ? QBAFARelations_PatientIds(view->relations, view->id)
+                                                : QBAFARelations_AgentIds(view->relations, view->id);
+    if (view->position >= vector->size)
+        return NULL;
+    return QBAFARelations_ArgumentOf(view->relations, vector->ids[view->position++]);
+}
+
 /**
  * @brief Remove all relations that contain any QBAFArgument of the the iterable.
  * Return -1 if an error has occurred, with its corresponding exception.
@@ -144,7 +321,7 @@ int _QBAFARelations_remove_arguments(QBAFARelationsObject *self, PyObject *itera
  * 
  * @param self instance of QBAFARelations
  * @param agent instance of QBAFArgument
- * @return PyObject* borrowed PySet of QBAFArgument, NULL if an error occurred
+ * @return PyObject* new PySet of QBAFArgument, NULL if an error occurred
  */
 PyObject * _QBAFARelations_patients_set(QBAFARelationsObject *self, PyObject *agent);
 
@@ -9,6 +9,9 @@ def determine_gradient_ctrb(topic, contributors, qbaf, epsilon=1.490116119384765
         contributors (string or set): The contributing argument(s)
         qbaf (QBAFramework): The QBAF that contains topic and contributor
         epsilon (float): Epsilon used by the approximator. Defaults to 1.4901161193847656e-08.
+            It only applies to QBAFs with Python semantics (custom aggregation and influence functions)
+            or that are not acyclic. Otherwise the exact derivatives are calculated (QBAFramework.gradient),
+            and the contribution of each of several tied strongest agents of 'top' is 0.
         aggregation_fn (function): Function to aggregate gradient contributions. Defaults to max.
 
     Returns:
@@ -18,7 +21,31 @@ def determine_gradient_ctrb(topic, contributors, qbaf, epsilon=1.490116119384765
         contributors = {contributors}
     if not all(item in qbaf.arguments for item in [topic, *contributors]):
             raise Exception ('Topic and contributor must be in the QBAF.')
+
+    if qbaf.semantics is not None and qbaf.isacyclic():
+        # Exact derivatives of all the contributors with a single backward pass
+        gradient = qbaf.gradient(topic)
+        return aggregation_fn([gradient[contributor] for contributor in contributors])
     
+    if qbaf.isacyclic():
+        # Evaluate the unperturbed and every perturbed vector of initial strengths in a single batch,
+        # reusing the compiled topology instead of building a new framework
+        argument_index = qbaf.argument_index
+        base = [qbaf.initial_strength(arg) for arg in qbaf.indexed_arguments]
+        rows, steps = [base], []
+        for contributor in contributors:
+            contributor_index = argument_index[contributor]
+            step = epsilon if base[contributor_index] + epsilon <= qbaf.max_strength else -epsilon
+            row = list(base)
+            row[contributor_index] += step
+            rows.append(row)
+            steps.append(step)
+        final_strengths = qbaf.evaluate_batch(rows)
+        topic_index = argument_index[topic]
+        strength_base = final_strengths[0, topic_index]
+        return aggregation_fn([(final_strengths[row + 1, topic_index] - strength_base) / step
+                               for row, step in enumerate(steps)])
+
     def func(contributor, contributor_strength, qbaf):
         initial_strengths = []
         argument_list = list(qbaf.arguments)
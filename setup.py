@@ -8,6 +8,11 @@ def main():
     module_folder = "src"
     # Files in module folder
     source_files = [os.path.join(module_folder, file) for file in os.listdir(module_folder)]
+    # POSIX threads are used to calculate final strengths in parallel
+    thread_args = [] if os.name == 'nt' else ['-pthread']
+    # Floating-point contraction (FMA) is disabled so that the vectorized influence functions
+    # compute exactly the same results as the scalar ones
+    compile_args = [] if os.name == 'nt' else ['-ffp-contract=off']
 
     setup(
         name='QBAF-Py',
@@ -18,7 +23,9 @@ def main():
         packages=['qbaf_visualizer', 'qbaf_ctrbs'],
         ext_modules=[Extension('qbaf', 
                         include_dirs = [include_folder],
-                        sources = source_files)],
+                        sources = source_files,
+                        extra_compile_args = thread_args + compile_args,
+                        extra_link_args = thread_args)],
         extras_require={
             'dev': [
                 'pytest'
@@ -10,57 +10,81 @@
 
 #include "argument.h"
 
+#define QBAF_ARGUMENT_MAXFREELIST 1024  /* maximum number of QBAFArgument objects kept for reuse */
+
 /**
  * @brief Struct that defines the Object Type Argument in a QBAF.
+ * The name and the description are str, so an argument cannot be part of a reference cycle
+ * and it is not tracked by the garbage collector.
  * 
  */
 typedef struct {
     PyObject_HEAD
-    PyObject *name;         /* name of the argument and identifier */
+    PyObject *name;         /* name of the argument and identifier (interned if it is an exact str) */
     PyObject *description;  /* description of the argument */
+    Py_hash_t hash;         /* hash of name, -1 if it has not been computed yet */
 } QBAFArgumentObject;
 
 /**
- * @brief This function is used by the garbage collector to detect reference cycles.
+ * @brief Free list of deallocated QBAFArgument objects (of the exact type), linked through their name.
  * 
- * @param self a object of type QBAFArgument
- * @param visit 
- * @param arg 
- * @return int 0 if the function was successful. Otherwise, -1.
  */
-static int
-QBAFArgument_traverse(QBAFArgumentObject *self, visitproc visit, void *arg)
-{
-    Py_VISIT(self->name);
-    Py_VISIT(self->description);
-    return 0;
-}
+static QBAFArgumentObject *free_list = NULL;
+static int numfree = 0;
 
 /**
- * @brief Drop the instance’s references to those of its members that may be Python objects, and set its pointers to those members to NULL.
+ * @brief Destructor function that is called to free memory of a object that will no longer be used.
+ * Objects of the exact type QBAFArgument are kept in the free list while it is not full.
  * 
  * @param self a object of type QBAFArgument
- * @return int 0 if the function was successful. Otherwise, -1.
  */
-static int
-QBAFArgument_clear(QBAFArgumentObject *self)
+static void
+QBAFArgument_dealloc(QBAFArgumentObject *self)
 {
     Py_CLEAR(self->name);
     Py_CLEAR(self->description);
-    return 0;
+    if (Py_TYPE(self) == get_QBAFArgumentType() && numfree < QBAF_ARGUMENT_MAXFREELIST) {
+        self->name = (PyObject *) free_list;
+        free_list = self;
+        numfree++;
+        return;
+    }
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+void
+QBAFArgument_ClearFreeList(void)
+{
+    while (free_list != NULL) {
+        QBAFArgumentObject *self = free_list;
+        free_list = (QBAFArgumentObject *) self->name;
+        numfree--;
+        get_QBAFArgumentType()->tp_free((PyObject *) self);
+    }
 }
 
 /**
- * @brief Destructor function that is called to free memory of a object that will no longer be used.
+ * @brief Set the name of a QBAFArgument, interning it so that equal names share one object,
+ * and cache its hash.
  * 
- * @param self a object of type QBAFArgument
+ * @param self the QBAFArgument object
+ * @param name a new reference to a str (stolen)
+ * @return int 0 if it was executed with no errors. Otherwise, -1.
  */
-static void
-QBAFArgument_dealloc(QBAFArgumentObject *self)
+static int
+QBAFArgument_setname(QBAFArgumentObject *self, PyObject *name)
 {
-    PyObject_GC_UnTrack(self);
-    QBAFArgument_clear(self);
-    Py_TYPE(self)->tp_free((PyObject *) self);
+    if (PyUnicode_CheckExact(name)) {
+        PyUnicode_InternInPlace(&name);
+    }
+    Py_hash_t hash = PyObject_Hash(name);
+    if (hash == -1) {
+        Py_DECREF(name);
+        return -1;
+    }
+    Py_XSETREF(self->name, name);
+    self->hash = hash;
+    return 0;
 }
 
 /**
@@ -75,10 +99,19 @@ static PyObject *
 QBAFArgument_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     QBAFArgumentObject *self;
-    self = (QBAFArgumentObject *) type->tp_alloc(type, 0);
+    if (free_list != NULL && type == get_QBAFArgumentType()) {
+        self = free_list;
+        free_list = (QBAFArgumentObject *) self->name;
+        numfree--;
+        self->name = NULL;
+        PyObject_Init((PyObject *) self, type);
+    }
+    else {
+        self = (QBAFArgumentObject *) type->tp_alloc(type, 0);
+    }
     if (self != NULL) {
-        self->name = PyUnicode_FromString("");
-        if (self->name == NULL) {
+        self->hash = -1;
+        if (QBAFArgument_setname(self, PyUnicode_FromString("")) < 0) {
             Py_DECREF(self);
             return NULL;
         }
@@ -109,10 +142,10 @@ QBAFArgument_init(QBAFArgumentObject *self, PyObject *args, PyObject *kwds)
                                      &name, &description))
         return -1;
 
-    tmp = self->name;
     Py_INCREF(name);
-    self->name = name;
-    Py_DECREF(tmp);
+    if (QBAFArgument_setname(self, name) < 0) {
+        return -1;
+    }
 
     if (description) {
         tmp = self->description;
@@ -196,11 +229,24 @@ QBAFArgument_richcompare(QBAFArgumentObject *self, PyObject *other, int op)
         PyErr_SetString(PyExc_TypeError, "Compare instance of 'QBAFArgument' with instance of a different type not supported");
         return NULL;
     }
-    return PyObject_RichCompare(self->name, ((QBAFArgumentObject *)other)->name, op);
+
+    // Equality is decided without comparing the names if they are the same object, their hashes differ,
+    // or both are interned (equal interned names are the same object)
+    PyObject *name = self->name, *other_name = ((QBAFArgumentObject *)other)->name;
+    if (op == Py_EQ || op == Py_NE) {
+        if (name == other_name) {
+            return PyBool_FromLong(op == Py_EQ);
+        }
+        if (self->hash != ((QBAFArgumentObject *)other)->hash ||
+            (PyUnicode_CHECK_INTERNED(name) && PyUnicode_CHECK_INTERNED(other_name))) {
+            return PyBool_FromLong(op == Py_NE);
+        }
+    }
+    return PyObject_RichCompare(name, other_name, op);
 }
 
 /**
- * @brief Return the hash of the name of a QBAFArgument instance.
+ * @brief Return the hash of the name of a QBAFArgument instance (cached when the name is set).
  * 
  * @param self the QBAFArgument object
  * @return PyObject* a object with the hash
@@ -208,7 +254,7 @@ QBAFArgument_richcompare(QBAFArgumentObject *self, PyObject *other, int op)
 static Py_hash_t
 QBAFArgument_hashfunc(QBAFArgumentObject *self)
 {
-    return PyObject_Hash(self->name);
+    return self->hash;
 }
 
 /**
@@ -237,6 +283,19 @@ QBAFArgument_repr(QBAFArgumentObject *self, PyObject *Py_UNUSED(ignored))
     return PyUnicode_FromFormat("'%S'", self->name);
 }
 
+/**
+ * @brief Return the tuple (type(self), (name, description)) used by pickle.
+ * 
+ * @param self the QBAFArgument object
+ * @param Py_UNUSED 
+ * @return PyObject* new PyTuple, NULL if an error occurred
+ */
+static PyObject *
+QBAFArgument_reduce(QBAFArgumentObject *self, PyObject *Py_UNUSED(ignored))
+{
+    return Py_BuildValue("(O(OO))", (PyObject *) Py_TYPE(self), self->name, self->description);
+}
+
 /**
  * @brief A list with the attributes of the class QBAFArgument
  * 
@@ -272,11 +331,21 @@ static PyGetSetDef QBAFArgument_getsetters[] = {
     {NULL}  /* Sentinel */
 };
 
+PyDoc_STRVAR(__reduce___doc,
+"__reduce__(self, /)\n"
+"--\n"
+"\n"
+"Helper for pickle.\n"
+);
+
 /**
  * @brief List of functions of the class QBAFArgument
  * 
  */
 static PyMethodDef QBAFArgument_methods[] = {
+    {"__reduce__", (PyCFunction) QBAFArgument_reduce, METH_NOARGS,
+    __reduce___doc
+    },
     {NULL}  /* Sentinel */
 };
 
@@ -301,12 +370,10 @@ static PyTypeObject QBAFArgumentType = {
     .tp_doc = QBAFArgument_doc,
     .tp_basicsize = sizeof(QBAFArgumentObject),
     .tp_itemsize = 0,
-    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
     .tp_new = QBAFArgument_new,
     .tp_init = (initproc) QBAFArgument_init,
     .tp_dealloc = (destructor) QBAFArgument_dealloc,
-    .tp_traverse = (traverseproc) QBAFArgument_traverse,
-    .tp_clear = (inquiry) QBAFArgument_clear,
     .tp_members = QBAFArgument_members,
     .tp_methods = QBAFArgument_methods,
     .tp_getset = QBAFArgument_getsetters,
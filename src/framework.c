@@ -8,12 +8,23 @@
 #include <Python.h>
 #include "structmember.h"
 #include <float.h>
+#include <limits.h>
+#include <math.h>
 #include <string.h>
+#include <time.h>
 
 #include "framework.h"
 #include "relations.h"
 #include "qbaf_utils.h"
 #include "qbaf_functions.h"
+#include "qbaf_graph.h"
+#include "qbaf_parallel.h"
+#include "qbaf_gradient.h"
+#include "qbaf_order.h"
+#include "qbaf_file.h"
+#include "qbaf_loader.h"
+#include "qbaf_subsets.h"
+#include "qbaf_overlay.h"
 
 #ifndef stricmp
 #include <ctype.h>
@@ -42,6 +53,16 @@ static const char *STR_EULERBASEDTOP_MODEL = "EulerBasedTop_model";
 static const char *STR_EULERBASED_MODEL = "EulerBased_model";
 static const char *STR_DFQUAD_MODEL = "DFQuAD_model";
 
+static const char *STR_JACOBI = "jacobi";
+static const char *STR_GAUSS_SEIDEL = "gauss_seidel";
+static const char *STR_EULER = "euler";
+static const char *STR_RK4 = "rk4";
+
+#define DEFAULT_TOLERANCE 1e-10
+#define DEFAULT_MAX_ITERATIONS 10000
+#define DEFAULT_DAMPING 1.0
+#define DEFAULT_STEP_SIZE 0.1
+
 /**
  * @brief Struct that defines the Object Type Framework in a QBAF.
  * 
@@ -52,18 +73,43 @@ typedef struct {
     PyObject *initial_strengths;      /* a dictionary (argument: QBAFArgument, initial_strength: double) */
     PyObject *attack_relations;     /* an instance of QBAFARelations */
     PyObject *support_relations;    /* an instance of QBAFARelations */
-    PyObject *final_strengths;        /* a dictionary (argument: QBAFArgument, final_strength: double) */
-    int       modified;             /* 0 if the framework has not been modified after calculating the final strengths. Otherwise, 1 */
+    QBAFGraph *graph;               /* compiled snapshot holding the final strengths, NULL if not calculated yet */
+    QBAFOrder *order;               /* topological order maintained while relations are added, NULL if not maintained */
+    int       modified;             /* 0 if the framework has not been modified after compiling the graph. Otherwise, 1 */
     int       disjoint_relations;   /* 1 if the attack/support relations must be disjoint, 0 if they do not have to */
+    int       threads;              /* number of threads used to calculate the final strengths with built-in semantics */
+    int       busy;                 /* number of evaluations of graph running (in other threads without the GIL,
+                                       or calling Python semantics that may modify the framework) */
+    int       fast_math;            /* 1 if built-in semantics may use the vectorized approximation of exp, 0 if not */
     char     *semantics;            /* name of the semantic model */
     double  (*influence_function)(double, double);   /* influence function that is going to be used to calcualte the final strengths */
     double  (*aggregation_function)(PyObject*, PyObject*); /* aggregation function that is going to be used to calcualte the final strengths */
+    QBAFArrayAggregation aggregation_array_function;       /* aggregation_function over arrays of strengths, NULL if custom */
     double    min_strength;           /* min value for the initial strengths */
     double    max_strength;           /* max value for the initial strengths */
     PyObject *influence_function_callable;   /* influence function given from python */
     PyObject *aggregation_function_callable; /* aggregation function given from python */
 } QBAFrameworkObject;
 
+/**
+ * @brief Check that the compiled graph of the Framework is not being evaluated by another thread
+ * (the GIL is released during a parallel evaluation) or by the Python semantics that are being called,
+ * so it can be read, modified or replaced.
+ * Return 0 if it is idle, -1 (with a RuntimeError) if it is busy.
+ * 
+ * @param self the QBAFramework
+ * @return int 0 if idle, -1 if busy
+ */
+static inline int
+_QBAFramework_check_idle(QBAFrameworkObject *self)
+{
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "the framework is being evaluated");
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * @brief This function is used by the garbage collector to detect reference cycles.
  * 
@@ -79,7 +125,10 @@ QBAFramework_traverse(QBAFrameworkObject *self, visitproc visit, void *arg)
     Py_VISIT(self->initial_strengths);
     Py_VISIT(self->attack_relations);
     Py_VISIT(self->support_relations);
-    Py_VISIT(self->final_strengths);
+    if (self->graph != NULL) {
+        Py_VISIT(self->graph->arguments);
+        Py_VISIT(self->graph->indices);
+    }
     Py_VISIT(self->influence_function_callable);
     Py_VISIT(self->aggregation_function_callable);
     return 0;
@@ -98,7 +147,10 @@ QBAFramework_clear(QBAFrameworkObject *self)
     Py_CLEAR(self->initial_strengths);
     Py_CLEAR(self->attack_relations);
     Py_CLEAR(self->support_relations);
-    Py_CLEAR(self->final_strengths);
+    QBAFGraph_Free(self->graph);
+    self->graph = NULL;
+    QBAFOrder_Free(self->order);
+    self->order = NULL;
     Py_CLEAR(self->influence_function_callable);
     Py_CLEAR(self->aggregation_function_callable);
     return 0;
@@ -139,13 +191,17 @@ QBAFramework_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->attack_relations = Py_None;
         Py_INCREF(Py_None);
         self->support_relations = Py_None;
-        Py_INCREF(Py_None);
-        self->final_strengths = Py_None;
+        self->graph = NULL;
+        self->order = NULL;
         self->modified = TRUE;
         self->disjoint_relations = TRUE;
+        self->threads = 1;
+        self->busy = 0;
+        self->fast_math = FALSE;
         self->semantics = STR_BASIC_MODEL;
         self->influence_function = simple_influence;
         self->aggregation_function = sum;
+        self->aggregation_array_function = sum_array;
         self->min_strength = -DBL_MAX;
         self->max_strength = DBL_MAX;
         self->influence_function_callable = NULL;
@@ -299,6 +355,25 @@ strength_in_minmax(PyObject *pyfloat, double min, double max)
     return TRUE;
 }
 
+/**
+ * @brief Set a ValueError saying that name must be within the range (min_strength, max_strength) of the Framework self.
+ * The limits are formatted with repr, so the message is bounded for any double (e.g. the default -DBL_MAX and DBL_MAX).
+ * 
+ * @param self a QBAFramework
+ * @param name the name of the value out of range
+ */
+static void
+_QBAFramework_range_error(QBAFrameworkObject *self, const char *name)
+{
+    PyObject *min = PyFloat_FromDouble(self->min_strength);
+    PyObject *max = PyFloat_FromDouble(self->max_strength);
+    if (min != NULL && max != NULL) {
+        PyErr_Format(PyExc_ValueError, "%s must be within range (%R, %R)", name, min, max);
+    }
+    Py_XDECREF(min);
+    Py_XDECREF(max);
+}
+
 static inline int
 _QBAFramework_initial_strengths_in_minmax(QBAFrameworkObject *self)
 {
@@ -337,6 +412,137 @@ _QBAFramework_initial_strengths_in_minmax(QBAFrameworkObject *self)
     return TRUE;
 }
 
+/**
+ * @brief Set the semantics (or the aggregation_function and the influence_function) of the Framework
+ * and check that all its initial strengths are within range (min_strength, max_strength).
+ * The initial strengths must have been initialized.
+ * 
+ * @param self an instance of QBAFramework
+ * @param semantics the name of the semantics, or NULL
+ * @param aggregation_function a callable, None or NULL
+ * @param influence_function a callable, None or NULL
+ * @param min_strength the minimum strength
+ * @param max_strength the maximum strength
+ * @return int 0 if it was executed with no errors. Otherwise, -1.
+ */
+static int
+_QBAFramework_init_semantics(QBAFrameworkObject *self, char *semantics,
+                             PyObject *aggregation_function, PyObject *influence_function,
+                             double min_strength, double max_strength)
+{
+    if (semantics == NULL && PyObject_IsNoneOrNULL(aggregation_function) && PyObject_IsNoneOrNULL(influence_function)) {
+        semantics = STR_BASIC_MODEL;
+    }
+
+    if (semantics != NULL && (min_strength != -DBL_MAX || max_strength != DBL_MAX)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "cannot modify min_strength or max_strength without implementing your own aggregation function and influence function");
+        return -1;
+    }
+
+    // Implement aggregation_function, influence_function
+    if (!PyObject_IsNoneOrNULL(aggregation_function) || !PyObject_IsNoneOrNULL(influence_function)) {
+        if (semantics != NULL) {
+            PyErr_SetString(PyExc_ValueError,
+                            "cannot modify the aggregation_function and influence_function of the semantics");
+            return -1;
+        }
+
+        if (!PyCallable_Check(aggregation_function) || !PyCallable_Check(influence_function)) {
+            PyErr_SetString(PyExc_ValueError,
+            "aggregation_function and influence_function must be callable");
+            return -1;
+        }
+
+        self->semantics = NULL;
+        self->influence_function = NULL;
+        self->aggregation_function = NULL;
+        self->aggregation_array_function = NULL;
+
+        Py_XDECREF(self->influence_function_callable);
+        Py_INCREF(influence_function);
+        self->influence_function_callable = influence_function;
+
+        Py_XDECREF(self->aggregation_function_callable);
+        Py_INCREF(aggregation_function);
+        self->aggregation_function_callable = aggregation_function;
+
+        self->min_strength = min_strength;
+        self->max_strength = max_strength;
+
+    }
+
+    // Assign the influence_function and aggregation_function based on the value of semantics
+    if (semantics != NULL) {
+
+        if (streq(semantics, STR_BASIC_MODEL)) {
+            self->semantics = STR_BASIC_MODEL;
+            self->aggregation_function = sum;
+            self->aggregation_array_function = sum_array;
+            self->influence_function = simple_influence;
+            self->min_strength = -DBL_MAX;
+            self->max_strength = DBL_MAX;
+        }
+        else if (streq(semantics, STR_QUADRATICENERGY_MODEL)) {
+            self->semantics = STR_QUADRATICENERGY_MODEL;
+            self->aggregation_function = sum;
+            self->aggregation_array_function = sum_array;
+            self->influence_function = max_2_1; // 2-Max(1)
+            self->min_strength = -DBL_MAX;
+            self->max_strength = DBL_MAX;
+        }
+        else if (streq(semantics, STR_SQUAREDDFQUAD_MODEL)) {
+            self->semantics = STR_SQUAREDDFQUAD_MODEL;
+            self->aggregation_function = product;
+            self->aggregation_array_function = product_array;
+            self->influence_function = max_1_1; // 1-Max(1)
+            self->min_strength = -DBL_MAX;
+            self->max_strength = DBL_MAX;
+        }
+        else if (streq(semantics, STR_EULERBASEDTOP_MODEL)) {
+            self->semantics = STR_EULERBASEDTOP_MODEL;
+            self->aggregation_function = top;
+            self->aggregation_array_function = top_array;
+            self->influence_function = euler_based;
+            self->min_strength = -DBL_MAX;
+            self->max_strength = DBL_MAX;
+        }
+        else if (streq(semantics, STR_EULERBASED_MODEL)) {
+            self->semantics = STR_EULERBASED_MODEL;
+            self->aggregation_function = sum;
+            self->aggregation_array_function = sum_array;
+            self->influence_function = euler_based;
+            self->min_strength = -DBL_MAX;
+            self->max_strength = DBL_MAX;
+        }
+        else if (streq(semantics, STR_DFQUAD_MODEL)) {
+            self->semantics = STR_DFQUAD_MODEL;
+            self->aggregation_function = product;
+            self->aggregation_array_function = product_array;
+            self->influence_function = linear_1; // Linear(1)
+            self->min_strength = -1;
+            self->max_strength = 1;
+        }
+        else {
+            PyErr_SetString(PyExc_ValueError, "incorrect value of semantics");
+            return -1;
+        }
+
+    }
+
+    // Check all the initial strengths are in range (min_strength, max_strength)
+    int initial_strengths_in_minmax = _QBAFramework_initial_strengths_in_minmax(self);
+    if (initial_strengths_in_minmax < 0) {
+        return -1;
+    }
+    if (!initial_strengths_in_minmax) {
+        _QBAFramework_range_error(self, "every initial_strength");
+        return -1;
+    }
+
+    return 0;
+}
+
 /**
  * @brief Initializer of a QBAFramework instance. It is called right after the constructor by the python interpreter.
  * 
@@ -417,7 +623,7 @@ QBAFramework_init(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 
     // Initialize support relations
     tmp = self->support_relations;
-    self->support_relations = QBAFARelations_Create(support_relations);
+    self->support_relations = QBAFARelations_CreateWithSymbols(support_relations, (QBAFARelationsObject*)self->attack_relations);
     if (self->support_relations == NULL) {
         /* propagate error*/
         self->support_relations = tmp;
@@ -460,112 +666,8 @@ QBAFramework_init(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
         }
     }
 
-    if (semantics == NULL && PyObject_IsNoneOrNULL(aggregation_function) && PyObject_IsNoneOrNULL(influence_function)) {
-        semantics = STR_BASIC_MODEL;
-    }
-
-    if (semantics != NULL && (min_strength != -DBL_MAX || max_strength != DBL_MAX)) {
-        PyErr_SetString(PyExc_ValueError,
-                        "cannot modify min_strength or max_strength without implementing your own aggregation function and influence function");
-        return -1;
-    }
-
-    // Implement aggregation_function, influence_function
-    if (!PyObject_IsNoneOrNULL(aggregation_function) || !PyObject_IsNoneOrNULL(influence_function)) {
-        if (semantics != NULL) {
-            PyErr_SetString(PyExc_ValueError,
-                            "cannot modify the aggregation_function and influence_function of the semantics");
-            return -1;
-        }
-
-        if (!PyCallable_Check(aggregation_function) || !PyCallable_Check(influence_function)) {
-            PyErr_SetString(PyExc_ValueError,
-            "aggregation_function and influence_function must be callable");
-            return -1;
-        }
-
-        self->semantics = NULL;
-        self->influence_function = NULL;
-        self->aggregation_function = NULL;
-
-        Py_XDECREF(self->influence_function_callable);
-        Py_INCREF(influence_function);
-        self->influence_function_callable = influence_function;
-
-        Py_XDECREF(self->aggregation_function_callable);
-        Py_INCREF(aggregation_function);
-        self->aggregation_function_callable = aggregation_function;
-
-        self->min_strength = min_strength;
-        self->max_strength = max_strength;
-
-    }
-
-    // Assign the influence_function and aggregation_function based on the value of semantics
-    if (semantics != NULL) {
-
-        if (streq(semantics, STR_BASIC_MODEL)) {
-            self->semantics = STR_BASIC_MODEL;
-            self->aggregation_function = sum;
-            self->influence_function = simple_influence;
-            self->min_strength = -DBL_MAX;
-            self->max_strength = DBL_MAX;
-        }
-        else if (streq(semantics, STR_QUADRATICENERGY_MODEL)) {
-            self->semantics = STR_QUADRATICENERGY_MODEL;
-            self->aggregation_function = sum;
-            self->influence_function = max_2_1; // 2-Max(1)
-            self->min_strength = -DBL_MAX;
-            self->max_strength = DBL_MAX;
-        }
-        else if (streq(semantics, STR_SQUAREDDFQUAD_MODEL)) {
-            self->semantics = STR_SQUAREDDFQUAD_MODEL;
-            self->aggregation_function = product;
-            self->influence_function = max_1_1; // 1-Max(1)
-            self->min_strength = -DBL_MAX;
-            self->max_strength = DBL_MAX;
-        }
-        else if (streq(semantics, STR_EULERBASEDTOP_MODEL)) {
-            self->semantics = STR_EULERBASEDTOP_MODEL;
-            self->aggregation_function = top;
-            self->influence_function = euler_based;
-            self->min_strength = -DBL_MAX;
-            self->max_strength = DBL_MAX;
-        }
-        else if (streq(semantics, STR_EULERBASED_MODEL)) {
-            self->semantics = STR_EULERBASED_MODEL;
-            self->aggregation_function = sum;
-            self->influence_function = euler_based;
-            self->min_strength = -DBL_MAX;
-            self->max_strength = DBL_MAX;
-        }
-        else if (streq(semantics, STR_DFQUAD_MODEL)) {
-            self->semantics = STR_DFQUAD_MODEL;
-            self->aggregation_function = product;
-            self->influence_function = linear_1; // Linear(1)
-            self->min_strength = -1;
-            self->max_strength = 1;
-        }
-        else {
-            PyErr_SetString(PyExc_ValueError, "incorrect value of semantics");
-            return -1;
-        }
-
-    }
-
-    // Check all the initial strengths are in range (min_strength, max_strength)
-    int initial_strengths_in_minmax = _QBAFramework_initial_strengths_in_minmax(self);
-    if (initial_strengths_in_minmax < 0) {
-        return -1;
-    }
-    if (!initial_strengths_in_minmax) {
-        char msg[100];
-        sprintf(msg, "every initial_strength must be within range (%.2f, %.2f)", self->min_strength, self->max_strength);
-        PyErr_SetString(PyExc_ValueError, msg);
-        return -1;
-    }
-
-    return 0;
+    return _QBAFramework_init_semantics(self, semantics, aggregation_function, influence_function,
+                                        min_strength, max_strength);
 }
 
 /**
@@ -741,23 +843,112 @@ QBAFramework_getmax_strength(QBAFrameworkObject *self, void *closure)
 }
 
 /**
- * @brief Setter of the attribute disjoint_relations.
+ * @brief Getter of the attribute threads.
  * 
  * @param self the QBAFramework object
- * @param value PyBool value for disjoint_relations
+ * @param closure 
+ * @return PyObject* new PyLong with the number of threads
+ */
+static PyObject *
+QBAFramework_getthreads(QBAFrameworkObject *self, void *closure)
+{
+    return PyLong_FromLong(self->threads);
+}
+
+/**
+ * @brief Setter of the attribute threads.
+ * 
+ * @param self the QBAFramework object
+ * @param value PyLong value for threads (greater than 0)
  * @param closure 
  * @return int 0 if it was executed with no errors. Otherwise, -1.
  */
 static int
-QBAFramework_setdisjoint_relations(QBAFrameworkObject *self, PyObject *value, void *closure)
+QBAFramework_setthreads(QBAFrameworkObject *self, PyObject *value, void *closure)
 {
-    if (!PyBool_Check(value)) {
+    if (value == NULL || !PyLong_Check(value)) {
         PyErr_SetString(PyExc_TypeError,
-                        "disjoint_relations must be of type boolean");
+                        "threads must be of type int");
         return -1;
     }
-    
-    int disjoint_relations = PyObject_IsTrue(value);
+
+    long threads = PyLong_AsLong(value);
+    if (threads == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (threads < 1 || threads > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError,
+                        "threads must be greater than 0");
+        return -1;
+    }
+
+    self->threads = (int) threads;
+
+    return 0;
+}
+
+/**
+ * @brief Getter of the attribute fast_math.
+ * 
+ * @param self the QBAFramework object
+ * @param closure 
+ * @return PyObject* new reference to True or False
+ */
+static PyObject *
+QBAFramework_getfast_math(QBAFrameworkObject *self, void *closure)
+{
+    Py_RETURN_BOOL(self->fast_math);
+}
+
+/**
+ * @brief Setter of the attribute fast_math.
+ * The final strengths are calculated again if the value changes.
+ * 
+ * @param self the QBAFramework object
+ * @param value PyBool value for fast_math
+ * @param closure 
+ * @return int 0 if it was executed with no errors. Otherwise, -1.
+ */
+static int
+QBAFramework_setfast_math(QBAFrameworkObject *self, PyObject *value, void *closure)
+{
+    if (value == NULL || !PyBool_Check(value)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "fast_math must be of type bool");
+        return -1;
+    }
+
+    int fast_math = value == Py_True;
+    if (fast_math != self->fast_math && self->graph != NULL) {
+        if (_QBAFramework_check_idle(self) < 0) {
+            return -1;
+        }
+        QBAFGraph_ClearDirty(self->graph);
+        self->graph->evaluated = FALSE;
+    }
+    self->fast_math = fast_math;
+
+    return 0;
+}
+
+/**
+ * @brief Setter of the attribute disjoint_relations.
+ * 
+ * @param self the QBAFramework object
+ * @param value PyBool value for disjoint_relations
+ * @param closure 
+ * @return int 0 if it was executed with no errors. Otherwise, -1.
+ */
+static int
+QBAFramework_setdisjoint_relations(QBAFrameworkObject *self, PyObject *value, void *closure)
+{
+    if (!PyBool_Check(value)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "disjoint_relations must be of type boolean");
+        return -1;
+    }
+    
+    int disjoint_relations = PyObject_IsTrue(value);
 
     if (self->disjoint_relations == disjoint_relations) {
         return 0;
@@ -826,21 +1017,50 @@ QBAFramework_modify_initial_strengths(QBAFrameworkObject *self, PyObject *args,
         return NULL;
     }
     if (!in_minmax) {
-        char msg[100];
-        sprintf(msg, "initial_strength must be within range (%.2f, %.2f)", self->min_strength, self->max_strength);
-        PyErr_SetString(PyExc_ValueError, msg);
+        _QBAFramework_range_error(self, "initial_strength");
+        Py_DECREF(initial_strength);
+        return NULL;
+    }
+
+    // Nothing is modified unless the argument exists and the graph can be updated
+    int contains = PySet_Contains(self->arguments, argument);
+    if (contains < 0) {
         Py_DECREF(initial_strength);
         return NULL;
     }
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError, "argument must be contained in the QBAFramework");
+        Py_DECREF(initial_strength);
+        return NULL;
+    }
+    Py_ssize_t index = -1;
+    if (!self->modified) {
+        if (_QBAFramework_check_idle(self) < 0 || QBAFGraph_Unshare(self->graph) < 0) {
+            Py_DECREF(initial_strength);
+            return NULL;
+        }
+        index = QBAFGraph_IndexOf(self->graph, argument);
+        if (index < -1) {
+            Py_DECREF(initial_strength);
+            return NULL;
+        }
+    }
 
     if (PyDict_SetItem(self->initial_strengths, argument, initial_strength) < 0) {
         Py_DECREF(initial_strength);
         return NULL;
     }
 
-    Py_DECREF(initial_strength);
+    // The compiled graph is updated in place and only the dependents of the argument are recalculated
+    if (index >= 0) {
+        self->graph->initial_strengths[index] = PyFloat_AS_DOUBLE(initial_strength);
+        QBAFGraph_MarkDirty(self->graph, index);
+    }
+    else {
+        self->modified = TRUE;
+    }
 
-    self->modified = TRUE;
+    Py_DECREF(initial_strength);
 
     Py_RETURN_NONE;
 }
@@ -945,9 +1165,7 @@ QBAFramework_add_argument(QBAFrameworkObject *self, PyObject *args, PyObject *kw
         return NULL;
     }
     if (!in_minmax) {
-        char msg[100];
-        sprintf(msg, "initial_strength must be within range (%.2f, %.2f)", self->min_strength, self->max_strength);
-        PyErr_SetString(PyExc_ValueError, msg);
+        _QBAFramework_range_error(self, "initial_strength");
         Py_DECREF(initial_strength);
         return NULL;
     }
@@ -964,6 +1182,10 @@ QBAFramework_add_argument(QBAFrameworkObject *self, PyObject *args, PyObject *kw
         return NULL;
     }
 
+    if (self->order != NULL && QBAFOrder_AddArgument(self->order, (QBAFARelationsObject*)self->attack_relations, argument) < 0) {
+        return NULL;
+    }
+
     self->modified = TRUE;
 
     Py_RETURN_NONE;
@@ -1025,902 +1247,2507 @@ QBAFramework_remove_argument(QBAFrameworkObject *self, PyObject *args, PyObject
         return NULL;
     }
 
+    if (self->order != NULL && QBAFOrder_RemoveArgument(self->order, (QBAFARelationsObject*)self->attack_relations, argument) < 0) {
+        return NULL;
+    }
+
+    // An equal argument added later must not get this object back from the symbol table of the relations
+    if (QBAFARelations_Release((QBAFARelationsObject*)self->attack_relations, argument) < 0) {
+        return NULL;
+    }
+
     self->modified = TRUE;
 
     Py_RETURN_NONE;
 }
 
 /**
- * @brief Add the Attack relation (attacker, attacked) to the Framework.
+ * @brief Compile the Framework into a new QBAFGraph if it has been modified
+ * from the last time it was compiled.
  * 
  * @param self an instance of QBAFramework
- * @param args the argument values (attacker: QBAFArgument, attacked: QBAFArgument)
- * @param kwds the argument names
- * @return PyObject* new Py_None, NULL in case of error
+ * @return int 0 if succesful, -1 if an error occurred
  */
-static PyObject *
-QBAFramework_add_attack_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+static int
+_QBAFramework_compile(QBAFrameworkObject *self)
 {
-    static char *kwlist[] = {"attacker", "attacked", NULL};
-    PyObject *agent, *patient;
-    int contains;
+    if (_QBAFramework_check_idle(self) < 0) {
+        return -1;
+    }
+    if (!self->modified) {
+        return 0;
+    }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
-                                     &agent, &patient))
-        return NULL;
+    QBAFGraph *graph = QBAFGraph_New(self->arguments, self->initial_strengths,
+                                     (QBAFARelationsObject*)self->attack_relations,
+                                     (QBAFARelationsObject*)self->support_relations);
+    if (graph == NULL) {
+        return -1;
+    }
+    // Only the arguments affected by the modifications will be recalculated
+    QBAFGraph_Inherit(graph, self->graph);
+    QBAFGraph_Free(self->graph);
+    self->graph = graph;
+    self->modified = FALSE;
 
-    contains = PySet_Contains(self->arguments, agent);
-    if (contains < 0) {
+    return 0;
+}
+
+/**
+ * @brief Copy the indices of a 1-D buffer of integers into the array ids, checking that every index is within [0, size).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+#define COPY_INDICES(ctype)                                                 \
+    for (Py_ssize_t i = 0; i < length; i++) {                               \
+        ctype index = ((const ctype *) view->buf)[i];                       \
+        if (index < 0 || (unsigned long long) index >= (unsigned long long) size) \
+            goto out_of_range;                                              \
+        ids[i] = (int32_t) index;                                           \
+    }
+
+/**
+ * @brief Return a new array with the indices of the 1-D buffer of integers view,
+ * NULL if an error occurred (also if an index is not within [0, size)).
+ * 
+ * @param view a 1-D C-contiguous Py_buffer with format
+ * @param name the name of the parameter (for the error messages)
+ * @param size the number of arguments
+ * @return int32_t* a new array (free it with PyMem_Free), NULL if an error occurred
+ */
+static int32_t *
+_QBAFramework_buffer_indices(Py_buffer *view, const char *name, Py_ssize_t size)
+{
+    const char *format = view->format;
+    if (format[0] == '@' || format[0] == '=')
+        format++;
+    if (view->ndim != 1 || format[0] == '\0' || format[1] != '\0' || strchr("bBhHiIlLqQnN", format[0]) == NULL) {
+        PyErr_Format(PyExc_ValueError, "%s must be a 1-D buffer of integers", name);
         return NULL;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "argument attacker is not contained in the framework");
+
+    Py_ssize_t length = view->shape[0];
+    int32_t *ids = PyMem_Malloc(length * sizeof(int32_t) + 1);
+    if (ids == NULL) {
+        PyErr_NoMemory();
         return NULL;
     }
 
-    contains = PySet_Contains(self->arguments, patient);
-    if (contains < 0) {
+    switch (format[0]) {
+        case 'b': COPY_INDICES(signed char); break;
+        case 'B': COPY_INDICES(unsigned char); break;
+        case 'h': COPY_INDICES(short); break;
+        case 'H': COPY_INDICES(unsigned short); break;
+        case 'i': COPY_INDICES(int); break;
+        case 'I': COPY_INDICES(unsigned int); break;
+        case 'l': COPY_INDICES(long); break;
+        case 'L': COPY_INDICES(unsigned long); break;
+        case 'q': COPY_INDICES(long long); break;
+        case 'Q': COPY_INDICES(unsigned long long); break;
+        case 'n': COPY_INDICES(Py_ssize_t); break;
+        case 'N': COPY_INDICES(size_t); break;
+    }
+    return ids;
+
+out_of_range:
+    PyErr_Format(PyExc_ValueError, "every index of %s must be within [0, %zd)", name, size);
+    PyMem_Free(ids);
+    return NULL;
+}
+
+#undef COPY_INDICES
+
+/**
+ * @brief Return a new array with the indices of indices, a 1-D buffer of integers or a sequence of int,
+ * NULL if an error occurred (also if an index is not within [0, size)).
+ * 
+ * @param indices a 1-D buffer of integers or a sequence of int
+ * @param name the name of the parameter (for the error messages)
+ * @param size the number of arguments
+ * @param length a pointer where the number of indices is stored
+ * @return int32_t* a new array (free it with PyMem_Free), NULL if an error occurred
+ */
+static int32_t *
+_QBAFramework_index_array(PyObject *indices, const char *name, Py_ssize_t size, Py_ssize_t *length)
+{
+    int32_t *ids;
+
+    if (PyObject_CheckBuffer(indices)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(indices, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            return NULL;
+        }
+        ids = _QBAFramework_buffer_indices(&view, name, size);
+        *length = view.ndim == 1 ? view.shape[0] : 0;
+        PyBuffer_Release(&view);
+        return ids;
+    }
+
+    PyObject *sequence = PySequence_Fast(indices, "the indices must be a buffer or a sequence of int");
+    if (sequence == NULL) {
         return NULL;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "argument attacked is not contained in the framework");
+    *length = PySequence_Fast_GET_SIZE(sequence);
+    ids = PyMem_Malloc(*length * sizeof(int32_t) + 1);
+    if (ids == NULL) {
+        Py_DECREF(sequence);
+        PyErr_NoMemory();
         return NULL;
     }
+    for (Py_ssize_t i = 0; i < *length; i++) {
+        Py_ssize_t index = PyLong_AsSsize_t(PySequence_Fast_GET_ITEM(sequence, i));
+        if (index == -1 && PyErr_Occurred()) {
+            Py_DECREF(sequence);
+            PyMem_Free(ids);
+            return NULL;
+        }
+        if (index < 0 || index >= size) {
+            PyErr_Format(PyExc_ValueError, "every index of %s must be within [0, %zd)", name, size);
+            Py_DECREF(sequence);
+            PyMem_Free(ids);
+            return NULL;
+        }
+        ids[i] = (int32_t) index;
+    }
+    Py_DECREF(sequence);
+    return ids;
+}
 
-    if (self->disjoint_relations) {
-        contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
-        if (contains < 0) {
+/**
+ * @brief Return a new PyList with a PyFloat for every initial strength of initial_strengths,
+ * a 1-D buffer of float64 or a sequence of numbers, NULL if an error occurred (a ValueError if one of them is NaN,
+ * which no range contains).
+ * 
+ * @param initial_strengths a 1-D buffer of float64 or a sequence of numbers
+ * @param size the number of arguments
+ * @return PyObject* a new PyList of PyFloat, NULL if an error occurred
+ */
+static PyObject *
+_QBAFramework_strength_list(PyObject *initial_strengths, Py_ssize_t size)
+{
+    if (PyObject_CheckBuffer(initial_strengths)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(initial_strengths, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
             return NULL;
         }
-        if (contains) {
+        const char *format = view.format;
+        if (format[0] == '@' || format[0] == '=')
+            format++;
+        if (view.ndim != 1 || strcmp(format, "d") != 0 || view.shape[0] != size) {
             PyErr_SetString(PyExc_ValueError,
-                            "attack relation already exists as support relation");
+                            "initial_strengths must be a 1-D buffer of float64 with an initial strength for every argument");
+            PyBuffer_Release(&view);
+            return NULL;
+        }
+        PyObject *list = PyList_New(size);
+        if (list == NULL) {
+            PyBuffer_Release(&view);
             return NULL;
         }
+        for (Py_ssize_t index = 0; index < size; index++) {
+            double value = ((const double *) view.buf)[index];
+            if (isnan(value)) {
+                PyErr_SetString(PyExc_ValueError, "initial_strengths must not contain NaN");
+                Py_DECREF(list);
+                PyBuffer_Release(&view);
+                return NULL;
+            }
+            PyObject *strength = PyFloat_FromDouble(value);
+            if (strength == NULL) {
+                Py_DECREF(list);
+                PyBuffer_Release(&view);
+                return NULL;
+            }
+            PyList_SET_ITEM(list, index, strength);
+        }
+        PyBuffer_Release(&view);
+        return list;
     }
 
-    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
-    if (contains < 0) {
+    PyObject *list = PySequence_List(initial_strengths);
+    if (list == NULL) {
         return NULL;
     }
-    if (contains) {
-        Py_RETURN_NONE;
+    if (PyList_GET_SIZE(list) != size) {
+        PyErr_SetString(PyExc_ValueError, "the lengths of names and initial_strengths must be equal");
+        Py_DECREF(list);
+        return NULL;
     }
-
-    if (_QBAFARelations_add((QBAFARelationsObject*) self->attack_relations, agent, patient) < 0) {
+    PyObject *strengths = PyListFloat_FromPyListNumeric(list);
+    Py_DECREF(list);
+    if (strengths == NULL) {
         return NULL;
     }
+    for (Py_ssize_t index = 0; index < size; index++) {
+        if (isnan(PyFloat_AS_DOUBLE(PyList_GET_ITEM(strengths, index)))) {
+            PyErr_SetString(PyExc_ValueError, "initial_strengths must not contain NaN");
+            Py_DECREF(strengths);
+            return NULL;
+        }
+    }
+    return strengths;
+}
 
-    self->modified = TRUE;
+/**
+ * @brief Add to the QBAFARelations relations the relations (ids of sources[i], ids of destinations[i]),
+ * where sources and destinations are 1-D buffers of integers or sequences of int with indices of the arguments.
+ * The ids of the arguments must be their indices. Return 0 if succeeded, -1 if an error occurred.
+ * 
+ * @param relations an instance of QBAFARelations
+ * @param sources the indices of the agents
+ * @param destinations the indices of the patients
+ * @param names the names of sources and destinations (for the error messages)
+ * @param size the number of arguments
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+_QBAFramework_add_index_relations(QBAFARelationsObject *relations, PyObject *sources, PyObject *destinations,
+                                  const char *names[2], Py_ssize_t size)
+{
+    Py_ssize_t nsources, ndestinations;
+    int32_t *agents = _QBAFramework_index_array(sources, names[0], size, &nsources);
+    if (agents == NULL) {
+        return -1;
+    }
+    int32_t *patients = _QBAFramework_index_array(destinations, names[1], size, &ndestinations);
+    if (patients == NULL) {
+        PyMem_Free(agents);
+        return -1;
+    }
+    if (nsources != ndestinations) {
+        PyErr_Format(PyExc_ValueError, "the lengths of %s and %s must be equal", names[0], names[1]);
+        PyMem_Free(agents); PyMem_Free(patients);
+        return -1;
+    }
 
-    Py_RETURN_NONE;
+    if (QBAFARelations_Reserve(relations, size, nsources) < 0) {
+        PyMem_Free(agents); PyMem_Free(patients);
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < nsources; i++) {
+        if (QBAFARelations_AddIds(relations, agents[i], patients[i]) < 0) {
+            PyMem_Free(agents); PyMem_Free(patients);
+            return -1;
+        }
+    }
+
+    PyMem_Free(agents);
+    PyMem_Free(patients);
+    return 0;
 }
 
 /**
- * @brief Add the Support relation (supporter, supported) to the Framework.
+ * @brief Create a new QBAFramework from the names of its arguments, their initial strengths and
+ * arrays with the indices (within names) of the attackers, the attacked, the supporters and the supported.
+ * The relations are added by id without hashing any argument, and the graph is compiled right away.
+ * Return NULL if an error has occurred.
  * 
- * @param self an instance of QBAFramework
- * @param args the argument values (supporter: QBAFArgument, supported: QBAFArgument)
+ * @param type the class (QBAFramework or a subclass)
+ * @param args the argument values
  * @param kwds the argument names
- * @return PyObject* new Py_None, NULL in case of error
+ * @return PyObject* new instance of the class, NULL if an error occurred
  */
 static PyObject *
-QBAFramework_add_support_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+QBAFramework_from_arrays(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"supporter", "supported", NULL};
-    PyObject *agent, *patient;
-    int contains;
+    static char *kwlist[] = {"names", "initial_strengths", "att_src", "att_dst", "sup_src", "sup_dst",
+                            "disjoint_relations", "semantics", "aggregation_function", "influence_function",
+                            "min_strength", "max_strength", NULL};
+    static const char *attack_names[2] = {"att_src", "att_dst"};
+    static const char *support_names[2] = {"sup_src", "sup_dst"};
+    PyObject *names, *initial_strengths, *att_src, *att_dst, *sup_src, *sup_dst;
+    int disjoint_relations = TRUE;
+    char *semantics = NULL;
+    PyObject *aggregation_function = NULL, *influence_function = NULL;
+    double min_strength = -DBL_MAX, max_strength = DBL_MAX;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
-                                     &agent, &patient))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOOOO|pzOOdd", kwlist,
+                                     &names, &initial_strengths, &att_src, &att_dst, &sup_src, &sup_dst,
+                                     &disjoint_relations, &semantics, &aggregation_function, &influence_function,
+                                     &min_strength, &max_strength))
         return NULL;
 
-    contains = PySet_Contains(self->arguments, agent);
-    if (contains < 0) {
+    names = PySequence_List(names);     // New reference
+    if (names == NULL) {
         return NULL;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "argument supporter is not contained in the framework");
+    Py_ssize_t size = PyList_GET_SIZE(names);
+    if (size >= INT32_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "too many arguments");
+        Py_DECREF(names);
         return NULL;
     }
 
-    contains = PySet_Contains(self->arguments, patient);
-    if (contains < 0) {
+    initial_strengths = _QBAFramework_strength_list(initial_strengths, size);   // New reference
+    if (initial_strengths == NULL) {
+        Py_DECREF(names);
         return NULL;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "argument supported is not contained in the framework");
+
+    PyObject *empty = PyTuple_New(0);
+    if (empty == NULL) {
+        Py_DECREF(names); Py_DECREF(initial_strengths);
         return NULL;
     }
-
-    if (self->disjoint_relations) {
-        contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
-        if (contains < 0) {
-            return NULL;
-        }
-        if (contains) {
-            PyErr_SetString(PyExc_ValueError,
-                            "support relation already exists as attack relation");
-            return NULL;
-        }
+    QBAFrameworkObject *self = (QBAFrameworkObject *) type->tp_new(type, empty, NULL);
+    Py_DECREF(empty);
+    if (self == NULL) {
+        Py_DECREF(names); Py_DECREF(initial_strengths);
+        return NULL;
     }
 
-    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
-    if (contains < 0) {
-        return NULL;
+    Py_SETREF(self->arguments, PySet_New(names));
+    if (self->arguments == NULL) {
+        goto error;
     }
-    if (contains) {
-        Py_RETURN_NONE;
+    if (PySet_GET_SIZE(self->arguments) != size) {
+        PyErr_SetString(PyExc_ValueError, "the names must be unique");
+        goto error;
     }
 
-    if (_QBAFARelations_add((QBAFARelationsObject*) self->support_relations, agent, patient) < 0) {
-        return NULL;
+    Py_SETREF(self->initial_strengths, PyDict_FromLists(names, initial_strengths));
+    if (self->initial_strengths == NULL) {
+        goto error;
     }
 
-    self->modified = TRUE;
+    Py_SETREF(self->attack_relations, QBAFARelations_Create(NULL));
+    if (self->attack_relations == NULL) {
+        goto error;
+    }
+    Py_SETREF(self->support_relations,
+              QBAFARelations_CreateWithSymbols(NULL, (QBAFARelationsObject*)self->attack_relations));
+    if (self->support_relations == NULL) {
+        goto error;
+    }
 
-    Py_RETURN_NONE;
-}
+    // The id of every argument in the (shared) symbol table is its index in names
+    for (Py_ssize_t index = 0; index < size; index++) {
+        if (QBAFARelations_Intern((QBAFARelationsObject*)self->attack_relations, PyList_GET_ITEM(names, index)) < 0) {
+            goto error;
+        }
+    }
 
-/**
- * @brief Remove the Attack relation (attacker, attacked) from the Framework.
- * 
- * @param self an instance of QBAFramework
- * @param args the argument values (attacker: QBAFArgument, attacked: QBAFArgument)
- * @param kwds the argument names
- * @return PyObject* new Py_None, NULL in case of error
- */
-static PyObject *
-QBAFramework_remove_attack_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
-{
-    static char *kwlist[] = {"attacker", "attacked", NULL};
-    PyObject *agent, *patient;
-    int contains;
+    if (_QBAFramework_add_index_relations((QBAFARelationsObject*)self->attack_relations, att_src, att_dst,
+                                          attack_names, size) < 0 ||
+        _QBAFramework_add_index_relations((QBAFARelationsObject*)self->support_relations, sup_src, sup_dst,
+                                          support_names, size) < 0) {
+        goto error;
+    }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
-                                     &agent, &patient))
-        return NULL;
+    self->disjoint_relations = disjoint_relations;
 
-    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
-    if (contains < 0) {
-        return NULL;
+    if (self->disjoint_relations) {
+        // Check attack and support relations are disjoint
+        int disjoint = _QBAFARelations_isDisjoint((QBAFARelationsObject*)self->attack_relations, (QBAFARelationsObject*)self->support_relations);
+        if (disjoint < 0) {
+            goto error;
+        }
+        if (!disjoint) {
+            PyErr_SetString(PyExc_ValueError, "attack_relations and support_relations must be disjoint");
+            goto error;
+        }
     }
-    if (!contains) {
-        Py_RETURN_NONE;
+
+    if (_QBAFramework_init_semantics(self, semantics, aggregation_function, influence_function,
+                                     min_strength, max_strength) < 0) {
+        goto error;
     }
 
-    if (_QBAFARelations_remove((QBAFARelationsObject*) self->attack_relations, agent, patient) < 0) {
-        return NULL;
+    if (_QBAFramework_compile(self) < 0) {
+        goto error;
     }
 
-    self->modified = TRUE;
+    Py_DECREF(names);
+    Py_DECREF(initial_strengths);
+    return (PyObject *) self;
 
-    Py_RETURN_NONE;
+error:
+    Py_DECREF(names);
+    Py_DECREF(initial_strengths);
+    Py_DECREF(self);
+    return NULL;
 }
 
 /**
- * @brief Remove the Support relation (supporter, supported) from the Framework.
+ * @brief Create a Framework from a JSON or CSV source (a path or a file-like object) read in chunks.
+ * Every argument and relation is inserted in the Framework as soon as it is parsed.
+ * Return NULL if an error has occurred.
  * 
- * @param self an instance of QBAFramework
- * @param args the argument values (supporter: QBAFArgument, supported: QBAFArgument)
+ * @param type the class (QBAFramework or a subclass)
+ * @param args the argument values
  * @param kwds the argument names
- * @return PyObject* new Py_None, NULL in case of error
+ * @return PyObject* new instance of the class, NULL if an error occurred
  */
 static PyObject *
-QBAFramework_remove_support_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+QBAFramework_load(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"supporter", "supported", NULL};
-    PyObject *agent, *patient;
-    int contains;
+    static char *kwlist[] = {"source", "format",
+                            "disjoint_relations", "semantics", "aggregation_function", "influence_function",
+                            "min_strength", "max_strength", NULL};
+    PyObject *source;
+    char *format = NULL;
+    int disjoint_relations = TRUE;
+    char *semantics = NULL;
+    PyObject *aggregation_function = NULL, *influence_function = NULL;
+    double min_strength = -DBL_MAX, max_strength = DBL_MAX;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
-                                     &agent, &patient))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|zpzOOdd", kwlist,
+                                     &source, &format,
+                                     &disjoint_relations, &semantics, &aggregation_function, &influence_function,
+                                     &min_strength, &max_strength))
         return NULL;
 
-    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
-    if (contains < 0) {
+    PyObject *empty = PyTuple_New(0);
+    if (empty == NULL) {
         return NULL;
     }
-    if (!contains) {
-        Py_RETURN_NONE;
+    QBAFrameworkObject *self = (QBAFrameworkObject *) type->tp_new(type, empty, NULL);
+    Py_DECREF(empty);
+    if (self == NULL) {
+        return NULL;
     }
 
-    if (_QBAFARelations_remove((QBAFARelationsObject*) self->support_relations, agent, patient) < 0) {
-        return NULL;
+    Py_SETREF(self->arguments, PySet_New(NULL));
+    if (self->arguments == NULL) {
+        goto error;
+    }
+    Py_SETREF(self->initial_strengths, PyDict_New());
+    if (self->initial_strengths == NULL) {
+        goto error;
+    }
+    Py_SETREF(self->attack_relations, QBAFARelations_Create(NULL));
+    if (self->attack_relations == NULL) {
+        goto error;
+    }
+    Py_SETREF(self->support_relations,
+              QBAFARelations_CreateWithSymbols(NULL, (QBAFARelationsObject*)self->attack_relations));
+    if (self->support_relations == NULL) {
+        goto error;
     }
 
-    self->modified = TRUE;
+    QBAFLoaderTarget target = {self->arguments, self->initial_strengths,
+                               (QBAFARelationsObject*)self->attack_relations,
+                               (QBAFARelationsObject*)self->support_relations};
+    if (QBAFLoader_Load(source, format, &target) < 0) {
+        goto error;
+    }
 
-    Py_RETURN_NONE;
+    self->disjoint_relations = disjoint_relations;
+
+    if (self->disjoint_relations) {
+        // Check attack and support relations are disjoint
+        int disjoint = _QBAFARelations_isDisjoint((QBAFARelationsObject*)self->attack_relations, (QBAFARelationsObject*)self->support_relations);
+        if (disjoint < 0) {
+            goto error;
+        }
+        if (!disjoint) {
+            PyErr_SetString(PyExc_ValueError, "attack_relations and support_relations must be disjoint");
+            goto error;
+        }
+    }
+
+    if (_QBAFramework_init_semantics(self, semantics, aggregation_function, influence_function,
+                                     min_strength, max_strength) < 0) {
+        goto error;
+    }
+
+    if (_QBAFramework_compile(self) < 0) {
+        goto error;
+    }
+
+    return (PyObject *) self;
+
+error:
+    Py_DECREF(self);
+    return NULL;
 }
 
 /**
- * @brief Return True if the argument is contained, False if it is not, NULL if an error has occurred.
+ * @brief Save the Framework in a binary file that can be opened with QBAFramework.mmap.
+ * Return None, NULL if an error has occurred.
  * 
  * @param self an instance of QBAFramework
- * @param args the argument values (argument: QBAFArgument)
+ * @param args the argument values (path: path-like object)
  * @param kwds the argument names
- * @return PyObject* new PyBool, NULL in case of error
+ * @return PyObject* None, NULL if an error occurred
  */
 static PyObject *
-QBAFramework_contains_argument(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+QBAFramework_save(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"argument", NULL};
-    PyObject *argument;
-    int contains;
+    static char *kwlist[] = {"path", NULL};
+    PyObject *path;
 
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
-                                     &argument))
+                                     &path))
         return NULL;
 
-    contains = PySet_Contains(self->arguments, argument);
-    if (contains < 0) {
+    if (self->semantics == NULL) {
+        PyErr_SetString(PyExc_ValueError,
+                        "only a framework with predefined semantics can be saved");
         return NULL;
     }
 
-    if (contains) {
-        Py_RETURN_TRUE;
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
     }
 
-    Py_RETURN_FALSE;
+    if (QBAFFile_Save(path, self->graph, self->semantics, self->disjoint_relations) < 0) {
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
 }
 
 /**
- * @brief Return True if the Attack relation is contained, False if it is not, NULL if an error has occurred.
+ * @brief Add to the relations of the Framework (without relations) the Attack and Support relations of the QBAFGraph graph.
+ * The arguments are interned in the order of the graph, so their ids are their indices.
+ * Return 0 if succeeded, -1 if an error has occurred.
  * 
  * @param self an instance of QBAFramework
- * @param args the argument values (attacker: QBAFArgument, attacked: QBAFArgument)
- * @param kwds the argument names
- * @return PyObject* new PyBool, NULL in case of error
+ * @param graph a QBAFGraph with the arguments of the Framework
+ * @return int 0 if succeeded, -1 if an error occurred
  */
-static PyObject *
-QBAFramework_contains_attack_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+static int
+_QBAFramework_relations_from_graph(QBAFrameworkObject *self, QBAFGraph *graph)
 {
-    static char *kwlist[] = {"attacker", "attacked", NULL};
-    PyObject *agent, *patient;
-    int contains;
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
-                                     &agent, &patient))
-        return NULL;
+    QBAFARelationsObject *attack_relations = (QBAFARelationsObject*)self->attack_relations;
+    QBAFARelationsObject *support_relations = (QBAFARelationsObject*)self->support_relations;
 
-    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
-    if (contains < 0) {
-        return NULL;
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        if (QBAFARelations_Intern(attack_relations, PyList_GET_ITEM(graph->arguments, index)) < 0) {
+            return -1;
+        }
     }
 
-    if (contains) {
-        Py_RETURN_TRUE;
+    if (QBAFARelations_Reserve(attack_relations, graph->size, graph->attackers_offsets[graph->size]) < 0 ||
+        QBAFARelations_Reserve(support_relations, graph->size, graph->supporters_offsets[graph->size]) < 0) {
+        return -1;
+    }
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        for (Py_ssize_t position = graph->attackers_offsets[index]; position < graph->attackers_offsets[index + 1]; position++) {
+            if (QBAFARelations_AddIds(attack_relations, graph->attackers[position], index) < 0) {
+                return -1;
+            }
+        }
+        for (Py_ssize_t position = graph->supporters_offsets[index]; position < graph->supporters_offsets[index + 1]; position++) {
+            if (QBAFARelations_AddIds(support_relations, graph->supporters[position], index) < 0) {
+                return -1;
+            }
+        }
     }
 
-    Py_RETURN_FALSE;
+    return 0;
 }
 
 /**
- * @brief Return True if the Support relation is contained, False if it is not, NULL if an error has occurred.
+ * @brief Return a new Framework of class type whose compiled graph is the QBAFGraph graph
+ * (e.g. mapped from a file or loaded from a binary image). The graph is owned by the Framework from now on.
+ * Return NULL if an error has occurred (the graph is freed).
  * 
- * @param self an instance of QBAFramework
- * @param args the argument values (supporter: QBAFArgument, supported: QBAFArgument)
- * @param kwds the argument names
- * @return PyObject* new PyBool, NULL in case of error
+ * @param type the class (QBAFramework or a subclass)
+ * @param graph a QBAFGraph
+ * @param header the header of the binary image of the graph
+ * @param aggregation_function the aggregation function if the semantics is not predefined, NULL if it is
+ * @param influence_function the influence function if the semantics is not predefined, NULL if it is
+ * @param min_strength the minimum strength
+ * @param max_strength the maximum strength
+ * @return QBAFrameworkObject* new instance of the class, NULL if an error occurred
  */
-static PyObject *
-QBAFramework_contains_support_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+static QBAFrameworkObject *
+_QBAFramework_from_graph(PyTypeObject *type, QBAFGraph *graph, QBAFFileHeader *header,
+                         PyObject *aggregation_function, PyObject *influence_function,
+                         double min_strength, double max_strength)
 {
-    static char *kwlist[] = {"supporter", "supported", NULL};
-    PyObject *agent, *patient;
-    int contains;
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
-                                     &agent, &patient))
+    PyObject *empty = PyTuple_New(0);
+    if (empty == NULL) {
+        QBAFGraph_Free(graph);
         return NULL;
-
-    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
-    if (contains < 0) {
+    }
+    QBAFrameworkObject *self = (QBAFrameworkObject *) type->tp_new(type, empty, NULL);
+    Py_DECREF(empty);
+    if (self == NULL) {
+        QBAFGraph_Free(graph);
         return NULL;
     }
 
-    if (contains) {
-        Py_RETURN_TRUE;
+    Py_SETREF(self->arguments, PySet_New(graph->arguments));
+    if (self->arguments == NULL) {
+        goto error;
+    }
+    Py_SETREF(self->initial_strengths, QBAFGraph_StrengthsAsDict(graph, graph->initial_strengths));
+    if (self->initial_strengths == NULL) {
+        goto error;
+    }
+    Py_SETREF(self->attack_relations, QBAFARelations_Create(NULL));
+    if (self->attack_relations == NULL) {
+        goto error;
+    }
+    Py_SETREF(self->support_relations,
+              QBAFARelations_CreateWithSymbols(NULL, (QBAFARelationsObject*)self->attack_relations));
+    if (self->support_relations == NULL) {
+        goto error;
+    }
+    if (_QBAFramework_relations_from_graph(self, graph) < 0) {
+        goto error;
     }
 
-    Py_RETURN_FALSE;
+    self->disjoint_relations = (header->flags & QBAF_FILE_DISJOINT_RELATIONS) != 0;
+    if (self->disjoint_relations) {
+        int disjoint = _QBAFARelations_isDisjoint((QBAFARelationsObject*)self->attack_relations, (QBAFARelationsObject*)self->support_relations);
+        if (disjoint < 0) {
+            goto error;
+        }
+        if (!disjoint) {
+            PyErr_SetString(PyExc_ValueError, "attack_relations and support_relations must be disjoint");
+            goto error;
+        }
+    }
+
+    if (_QBAFramework_init_semantics(self, header->semantics[0] != '\0' ? header->semantics : NULL,
+                                     aggregation_function, influence_function, min_strength, max_strength) < 0) {
+        goto error;
+    }
+
+    // The Framework is already compiled
+    QBAFGraph_Free(self->graph);
+    self->graph = graph;
+    self->modified = FALSE;
+
+    return self;
+
+error:
+    QBAFGraph_Free(graph);
+    Py_DECREF(self);
+    return NULL;
 }
 
 /**
- * @brief Return the arguments that are attacked by the argument attacker,
- * NULL (with the corresponding exception) if an error has occurred.
+ * @brief Open a Framework saved with QBAFramework.save by mapping its file into memory.
+ * The compiled graph reads its arrays and the initial strengths directly from the mapped pages.
+ * Return NULL if an error has occurred.
  * 
- * @param self 
- * @param args the argument values (attacker: QBAFArgument)
+ * @param type the class (QBAFramework or a subclass)
+ * @param args the argument values (path: path-like object)
  * @param kwds the argument names
- * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ * @return PyObject* new instance of the class, NULL if an error occurred
  */
 static PyObject *
-QBAFramework_attackedBy(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+QBAFramework_mmap(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"attacker", NULL};
-    PyObject *attacker;
+    static char *kwlist[] = {"path", NULL};
+    PyObject *path;
 
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
-                                     &attacker))
+                                     &path))
         return NULL;
 
-    int contains = PySet_Contains(self->arguments, attacker);
-    if (contains < 0) {
-        return NULL;
-    }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "attacker must be an argument of the framework");
+    QBAFFileHeader header;
+    QBAFGraph *graph = QBAFFile_Map(path, &header);
+    if (graph == NULL) {
         return NULL;
     }
 
-    return _QBAFARelations_patients(self->attack_relations, attacker);
+    return (PyObject *) _QBAFramework_from_graph(type, graph, &header, NULL, NULL, -DBL_MAX, DBL_MAX);
 }
 
+#define PICKLE_STATE_VERSION 1  /* version of the state returned by __reduce_ex__ */
+
 /**
- * @brief Return the arguments that are attacking the argument attacked,
- * NULL (with the corresponding exception) if an error has occurred.
+ * @brief Return a new PickleBuffer over object if protocol supports out-of-band buffers (5 or higher),
+ * or a new bytes copy of it if not. Return NULL if an error has occurred.
+ */
+static PyObject *
+_QBAFramework_pickle_buffer(PyObject *object, int protocol)
+{
+    if (protocol >= 5) {
+        return PyPickleBuffer_FromObject(object);
+    }
+    return PyBytes_FromObject(object);
+}
+
+/**
+ * @brief Return the tuple (type(self)._from_state, (state,)) used by pickle.
+ * The state contains the binary image of the compiled graph (see qbaf_file.h) and the final strengths
+ * (if they are up to date), both as PickleBuffer with protocol 5 so they can be transferred out-of-band.
+ * Return NULL if an error has occurred.
  * 
- * @param self 
- * @param args the argument values (attacked: QBAFArgument)
- * @param kwds the argument names
- * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ * @param self an instance of QBAFramework
+ * @param args the argument values (protocol: int)
+ * @return PyObject* new PyTuple, NULL if an error occurred
  */
 static PyObject *
-QBAFramework_attackersOf(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+QBAFramework_reduce_ex(QBAFrameworkObject *self, PyObject *args)
 {
-    static char *kwlist[] = {"attacked", NULL};
-    PyObject *attacked;
+    int protocol;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
-                                     &attacked))
+    if (!PyArg_ParseTuple(args, "i", &protocol))
         return NULL;
 
-    int contains = PySet_Contains(self->arguments, attacked);
-    if (contains < 0) {
+    if (_QBAFramework_compile(self) < 0) {
         return NULL;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "attacked must be an argument of the framework");
+    QBAFGraph *graph = self->graph;
+
+    PyObject *image = QBAFFile_Dumps(graph, self->semantics != NULL ? self->semantics : "",
+                                     self->disjoint_relations, TRUE);
+    if (image == NULL) {
+        return NULL;
+    }
+    Py_SETREF(image, _QBAFramework_pickle_buffer(image, protocol));
+    if (image == NULL) {
         return NULL;
     }
 
-    return _QBAFARelations_agents(self->attack_relations, attacked);
+    PyObject *final_strengths = Py_None;
+    Py_INCREF(final_strengths);
+    if (graph->evaluated && !QBAFGraph_IsDirty(graph)) {
+        Py_SETREF(final_strengths, _QBAFramework_pickle_buffer(graph->final_strengths_buffer, protocol));
+        if (final_strengths == NULL) {
+            Py_DECREF(image);
+            return NULL;
+        }
+    }
+
+    PyObject *constructor = PyObject_GetAttrString((PyObject *) Py_TYPE(self), "_from_state");
+    if (constructor == NULL) {
+        Py_DECREF(image); Py_DECREF(final_strengths);
+        return NULL;
+    }
+
+    return Py_BuildValue("(N((iNONOOddii)))", constructor,
+                         PICKLE_STATE_VERSION, image, graph->arguments, final_strengths,
+                         self->aggregation_function_callable != NULL ? self->aggregation_function_callable : Py_None,
+                         self->influence_function_callable != NULL ? self->influence_function_callable : Py_None,
+                         self->min_strength, self->max_strength, self->threads, self->fast_math);
 }
 
 /**
- * @brief Return the arguments that are supported by the argument supporter,
- * NULL (with the corresponding exception) if an error has occurred.
+ * @brief Create a Framework from the state returned by __reduce_ex__.
+ * The compiled graph reads its arrays and the initial strengths directly from the binary image
+ * if it is an immutable bytes object, and from a validated copy otherwise (see QBAFFile_Loads).
+ * The final strengths are always copied.
+ * Return NULL if an error has occurred.
  * 
- * @param self 
- * @param args the argument values (supporter: QBAFArgument)
- * @param kwds the argument names
- * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ * @param type the class (QBAFramework or a subclass)
+ * @param state the state
+ * @return PyObject* new instance of the class, NULL if an error occurred
  */
 static PyObject *
-QBAFramework_supportedBy(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+QBAFramework_from_state(PyTypeObject *type, PyObject *state)
 {
-    static char *kwlist[] = {"supporter", NULL};
-    PyObject *supporter;
+    int version, threads, fast_math = FALSE;
+    PyObject *image, *arguments, *final_strengths, *aggregation_function, *influence_function;
+    double min_strength, max_strength;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
-                                     &supporter))
+    // fast_math is optional, so the states pickled before it existed can still be loaded
+    if (!PyArg_ParseTuple(state, "iOO!OOOddi|p:_from_state", &version, &image, &PyList_Type, &arguments,
+                          &final_strengths, &aggregation_function, &influence_function,
+                          &min_strength, &max_strength, &threads, &fast_math))
         return NULL;
 
-    int contains = PySet_Contains(self->arguments, supporter);
-    if (contains < 0) {
+    if (version != PICKLE_STATE_VERSION) {
+        PyErr_Format(PyExc_ValueError, "unsupported version %d of the pickled state", version);
         return NULL;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "supporter must be an argument of the framework");
+    if (threads < 1) {
+        PyErr_SetString(PyExc_ValueError, "threads must be greater than 0");
         return NULL;
     }
 
-    return _QBAFARelations_patients(self->support_relations, supporter);
+    QBAFFileHeader header;
+    QBAFGraph *graph = QBAFFile_Loads(image, arguments, &header);
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    if (final_strengths != Py_None) {
+        // They are always copied into the buffer of the graph, which must not be shared with the caller
+        Py_buffer view;
+        if (PyObject_GetBuffer(final_strengths, &view, PyBUF_C_CONTIGUOUS) < 0) {
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+        if (view.len != graph->size * (Py_ssize_t) sizeof(double)) {
+            PyBuffer_Release(&view);
+            QBAFGraph_Free(graph);
+            PyErr_SetString(PyExc_ValueError, "the number of final strengths does not match the arguments");
+            return NULL;
+        }
+        if (view.len > 0)
+            memcpy(graph->final_strengths, view.buf, view.len);
+        PyBuffer_Release(&view);
+        graph->evaluated = TRUE;
+    }
+
+    QBAFrameworkObject *self = _QBAFramework_from_graph(type, graph, &header,
+                                                        aggregation_function, influence_function,
+                                                        min_strength, max_strength);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->threads = threads;
+    self->fast_math = fast_math;
+
+    return (PyObject *) self;
 }
 
 /**
- * @brief Return the arguments that are supporting the argument supported,
- * NULL (with the corresponding exception) if an error has occurred.
+ * @brief Return True if the relations of the Framework are acyclic, False if not,
+ * -1 if an error has occurred.
  * 
- * @param self 
- * @param args the argument values (supported: QBAFArgument)
- * @param kwds the argument names
- * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ * @param self an instance of QBAFramework
+ * @return PyObject* 1 if acyclic, 0 if not acyclic, -1 if an error occurred
  */
-static PyObject *
-QBAFramework_supportersOf(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+static inline int
+_QBAFramework_isacyclic(QBAFrameworkObject *self)
 {
-    static char *kwlist[] = {"supported", NULL};
-    PyObject *supported;
+    if (self->order != NULL) {  // Only acyclic frameworks maintain a topological order
+        return TRUE;
+    }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
-                                     &supported))
-        return NULL;
+    if (_QBAFramework_compile(self) < 0) {
+        return -1;
+    }
 
-    int contains = PySet_Contains(self->arguments, supported);
-    if (contains < 0) {
-        return NULL;
+    return QBAFGraph_IsAcyclic(self->graph);
+}
+
+/**
+ * @brief Keep the topological order of the Framework (if it is maintained) valid before adding
+ * the relation (agent, patient). If require_acyclic, the order is created if it is not maintained yet
+ * and a ValueError is raised if the framework is not acyclic or the relation would create a cycle.
+ * Otherwise, the order is no longer maintained if the relation creates a cycle.
+ * Return 0 if the relation can be added, -1 if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param agent the attacker/supporter (contained in the framework)
+ * @param patient the attacked/supported argument (contained in the framework)
+ * @param require_acyclic 1 if the relation must not create a cycle, 0 if it may
+ * @return int 0 if the relation can be added, -1 if an error occurred
+ */
+static int
+_QBAFramework_order_relation(QBAFrameworkObject *self, PyObject *agent, PyObject *patient, int require_acyclic)
+{
+    if (self->order == NULL) {
+        if (!require_acyclic) {
+            return 0;
+        }
+        int isacyclic = _QBAFramework_isacyclic(self);
+        if (isacyclic < 0) {
+            return -1;
+        }
+        if (!isacyclic) {
+            PyErr_SetString(PyExc_ValueError,
+                            "require_acyclic cannot be used with a non-acyclic framework");
+            return -1;
+        }
+        self->order = QBAFOrder_New(self->graph, (QBAFARelationsObject*)self->attack_relations);
+        if (self->order == NULL) {
+            return -1;
+        }
     }
-    if (!contains) {
+
+    int updated = QBAFOrder_AddRelation(self->order, (QBAFARelationsObject*) self->attack_relations,
+                                        (QBAFARelationsObject*) self->support_relations, agent, patient);
+    if (updated > 0) {
+        return 0;
+    }
+    if (updated == 0 && require_acyclic) {
         PyErr_SetString(PyExc_ValueError,
-                        "supported must be an argument of the framework");
-        return NULL;
+                        "the relation would create a cycle");
+        return -1;
     }
-
-    return _QBAFARelations_agents(self->support_relations, supported);
+    // The order is not valid anymore (or it may have been left incomplete by an error)
+    QBAFOrder_Free(self->order);
+    self->order = NULL;
+    return updated < 0 ? -1 : 0;
 }
 
 /**
- * @brief Return a shallow copy of this instance.
- * New references are created for the copy, except for the QBAFArgument and QBAFARelations.
+ * @brief Add the Attack relation (attacker, attacked) to the Framework.
  * 
- * @param self instance of QBAFramework
- * @param Py_UNUSED 
- * @return PyObject* new instance of QBAFramework
+ * @param self an instance of QBAFramework
+ * @param args the argument values (attacker: QBAFArgument, attacked: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new Py_None, NULL in case of error
  */
-PyObject *
-QBAFramework_copy(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+static PyObject *
+QBAFramework_add_attack_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 {
-    PyObject *kwds = NULL;
-    PyObject *args = NULL;
+    static char *kwlist[] = {"attacker", "attacked", "require_acyclic", NULL};
+    PyObject *agent, *patient;
+    int require_acyclic = FALSE;
+    int contains;
 
-    QBAFrameworkObject *copy = (QBAFrameworkObject*) QBAFramework_new(Py_TYPE(self), args, kwds);
-    if (copy == NULL) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|p", kwlist,
+                                     &agent, &patient, &require_acyclic))
         return NULL;
-    }
 
-    Py_DECREF(copy->arguments);
-    copy->arguments = PySet_New(self->arguments);
-    if (copy->arguments == NULL) {
-        Py_DECREF(copy);
+    contains = PySet_Contains(self->arguments, agent);
+    if (contains < 0) {
         return NULL;
     }
-
-    Py_DECREF(copy->initial_strengths);
-    copy->initial_strengths = PyDict_Copy(self->initial_strengths);
-    if (copy->initial_strengths == NULL) {
-        Py_DECREF(copy);
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "argument attacker is not contained in the framework");
         return NULL;
     }
 
-    Py_DECREF(copy->attack_relations);
-    copy->attack_relations = QBAFARelations_copy((QBAFARelationsObject*)self->attack_relations, NULL);
-    if (copy->attack_relations == NULL) {
-        Py_DECREF(copy);
+    contains = PySet_Contains(self->arguments, patient);
+    if (contains < 0) {
         return NULL;
     }
-
-    Py_DECREF(copy->support_relations);
-    copy->support_relations = QBAFARelations_copy((QBAFARelationsObject*)self->support_relations, NULL);
-    if (copy->support_relations == NULL) {
-        Py_DECREF(copy);
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "argument attacked is not contained in the framework");
         return NULL;
     }
 
-    if (!self->modified) {
-        Py_DECREF(copy->final_strengths);
-        copy->final_strengths = PyDict_Copy(self->final_strengths);
-        if (copy->final_strengths == NULL) {
-            Py_DECREF(copy);
+    if (self->disjoint_relations) {
+        contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
+        if (contains < 0) {
+            return NULL;
+        }
+        if (contains) {
+            PyErr_SetString(PyExc_ValueError,
+                            "attack relation already exists as support relation");
             return NULL;
         }
     }
 
-    copy->modified = self->modified;
-    copy->disjoint_relations = self->disjoint_relations;
+    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (contains) {
+        Py_RETURN_NONE;
+    }
 
-    copy->semantics = self->semantics;
-    copy->aggregation_function = self->aggregation_function;
-    copy->influence_function = self->influence_function;
-    copy->min_strength = self->min_strength;
-    copy->max_strength = self->max_strength;
+    if (_QBAFramework_order_relation(self, agent, patient, require_acyclic) < 0) {
+        return NULL;
+    }
 
-    Py_XINCREF(self->aggregation_function_callable);
-    copy->aggregation_function_callable = self->aggregation_function_callable;
-    Py_XINCREF(self->influence_function_callable);
-    copy->influence_function_callable = self->influence_function_callable;
-    
-    return (PyObject*)copy;
+    if (_QBAFARelations_add((QBAFARelationsObject*) self->attack_relations, agent, patient) < 0) {
+        return NULL;
+    }
+
+    self->modified = TRUE;
+
+    Py_RETURN_NONE;
 }
 
 /**
- * @brief Return a list with the arguments that are being attacked/supported by Argument argument (itself included)
- * that are in a cycle, NULL if an error has occurred.
+ * @brief Add the Support relation (supporter, supported) to the Framework.
  * 
  * @param self an instance of QBAFramework
- * @param argument an instance of QBAFArgument
- * @param not_visited a PySet of QBAFArgument that have not been visited yet (this set is modified in this function)
- * @param visiting a PySet of QBAFArgument that are being visited within this function
- * @return PyObject* a new PyList of QBAFArgument objects that contain at least one cycle 
+ * @param args the argument values (supporter: QBAFArgument, supported: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new Py_None, NULL in case of error
  */
 static PyObject *
-_QBAFramework_incycle_arguments(QBAFrameworkObject *self, PyObject *argument, PyObject *not_visited, PyObject *visiting)
+QBAFramework_add_support_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 {
-    int contains = PySet_Contains(visiting, argument);
-    if (contains < 0) {
-        return NULL;
-    }
-    if (contains) { // If argument is being visited, do not visit it again but return it
-        PyObject *list = PyList_New(1);
-        if (list == NULL)
-            return NULL;
-        Py_INCREF(argument);
-        PyList_SET_ITEM(list, 0, argument);
-        return list;
-    }
+    static char *kwlist[] = {"supporter", "supported", "require_acyclic", NULL};
+    PyObject *agent, *patient;
+    int require_acyclic = FALSE;
+    int contains;
 
-    if (PySet_Add(visiting, argument) < 0) {    // We add the argument to visiting
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|p", kwlist,
+                                     &agent, &patient, &require_acyclic))
         return NULL;
-    }
-    PyObject *attack_patients, *support_patients;
-    PyObject *patients, *result, *previous_result, *incycle;
 
-    attack_patients = _QBAFARelations_patients((QBAFARelationsObject*)self->attack_relations, argument);
-    if (attack_patients == NULL) {
+    contains = PySet_Contains(self->arguments, agent);
+    if (contains < 0) {
         return NULL;
     }
-    support_patients = _QBAFARelations_patients((QBAFARelationsObject*)self->support_relations, argument);
-    if (support_patients == NULL) {
-        Py_DECREF(attack_patients);
-    }
-
-    patients = PyList_Concat(attack_patients, support_patients);
-    Py_DECREF(attack_patients);
-    Py_DECREF(support_patients);
-    if (patients == NULL) {
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "argument supporter is not contained in the framework");
         return NULL;
     }
 
-    result = PyList_New(0);
-    if (result == NULL) {
-        Py_DECREF(patients);
+    contains = PySet_Contains(self->arguments, patient);
+    if (contains < 0) {
         return NULL;
     }
-
-    PyObject *iterator = PyObject_GetIter(patients);
-    PyObject *item;
-
-    if (iterator == NULL) {
-        Py_DECREF(patients);
-        Py_DECREF(result);
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "argument supported is not contained in the framework");
         return NULL;
     }
 
-    while ((item = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        contains = PySet_Contains(not_visited, item);
+    if (self->disjoint_relations) {
+        contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
         if (contains < 0) {
-            Py_DECREF(patients); Py_DECREF(result);
-            Py_DECREF(iterator); Py_DECREF(item);
             return NULL;
         }
-
         if (contains) {
-            previous_result = result;
-            incycle = _QBAFramework_incycle_arguments(self, item, not_visited, visiting);
-            if (incycle == NULL) {
-                Py_DECREF(patients); Py_DECREF(previous_result);
-                Py_DECREF(iterator); Py_DECREF(item);
-                return NULL;
-            }
-
-            result = PyList_Concat(previous_result, incycle);
-            Py_DECREF(previous_result);
-            Py_DECREF(incycle);
-            if (result == NULL) {
-                Py_DECREF(patients);
-                Py_DECREF(iterator); Py_DECREF(item);
-                return NULL;
-            }
+            PyErr_SetString(PyExc_ValueError,
+                            "support relation already exists as attack relation");
+            return NULL;
         }
-
-        Py_DECREF(item);
     }
 
-    Py_DECREF(iterator);
-    Py_DECREF(patients);
+    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (contains) {
+        Py_RETURN_NONE;
+    }
 
-    if (PySet_Discard(not_visited, argument) < 0) { // We remove the argument from not visited
-        Py_DECREF(result);
+    if (_QBAFramework_order_relation(self, agent, patient, require_acyclic) < 0) {
         return NULL;
     }
 
-    if (PySet_Discard(visiting, argument) < 0) { // We remove the argument from visiting
-        Py_DECREF(result);
+    if (_QBAFARelations_add((QBAFARelationsObject*) self->support_relations, agent, patient) < 0) {
         return NULL;
     }
 
-    return result;
+    self->modified = TRUE;
+
+    Py_RETURN_NONE;
 }
 
 /**
- * @brief Return True if the relations of the Framework are acyclic, False if not,
- * -1 if an error has occurred.
+ * @brief Remove the Attack relation (attacker, attacked) from the Framework.
  * 
  * @param self an instance of QBAFramework
- * @return PyObject* 1 if acyclic, 0 if not acyclic, -1 if an error occurred
+ * @param args the argument values (attacker: QBAFArgument, attacked: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new Py_None, NULL in case of error
  */
-static inline int
-_QBAFramework_isacyclic(QBAFrameworkObject *self)
+static PyObject *
+QBAFramework_remove_attack_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 {
-    PyObject *not_visited, *visiting;
+    static char *kwlist[] = {"attacker", "attacked", NULL};
+    PyObject *agent, *patient;
+    int contains;
 
-    visiting = PySet_New(NULL); // New empty set
-    if (visiting == NULL)
-        return -1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
+                                     &agent, &patient))
+        return NULL;
 
-    not_visited = PySet_New(self->arguments);   // Copy of self->arguments
-    if (not_visited == NULL) {
-        Py_DECREF(visiting);
-        return -1;
+    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (!contains) {
+        Py_RETURN_NONE;
     }
 
-    PyObject *argument, *incycle;
+    if (_QBAFARelations_remove((QBAFARelationsObject*) self->attack_relations, agent, patient) < 0) {
+        return NULL;
+    }
 
-    while (PySet_GET_SIZE(not_visited) > 0) {
-        argument = PySet_Pop(not_visited);  // New reference. Unchecked errors
-        PySet_Add(not_visited, argument);   // We return the argument to the set
-        Py_DECREF(argument);
+    self->modified = TRUE;
 
-        incycle = _QBAFramework_incycle_arguments(self, argument, not_visited, visiting);
-        if (incycle == NULL) {
-            Py_DECREF(visiting); Py_DECREF(not_visited);
-            return -1;
+    Py_RETURN_NONE;
+}
+
+/**
+ * @brief Remove the Support relation (supporter, supported) from the Framework.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args the argument values (supporter: QBAFArgument, supported: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new Py_None, NULL in case of error
+ */
+static PyObject *
+QBAFramework_remove_support_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"supporter", "supported", NULL};
+    PyObject *agent, *patient;
+    int contains;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
+                                     &agent, &patient))
+        return NULL;
+
+    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (!contains) {
+        Py_RETURN_NONE;
+    }
+
+    if (_QBAFARelations_remove((QBAFARelationsObject*) self->support_relations, agent, patient) < 0) {
+        return NULL;
+    }
+
+    self->modified = TRUE;
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * @brief Return True if the argument is contained, False if it is not, NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args the argument values (argument: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyBool, NULL in case of error
+ */
+static PyObject *
+QBAFramework_contains_argument(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"argument", NULL};
+    PyObject *argument;
+    int contains;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &argument))
+        return NULL;
+
+    contains = PySet_Contains(self->arguments, argument);
+    if (contains < 0) {
+        return NULL;
+    }
+
+    if (contains) {
+        Py_RETURN_TRUE;
+    }
+
+    Py_RETURN_FALSE;
+}
+
+/**
+ * @brief Return True if the Attack relation is contained, False if it is not, NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args the argument values (attacker: QBAFArgument, attacked: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyBool, NULL in case of error
+ */
+static PyObject *
+QBAFramework_contains_attack_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"attacker", "attacked", NULL};
+    PyObject *agent, *patient;
+    int contains;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
+                                     &agent, &patient))
+        return NULL;
+
+    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->attack_relations, agent, patient);
+    if (contains < 0) {
+        return NULL;
+    }
+
+    if (contains) {
+        Py_RETURN_TRUE;
+    }
+
+    Py_RETURN_FALSE;
+}
+
+/**
+ * @brief Return True if the Support relation is contained, False if it is not, NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args the argument values (supporter: QBAFArgument, supported: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyBool, NULL in case of error
+ */
+static PyObject *
+QBAFramework_contains_support_relation(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"supporter", "supported", NULL};
+    PyObject *agent, *patient;
+    int contains;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|", kwlist,
+                                     &agent, &patient))
+        return NULL;
+
+    contains = _QBAFARelations_contains((QBAFARelationsObject*) self->support_relations, agent, patient);
+    if (contains < 0) {
+        return NULL;
+    }
+
+    if (contains) {
+        Py_RETURN_TRUE;
+    }
+
+    Py_RETURN_FALSE;
+}
+
+/**
+ * @brief Return the arguments that are attacked by the argument attacker,
+ * NULL (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self 
+ * @param args the argument values (attacker: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_attackedBy(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"attacker", NULL};
+    PyObject *attacker;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &attacker))
+        return NULL;
+
+    int contains = PySet_Contains(self->arguments, attacker);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "attacker must be an argument of the framework");
+        return NULL;
+    }
+
+    return _QBAFARelations_patients(self->attack_relations, attacker);
+}
+
+/**
+ * @brief Return the arguments that are attacking the argument attacked,
+ * NULL (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self 
+ * @param args the argument values (attacked: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_attackersOf(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"attacked", NULL};
+    PyObject *attacked;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &attacked))
+        return NULL;
+
+    int contains = PySet_Contains(self->arguments, attacked);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "attacked must be an argument of the framework");
+        return NULL;
+    }
+
+    return _QBAFARelations_agents(self->attack_relations, attacked);
+}
+
+/**
+ * @brief Return the arguments that are supported by the argument supporter,
+ * NULL (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self 
+ * @param args the argument values (supporter: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_supportedBy(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"supporter", NULL};
+    PyObject *supporter;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &supporter))
+        return NULL;
+
+    int contains = PySet_Contains(self->arguments, supporter);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "supporter must be an argument of the framework");
+        return NULL;
+    }
+
+    return _QBAFARelations_patients(self->support_relations, supporter);
+}
+
+/**
+ * @brief Return the arguments that are supporting the argument supported,
+ * NULL (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self 
+ * @param args the argument values (supported: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_supportersOf(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"supported", NULL};
+    PyObject *supported;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &supported))
+        return NULL;
+
+    int contains = PySet_Contains(self->arguments, supported);
+    if (contains < 0) {
+        return NULL;
+    }
+    if (!contains) {
+        PyErr_SetString(PyExc_ValueError,
+                        "supported must be an argument of the framework");
+        return NULL;
+    }
+
+    return _QBAFARelations_agents(self->support_relations, supported);
+}
+
+/**
+ * @brief Return a shallow copy of this instance.
+ * New references are created for the copy, except for the QBAFArgument and QBAFARelations.
+ * 
+ * @param self instance of QBAFramework
+ * @param Py_UNUSED 
+ * @return PyObject* new instance of QBAFramework
+ */
+PyObject *
+QBAFramework_copy(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *kwds = NULL;
+    PyObject *args = NULL;
+
+    QBAFrameworkObject *copy = (QBAFrameworkObject*) QBAFramework_new(Py_TYPE(self), args, kwds);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    Py_DECREF(copy->arguments);
+    copy->arguments = PySet_New(self->arguments);
+    if (copy->arguments == NULL) {
+        Py_DECREF(copy);
+        return NULL;
+    }
+
+    Py_DECREF(copy->initial_strengths);
+    copy->initial_strengths = PyDict_Copy(self->initial_strengths);
+    if (copy->initial_strengths == NULL) {
+        Py_DECREF(copy);
+        return NULL;
+    }
+
+    Py_DECREF(copy->attack_relations);
+    copy->attack_relations = QBAFARelations_CopyWithSymbols((QBAFARelationsObject*)self->attack_relations, NULL);
+    if (copy->attack_relations == NULL) {
+        Py_DECREF(copy);
+        return NULL;
+    }
+
+    Py_DECREF(copy->support_relations);
+    copy->support_relations = QBAFARelations_CopyWithSymbols((QBAFARelationsObject*)self->support_relations,
+                                                              (QBAFARelationsObject*)copy->attack_relations);
+    if (copy->support_relations == NULL) {
+        Py_DECREF(copy);
+        return NULL;
+    }
+
+    if (!self->modified) {
+        if (_QBAFramework_check_idle(self) < 0) {
+            Py_DECREF(copy);
+            return NULL;
+        }
+        copy->graph = QBAFGraph_Copy(self->graph);
+        if (copy->graph == NULL) {
+            Py_DECREF(copy);
+            return NULL;
+        }
+    }
+
+    if (self->order != NULL) {
+        copy->order = QBAFOrder_Copy(self->order);
+        if (copy->order == NULL) {
+            Py_DECREF(copy);
+            return NULL;
+        }
+    }
+
+    copy->modified = self->modified;
+    copy->disjoint_relations = self->disjoint_relations;
+    copy->threads = self->threads;
+    copy->fast_math = self->fast_math;
+
+    copy->semantics = self->semantics;
+    copy->aggregation_function = self->aggregation_function;
+    copy->aggregation_array_function = self->aggregation_array_function;
+    copy->influence_function = self->influence_function;
+    copy->min_strength = self->min_strength;
+    copy->max_strength = self->max_strength;
+
+    Py_XINCREF(self->aggregation_function_callable);
+    copy->aggregation_function_callable = self->aggregation_function_callable;
+    Py_XINCREF(self->influence_function_callable);
+    copy->influence_function_callable = self->influence_function_callable;
+    
+    return (PyObject*)copy;
+}
+
+/**
+ * @brief Return True if the relations of the Framework are acyclic, False if not,
+ * NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param Py_UNUSED 
+ * @return PyObject* new PyBool.
+ */
+static PyObject *
+QBAFramework_isacyclic(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+{
+    int isacyclic = _QBAFramework_isacyclic(self);
+    if (isacyclic < 0) {
+        return NULL;
+    }
+
+    if (isacyclic)
+        Py_RETURN_TRUE;
+        
+    Py_RETURN_FALSE;
+}
+
+/**
+ * @brief Return a list with the arguments of a cycle of the Framework, None if it is acyclic,
+ * NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param Py_UNUSED 
+ * @return PyObject* new PyList of QBAFArgument or Py_None, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_find_cycle(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
+    }
+
+    return QBAFGraph_FindCycle(self->graph);
+}
+
+/**
+ * @brief Return a list with the strongly connected components of the Framework in topological order,
+ * NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param Py_UNUSED 
+ * @return PyObject* new PyList of PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_strongly_connected_components(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
+    }
+    QBAFGraph *graph = self->graph;
+    if (QBAFGraph_ComputeComponents(graph) < 0) {
+        return NULL;
+    }
+
+    PyObject *components = PyList_New(graph->component_count);
+    if (components == NULL) {
+        return NULL;
+    }
+    for (Py_ssize_t component = 0; component < graph->component_count; component++) {
+        Py_ssize_t start = graph->component_offsets[component];
+        PyObject *list = PyList_New(graph->component_offsets[component + 1] - start);
+        if (list == NULL) {
+            Py_DECREF(components);
+            return NULL;
+        }
+        for (Py_ssize_t position = start; position < graph->component_offsets[component + 1]; position++) {
+            PyObject *argument = PyList_GET_ITEM(graph->arguments, graph->component_members[position]);
+            Py_INCREF(argument);
+            PyList_SET_ITEM(list, position - start, argument);
+        }
+        PyList_SET_ITEM(components, component, list);
+    }
+
+    return components;
+}
+
+/**
+ * @brief Return a list with the topological levels of the Framework, NULL if an error has occurred.
+ * The arguments of a level are only attacked/supported by arguments of previous levels.
+ * 
+ * @param self an instance of QBAFramework
+ * @param closure 
+ * @return PyObject* a new PyList of PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_getevaluation_order(QBAFrameworkObject *self, void *closure)
+{
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
+    }
+    if (!QBAFGraph_IsAcyclic(self->graph)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "the evaluation order of a non-acyclic framework is not defined");
+        return NULL;
+    }
+
+    return QBAFGraph_LevelsAsList(self->graph);
+}
+
+/**
+ * @brief Return 1 if the semantics of self are evaluated without Python objects (built-in semantics), 0 if not.
+ * 
+ * @param self an instance of QBAFramework
+ * @return int 1 if the semantics are built-in, 0 if not
+ */
+static inline int
+_QBAFramework_builtin_semantics(QBAFrameworkObject *self)
+{
+    return self->aggregation_array_function != NULL && self->influence_function != NULL;
+}
+
+/**
+ * @brief Return the strength of the argument with index index in the compiled graph that results from
+ * applying the semantics to the strengths of its attackers and supporters, -1.0 if an error occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param graph the compiled QBAFGraph of self
+ * @param index the index of the argument
+ * @param initial_strengths the initial strengths of the arguments (size graph->size)
+ * @param strengths the current strengths of the arguments (size graph->size)
+ * @return double the new strength, -1.0 if an error has occurrred
+ */
+static double
+_QBAFramework_calculate_final_strength(QBAFrameworkObject *self, QBAFGraph *graph, Py_ssize_t index,
+                                       const double *initial_strengths, const double *strengths)
+{
+    // Built-in semantics aggregate the strengths without Python objects
+    if (self->aggregation_array_function != NULL) {
+        double aggregation = QBAFGraph_Aggregate(graph, index, strengths, self->aggregation_array_function, graph->buffer);
+        // The batched influence yields the same values as the evaluation of the whole framework
+        QBAFBatchInfluence batch = batch_influence_function(self->influence_function, self->fast_math);
+        if (batch != NULL) {
+            double final_strength;
+            batch(&initial_strengths[index], &aggregation, &final_strength, 1);
+            return final_strength;
+        }
+        return _QBAFramework_influence_function(self, initial_strengths[index], aggregation);
+    }
+
+    // Obtain final strength of attackers
+    Py_ssize_t start = graph->attackers_offsets[index];
+    Py_ssize_t end = graph->attackers_offsets[index + 1];
+    PyObject *attacker_strengths = PyList_New(end - start);
+    if (attacker_strengths == NULL) {
+        return -1.0;
+    }
+    for (Py_ssize_t position = start; position < end; position++) {
+        PyObject *pystrength = PyFloat_FromDouble(strengths[graph->attackers[position]]);
+        if (pystrength == NULL) {
+            Py_DECREF(attacker_strengths);
+            return -1.0;
+        }
+        PyList_SET_ITEM(attacker_strengths, position - start, pystrength);
+    }
+
+    // Obtain final strength of supporters
+    start = graph->supporters_offsets[index];
+    end = graph->supporters_offsets[index + 1];
+    PyObject *supporter_strengths = PyList_New(end - start);
+    if (supporter_strengths == NULL) {
+        Py_DECREF(attacker_strengths);
+        return -1.0;
+    }
+    for (Py_ssize_t position = start; position < end; position++) {
+        PyObject *pystrength = PyFloat_FromDouble(strengths[graph->supporters[position]]);
+        if (pystrength == NULL) {
+            Py_DECREF(attacker_strengths);
+            Py_DECREF(supporter_strengths);
+            return -1.0;
+        }
+        PyList_SET_ITEM(supporter_strengths, position - start, pystrength);
+    }
+
+    // Obtain result from aggregation function
+    double aggregation = _QBAFramework_aggregation_function(self, attacker_strengths, supporter_strengths);
+    Py_DECREF(attacker_strengths);
+    Py_DECREF(supporter_strengths);
+    if (aggregation == -1.0 && PyErr_Occurred()) {
+        return -1.0;
+    }
+
+    // calculate final strength;
+    return _QBAFramework_influence_function(self, initial_strengths[index], aggregation);
+}
+
+/**
+ * @brief Store in next the result of applying the semantics to every argument with the strengths current,
+ * i.e. next[i] = update(current)[i] - current[i] (if derivative) or next[i] = update(current)[i] (if not).
+ * Return the maximum absolute difference between update(current) and current, -1.0 if an error occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param graph the compiled QBAFGraph of self
+ * @param current the current strengths (size graph->size)
+ * @param next the array where the result is stored (size graph->size, different from current)
+ * @param derivative 1 if the derivative of the continuous-time model must be stored, 0 if not
+ * @return double the maximum change, -1.0 if an error occurred
+ */
+static double
+_QBAFramework_solver_sweep(QBAFrameworkObject *self, QBAFGraph *graph, const double *current, double *next, int derivative)
+{
+    double residual = 0.0;
+
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        double strength = _QBAFramework_calculate_final_strength(self, graph, index, graph->initial_strengths, current);
+        if (strength == -1.0 && PyErr_Occurred()) {
+            return -1.0;
+        }
+        double change = strength - current[index];
+        next[index] = derivative ? change : strength;
+        if (!(fabs(change) <= residual))    // It also propagates NaN
+            residual = fabs(change);
+    }
+
+    return residual;
+}
+
+/**
+ * @brief Approximate the final strengths of the arguments of the Framework with an iterative method,
+ * starting from the initial strengths. It can be used with cyclic frameworks.
+ * If converged, the approximation is stored as the final strengths of self->graph.
+ * Return 1 if the method converged, 0 if it did not, -1 if an error occurred.
+ * 
+ * @param self the QBAFramework (compiled)
+ * @param method one of the strings STR_JACOBI, STR_GAUSS_SEIDEL, STR_EULER or STR_RK4
+ * @param tolerance the method has converged when the maximum change of a strength in an iteration is lower than tolerance
+ * @param max_iterations maximum number of iterations
+ * @param damping factor in (0, 1] that weights the new strengths in Jacobi/Gauss-Seidel sweeps
+ * @param step_size time step of the Euler/RK4 integration
+ * @param iterations a pointer where the number of iterations performed is stored
+ * @return int 1 if converged, 0 if not converged, -1 if an error occurred
+ */
+static int
+_QBAFramework_solve(QBAFrameworkObject *self, const char *method, double tolerance, Py_ssize_t max_iterations,
+                    double damping, double step_size, Py_ssize_t *iterations)
+{
+    QBAFGraph *graph = self->graph;
+    Py_ssize_t size = graph->size;
+    int rk4 = streq(method, STR_RK4);
+
+    // Workspace: current strengths, next strengths and the stages of RK4
+    double *workspace = PyMem_Malloc((rk4 ? 7 : 2) * size * sizeof(double) + 1);
+    if (workspace == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    double *current = workspace, *next = workspace + size;
+    memcpy(current, graph->initial_strengths, size * sizeof(double));
+
+    int converged = FALSE;
+    double residual = 0.0;
+    *iterations = 0;
+
+    while (!converged && *iterations < max_iterations && isfinite(residual)) {
+        if (streq(method, STR_JACOBI)) {
+            residual = _QBAFramework_solver_sweep(self, graph, current, next, FALSE);
+            if (residual < 0.0)
+                goto error;
+            for (Py_ssize_t index = 0; index < size; index++)
+                current[index] += damping * (next[index] - current[index]);
+        }
+        else if (streq(method, STR_GAUSS_SEIDEL)) {
+            residual = 0.0;
+            for (Py_ssize_t index = 0; index < size; index++) {
+                double strength = _QBAFramework_calculate_final_strength(self, graph, index, graph->initial_strengths, current);
+                if (strength == -1.0 && PyErr_Occurred())
+                    goto error;
+                double change = strength - current[index];
+                current[index] += damping * change;
+                if (!(fabs(change) <= residual))
+                    residual = fabs(change);
+            }
+        }
+        else if (streq(method, STR_EULER)) {
+            residual = _QBAFramework_solver_sweep(self, graph, current, next, TRUE);
+            if (residual < 0.0)
+                goto error;
+            for (Py_ssize_t index = 0; index < size; index++)
+                current[index] += step_size * next[index];
+        }
+        else {  // RK4
+            double *k1 = next, *k2 = workspace + 2 * size, *k3 = workspace + 3 * size;
+            double *k4 = workspace + 4 * size, *stage = workspace + 5 * size;
+
+            residual = _QBAFramework_solver_sweep(self, graph, current, k1, TRUE);
+            if (residual < 0.0)
+                goto error;
+            for (Py_ssize_t index = 0; index < size; index++)
+                stage[index] = current[index] + 0.5 * step_size * k1[index];
+            if (_QBAFramework_solver_sweep(self, graph, stage, k2, TRUE) < 0.0)
+                goto error;
+            for (Py_ssize_t index = 0; index < size; index++)
+                stage[index] = current[index] + 0.5 * step_size * k2[index];
+            if (_QBAFramework_solver_sweep(self, graph, stage, k3, TRUE) < 0.0)
+                goto error;
+            for (Py_ssize_t index = 0; index < size; index++)
+                stage[index] = current[index] + step_size * k3[index];
+            if (_QBAFramework_solver_sweep(self, graph, stage, k4, TRUE) < 0.0)
+                goto error;
+            for (Py_ssize_t index = 0; index < size; index++)
+                current[index] += step_size / 6.0 * (k1[index] + 2.0 * k2[index] + 2.0 * k3[index] + k4[index]);
+        }
+
+        (*iterations)++;
+        converged = residual < tolerance;
+    }
+
+    if (converged) {
+        if (QBAFGraph_Unshare(graph) < 0) {
+            goto error;
+        }
+        memcpy(graph->final_strengths, current, size * sizeof(double));
+        QBAFGraph_ClearDirty(graph);
+        graph->evaluated = TRUE;
+    }
+
+    PyMem_Free(workspace);
+    return converged;
+
+error:
+    PyMem_Free(workspace);
+    return -1;
+}
+
+/**
+ * @brief Approximate the final strengths of the arguments of a strongly connected component of the Framework
+ * with Jacobi sweeps restricted to its members, starting from their initial strengths.
+ * The final strengths of the previous components must have been calculated.
+ * Return 1 if the method converged, 0 if it did not, -1 if an error occurred.
+ * 
+ * @param self the QBAFramework (compiled)
+ * @param members the indices of the arguments of the component
+ * @param count the number of arguments of the component
+ * @param next a scratch array of size count
+ * @param iterations a pointer where the number of iterations performed is stored
+ * @return int 1 if converged, 0 if not converged, -1 if an error occurred
+ */
+static int
+_QBAFramework_solve_component(QBAFrameworkObject *self, const Py_ssize_t *members, Py_ssize_t count,
+                              double *next, Py_ssize_t *iterations)
+{
+    QBAFGraph *graph = self->graph;
+    double *strengths = graph->final_strengths;
+    double residual = 0.0;
+
+    for (Py_ssize_t member = 0; member < count; member++)
+        strengths[members[member]] = graph->initial_strengths[members[member]];
+
+    for (*iterations = 0; *iterations < DEFAULT_MAX_ITERATIONS && isfinite(residual); ) {
+        residual = 0.0;
+        for (Py_ssize_t member = 0; member < count; member++) {
+            Py_ssize_t index = members[member];
+            double strength = _QBAFramework_calculate_final_strength(self, graph, index, graph->initial_strengths, strengths);
+            if (strength == -1.0 && PyErr_Occurred()) {
+                return -1;
+            }
+            double change = strength - strengths[index];
+            next[member] = change;
+            if (!(fabs(change) <= residual))    // It also propagates NaN
+                residual = fabs(change);
+        }
+        for (Py_ssize_t member = 0; member < count; member++)
+            strengths[members[member]] += DEFAULT_DAMPING * next[member];
+
+        (*iterations)++;
+        if (residual < DEFAULT_TOLERANCE)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Return 1 if the argument with index index attacks or supports itself, 0 if not.
+ * 
+ * @param graph a QBAFGraph
+ * @param index the index of the argument
+ * @return int 1 if the argument is one of its own agents, 0 if not
+ */
+static inline int
+_QBAFramework_self_dependent(QBAFGraph *graph, Py_ssize_t index)
+{
+    for (Py_ssize_t position = graph->dependents_offsets[index]; position < graph->dependents_offsets[index + 1]; position++) {
+        if (graph->dependents[position] == index)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * @brief Calculate the final strengths of the arguments of a non-acyclic Framework.
+ * The strongly connected components are evaluated in topological order (the condensation of the graph):
+ * an argument that does not belong to any cycle is evaluated directly, and the arguments of a cycle
+ * are approximated with Jacobi sweeps restricted to their component.
+ * It stores all the calculated final strengths in self->graph.
+ * 
+ * @param self the QBAFramework (compiled)
+ * @return int 0 if succesful, -1 if an error occurred
+ */
+static int
+_QBAFramework_calculate_components(QBAFrameworkObject *self)
+{
+    QBAFGraph *graph = self->graph;
+
+    if (QBAFGraph_ComputeComponents(graph) < 0 || QBAFGraph_Unshare(graph) < 0) {
+        return -1;
+    }
+
+    Py_ssize_t largest = 1;
+    for (Py_ssize_t component = 0; component < graph->component_count; component++) {
+        Py_ssize_t count = graph->component_offsets[component + 1] - graph->component_offsets[component];
+        if (count > largest)
+            largest = count;
+    }
+    double *next = PyMem_Malloc(largest * sizeof(double));
+    if (next == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (Py_ssize_t component = 0; component < graph->component_count; component++) {
+        const Py_ssize_t *members = &graph->component_members[graph->component_offsets[component]];
+        Py_ssize_t count = graph->component_offsets[component + 1] - graph->component_offsets[component];
+
+        if (count == 1 && !_QBAFramework_self_dependent(graph, members[0])) {
+            double final_strength = _QBAFramework_calculate_final_strength(self, graph, members[0], graph->initial_strengths, graph->final_strengths);
+            if (final_strength == -1.0 && PyErr_Occurred()) {
+                goto error;
+            }
+            graph->final_strengths[members[0]] = final_strength;
+            continue;
+        }
+
+        Py_ssize_t iterations;
+        int converged = _QBAFramework_solve_component(self, members, count, next, &iterations);
+        if (converged < 0) {
+            goto error;
+        }
+        if (!converged) {
+            PyErr_Format(PyExc_RuntimeError,
+                         "the final strengths of a cycle of %zd arguments did not converge after %zd iterations",
+                         count, iterations);
+            goto error;
+        }
+    }
+
+    PyMem_Free(next);
+    QBAFGraph_ClearDirty(graph);
+    graph->evaluated = TRUE;
+    return 0;
+
+error:
+    PyMem_Free(next);
+    return -1;
+}
+
+/**
+ * @brief Calculate the final strengths of all the arguments of the Framework.
+ * If the Framework is acyclic, the arguments are evaluated level by level following
+ * the topological order of the compiled graph. Otherwise, the strongly connected components
+ * are evaluated in topological order, iterating only inside the cycles.
+ * It stores all the calculated final strengths in self->graph.
+ * 
+ * @param self the QBAFramework (compiled)
+ * @return int 0 if succesful, -1 if an error occurred
+ */
+static int
+_QBAFRamework_calculate_final_strengths(QBAFrameworkObject *self)
+{
+    QBAFGraph *graph = self->graph;
+
+    if (!QBAFGraph_IsAcyclic(graph)) {
+        return _QBAFramework_calculate_components(self);
+    }
+
+    if (QBAFGraph_Unshare(graph) < 0) {
+        return -1;
+    }
+
+    // Built-in semantics are evaluated without Python objects (in parallel and with SIMD influence)
+    if (self->aggregation_array_function != NULL && self->influence_function != NULL) {
+        if (QBAFParallel_Evaluate(graph, self->aggregation_array_function, self->influence_function,
+                                  self->fast_math, self->threads) < 0) {
+            return -1;
+        }
+        graph->evaluated = TRUE;
+        return 0;
+    }
+
+    for (Py_ssize_t position = 0; position < graph->ordered; position++) {
+        Py_ssize_t index = graph->order[position];
+        double final_strength = _QBAFramework_calculate_final_strength(self, graph, index, graph->initial_strengths, graph->final_strengths);
+        if (final_strength == -1.0 && PyErr_Occurred()) {
+            return -1;
+        }
+        graph->final_strengths[index] = final_strength;
+    }
+    graph->evaluated = TRUE;
+
+    return 0;
+}
+
+/**
+ * @brief Recalculate the final strengths of the dirty arguments of the (acyclic) Framework
+ * following the topological order. The dependents of an argument are only marked as dirty
+ * if its new final strength is not bit-identical to the previous one (early cutoff).
+ * If an error occurs, the final strengths are invalidated.
+ * 
+ * @param self the QBAFramework (compiled and evaluated)
+ * @return int 0 if succesful, -1 if an error occurred
+ */
+static int
+_QBAFramework_update_final_strengths(QBAFrameworkObject *self)
+{
+    QBAFGraph *graph = self->graph;
+
+    if (QBAFGraph_Unshare(graph) < 0) {
+        return -1;
+    }
+
+    for (Py_ssize_t position = graph->dirty_first; QBAFGraph_IsDirty(graph); position++) {
+        Py_ssize_t index = graph->order[position];
+        if (!graph->dirty[index])
+            continue;
+
+        double final_strength = _QBAFramework_calculate_final_strength(self, graph, index, graph->initial_strengths, graph->final_strengths);
+        if (final_strength == -1.0 && PyErr_Occurred()) {
+            QBAFGraph_ClearDirty(graph);
+            graph->evaluated = FALSE;
+            return -1;
         }
-        if (PyList_GET_SIZE(incycle) > 0) { // If detected cycle
-            Py_DECREF(visiting); Py_DECREF(not_visited);
-            Py_DECREF(incycle);
-            return 0; // Return False
+        graph->dirty[index] = FALSE;
+        graph->dirty_count--;
+
+        if (memcmp(&final_strength, &graph->final_strengths[index], sizeof(double)) != 0) {
+            graph->final_strengths[index] = final_strength;
+            for (Py_ssize_t dependent = graph->dependents_offsets[index]; dependent < graph->dependents_offsets[index + 1]; dependent++)
+                QBAFGraph_MarkDirty(graph, graph->dependents[dependent]);
         }
-        Py_DECREF(incycle);
     }
+    graph->dirty_first = graph->size;
 
-    Py_DECREF(visiting);
-    Py_DECREF(not_visited);
-
-    return 1;   // Return True
+    return 0;
 }
 
 /**
- * @brief Return True if the relations of the Framework are acyclic, False if not,
- * NULL if an error has occurred.
+ * @brief Calculate the final strengths of the Framework if it has been modified
+ * from the last time they were calculated.
  * 
- * @param self an instance of QBAFramework
- * @param Py_UNUSED 
- * @return PyObject* new PyBool.
+ * @param self the QBAFramework
+ * @return int 0 if succesful, -1 if an error occurred
  */
-static PyObject *
-QBAFramework_isacyclic(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+static inline int
+_QBAFramework_evaluate(QBAFrameworkObject *self)
 {
-    int isacyclic = _QBAFramework_isacyclic(self);
-    if (isacyclic < 0) {
-        return NULL;
+    if (_QBAFramework_compile(self) < 0) {
+        return -1;
     }
-
-    if (isacyclic)
-        Py_RETURN_TRUE;
-        
-    Py_RETURN_FALSE;
+    // The graph must not be replaced or modified while the threads evaluate it without the GIL
+    // or while the Python semantics are called
+    int result = 0;
+    self->busy++;
+    if (!self->graph->evaluated) {   // Calculate final strengths if the framework has been modified
+        result = _QBAFRamework_calculate_final_strengths(self);
+    }
+    else if (QBAFGraph_IsDirty(self->graph)) {  // Recalculate only the arguments affected by the modifications
+        result = _QBAFramework_update_final_strengths(self);
+    }
+    self->busy--;
+    return result;
 }
 
 /**
- * @brief Return the final strength of a specific argument, -1.0 if an error occurred.
- * This function calls itself recursively. So, it only works with acyclic arguments.
- * It stores all the calculated final strengths in self.__final_strengths.
+ * @brief Approximate the final strengths of the Framework with an iterative method and return
+ * a tuple (converged: bool, iterations: int), NULL if an error occurred.
  * 
  * @param self an instance of QBAFramework
- * @param argument the QBAFArgument
- * @return PyObject* borrowed PyFloat reference, -1.0 if an error has occurrred
+ * @param args the argument values (method: str, tolerance: float, max_iterations: int, damping: float, step_size: float)
+ * @param kwds the argument names
+ * @return PyObject* new PyTuple, NULL if an error occurred
  */
-static double
-_QBAFramework_calculate_final_strength(QBAFrameworkObject *self, PyObject *argument)
+static PyObject *
+QBAFramework_solve(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 {
+    static char *kwlist[] = {"method", "tolerance", "max_iterations", "damping", "step_size", NULL};
+    const char *method = STR_JACOBI;
+    double tolerance = DEFAULT_TOLERANCE, damping = DEFAULT_DAMPING, step_size = DEFAULT_STEP_SIZE;
+    Py_ssize_t max_iterations = DEFAULT_MAX_ITERATIONS;
 
-    // Check if it has been calculated already
-    int contains = PyDict_Contains(self->final_strengths, argument);
-    if (contains < 0) {
-        return -1.0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sdndd", kwlist,
+                                     &method, &tolerance, &max_iterations, &damping, &step_size))
+        return NULL;
+
+    if (!streq(method, STR_JACOBI) && !streq(method, STR_GAUSS_SEIDEL) &&
+        !streq(method, STR_EULER) && !streq(method, STR_RK4)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "method must be 'jacobi', 'gauss_seidel', 'euler' or 'rk4'");
+        return NULL;
     }
-    if (contains) {
-        return PyFloat_AsDouble(PyDict_GetItem(self->final_strengths, argument));
+    if (!(tolerance > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "tolerance must be greater than 0");
+        return NULL;
+    }
+    if (max_iterations < 0) {
+        PyErr_SetString(PyExc_ValueError, "max_iterations must be non-negative");
+        return NULL;
+    }
+    if (!(damping > 0.0 && damping <= 1.0)) {
+        PyErr_SetString(PyExc_ValueError, "damping must be in (0, 1]");
+        return NULL;
+    }
+    if (!(step_size > 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "step_size must be greater than 0");
+        return NULL;
     }
 
-    // Obtain final strength of attackers
-    PyObject *attackers = _QBAFARelations_agents((QBAFARelationsObject*)self->attack_relations, argument);
-    if (attackers == NULL) {
-        return -1.0;
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
     }
 
-    PyObject *iterator = PyObject_GetIter(attackers);
-    PyObject *item;
+    // The final strengths of an acyclic framework are exact: they are calculated following its schedule
+    if (QBAFGraph_IsAcyclic(self->graph)) {
+        if (_QBAFramework_evaluate(self) < 0) {
+            return NULL;
+        }
+        return Py_BuildValue("(Nn)", PyBool_FromLong(TRUE), (Py_ssize_t) 0);
+    }
 
-    if (iterator == NULL) {
-        Py_DECREF(attackers);
-        return -1.0;
+    Py_ssize_t iterations;
+    self->busy++;   // The Python semantics must not replace or modify the graph
+    int converged = _QBAFramework_solve(self, method, tolerance, max_iterations, damping, step_size, &iterations);
+    self->busy--;
+    if (converged < 0) {
+        return NULL;
     }
-    Py_ssize_t size = PyObject_Size(attackers);
-    if (size == -1) {
-        Py_DECREF(attackers);
-        Py_DECREF(iterator);
-        return -1.0;
+    if (!converged) {
+        if (PyErr_WarnFormat(PyExc_RuntimeWarning, 1,
+                             "the method '%s' did not converge after %zd iterations, "
+                             "the final strengths have not been modified", method, iterations) < 0) {
+            return NULL;
+        }
     }
 
-    PyObject *attacker_strengths = PyList_New(size);
-    if (attacker_strengths == NULL) {
-        Py_DECREF(attackers);
-        Py_DECREF(iterator);
-        return -1.0;
+    return Py_BuildValue("(Nn)", PyBool_FromLong(converged), iterations);
+}
+
+/**
+ * @brief Return a new array (rows x size, row-major) with the initial strengths of matrix,
+ * a 2-D C-contiguous buffer of doubles or a sequence of sequences of numbers, NULL if an error occurred.
+ * 
+ * @param matrix the initial strengths of every row
+ * @param size the number of columns (arguments)
+ * @param rows a pointer where the number of rows is stored
+ * @return double* a new array (free it with PyMem_Free), NULL if an error occurred
+ */
+static double *
+_QBAFramework_batch_matrix(PyObject *matrix, Py_ssize_t size, Py_ssize_t *rows)
+{
+    double *strengths;
+
+    if (PyObject_CheckBuffer(matrix)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(matrix, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            return NULL;
+        }
+        const char *format = view.format;
+        if (format[0] == '@' || format[0] == '=')
+            format++;
+        if (view.ndim != 2 || strcmp(format, "d") != 0 || view.shape[1] != size) {
+            PyErr_SetString(PyExc_ValueError,
+                            "initial_strengths must be a 2-D buffer of float64 with a column for every argument");
+            PyBuffer_Release(&view);
+            return NULL;
+        }
+        *rows = view.shape[0];
+        strengths = PyMem_Malloc(*rows * size * sizeof(double) + 1);
+        if (strengths == NULL) {
+            PyBuffer_Release(&view);
+            PyErr_NoMemory();
+            return NULL;
+        }
+        memcpy(strengths, view.buf, *rows * size * sizeof(double));
+        PyBuffer_Release(&view);
+        return strengths;
     }
-    
-    Py_ssize_t index = 0;
-    while ((item = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        double strength = _QBAFramework_calculate_final_strength(self, item);
-        Py_DECREF(item);
-        if (strength == -1.0 && PyErr_Occurred()) {
-            Py_DECREF(iterator);
-            Py_DECREF(attackers);
-            Py_DECREF(attacker_strengths);
-            return -1.0;
+
+    PyObject *sequence = PySequence_Fast(matrix, "initial_strengths must be a buffer or a sequence of sequences");
+    if (sequence == NULL) {
+        return NULL;
+    }
+    *rows = PySequence_Fast_GET_SIZE(sequence);
+    if (size > 0 && *rows > PY_SSIZE_T_MAX / (Py_ssize_t) sizeof(double) / size) {
+        Py_DECREF(sequence);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    strengths = PyMem_Malloc(*rows * size * sizeof(double) + 1);
+    if (strengths == NULL) {
+        Py_DECREF(sequence);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (Py_ssize_t row = 0; row < *rows; row++) {
+        PyObject *items = PySequence_Fast(PySequence_Fast_GET_ITEM(sequence, row),
+                                          "initial_strengths must be a buffer or a sequence of sequences");
+        if (items == NULL) {
+            goto error;
+        }
+        if (PySequence_Fast_GET_SIZE(items) != size) {
+            PyErr_SetString(PyExc_ValueError,
+                            "every row of initial_strengths must have an initial strength for every argument");
+            Py_DECREF(items);
+            goto error;
         }
+        for (Py_ssize_t index = 0; index < size; index++) {
+            PyObject *item = PySequence_Fast_GET_ITEM(items, index);
+            if (!PyFloat_Check(item) && !PyLong_Check(item)) {
+                PyErr_SetString(PyExc_TypeError, "initial_strengths must be of a numeric type");
+                Py_DECREF(items);
+                goto error;
+            }
+            strengths[row * size + index] = PyFloat_AsDouble(item);
+            if (strengths[row * size + index] == -1.0 && PyErr_Occurred()) {
+                Py_DECREF(items);
+                goto error;
+            }
+        }
+        Py_DECREF(items);
+    }
+    Py_DECREF(sequence);
+    return strengths;
 
-        PyList_SET_ITEM(attacker_strengths, index, PyFloat_FromDouble(strength));
+error:
+    Py_DECREF(sequence);
+    PyMem_Free(strengths);
+    return NULL;
+}
 
-        index++;
-    }
+/**
+ * @brief Calculate the final strengths of the (acyclic) Framework for every row of initial strengths
+ * reusing the compiled graph, and return them as a 2-D memoryview (rows x arguments), NULL if an error occurred.
+ * The columns follow the order of indexed_arguments.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args the argument values (initial_strengths: buffer or sequence of sequences)
+ * @param kwds the argument names
+ * @return PyObject* new memoryview of float64, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_evaluate_batch(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"initial_strengths", NULL};
+    PyObject *matrix;
 
-    Py_DECREF(iterator);
-    Py_DECREF(attackers);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &matrix))
+        return NULL;
 
-    // Obtain final strength of supporters
-    PyObject *supporters = _QBAFARelations_agents((QBAFARelationsObject*)self->support_relations, argument);
-    if (supporters == NULL) {
-        Py_DECREF(attacker_strengths);
-        return -1.0;
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
+    }
+    QBAFGraph *graph = self->graph;
+    if (!QBAFGraph_IsAcyclic(graph)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "the batch evaluation of a non-acyclic framework is not supported");
+        return NULL;
     }
-    iterator = PyObject_GetIter(supporters);
+    Py_ssize_t size = graph->size, rows;
 
-    if (iterator == NULL) {
-        Py_DECREF(attacker_strengths);
-        Py_DECREF(supporters);
-        return -1.0;
+    double *initial_strengths = _QBAFramework_batch_matrix(matrix, size, &rows);
+    if (initial_strengths == NULL) {
+        return NULL;
     }
-    size = PyObject_Size(supporters);
-    if (size == -1) {
-        Py_DECREF(attacker_strengths);
-        Py_DECREF(iterator);
-        Py_DECREF(supporters);
-        return -1.0;
+    if (rows == 0 || size == 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "initial_strengths must have at least one row and the framework at least one argument");
+        PyMem_Free(initial_strengths);
+        return NULL;
+    }
+    for (Py_ssize_t position = 0; position < rows * size; position++) {
+        // NaN is not within range either
+        if (!(initial_strengths[position] >= self->min_strength && initial_strengths[position] <= self->max_strength)) {
+            _QBAFramework_range_error(self, "initial_strength");
+            PyMem_Free(initial_strengths);
+            return NULL;
+        }
     }
 
-    PyObject *supporter_strengths = PyList_New(size);
-    if (supporter_strengths == NULL) {
-        Py_DECREF(attacker_strengths);
-        Py_DECREF(iterator);
-        Py_DECREF(supporters);
-        return -1.0;
+    PyObject *bytes = PyByteArray_FromStringAndSize(NULL, rows * size * sizeof(double));
+    if (bytes == NULL) {
+        PyMem_Free(initial_strengths);
+        return NULL;
     }
-    
-    index = 0;
-    while ((item = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        double strength = _QBAFramework_calculate_final_strength(self, item);
-        Py_DECREF(item);
-        if (strength == -1.0 && PyErr_Occurred()) {
-            Py_DECREF(attacker_strengths);
-            Py_DECREF(iterator);
-            Py_DECREF(supporters);
-            Py_DECREF(supporter_strengths);
-            return -1.0;
+    double *final_strengths = (double *) PyByteArray_AS_STRING(bytes);
+
+    // The graph must not be replaced or modified while the threads or the Python semantics evaluate it
+    int evaluated = 0;
+    self->busy++;
+    if (self->aggregation_array_function != NULL && self->influence_function != NULL) {
+        // Built-in semantics are evaluated in blocks of rows without Python objects
+        evaluated = QBAFParallel_EvaluateBatch(graph, self->aggregation_array_function, self->influence_function,
+                                               self->fast_math, initial_strengths, final_strengths, rows, self->threads);
+    }
+    else {
+        for (Py_ssize_t row = 0; evaluated == 0 && row < rows; row++) {
+            for (Py_ssize_t position = 0; position < graph->ordered; position++) {
+                Py_ssize_t index = graph->order[position];
+                double final_strength = _QBAFramework_calculate_final_strength(self, graph, index,
+                                            initial_strengths + row * size, final_strengths + row * size);
+                if (final_strength == -1.0 && PyErr_Occurred()) {
+                    evaluated = -1;
+                    break;
+                }
+                final_strengths[row * size + index] = final_strength;
+            }
         }
+    }
+    self->busy--;
+    if (evaluated < 0) {
+        goto error;
+    }
+    PyMem_Free(initial_strengths);
 
-        PyList_SET_ITEM(supporter_strengths, index, PyFloat_FromDouble(strength));
+    PyObject *view = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    if (view == NULL) {
+        return NULL;
+    }
+    PyObject *matrix_view = PyObject_CallMethod(view, "cast", "s(nn)", "d", rows, size);
+    Py_DECREF(view);
+    return matrix_view;
 
-        index++;
-    } 
+error:
+    PyMem_Free(initial_strengths);
+    Py_DECREF(bytes);
+    return NULL;
+}
 
-    Py_DECREF(iterator);
-    Py_DECREF(supporters);
+/**
+ * @brief Return a list with the arguments of the Framework in the order of their indices,
+ * i.e. the columns of evaluate_batch, NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param closure 
+ * @return PyObject* a new PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_getindexed_arguments(QBAFrameworkObject *self, void *closure)
+{
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
+    }
 
-    // Obtain result from aggregation function
-    double aggregation = _QBAFramework_aggregation_function(self, attacker_strengths, supporter_strengths);
-    Py_DECREF(attacker_strengths);
-    Py_DECREF(supporter_strengths);
-    if (aggregation == -1.0 && PyErr_Occurred()) {
-        return -1.0;
+    return PyList_GetSlice(self->graph->arguments, 0, self->graph->size);
+}
+
+/**
+ * @brief Return the final strengths of arguments of the Framework, NULL if an error occurred.
+ * If the framework has been modified from the last time they were calculated
+ * they are calculated again. Otherwise, it returns the already calculated final strengths.
+ * 
+ * @param self the QBAFramework
+ * @param closure 
+ * @return PyObject* a new PyDict, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_getfinal_strengths(QBAFrameworkObject *self, void *closure)
+{
+    if (_QBAFramework_evaluate(self) < 0) {
+        return NULL;
     }
 
-    // Obtain initial strength
-    double initial_strength = PyFloat_AsDouble(PyDict_GetItem(self->initial_strengths, argument));
-    if (initial_strength == -1.0 && PyErr_Occurred()) {
-        return -1.0;
+    return QBAFGraph_StrengthsAsDict(self->graph, self->graph->final_strengths);
+}
+
+/**
+ * @brief Return a read-only memoryview of float64 over the final strengths of the Framework (no copy),
+ * indexed like argument_index, NULL if an error occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param Py_UNUSED 
+ * @return PyObject* new memoryview, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_final_strengths_array(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (_QBAFramework_evaluate(self) < 0) {
+        return NULL;
     }
 
-    // calculate final strength;
-    double final_strength = _QBAFramework_influence_function(self, initial_strength, aggregation);
-    if (final_strength == -1.0 && PyErr_Occurred()) {
-        return -1.0;
+    return QBAFGraph_FinalStrengthsView(self->graph);
+}
+
+/**
+ * @brief Return a read-only memoryview of float64 over the initial strengths of the Framework (no copy),
+ * indexed like argument_index, NULL if an error occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param Py_UNUSED 
+ * @return PyObject* new memoryview, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_initial_strengths_array(QBAFrameworkObject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
     }
 
-    // final_strengths[argument] = final_strength
-    PyObject *pyfinal_strength = PyFloat_FromDouble(final_strength);    // New reference
-    if (PyDict_SetItem(self->final_strengths, argument, pyfinal_strength) < 0) {
-        Py_XDECREF(pyfinal_strength);
-        return -1.0;
+    return QBAFGraph_InitialStrengthsView(self->graph);
+}
+
+/**
+ * @brief Return a dict with the index of every argument of the Framework, i.e. its position in
+ * final_strengths_array(), initial_strengths_array() and the columns of evaluate_batch(), NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param closure 
+ * @return PyObject* a new PyDict of (QBAFArgument, PyLong), NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_getargument_index(QBAFrameworkObject *self, void *closure)
+{
+    if (_QBAFramework_compile(self) < 0) {
+        return NULL;
     }
-    Py_XDECREF(pyfinal_strength);
 
-    return final_strength;
+    return PyDict_Copy(self->graph->indices);
 }
 
 /**
- * @brief Calculate the final strengths of all the arguments of the Framework.
- * It stores all the calculated final strengths in self.__final_strengths.
+ * @brief Return the index of the Argument argument in the compiled graph of the Framework,
+ * -1 (with a ValueError) if it is not contained, and -2 if another error has occurred.
+ * The final strengths must have been calculated.
  * 
- * @param self the QBAFramework
- * @return int 0 if succesful, -1 if an error occurred
+ * @param self an instance of QBAFramework
+ * @param argument the QBAFArgument
+ * @param msg the message of the ValueError if argument is not contained
+ * @return Py_ssize_t the index of argument, negative if an error occurred
  */
-static int
-_QBAFRamework_calculate_final_strengths(QBAFrameworkObject *self)
+static inline Py_ssize_t
+_QBAFramework_index_of(QBAFrameworkObject *self, PyObject *argument, const char *msg)
+{
+    Py_ssize_t index = QBAFGraph_IndexOf(self->graph, argument);
+    if (index == -1) {
+        PyErr_SetString(PyExc_ValueError, msg);
+    }
+    return index;
+}
+
+/**
+ * @brief Return a new PyDict with the derivatives of the final strengths of the (acyclic) Framework
+ * w.r.t. the initial strengths, NULL if an error occurred. If reverse, the derivatives of the final strength
+ * of argument w.r.t. the initial strength of every argument. Otherwise, the derivatives of the final strength
+ * of every argument w.r.t. the initial strength of argument.
+ * 
+ * @param self an instance of QBAFramework
+ * @param argument a QBAFArgument
+ * @param reverse TRUE for reverse mode, FALSE for forward mode
+ * @return PyObject* new PyDict of (QBAFArgument, PyFloat), NULL if an error occurred
+ */
+static PyObject *
+_QBAFramework_derivatives(QBAFrameworkObject *self, PyObject *argument, int reverse)
 {
+    QBAFArrayAggregationDerivative aggregation_derivative = NULL;
+    QBAFInfluenceDerivative influence_derivative = NULL;
+    if (self->aggregation_array_function != NULL && self->influence_function != NULL) {
+        aggregation_derivative = aggregation_derivative_function(self->aggregation_array_function);
+        influence_derivative = influence_derivative_function(self->influence_function);
+    }
+    if (aggregation_derivative == NULL || influence_derivative == NULL) {
+        PyErr_SetString(PyExc_ValueError,
+                        "the derivatives are only available with built-in semantics");
+        return NULL;
+    }
+
     int isacyclic = _QBAFramework_isacyclic(self);
     if (isacyclic < 0) {
-        return -1;
+        return NULL;
+    }
+    if (!isacyclic) {
+        PyErr_SetString(PyExc_ValueError,
+                        "the derivatives of a non-acyclic framework are not supported");
+        return NULL;
+    }
+    if (_QBAFramework_evaluate(self) < 0) {
+        return NULL;
     }
-    if (!isacyclic) {
-        PyErr_SetString(PyExc_NotImplementedError,
-                        "calculate final strengths of non-acyclic framework not implemented");
-        return -1;
+    QBAFGraph *graph = self->graph;
+    Py_ssize_t index = _QBAFramework_index_of(self, argument, "argument must be contained in the QBAFramework");
+    if (index < 0) {
+        return NULL;
     }
 
-    Py_CLEAR(self->final_strengths);
-    self->final_strengths = PyDict_New();
-
-    PyObject *iterator = PyObject_GetIter(self->arguments);
-    PyObject *item;
-    if (iterator == NULL) {
-        return -1;
+    double *derivatives = PyMem_Malloc(graph->size * sizeof(double) + 1);
+    if (derivatives == NULL) {
+        PyErr_NoMemory();
+        return NULL;
     }
-
-    while ((item = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        if (_QBAFramework_calculate_final_strength(self, item) == -1.0 && PyErr_Occurred()) {
-            Py_DECREF(item); Py_DECREF(iterator);
-            return -1;
-        }
-        Py_DECREF(item);
+    int result = reverse ?
+        QBAFGradient_Reverse(graph, index, self->aggregation_array_function,
+                             aggregation_derivative, influence_derivative, derivatives) :
+        QBAFGradient_Forward(graph, index, self->aggregation_array_function,
+                             aggregation_derivative, influence_derivative, derivatives);
+    if (result < 0) {
+        PyMem_Free(derivatives);
+        return NULL;
     }
 
-    Py_DECREF(iterator);
+    PyObject *dict = QBAFGraph_StrengthsAsDict(graph, derivatives);
+    PyMem_Free(derivatives);
+    return dict;
+}
 
-    return 0;
+/**
+ * @brief Return a new PyDict with the derivative of the final strength of topic w.r.t. the initial strength
+ * of every argument (reverse mode), NULL if an error occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args the argument values (topic: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyDict of (QBAFArgument, PyFloat), NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_gradient(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"topic", NULL};
+    PyObject *topic;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &topic))
+        return NULL;
+
+    return _QBAFramework_derivatives(self, topic, TRUE);
 }
 
 /**
- * @brief Return the final strengths of arguments of the Framework, NULL if an error occurred.
- * If the framework has been modified from the last time they were calculated
- * they are calculated again. Otherwise, it returns the already calculated final strengths.
+ * @brief Return a new PyDict with the derivative of the final strength of every argument w.r.t. the initial strength
+ * of argument (forward mode), NULL if an error occurred.
  * 
- * @param self the QBAFramework
- * @param closure 
- * @return PyObject* a new PyDict, NULL if an error occurred
+ * @param self an instance of QBAFramework
+ * @param args the argument values (argument: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new PyDict of (QBAFArgument, PyFloat), NULL if an error occurred
  */
 static PyObject *
-QBAFramework_getfinal_strengths(QBAFrameworkObject *self, void *closure)
+QBAFramework_tangent(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 {
-    if (self->modified) {   // Calculate final strengths if the framework has been modified
-        if (_QBAFRamework_calculate_final_strengths(self) < 0) {
-            return NULL;
-        }
-        self->modified = FALSE;
-    }
+    static char *kwlist[] = {"argument", NULL};
+    PyObject *argument;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &argument))
+        return NULL;
 
-    return PyDict_Copy(self->final_strengths);
+    return _QBAFramework_derivatives(self, argument, FALSE);
 }
 
 /**
@@ -1928,29 +3755,21 @@ QBAFramework_getfinal_strengths(QBAFrameworkObject *self, void *closure)
  * 
  * @param self an instance of QBAFramework
  * @param argument the QBAFArgument
- * @return PyObject* borrowed PyFloat
+ * @return PyObject* new PyFloat
  */
 static PyObject *
 _QBAFramework_final_strength(QBAFrameworkObject *self, PyObject *argument)
 {
-    if (self->modified) {   // Calculate final strengths if the framework has been modified
-        if (_QBAFRamework_calculate_final_strengths(self) < 0) {
-            return NULL;
-        }
-        self->modified = FALSE;
-    }
-
-    int contains = PyDict_Contains(self->final_strengths, argument);
-    if (contains < 0) {
+    if (_QBAFramework_evaluate(self) < 0) {
         return NULL;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError,
-                        "argument must be contained in the QBAFramework");
+
+    Py_ssize_t index = _QBAFramework_index_of(self, argument, "argument must be contained in the QBAFramework");
+    if (index < 0) {
         return NULL;
     }
 
-    return PyDict_GetItem(self->final_strengths, argument);
+    return PyFloat_FromDouble(self->graph->final_strengths[index]);
 }
 
 /**
@@ -1971,9 +3790,22 @@ QBAFramework_final_strength(QBAFrameworkObject *self, PyObject *args, PyObject *
                                      &argument))
         return NULL;
 
-    PyObject *final_strength = _QBAFramework_final_strength(self, argument); // Borrowed reference
-    Py_XINCREF(final_strength);
-    return final_strength;
+    return _QBAFramework_final_strength(self, argument);
+}
+
+/**
+ * @brief Return 1 if the final strengths s1 and s2 of two arguments are ordered
+ * like their final strengths t1 and t2 in another framework, 0 if not.
+ * 
+ */
+static inline int
+_QBAFramework_consistent_strengths(double s1, double s2, double t1, double t2)
+{
+    if (s1 < s2)
+        return t1 < t2;
+    if (s1 > s2)
+        return t1 > t2;
+    return t1 == t2;
 }
 
 /**
@@ -1989,63 +3821,38 @@ QBAFramework_final_strength(QBAFrameworkObject *self, PyObject *args, PyObject *
 static inline int
 _QBAFramework_are_strength_consistent(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *arg1, PyObject *arg2)
 {
-    if (self->modified) {   // Calculate final strengths if the framework has been modified
-        if (_QBAFRamework_calculate_final_strengths(self) < 0) {
-            return -1;
-        }
-        self->modified = FALSE;
-    }
-    if (other->modified) {   // Calculate final strengths if the framework has been modified
-        if (_QBAFRamework_calculate_final_strengths(other) < 0) {
-            return -1;
-        }
-        other->modified = FALSE;
-    }
-
-    // Check that the arguments are contained in both frameworks
-    int contains = PyDict_Contains(self->final_strengths, arg1);
-    if (contains < 0) {
-        return -1;
-    }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError, "arg1 must be an argument of this QBAFramework");
-        return -1;
-    }
-    contains = PyDict_Contains(self->final_strengths, arg2);
-    if (contains < 0) {
+    if (_QBAFramework_evaluate(self) < 0) {
         return -1;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError, "arg2 must be an argument of this QBAFramework");
+    if (_QBAFramework_evaluate(other) < 0) {
         return -1;
     }
-    contains = PyDict_Contains(other->final_strengths, arg1);
-    if (contains < 0) {
+
+    // Check that the arguments are contained in both frameworks
+    Py_ssize_t self_index_arg1 = _QBAFramework_index_of(self, arg1, "arg1 must be an argument of this QBAFramework");
+    if (self_index_arg1 < 0) {
         return -1;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError, "arg1 must be an argument of the QBAFramework other");
+    Py_ssize_t self_index_arg2 = _QBAFramework_index_of(self, arg2, "arg2 must be an argument of this QBAFramework");
+    if (self_index_arg2 < 0) {
         return -1;
     }
-    contains = PyDict_Contains(other->final_strengths, arg2);
-    if (contains < 0) {
+    Py_ssize_t other_index_arg1 = _QBAFramework_index_of(other, arg1, "arg1 must be an argument of the QBAFramework other");
+    if (other_index_arg1 < 0) {
         return -1;
     }
-    if (!contains) {
-        PyErr_SetString(PyExc_ValueError, "arg2 must be an argument of the QBAFramework other");
+    Py_ssize_t other_index_arg2 = _QBAFramework_index_of(other, arg2, "arg2 must be an argument of the QBAFramework other");
+    if (other_index_arg2 < 0) {
         return -1;
     }
 
-    double self_final_strength_arg1 = PyFloat_AS_DOUBLE(PyDict_GetItem(self->final_strengths, arg1));
-    double self_final_strength_arg2 = PyFloat_AS_DOUBLE(PyDict_GetItem(self->final_strengths, arg2));
-    double other_final_strength_arg1 = PyFloat_AS_DOUBLE(PyDict_GetItem(other->final_strengths, arg1));
-    double other_final_strength_arg2 = PyFloat_AS_DOUBLE(PyDict_GetItem(other->final_strengths, arg2));
+    double self_final_strength_arg1 = self->graph->final_strengths[self_index_arg1];
+    double self_final_strength_arg2 = self->graph->final_strengths[self_index_arg2];
+    double other_final_strength_arg1 = other->graph->final_strengths[other_index_arg1];
+    double other_final_strength_arg2 = other->graph->final_strengths[other_index_arg2];
 
-    if (self_final_strength_arg1 < self_final_strength_arg2)
-        return other_final_strength_arg1 < other_final_strength_arg2;
-    if (self_final_strength_arg1 > self_final_strength_arg2)
-        return other_final_strength_arg1 > other_final_strength_arg2;
-    return other_final_strength_arg1 == other_final_strength_arg2;
+    return _QBAFramework_consistent_strengths(self_final_strength_arg1, self_final_strength_arg2,
+                                              other_final_strength_arg1, other_final_strength_arg2);
 }
 
 /**
@@ -2121,7 +3928,7 @@ _QBAFramework_copy_settings(QBAFrameworkObject *self)
     }
 
     Py_DECREF(copy->support_relations);
-    copy->support_relations = QBAFARelations_Create(NULL);
+    copy->support_relations = QBAFARelations_CreateWithSymbols(NULL, (QBAFARelationsObject*)copy->attack_relations);
     if (copy->support_relations == NULL) {
         Py_DECREF(copy);
         return NULL;
@@ -2129,9 +3936,12 @@ _QBAFramework_copy_settings(QBAFrameworkObject *self)
 
     copy->modified = TRUE;
     copy->disjoint_relations = self->disjoint_relations;
+    copy->threads = self->threads;
+    copy->fast_math = self->fast_math;
 
     copy->semantics = self->semantics;
     copy->aggregation_function = self->aggregation_function;
+    copy->aggregation_array_function = self->aggregation_array_function;
     copy->influence_function = self->influence_function;
     copy->min_strength = self->min_strength;
     copy->max_strength = self->max_strength;
@@ -2210,7 +4020,7 @@ _QBAFramework_reversal(QBAFrameworkObject *self, QBAFrameworkObject *other, PyOb
 
     // Modify attack relations
     Py_DECREF(reversal->attack_relations);
-    reversal->attack_relations = QBAFARelations_copy((QBAFARelationsObject*)self->attack_relations, NULL);
+    reversal->attack_relations = QBAFARelations_CopyWithSymbols((QBAFARelationsObject*)self->attack_relations, NULL);
     if (reversal->attack_relations == NULL) {
         Py_DECREF(reversal);
         return NULL;
@@ -2222,12 +4032,13 @@ _QBAFramework_reversal(QBAFrameworkObject *self, QBAFrameworkObject *other, PyOb
     }
     while ((arg = PyIter_Next(set_iterator))) {    // PyIter_Next returns a new reference
         // for attacked in self.__attack_relations.patients(arg).intersection(other): att.remove(arg, attacked)
-        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)self->attack_relations, arg); // borrowed reference
+        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)self->attack_relations, arg); // new reference
         if (patients == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
         }
         patients_intersection_other_arguments = PySet_Intersection(patients, other->arguments);
+        Py_DECREF(patients);
         if (patients_intersection_other_arguments == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
@@ -2249,12 +4060,13 @@ _QBAFramework_reversal(QBAFrameworkObject *self, QBAFrameworkObject *other, PyOb
         Py_DECREF(iterator);
 
         // for attacked in other.__attack_relations.patients(arg).intersection(args): att.add_relation(arg, attacked)
-        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)other->attack_relations, arg); // borrowed reference
+        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)other->attack_relations, arg); // new reference
         if (patients == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
         }
         patients_intersection_reversal_arguments = PySet_Intersection(patients, reversal->arguments);
+        Py_DECREF(patients);
         if (patients_intersection_reversal_arguments == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
@@ -2282,7 +4094,8 @@ _QBAFramework_reversal(QBAFrameworkObject *self, QBAFrameworkObject *other, PyOb
 
     // Modify support relations
     Py_DECREF(reversal->support_relations);
-    reversal->support_relations = QBAFARelations_copy((QBAFARelationsObject*)self->support_relations, NULL);
+    reversal->support_relations = QBAFARelations_CopyWithSymbols((QBAFARelationsObject*)self->support_relations,
+                                                                  (QBAFARelationsObject*)reversal->attack_relations);
     if (reversal->support_relations == NULL) {
         Py_DECREF(reversal);
         return NULL;
@@ -2294,12 +4107,13 @@ _QBAFramework_reversal(QBAFrameworkObject *self, QBAFrameworkObject *other, PyOb
     }
     while ((arg = PyIter_Next(set_iterator))) {    // PyIter_Next returns a new reference
         // for supported in self.__support_relations.patients(arg).intersection(other): supp.remove(arg, supported)
-        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)self->support_relations, arg); // borrowed reference
+        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)self->support_relations, arg); // new reference
         if (patients == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
         }
         patients_intersection_other_arguments = PySet_Intersection(patients, other->arguments);
+        Py_DECREF(patients);
         if (patients_intersection_other_arguments == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
@@ -2321,12 +4135,13 @@ _QBAFramework_reversal(QBAFrameworkObject *self, QBAFrameworkObject *other, PyOb
         Py_DECREF(iterator);
 
         // for supported in other.__support_relations.patients(arg).intersection(args): supp.add_relation(arg, supported)
-        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)other->support_relations, arg); // borrowed reference
+        patients = _QBAFARelations_patients_set((QBAFARelationsObject*)other->support_relations, arg); // new reference
         if (patients == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
         }
         patients_intersection_reversal_arguments = PySet_Intersection(patients, reversal->arguments);
+        Py_DECREF(patients);
         if (patients_intersection_reversal_arguments == NULL) {
             Py_DECREF(reversal); Py_DECREF(arg); Py_DECREF(set_iterator);
             return NULL;
@@ -2418,8 +4233,8 @@ _QBAFramework_reversal(QBAFrameworkObject *self, QBAFrameworkObject *other, PyOb
     Py_DECREF(other_arguments_intersection_set);
 
     // Remove calculated final strengths
-    Py_CLEAR(reversal->final_strengths);
-    reversal->final_strengths = PyDict_New();
+    QBAFGraph_Free(reversal->graph);
+    reversal->graph = NULL;
     reversal->modified = TRUE;
 
     // Return
@@ -2450,23 +4265,361 @@ QBAFramework_reversal(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
         return NULL;
     }
 
-    if (PySet_Check(set)) {
-        Py_INCREF(set);
-    } else if (PyList_Check(set)) {
-        set = PySet_New(set); // new reference
-        if (set == NULL) {
-            return NULL;
-        }
-    } else {
-        PyErr_SetString(PyExc_TypeError, "argument set must be an instance of set or list");
-        return NULL;
+    if (PySet_Check(set)) {
+        Py_INCREF(set);
+    } else if (PyList_Check(set)) {
+        set = PySet_New(set); // new reference
+        if (set == NULL) {
+            return NULL;
+        }
+    } else {
+        PyErr_SetString(PyExc_TypeError, "argument set must be an instance of set or list");
+        return NULL;
+    }
+
+    PyObject *reversal = _QBAFramework_reversal(self, (QBAFrameworkObject*)other, set);
+
+    Py_DECREF(set);
+
+    return reversal;
+}
+
+/**
+ * @brief Struct with the state shared by the explanation checks of arg1 and arg2
+ * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF): the reversals are evaluated
+ * on an overlay of both compiled frameworks instead of being built.
+ * 
+ */
+typedef struct {
+    QBAFrameworkObject *self;           /* the framework that is reversed (QBF') */
+    QBAFrameworkObject *other;          /* the framework it is reversed into (QBF) */
+    QBAFOverlay        *overlay;        /* overlay of the compiled graphs of self and other */
+    Py_ssize_t          roots[2];       /* index of arg1 and arg2 in overlay */
+    double              other_strengths[2]; /* final strengths of arg1 and arg2 in other */
+    PyObject           *arg1;           /* the first argument (borrowed) */
+    PyObject           *arg2;           /* the second argument (borrowed) */
+    int                 consistent;     /* 1 if arg1 and arg2 are strength consistent w.r.t. self and other,
+                                           0 if not, -1 if it has not been calculated yet */
+} QBAFExplanationContext;
+
+/**
+ * @brief Initialize the QBAFExplanationContext context of arg1 and arg2 w.r.t. QBAFramework self (QBF')
+ * and QBAFramework other (QBF). Return 0 if succeeded, -1 if an error has occurred
+ * (also if arg1 or arg2 are not contained in both frameworks).
+ * 
+ * @param context the QBAFExplanationContext
+ * @param self an instance of QBAFramework
+ * @param other a different instance of QBAFramework
+ * @param arg1 a QBAFArgument
+ * @param arg2 a QBAFArgument
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+_QBAFExplanationContext_Init(QBAFExplanationContext *context, QBAFrameworkObject *self, QBAFrameworkObject *other,
+                             PyObject *arg1, PyObject *arg2)
+{
+    // The final strengths of self are only needed (and calculated) to know if arg1 and arg2 are strength consistent
+    if (_QBAFramework_compile(self) < 0 || _QBAFramework_evaluate(other) < 0) {
+        return -1;
+    }
+    if (_QBAFramework_index_of(self, arg1, "arg1 must be an argument of this QBAFramework") < 0 ||
+        _QBAFramework_index_of(self, arg2, "arg2 must be an argument of this QBAFramework") < 0) {
+        return -1;
+    }
+    Py_ssize_t other_index_arg1 = _QBAFramework_index_of(other, arg1, "arg1 must be an argument of the QBAFramework other");
+    if (other_index_arg1 < 0) {
+        return -1;
+    }
+    Py_ssize_t other_index_arg2 = _QBAFramework_index_of(other, arg2, "arg2 must be an argument of the QBAFramework other");
+    if (other_index_arg2 < 0) {
+        return -1;
+    }
+
+    context->self = self;
+    context->other = other;
+    context->other_strengths[0] = other->graph->final_strengths[other_index_arg1];
+    context->other_strengths[1] = other->graph->final_strengths[other_index_arg2];
+    context->consistent = -1;
+    context->arg1 = arg1;
+    context->arg2 = arg2;
+
+    context->overlay = QBAFOverlay_New(self->graph, other->graph);
+    if (context->overlay == NULL) {
+        return -1;
+    }
+    context->roots[0] = QBAFOverlay_IndexOf(context->overlay, arg1);
+    context->roots[1] = QBAFOverlay_IndexOf(context->overlay, arg2);
+    if (context->roots[0] < 0 || context->roots[1] < 0) {
+        QBAFOverlay_Free(context->overlay);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Free the memory of the QBAFExplanationContext context.
+ * 
+ * @param context the QBAFExplanationContext
+ */
+static inline void
+_QBAFExplanationContext_Free(QBAFExplanationContext *context)
+{
+    QBAFOverlay_Free(context->overlay);
+    context->overlay = NULL;
+}
+
+/**
+ * @brief Store in members (a new array) the indices in the overlay of the QBAFExplanationContext context
+ * of the arguments of the PySet set. Return 0 if succeeded, -1 if an error has occurred
+ * (a ValueError if an argument is not contained in any framework).
+ * 
+ * @param context the QBAFExplanationContext
+ * @param set a PySet of QBAFArgument
+ * @param members a pointer where the new array is stored (free it with PyMem_Free)
+ * @param count a pointer where the number of members is stored
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+_QBAFExplanationContext_members(QBAFExplanationContext *context, PyObject *set, Py_ssize_t **members, Py_ssize_t *count)
+{
+    Py_ssize_t size = PyObject_Size(set);
+    if (size < 0) {
+        return -1;
+    }
+    *members = PyMem_New(Py_ssize_t, size + 1);
+    if (*members == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    PyObject *iterator = PyObject_GetIter(set);
+    if (iterator == NULL) {
+        PyMem_Free(*members);
+        return -1;
+    }
+
+    *count = 0;
+    PyObject *argument;
+    while ((argument = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
+        Py_ssize_t index = QBAFOverlay_IndexOf(context->overlay, argument);
+        Py_DECREF(argument);
+        if (index < 0) {
+            if (index == -1)
+                PyErr_SetString(PyExc_ValueError,
+                                "argument set must be a subset of the union of the arguments of both frameworks");
+            break;
+        }
+        if (*count < size)
+            (*members)[(*count)++] = index;
+    }
+    Py_DECREF(iterator);
+
+    if (PyErr_Occurred()) {
+        PyMem_Free(*members);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Return True if arg1 and arg2 are strength consistent w.r.t. self (QBF') and other (QBF)
+ * of the QBAFExplanationContext context, False if not, -1 if an error has occurred.
+ * It is only calculated the first time, so it does not use Python objects afterwards.
+ * 
+ * @param context the QBAFExplanationContext of arg1 and arg2
+ * @return int 1 if strength consistent, 0 if not, -1 if an error occurred
+ */
+static int
+_QBAFExplanationContext_consistent(QBAFExplanationContext *context)
+{
+    if (context->consistent < 0) {
+        context->consistent = _QBAFramework_are_strength_consistent(context->self, context->other, context->arg1, context->arg2);
+    }
+    return context->consistent;
+}
+
+/**
+ * @brief Return True if arg1 and arg2 are strength consistent w.r.t. other (QBF) and the reversal of self (QBF') to other
+ * w.r.t. the arguments with indices members (complement = 0) or w.r.t. every argument except them (complement = 1),
+ * False if not, -1 if an error has occurred. Only the arguments that arg1 and arg2 depend on are evaluated.
+ * If the reversal is not acyclic, acyclic is set to 0 (and False is returned).
+ * The reversal is selected in overlay, which can be the overlay of context or a fork of it,
+ * and no Python object is used if self has built-in semantics.
+ * 
+ * @param context the QBAFExplanationContext of arg1 and arg2
+ * @param overlay the overlay of context or a fork of it (QBAFOverlay_Fork)
+ * @param members indices of arguments in the overlay of context
+ * @param count the number of members
+ * @param complement 1 if the reversal is w.r.t. the complement of members, 0 if w.r.t. members
+ * @param acyclic a pointer where 1 is stored if the reversal is acyclic, 0 if not
+ * @return int 1 if strength consistent, 0 if not, -1 if an error occurred
+ */
+static int
+_QBAFramework_reversal_consistent(QBAFExplanationContext *context, QBAFOverlay *overlay,
+                                  const Py_ssize_t *members, Py_ssize_t count, int complement, int *acyclic)
+{
+    QBAFOverlay_Select(overlay, members, count, complement);
+    *acyclic = QBAFOverlay_Schedule(overlay, context->roots, 2);
+    if (!*acyclic) {
+        return FALSE;
+    }
+
+    for (Py_ssize_t position = 0; position < overlay->ordered; position++) {
+        Py_ssize_t index = overlay->order[position];
+        double final_strength = _QBAFramework_calculate_final_strength(context->self, &overlay->view, index,
+                                                                       overlay->initial_strengths, overlay->final_strengths);
+        // Built-in semantics cannot fail (and the GIL may be released)
+        if (final_strength == -1.0 && !_QBAFramework_builtin_semantics(context->self) && PyErr_Occurred()) {
+            return -1;
+        }
+        overlay->final_strengths[index] = final_strength;
+    }
+
+    return _QBAFramework_consistent_strengths(context->other_strengths[0], context->other_strengths[1],
+                                              overlay->final_strengths[context->roots[0]],
+                                              overlay->final_strengths[context->roots[1]]);
+}
+
+/**
+ * @brief Return True if the arguments with indices members are a Sufficient Strength Inconsistency (SSI) Explanation
+ * of the QBAFExplanationContext context, False if not, -1 if encountered an error.
+ * If False is returned because a reversal is not acyclic, the warning to be issued is stored in warning.
+ * No Python object is used if self has built-in semantics and _QBAFExplanationContext_consistent has been calculated.
+ * 
+ * @param context the QBAFExplanationContext of arg1 and arg2
+ * @param overlay the overlay of context or a fork of it (QBAFOverlay_Fork)
+ * @param members indices of arguments in the overlay of context
+ * @param count the number of members
+ * @param warning a pointer where the message of the warning is stored, NULL if there is none
+ * @return int 1 if it is a SSI Explanation, 0 if it is not, -1 if an error has occurred
+ */
+static int
+_QBAFramework_checkSSIExplanation(QBAFExplanationContext *context, QBAFOverlay *overlay,
+                                  const Py_ssize_t *members, Py_ssize_t count, const char **warning)
+{
+    *warning = NULL;
+
+    int consistent = _QBAFExplanationContext_consistent(context);
+    if (consistent < 0) {
+        return -1;
+    }
+    if (consistent) {
+        return count == 0;
+    }
+
+    int acyclic;
+    int are_strength_consistent = _QBAFramework_reversal_consistent(context, overlay, members, count, TRUE, &acyclic);
+    if (are_strength_consistent < 0) {
+        return -1;
+    }
+    if (!acyclic) {
+        *warning = "Acyclic reversal of a QBAF was found when checking if it was a SSI Explanation. "
+                   "False was returned instead.";
+        return FALSE;
+    }
+    return !are_strength_consistent;
+}
+
+/**
+ * @brief Return True if the arguments with indices members are a Counterfactual Strength Inconsistency (CSI) Explanation
+ * of the QBAFExplanationContext context, False if not, -1 if encountered an error.
+ * If False is returned because a reversal is not acyclic, the warning to be issued is stored in warning.
+ * No Python object is used if self has built-in semantics and _QBAFExplanationContext_consistent has been calculated.
+ * 
+ * @param context the QBAFExplanationContext of arg1 and arg2
+ * @param overlay the overlay of context or a fork of it (QBAFOverlay_Fork)
+ * @param members indices of arguments in the overlay of context
+ * @param count the number of members
+ * @param warning a pointer where the message of the warning is stored, NULL if there is none
+ * @return int 1 if it is a CSI Explanation, 0 if it is not, -1 if an error has occurred
+ */
+static int
+_QBAFramework_checkCSIExplanation(QBAFExplanationContext *context, QBAFOverlay *overlay,
+                                  const Py_ssize_t *members, Py_ssize_t count, const char **warning)
+{
+    *warning = NULL;
+
+    int acyclic;
+    int are_strength_consistent = _QBAFramework_reversal_consistent(context, overlay, members, count, FALSE, &acyclic);
+    if (are_strength_consistent < 0) {
+        return -1;
+    }
+    if (!acyclic) {
+        *warning = "Acyclic reversal of a QBAF was found when checking if it was a CSI Explanation. "
+                   "False was returned instead.";
+        return FALSE;
+    }
+    if (!are_strength_consistent) {
+        return FALSE;
+    }
+
+    return _QBAFramework_checkSSIExplanation(context, overlay, members, count, warning);
+}
+
+/**
+ * @brief Function that checks if the arguments with indices members are an explanation
+ * of the QBAFExplanationContext context in overlay
+ * (_QBAFramework_checkSSIExplanation or _QBAFramework_checkCSIExplanation).
+ * 
+ */
+typedef int (*QBAFExplanationCheck)(QBAFExplanationContext *context, QBAFOverlay *overlay,
+                                    const Py_ssize_t *members, Py_ssize_t count, const char **warning);
+
+/**
+ * @brief Return True if the arguments with indices members are an explanation of the QBAFExplanationContext context
+ * according to check, False if not, -1 if encountered an error. The warning of check is issued if there is one.
+ * 
+ * @param context the QBAFExplanationContext of arg1 and arg2
+ * @param check the function that decides whether a set is an explanation
+ * @param members indices of arguments in the overlay of context
+ * @param count the number of members
+ * @return int 1 if it is an explanation, 0 if it is not, -1 if an error has occurred
+ */
+static int
+_QBAFramework_isExplanation_members(QBAFExplanationContext *context, QBAFExplanationCheck check,
+                                    const Py_ssize_t *members, Py_ssize_t count)
+{
+    const char *warning;
+    int result = check(context, context->overlay, members, count, &warning);
+    if (warning != NULL) {
+        PyErr_WarnEx(PyExc_Warning, warning, 1);
+    }
+    return result;
+}
+
+/**
+ * @brief Return True if the PySet set is an explanation of arg1 and arg2 w.r.t. QBAFramework self (QBF')
+ * and QBAFramework other (QBF) according to check, False if not, -1 if encountered an error.
+ * 
+ * @param self an instance of QBAFramework
+ * @param other a different instance of QBAFramework
+ * @param set a PySet of QBAFArgument
+ * @param arg1 a QBAFArgument
+ * @param arg2 a QBAFArgument
+ * @param check the function that decides whether a set is an explanation
+ * @return int 1 if it is an explanation, 0 if it is not, -1 if an error has occurred
+ */
+static int
+_QBAFramework_isExplanation(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *set, PyObject *arg1, PyObject *arg2,
+                            QBAFExplanationCheck check)
+{
+    QBAFExplanationContext context;
+    if (_QBAFExplanationContext_Init(&context, self, other, arg1, arg2) < 0) {
+        return -1;
+    }
+
+    Py_ssize_t *members, count;
+    if (_QBAFExplanationContext_members(&context, set, &members, &count) < 0) {
+        _QBAFExplanationContext_Free(&context);
+        return -1;
     }
 
-    PyObject *reversal = _QBAFramework_reversal(self, (QBAFrameworkObject*)other, set);
-
-    Py_DECREF(set);
+    int result = _QBAFramework_isExplanation_members(&context, check, members, count);
 
-    return reversal;
+    PyMem_Free(members);
+    _QBAFExplanationContext_Free(&context);
+    return result;
 }
 
 /**
@@ -2484,43 +4637,7 @@ QBAFramework_reversal(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 static int
 _QBAFramework_isSSIExplanation(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *set, PyObject *arg1, PyObject *arg2)
 {
-    int are_strength_consistent = _QBAFramework_are_strength_consistent(self, other, arg1, arg2);
-    if (are_strength_consistent < 0) {
-        return -1;
-    }
-    if (are_strength_consistent) {
-        return PySet_GET_SIZE(set) == 0;
-    }
-
-    PyObject *self_arguments_union_other_arguments = PySet_Union(self->arguments, other->arguments);
-    if (self_arguments_union_other_arguments == NULL) {
-        return -1;
-    }
-    PyObject *self_arguments_union_other_arguments_difference_set = PySet_Difference(self_arguments_union_other_arguments, set);
-    Py_DECREF(self_arguments_union_other_arguments);
-    if (self_arguments_union_other_arguments_difference_set == NULL) {
-        return -1;
-    }
-
-    PyObject *reversal = _QBAFramework_reversal(self, other, self_arguments_union_other_arguments_difference_set);
-    Py_DECREF(self_arguments_union_other_arguments_difference_set);
-    if (reversal == NULL) {
-        return -1;
-    }
-
-    if (!_QBAFramework_isacyclic(reversal)) {
-        PyErr_WarnEx(PyExc_Warning, "Acyclic reversal of a QBAF was found when checking if it was a SSI Explanation. "
-                                    "False was returned instead.", 1);
-        Py_DECREF(reversal);
-        return FALSE;
-    }
-
-    are_strength_consistent = _QBAFramework_are_strength_consistent(other, (QBAFrameworkObject*)reversal, arg1, arg2);
-    Py_DECREF(reversal);
-    if (are_strength_consistent < 0) {
-        return -1;
-    }
-    return !are_strength_consistent;
+    return _QBAFramework_isExplanation(self, other, set, arg1, arg2, _QBAFramework_checkSSIExplanation);
 }
 
 /**
@@ -2538,28 +4655,7 @@ _QBAFramework_isSSIExplanation(QBAFrameworkObject *self, QBAFrameworkObject *oth
 static int
 _QBAFramework_isCSIExplanation(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *set, PyObject *arg1, PyObject *arg2)
 {
-    PyObject *reversal = _QBAFramework_reversal(self, other, set);
-    if (reversal == NULL) {
-        return -1;
-    }
-
-    if (!_QBAFramework_isacyclic(reversal)) {
-        PyErr_WarnEx(PyExc_Warning, "Acyclic reversal of a QBAF was found when checking if it was a CSI Explanation. "
-                                    "False was returned instead.", 1);
-        Py_DECREF(reversal);
-        return FALSE;
-    }
-
-    int are_strength_consistent = _QBAFramework_are_strength_consistent(other, (QBAFrameworkObject*)reversal, arg1, arg2);
-    Py_DECREF(reversal);
-    if (are_strength_consistent < 0) {
-        return -1;
-    }
-    if (!are_strength_consistent) {
-        return FALSE;
-    }
-
-    return _QBAFramework_isSSIExplanation(self, other, set, arg1, arg2);
+    return _QBAFramework_isExplanation(self, other, set, arg1, arg2, _QBAFramework_checkCSIExplanation);
 }
 
 /**
@@ -2577,20 +4673,34 @@ _QBAFramework_isCSIExplanation(QBAFrameworkObject *self, QBAFrameworkObject *oth
 static int
 _QBAFramework_isNSIExplanation(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *set, PyObject *arg1, PyObject *arg2)
 {
-    // if not isSSIExplanation: return False
-    int isSSIExplanation = _QBAFramework_isSSIExplanation(self, other, set, arg1, arg2);
-    if (isSSIExplanation < 0)
+    QBAFExplanationContext context;
+    if (_QBAFExplanationContext_Init(&context, self, other, arg1, arg2) < 0) {
         return -1;
-    if (!isSSIExplanation)
-        return FALSE;
+    }
+
+    Py_ssize_t *members, count;
+    if (_QBAFExplanationContext_members(&context, set, &members, &count) < 0) {
+        _QBAFExplanationContext_Free(&context);
+        return -1;
+    }
+
+    // if not isSSIExplanation: return False
+    int isSSIExplanation = _QBAFramework_isExplanation_members(&context, _QBAFramework_checkSSIExplanation, members, count);
+    PyMem_Free(members);
+    if (isSSIExplanation <= 0) {
+        _QBAFExplanationContext_Free(&context);
+        return isSSIExplanation;
+    }
 
     PyObject *self_arguments_union_other_arguments = PySet_Union(self->arguments, other->arguments);
     if (self_arguments_union_other_arguments == NULL) {
+        _QBAFExplanationContext_Free(&context);
         return -1;
     }
     PyObject *self_arguments_union_other_arguments_difference_set = PySet_Difference(self_arguments_union_other_arguments, set);
     Py_DECREF(self_arguments_union_other_arguments);
     if (self_arguments_union_other_arguments_difference_set == NULL) {
+        _QBAFExplanationContext_Free(&context);
         return -1;
     }
 
@@ -2602,38 +4712,47 @@ _QBAFramework_isNSIExplanation(QBAFrameworkObject *self, QBAFrameworkObject *oth
         subsets = PySet_SubSets(self_arguments_union_other_arguments_difference_set, size);
         if (subsets == NULL) {
             Py_DECREF(self_arguments_union_other_arguments_difference_set);
+            _QBAFExplanationContext_Free(&context);
             return -1;
         }
 
         iterator = PyObject_GetIter(subsets);
         if (iterator == NULL) {
             Py_DECREF(subsets); Py_DECREF(self_arguments_union_other_arguments_difference_set);
+            _QBAFExplanationContext_Free(&context);
             return -1;
         }
 
         while ((currentset = PyIter_Next(iterator))) {
-            isSSIExplanation = _QBAFramework_isSSIExplanation(self, other, currentset, arg1, arg2);
-            if (isSSIExplanation < 0) {
-                Py_DECREF(subsets); Py_DECREF(self_arguments_union_other_arguments_difference_set);
-                Py_DECREF(currentset); Py_DECREF(iterator);
-                return -1;
+            if (_QBAFExplanationContext_members(&context, currentset, &members, &count) < 0) {
+                isSSIExplanation = -1;
+            } else {
+                isSSIExplanation = _QBAFramework_isExplanation_members(&context, _QBAFramework_checkSSIExplanation,
+                                                                       members, count);
+                PyMem_Free(members);
             }
+            Py_DECREF(currentset);
 
             // if any subset isSSIExplanation: return False
-            if (isSSIExplanation) {
+            if (isSSIExplanation != FALSE) {
                 Py_DECREF(subsets); Py_DECREF(self_arguments_union_other_arguments_difference_set);
-                Py_DECREF(currentset); Py_DECREF(iterator);
-                return FALSE;
+                Py_DECREF(iterator);
+                _QBAFExplanationContext_Free(&context);
+                return isSSIExplanation < 0 ? -1 : FALSE;
             }
-
-            Py_DECREF(currentset);
         }
 
         Py_DECREF(iterator);
         Py_DECREF(subsets);
+        if (PyErr_Occurred()) {
+            Py_DECREF(self_arguments_union_other_arguments_difference_set);
+            _QBAFExplanationContext_Free(&context);
+            return -1;
+        }
     }
 
     Py_DECREF(self_arguments_union_other_arguments_difference_set);
+    _QBAFExplanationContext_Free(&context);
 
     // return True
     return TRUE;
@@ -2953,115 +5072,65 @@ QBAFramework_isNSIExplanation(QBAFrameworkObject *self, PyObject *args, PyObject
 }
 
 /**
- * @brief Return a list with the arguments that are attacking/supporting Argument argument directly or indirectly,
- * NULL if an error has occurred.
+ * @brief Add to the set result the Argument argument and the arguments that are attacking/supporting it
+ * directly or indirectly. Return 0 if succeeded, -1 if an error has occurred.
+ * The attackers/supporters are walked through borrowed views of the relations, so no list is allocated per argument.
  * 
  * @param self an instance of QBAFramework
  * @param argument an instance of QBAFArgument
  * @param not_visited a PySet of QBAFArgument that have not been visited yet (this set is modified in this function)
  * @param visiting a PySet of QBAFArgument that are being visited within this function
- * @return PyObject* a new PyList of QBAFArgument objects 
+ * @param result a PySet where the influential arguments are added
+ * @return int 0 if succeeded, -1 if an error occurred
  */
-static PyObject *
-_QBAFramework_influential_arguments(QBAFrameworkObject *self, PyObject *argument, PyObject *not_visited, PyObject *visiting)
+static int
+_QBAFramework_influential_arguments(QBAFrameworkObject *self, PyObject *argument, PyObject *not_visited, PyObject *visiting,
+                                    PyObject *result)
 {
+    if (PySet_Add(result, argument) < 0) {
+        return -1;
+    }
+
     int contains = PySet_Contains(visiting, argument);
     if (contains < 0) {
-        return NULL;
+        return -1;
     }
-    if (contains) { // If argument is being visited, do not visit it again but return it
-        PyObject *list = PyList_New(1);
-        if (list == NULL)
-            return NULL;
-        Py_INCREF(argument);
-        PyList_SET_ITEM(list, 0, argument);
-        return list;
+    if (contains) { // If argument is being visited, do not visit it again
+        return 0;
     }
 
     if (PySet_Add(visiting, argument) < 0) {    // We add the argument to visiting
-        return NULL;
-    }
-    PyObject *attack_agents, *support_agents;
-    PyObject *agents, *result, *previous_result, *influential_arguments;
-
-    attack_agents = _QBAFARelations_agents((QBAFARelationsObject*)self->attack_relations, argument);
-    if (attack_agents == NULL) {
-        return NULL;
-    }
-    support_agents = _QBAFARelations_agents((QBAFARelationsObject*)self->support_relations, argument);
-    if (support_agents == NULL) {
-        Py_DECREF(attack_agents);
-    }
-
-    agents = PyList_Concat(attack_agents, support_agents);
-    Py_DECREF(attack_agents);
-    Py_DECREF(support_agents);
-    if (agents == NULL) {
-        return NULL;
-    }
-
-    // result = [argument]
-    result = PyList_New(1);
-    if (result == NULL) {
-        Py_DECREF(agents);
-        return NULL;
-    }
-    Py_INCREF(argument);
-    PyList_SET_ITEM(result, 0, argument);
-
-    PyObject *iterator = PyObject_GetIter(agents);
-    PyObject *item;
-
-    if (iterator == NULL) {
-        Py_DECREF(agents);
-        Py_DECREF(result);
-        return NULL;
+        return -1;
     }
 
-    while ((item = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        contains = PySet_Contains(not_visited, item);
-        if (contains < 0) {
-            Py_DECREF(agents); Py_DECREF(result);
-            Py_DECREF(iterator); Py_DECREF(item);
-            return NULL;
+    PyObject *relations[2] = {self->attack_relations, self->support_relations};
+    for (int relation = 0; relation < 2; relation++) {
+        QBAFANeighbours agents;
+        if (QBAFANeighbours_Init(&agents, (QBAFARelationsObject*)relations[relation], argument, 0) < 0) {
+            return -1;
         }
 
-        if (contains) {
-            previous_result = result;
-            influential_arguments = _QBAFramework_influential_arguments(self, item, not_visited, visiting);
-            if (influential_arguments == NULL) {
-                Py_DECREF(agents); Py_DECREF(previous_result);
-                Py_DECREF(iterator); Py_DECREF(item);
-                return NULL;
+        PyObject *agent;
+        while ((agent = QBAFANeighbours_Next(&agents))) {  // Borrowed reference
+            contains = PySet_Contains(not_visited, agent);
+            if (contains < 0) {
+                return -1;
             }
-
-            result = PyList_Concat(previous_result, influential_arguments);
-            Py_DECREF(previous_result);
-            Py_DECREF(influential_arguments);
-            if (result == NULL) {
-                Py_DECREF(agents);
-                Py_DECREF(iterator); Py_DECREF(item);
-                return NULL;
+            if (contains && _QBAFramework_influential_arguments(self, agent, not_visited, visiting, result) < 0) {
+                return -1;
             }
         }
-
-        Py_DECREF(item);
     }
 
-    Py_DECREF(iterator);
-    Py_DECREF(agents);
-
     if (PySet_Discard(not_visited, argument) < 0) { // We remove the argument from not visited
-        Py_DECREF(result);
-        return NULL;
+        return -1;
     }
 
     if (PySet_Discard(visiting, argument) < 0) { // We remove the argument from visiting
-        Py_DECREF(result);
-        return NULL;
+        return -1;
     }
 
-    return result;
+    return 0;
 }
 
 /**
@@ -3087,39 +5156,22 @@ _QBAFramework_influential_arguments_set(QBAFrameworkObject *self, PyObject *arg1
         return NULL;
     }
 
-    PyObject *influential_arg1 = _QBAFramework_influential_arguments(self, arg1, not_visited, visiting);
-    if (influential_arg1 == NULL) {
+    PyObject *set = PySet_New(NULL);
+    if (set == NULL) {
         Py_DECREF(not_visited); Py_DECREF(visiting);
         return NULL;
     }
 
-    PyObject *influential_arg2 = _QBAFramework_influential_arguments(self, arg2, not_visited, visiting);
-    if (influential_arg2 == NULL) {
+    if (_QBAFramework_influential_arguments(self, arg1, not_visited, visiting, set) < 0
+        || _QBAFramework_influential_arguments(self, arg2, not_visited, visiting, set) < 0) {
         Py_DECREF(not_visited); Py_DECREF(visiting);
-        Py_DECREF(influential_arg1);
+        Py_DECREF(set);
         return NULL;
     }
 
     Py_DECREF(not_visited);
     Py_DECREF(visiting);
 
-    PyObject *influential_arguments = PyList_Concat(influential_arg1, influential_arg2);
-    if (influential_arguments == NULL) {
-        Py_DECREF(influential_arg1); Py_DECREF(influential_arg2);
-        return NULL;
-    }
-
-    Py_DECREF(influential_arg1);
-    Py_DECREF(influential_arg2);
-
-    PyObject *set = PySet_New(influential_arguments);
-    if (set == NULL) {
-        Py_DECREF(influential_arguments);
-        return NULL;
-    }
-
-    Py_DECREF(influential_arguments);
-
     return set;
 }
 
@@ -3181,155 +5233,501 @@ _QBAFramework_candidate_argument(QBAFrameworkObject *self, QBAFrameworkObject *o
         return TRUE;
     }
 
-    // return False
-    return FALSE;
+    // return False
+    return FALSE;
+}
+
+/**
+ * @brief Return a new PyList with the candidate arguments of arg1 and arg2 w.r.t. QBAFramework self (QBF')
+ * and QBAFramework other (QBF), i.e. the influential arguments of arg1 or arg2 that are 'different'
+ * in self and other, NULL if an error was encountered.
+ * 
+ * @param self an instance of QBAFramework
+ * @param other a different instance of QBAFramework
+ * @param arg1 a QBAFArgument
+ * @param arg2 a QBAFArgument
+ * @return PyObject* new PyList, NULL if an error occurred
+ */
+static PyObject *
+_QBAFramework_candidate_arguments(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *arg1, PyObject *arg2)
+{
+    // Obtain the influential arguments (arguments that attack/support arg1 or arg2, directly or indirectly)
+    PyObject *self_influential_arguments = _QBAFramework_influential_arguments_set(self, arg1, arg2);
+    if (self_influential_arguments == NULL) {
+        return NULL;
+    }
+
+    PyObject *other_influential_arguments = _QBAFramework_influential_arguments_set(other, arg1, arg2);
+    if (other_influential_arguments == NULL) {
+        Py_DECREF(self_influential_arguments);
+        return NULL;
+    }
+
+    PyObject *influential_arguments = PySet_Union(self_influential_arguments, other_influential_arguments);
+    Py_DECREF(self_influential_arguments);
+    Py_DECREF(other_influential_arguments);
+    if (influential_arguments == NULL) {
+        return NULL;
+    }
+
+    // Filter the candidate arguments (arguments that are 'different' in self and other)
+    PyObject *candidate_arguments = PyList_New(0);
+    if (candidate_arguments == NULL) {
+        Py_DECREF(influential_arguments);
+        return NULL;
+    }
+
+    PyObject *iterator = PyObject_GetIter(influential_arguments);
+    PyObject *argument;
+    int candidate;
+
+    if (iterator == NULL) {
+        Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
+        return NULL;
+    }
+
+    while ((argument = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
+        candidate = _QBAFramework_candidate_argument(self, other, argument);
+        if (candidate < 0) {
+            Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
+            Py_DECREF(argument); Py_DECREF(iterator);
+            return NULL;
+        }
+        
+        if (candidate) {
+            if (PyList_Append(candidate_arguments, argument) < 0) {
+                Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
+                Py_DECREF(argument); Py_DECREF(iterator);
+                return NULL;
+            }
+        }
+
+        Py_DECREF(argument);
+    }
+
+    Py_DECREF(iterator);
+    Py_DECREF(influential_arguments);
+
+    if (PyErr_Occurred()) {
+        Py_DECREF(candidate_arguments);
+        return NULL;
+    }
+
+    return candidate_arguments;
+}
+
+/**
+ * @brief Return a new PyList with a PySet containing only the empty set, NULL if an error was encountered.
+ * It is the result of the minimal explanations when the arguments are strength consistent.
+ * 
+ * @return PyObject* new PyList, NULL if an error occurred
+ */
+static PyObject *
+_QBAFramework_empty_explanation(void)
+{
+    PyObject *empty_set = PySet_New(NULL);
+    if (empty_set == NULL) {
+        return NULL;
+    }
+    PyObject *list = PyList_New(1);
+    if (list == NULL) {
+        Py_DECREF(empty_set);
+        return NULL;
+    }
+    PyList_SET_ITEM(list, 0, empty_set);
+    return list;
+}
+
+#define EXPLANATION_BATCH 1024  /* maximum number of subsets of the same size that are checked at once */
+
+/**
+ * @brief Struct with a batch of subsets of candidate arguments (of the same size) that are checked
+ * by _QBAFramework_check_batch, and the workspace of every thread that checks them.
+ * 
+ */
+typedef struct {
+    QBAFExplanationContext *context;
+    QBAFExplanationCheck    check;
+    QBAFOverlay           **overlays;   /* overlay of every thread (the first one is the overlay of context) */
+    Py_ssize_t             *members;    /* members of the subset of every thread (candidates indices each) */
+    Py_ssize_t             *indices;    /* index in the overlay of every candidate */
+    Py_ssize_t              candidates; /* number of candidates */
+    Py_ssize_t              words;      /* number of words of a subset (QBAFBitset_Words of candidates) */
+    QBAFBitsetWord         *sets;       /* the subsets of the batch: the words from i * words are the subset i
+                                           (EXPLANATION_BATCH subsets) */
+    int                     results[EXPLANATION_BATCH];     /* the result of check of every subset */
+    const char             *warnings[EXPLANATION_BATCH];    /* the warning of check of every subset, or NULL */
+} QBAFExplanationBatch;
+
+/**
+ * @brief Check the subsets [start, end) of the QBAFExplanationBatch task with the workspace of the thread thread
+ * (QBAFParallelBody). The results are -1 if an error has occurred.
+ * 
+ * @param task a QBAFExplanationBatch
+ * @param thread the number of the thread
+ * @param start first subset (included)
+ * @param end last subset (excluded)
+ */
+static void
+_QBAFramework_check_subsets(void *task, int thread, Py_ssize_t start, Py_ssize_t end)
+{
+    QBAFExplanationBatch *batch = task;
+    Py_ssize_t *members = batch->members + thread * batch->candidates;
+
+    for (Py_ssize_t position = start; position < end; position++) {
+        Py_ssize_t size = 0;
+        const QBAFBitsetWord *set = batch->sets + position * batch->words;
+        for (Py_ssize_t candidate = 0; candidate < batch->candidates; candidate++) {
+            if (QBAFBitset_Contains(set, candidate))
+                members[size++] = batch->indices[candidate];
+        }
+        batch->results[position] = batch->check(batch->context, batch->overlays[thread], members, size,
+                                                &batch->warnings[position]);
+        if (batch->results[position] < 0)   // Only with Python semantics, which are checked in the current thread
+            break;
+    }
+}
+
+/**
+ * @brief Check the first size subsets of the QBAFExplanationBatch batch with the threads of pool.
+ * With built-in semantics the subsets are checked in parallel with the GIL released,
+ * with Python semantics they are checked in the current thread.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ * 
+ * @param batch a QBAFExplanationBatch
+ * @param size the number of subsets of the batch
+ * @param pool a QBAFParallelPool (with at most as many threads as overlays of batch)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+_QBAFramework_check_batch(QBAFExplanationBatch *batch, Py_ssize_t size, QBAFParallelPool *pool)
+{
+    if (_QBAFramework_builtin_semantics(batch->context->self)) {
+        return QBAFParallel_For(pool, _QBAFramework_check_subsets, batch, size, 1);
+    }
+
+    for (Py_ssize_t position = 0; position < size; position++) {
+        _QBAFramework_check_subsets(batch, 0, position, position + 1);
+        if (batch->results[position] < 0) {
+            return -1;
+        }
+    }
+    return 0;
 }
 
 /**
- * @brief Return a list of all the sets of arguments that are minimal SSI Explanations of arg1 and arg2
- * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
+ * @brief Return the time of a monotonic clock in milliseconds.
+ * 
+ * @return double the time in milliseconds
+ */
+static double
+_QBAFramework_monotonic_ms(void)
+{
+    struct timespec now;
+#ifdef _WIN32
+    timespec_get(&now, TIME_UTC);   // There is no monotonic clock in the C standard
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Struct with the state of the search of the minimal subsets of candidate arguments that are explanations
+ * (according to a QBAFExplanationCheck) of arg1 and arg2 w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF).
+ * The subsets are enumerated lazily as bitsets in ascending order of size, skipping the supersets
+ * of the explanations already found and the subsets that do not intersect every bitset of masks.
+ * The subsets of the same size cannot contain each other, so they are checked in batches
+ * (in parallel with self->threads threads if self has built-in semantics, by a pool that lives as long as the search),
+ * and the explanations of a batch are accepted in the order of enumeration before enumerating the next subsets.
+ * Hence every explanation is minimal as soon as its batch has been checked.
+ * The limits are checked before every batch.
+ * 
+ */
+typedef struct {
+    QBAFSubsets             subsets;
+    QBAFExplanationContext  context;
+    QBAFExplanationBatch   *batch;          /* the current batch and the workspace of every thread */
+    int                     threads;        /* number of threads (as many as overlays of batch) */
+    QBAFParallelPool       *pool;           /* the threads that check the batches */
+    Py_ssize_t              limit;          /* maximum number of subsets of a batch (at most EXPLANATION_BATCH) */
+    Py_ssize_t              size;           /* number of subsets of the current batch */
+    Py_ssize_t              position;       /* next subset of the current batch to be merged */
+    Py_ssize_t              evaluations;    /* number of subsets checked */
+    int                     max_size;       /* greater subsets are not checked */
+    Py_ssize_t              max_evaluations;    /* maximum number of subsets checked, -1 if unlimited */
+    double                  deadline;       /* no batch is checked after this time (_QBAFramework_monotonic_ms),
+                                               -1.0 if unlimited */
+    int                     stopped;        /* 1 if the search has been stopped by a limit, 0 if not */
+} QBAFExplanationSearch;
+
+/**
+ * @brief Free the memory of the QBAFExplanationSearch search. It does nothing if search is NULL.
+ * 
+ * @param search a QBAFExplanationSearch allocated with PyMem
+ */
+static void
+_QBAFExplanationSearch_Free(QBAFExplanationSearch *search)
+{
+    if (search == NULL)
+        return;
+
+    QBAFExplanationBatch *batch = search->batch;
+    if (batch != NULL) {
+        if (batch->overlays != NULL) {
+            for (int thread = 1; thread < search->threads; thread++)
+                QBAFOverlay_Free(batch->overlays[thread]);
+        }
+        PyMem_Free(batch->overlays);
+        PyMem_Free(batch->members);
+        PyMem_Free(batch->indices);
+        PyMem_Free(batch->sets);
+        PyMem_Free(batch);
+    }
+    QBAFParallelPool_Free(search->pool);
+    QBAFSubsets_Free(&search->subsets);
+    _QBAFExplanationContext_Free(&search->context);
+    PyMem_Free(search);
+}
+
+/**
+ * @brief Return a new QBAFExplanationSearch of the minimal subsets of candidate_arguments that are explanations
+ * (according to check) of arg1 and arg2 w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF),
+ * checked in batches of at most limit subsets and without any other limit.
+ * Return NULL if an error has occurred.
  * 
  * @param self an instance of QBAFramework
  * @param other a different instance of QBAFramework
  * @param arg1 a QBAFArgument
  * @param arg2 a QBAFArgument
- * @return PyObject* new PyList, NULL if an error occurred
+ * @param candidate_arguments a PyList of distinct QBAFArgument
+ * @param masks an array of count bitsets over candidate_arguments that must outlive the search (NULL if count is 0)
+ * @param count the number of masks
+ * @param check the function that decides whether a set is an explanation
+ * @param limit the maximum number of subsets of a batch (from 1 to EXPLANATION_BATCH)
+ * @return QBAFExplanationSearch* a new QBAFExplanationSearch (free it with _QBAFExplanationSearch_Free), NULL if an error occurred
  */
-static inline PyObject *
-_QBAFramework_minimalSSIExplanations(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *arg1, PyObject *arg2)
+static QBAFExplanationSearch *
+_QBAFExplanationSearch_New(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *arg1, PyObject *arg2,
+                           PyObject *candidate_arguments, const QBAFBitsetWord *masks, Py_ssize_t count,
+                           QBAFExplanationCheck check, Py_ssize_t limit)
 {
-    // If strength consistent return a list with empty set
-    int strength_consistent = _QBAFramework_are_strength_consistent(self, other, arg1, arg2);
-    if (strength_consistent < 0) {
+    QBAFExplanationSearch *search = PyMem_Calloc(1, sizeof(QBAFExplanationSearch));
+    if (search == NULL) {
+        PyErr_NoMemory();
         return NULL;
     }
-    if (strength_consistent) {
-        PyObject *empty_set = PySet_New(NULL);
-        if (empty_set == NULL) {
-            return NULL;
-        }
-        PyObject *list = PyList_New(1);
-        if (list == NULL) {
-            Py_DECREF(empty_set);
-            return NULL;
-        }
-        PyList_SET_ITEM(list, 0, empty_set);
-        return list;
+    if (QBAFSubsets_Init(&search->subsets, PyList_GET_SIZE(candidate_arguments), masks, count) < 0) {
+        PyMem_Free(search);
+        return NULL;
     }
-
-    // Obtain the influential arguments (arguments that attack/support arg1 or arg2, directly or indirectly)
-    PyObject *self_influential_arguments = _QBAFramework_influential_arguments_set(self, arg1, arg2);
-    if (self_influential_arguments == NULL) {
+    if (_QBAFExplanationContext_Init(&search->context, self, other, arg1, arg2) < 0) {
+        QBAFSubsets_Free(&search->subsets);
+        PyMem_Free(search);
         return NULL;
     }
 
-    PyObject *other_influential_arguments = _QBAFramework_influential_arguments_set(other, arg1, arg2);
-    if (other_influential_arguments == NULL) {
-        Py_DECREF(self_influential_arguments);
+    // Only built-in semantics are checked in parallel
+    search->threads = _QBAFramework_builtin_semantics(self) ? self->threads : 1;
+    search->limit = limit;
+    search->max_size = INT_MAX;
+    search->max_evaluations = -1;
+    search->deadline = -1.0;
+
+    QBAFExplanationBatch *batch = search->batch = PyMem_Calloc(1, sizeof(QBAFExplanationBatch));
+    if (batch == NULL) {
+        _QBAFExplanationSearch_Free(search);
+        PyErr_NoMemory();
         return NULL;
     }
 
-    PyObject *influential_arguments = PySet_Union(self_influential_arguments, other_influential_arguments);
-    if (influential_arguments == NULL) {
-        Py_DECREF(self_influential_arguments); Py_DECREF(other_influential_arguments);
+    // Index of every candidate in the overlay, and the workspace of every thread
+    if (_QBAFExplanationContext_members(&search->context, candidate_arguments, &batch->indices, &batch->candidates) < 0) {
+        batch->indices = NULL;
+        _QBAFExplanationSearch_Free(search);
         return NULL;
     }
-
-    Py_DECREF(self_influential_arguments);
-    Py_DECREF(other_influential_arguments);
-
-    // Filter the candidate arguments (arguments that are 'different' in self and other)
-    PyObject *candidate_arguments = PySet_New(NULL);
-    if (candidate_arguments == NULL) {
-        Py_DECREF(influential_arguments);
+    batch->words = search->subsets.words;
+    batch->sets = PyMem_New(QBAFBitsetWord, EXPLANATION_BATCH * batch->words);
+    batch->members = PyMem_New(Py_ssize_t, search->threads * batch->candidates + 1);
+    batch->overlays = PyMem_Calloc(search->threads, sizeof(QBAFOverlay *));
+    if (batch->sets == NULL || batch->members == NULL || batch->overlays == NULL) {
+        _QBAFExplanationSearch_Free(search);
+        PyErr_NoMemory();
         return NULL;
     }
+    batch->overlays[0] = search->context.overlay;
+    for (int thread = 1; thread < search->threads; thread++) {
+        batch->overlays[thread] = QBAFOverlay_Fork(search->context.overlay);
+        if (batch->overlays[thread] == NULL) {
+            _QBAFExplanationSearch_Free(search);
+            return NULL;
+        }
+    }
+    batch->context = &search->context;
+    batch->check = check;
 
-    PyObject *iterator = PyObject_GetIter(influential_arguments);
-    PyObject *argument;
-    int candidate;
+    search->pool = QBAFParallelPool_New(search->threads);
+    if (search->pool == NULL) {
+        _QBAFExplanationSearch_Free(search);
+        return NULL;
+    }
 
-    if (iterator == NULL) {
-        Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
+    // The threads must not calculate it
+    if (_QBAFExplanationContext_consistent(&search->context) < 0) {
+        _QBAFExplanationSearch_Free(search);
         return NULL;
     }
 
-    while ((argument = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        candidate = _QBAFramework_candidate_argument(self, other, argument);
-        if (candidate < 0) {
-            Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
-            Py_DECREF(argument); Py_DECREF(iterator);
-            return NULL;
-        }
-        
-        if (candidate) {
-            if (PySet_Add(candidate_arguments, argument) < 0) {
-                Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
-                Py_DECREF(argument); Py_DECREF(iterator);
-                return NULL;
+    return search;
+}
+
+/**
+ * @brief Store in explanation the next minimal explanation of the QBAFExplanationSearch search.
+ * Return 1 if there is a next explanation, 0 if the search has finished (search->stopped is 1
+ * if it has been stopped by a limit), -1 if an error has occurred.
+ * 
+ * @param search a QBAFExplanationSearch
+ * @param explanation a pointer where the explanation is stored (a bitset over the candidates,
+ * valid until the next call)
+ * @return int 1 if there is a next explanation, 0 if not, -1 if an error occurred
+ */
+static int
+_QBAFExplanationSearch_Next(QBAFExplanationSearch *search, const QBAFBitsetWord **explanation)
+{
+    QBAFExplanationBatch *batch = search->batch;
+
+    for (;;) {
+        // Merge the results of the current batch in the order of enumeration
+        while (search->position < search->size) {
+            Py_ssize_t position = search->position++;
+            if (batch->warnings[position] != NULL) {
+                PyErr_WarnEx(PyExc_Warning, batch->warnings[position], 1);
+            }
+            if (batch->results[position]) {     // None of its supersets will be enumerated
+                const QBAFBitsetWord *set = batch->sets + position * batch->words;
+                if (QBAFSubsets_Accept(&search->subsets, set) < 0) {
+                    return -1;
+                }
+                *explanation = set;
+                return 1;
             }
         }
 
-        Py_DECREF(argument);
-    }
+        if (search->stopped) {
+            return 0;
+        }
+        int next = QBAFSubsets_Next(&search->subsets);
+        if (next <= 0) {
+            return next;
+        }
 
-    Py_DECREF(iterator);
-    Py_DECREF(influential_arguments);
+        Py_ssize_t limit = search->limit;
+        if (search->max_evaluations >= 0 && search->max_evaluations - search->evaluations < limit)
+            limit = search->max_evaluations - search->evaluations;
+        if (limit <= 0 || search->subsets.cardinality > search->max_size ||
+            (search->deadline >= 0.0 && _QBAFramework_monotonic_ms() >= search->deadline)) {
+            search->stopped = 1;
+            return 0;
+        }
 
-    // Find SSI Explanations trying with size from 1 to length of candidate_arguments
-    Py_ssize_t max_size = PySet_GET_SIZE(candidate_arguments);
-    PyObject *subsets, *explanations, *set;
-    int contains_subset, isSSIExplanation;
+        Py_ssize_t size = 0;
+        do {
+            memcpy(batch->sets + size++ * batch->words, search->subsets.current, batch->words * sizeof(QBAFBitsetWord));
+        } while (size < limit && QBAFSubsets_NextOfSize(&search->subsets));
 
-    explanations = PyList_New(0);
-    if (explanations == NULL) {
-        Py_DECREF(candidate_arguments);
-        return NULL;
+        search->position = search->size = 0;
+        if (_QBAFramework_check_batch(batch, size, search->pool) < 0) {
+            return -1;
+        }
+        search->size = size;
+        search->evaluations += size;
     }
+}
 
-    subsets = PySet_PowersetWithoutEmptySet(candidate_arguments);
-    if (subsets == NULL) {
-        Py_DECREF(candidate_arguments); Py_DECREF(explanations);
+/**
+ * @brief Return a list of all the minimal subsets of candidate_arguments that are explanations (according to check)
+ * of arg1 and arg2 w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
+ * They are found by a QBAFExplanationSearch, and only the explanations are converted into PySets.
+ * 
+ * @param self an instance of QBAFramework
+ * @param other a different instance of QBAFramework
+ * @param arg1 a QBAFArgument
+ * @param arg2 a QBAFArgument
+ * @param candidate_arguments a PyList of distinct QBAFArgument
+ * @param masks an array of count bitsets over candidate_arguments (it can be NULL if count is 0)
+ * @param count the number of masks
+ * @param check the function that decides whether a set is an explanation
+ * @return PyObject* new PyList, NULL if an error occurred
+ */
+static PyObject *
+_QBAFramework_minimal_explanations(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *arg1, PyObject *arg2,
+                                   PyObject *candidate_arguments, const QBAFBitsetWord *masks, Py_ssize_t count,
+                                   QBAFExplanationCheck check)
+{
+    QBAFExplanationSearch *search = _QBAFExplanationSearch_New(self, other, arg1, arg2, candidate_arguments,
+                                                               masks, count, check, EXPLANATION_BATCH);
+    if (search == NULL) {
         return NULL;
     }
 
-    iterator = PyObject_GetIter(subsets);
-    if (iterator == NULL) {
-        Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
+    PyObject *explanations = PyList_New(0);
+    if (explanations == NULL) {
+        _QBAFExplanationSearch_Free(search);
         return NULL;
     }
 
-    while ((set = PyIter_Next(iterator))) {
-        contains_subset = PyList_ContainsSubset(explanations, set);
-        if (contains_subset < 0) {
-            Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
-            Py_DECREF(set); Py_DECREF(iterator);
-            return NULL;
+    const QBAFBitsetWord *set;
+    int found;
+    while ((found = _QBAFExplanationSearch_Next(search, &set)) > 0) {
+        PyObject *explanation = QBAFBitset_ToSet(set, candidate_arguments);
+        if (explanation == NULL || PyList_Append(explanations, explanation) < 0) {
+            Py_XDECREF(explanation);
+            found = -1;
+            break;
         }
-        
-        if (!contains_subset) { // If set is not a superset of any explanation
-            isSSIExplanation = _QBAFramework_isSSIExplanation(self, other, set, arg1, arg2);
-            if (isSSIExplanation < 0) {
-                Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
-                Py_DECREF(set); Py_DECREF(iterator);
-                return NULL;
-            }
+        Py_DECREF(explanation);
+    }
 
-            if (isSSIExplanation) {
-                if (PyList_Append(explanations, set) < 0) {
-                    Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
-                    Py_DECREF(set); Py_DECREF(iterator);
-                    return NULL;
-                }
-            }
-        }
+    _QBAFExplanationSearch_Free(search);
+    if (found < 0) {
+        Py_DECREF(explanations);
+        return NULL;
+    }
+    return explanations;
+}
 
-        Py_DECREF(set);
+/**
+ * @brief Return a list of all the sets of arguments that are minimal SSI Explanations of arg1 and arg2
+ * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
+ * 
+ * @param self an instance of QBAFramework
+ * @param other a different instance of QBAFramework
+ * @param arg1 a QBAFArgument
+ * @param arg2 a QBAFArgument
+ * @return PyObject* new PyList, NULL if an error occurred
+ */
+static inline PyObject *
+_QBAFramework_minimalSSIExplanations(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *arg1, PyObject *arg2)
+{
+    // If strength consistent return a list with empty set
+    int strength_consistent = _QBAFramework_are_strength_consistent(self, other, arg1, arg2);
+    if (strength_consistent < 0) {
+        return NULL;
+    }
+    if (strength_consistent) {
+        return _QBAFramework_empty_explanation();
     }
 
-    Py_DECREF(iterator);
-    Py_DECREF(subsets);
+    PyObject *candidate_arguments = _QBAFramework_candidate_arguments(self, other, arg1, arg2);
+    if (candidate_arguments == NULL) {
+        return NULL;
+    }
 
+    // Find SSI Explanations trying with size from 1 to length of candidate_arguments
+    PyObject *explanations = _QBAFramework_minimal_explanations(self, other, arg1, arg2,
+                                                                candidate_arguments, NULL, 0,
+                                                                _QBAFramework_checkSSIExplanation);
     Py_DECREF(candidate_arguments);
 
     return explanations;
@@ -3374,140 +5772,25 @@ QBAFramework_minimalSSIExplanations(QBAFrameworkObject *self, PyObject *args, Py
  */
 static inline PyObject *
 _QBAFramework_minimalCSIExplanations(QBAFrameworkObject *self, QBAFrameworkObject *other, PyObject *arg1, PyObject *arg2)
-{
-    // If strength consistent return a list with empty set
-    int strength_consistent = _QBAFramework_are_strength_consistent(self, other, arg1, arg2);
-    if (strength_consistent < 0) {
-        return NULL;
-    }
-    if (strength_consistent) {
-        PyObject *empty_set = PySet_New(NULL);
-        if (empty_set == NULL) {
-            return NULL;
-        }
-        PyObject *list = PyList_New(1);
-        if (list == NULL) {
-            Py_DECREF(empty_set);
-            return NULL;
-        }
-        PyList_SET_ITEM(list, 0, empty_set);
-        return list;
-    }
-
-    // Obtain the influential arguments (arguments that attack/support arg1 or arg2, directly or indirectly)
-    PyObject *self_influential_arguments = _QBAFramework_influential_arguments_set(self, arg1, arg2);
-    if (self_influential_arguments == NULL) {
-        return NULL;
-    }
-
-    PyObject *other_influential_arguments = _QBAFramework_influential_arguments_set(other, arg1, arg2);
-    if (other_influential_arguments == NULL) {
-        Py_DECREF(self_influential_arguments);
-        return NULL;
-    }
-
-    PyObject *influential_arguments = PySet_Union(self_influential_arguments, other_influential_arguments);
-    if (influential_arguments == NULL) {
-        Py_DECREF(self_influential_arguments); Py_DECREF(other_influential_arguments);
-        return NULL;
-    }
-
-    Py_DECREF(self_influential_arguments);
-    Py_DECREF(other_influential_arguments);
-
-    // Filter the candidate arguments (arguments that are 'different' in self and other)
-    PyObject *candidate_arguments = PySet_New(NULL);
-    if (candidate_arguments == NULL) {
-        Py_DECREF(influential_arguments);
-        return NULL;
-    }
-
-    PyObject *iterator = PyObject_GetIter(influential_arguments);
-    PyObject *argument;
-    int candidate;
-
-    if (iterator == NULL) {
-        Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
-        return NULL;
-    }
-
-    while ((argument = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        candidate = _QBAFramework_candidate_argument(self, other, argument);
-        if (candidate < 0) {
-            Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
-            Py_DECREF(argument); Py_DECREF(iterator);
-            return NULL;
-        }
-        
-        if (candidate) {
-            if (PySet_Add(candidate_arguments, argument) < 0) {
-                Py_DECREF(influential_arguments); Py_DECREF(candidate_arguments);
-                Py_DECREF(argument); Py_DECREF(iterator);
-                return NULL;
-            }
-        }
-
-        Py_DECREF(argument);
-    }
-
-    Py_DECREF(iterator);
-    Py_DECREF(influential_arguments);
-
-    // Find CSI Explanations trying with size from 1 to length of candidate_arguments
-    Py_ssize_t max_size = PySet_GET_SIZE(candidate_arguments);
-    PyObject *subsets, *explanations, *set;
-    int contains_subset, isCSIExplanation;
-
-    explanations = PyList_New(0);
-    if (explanations == NULL) {
-        Py_DECREF(candidate_arguments);
-        return NULL;
-    }
-
-    subsets = PySet_PowersetWithoutEmptySet(candidate_arguments);
-    if (subsets == NULL) {
-        Py_DECREF(candidate_arguments); Py_DECREF(explanations);
-        return NULL;
-    }
-
-    iterator = PyObject_GetIter(subsets);
-    if (iterator == NULL) {
-        Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
-        return NULL;
-    }
-
-    while ((set = PyIter_Next(iterator))) {
-        contains_subset = PyList_ContainsSubset(explanations, set);
-        if (contains_subset < 0) {
-            Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
-            Py_DECREF(set); Py_DECREF(iterator);
-            return NULL;
-        }
-        
-        if (!contains_subset) { // If set is not a superset of any explanation
-            isCSIExplanation = _QBAFramework_isCSIExplanation(self, other, set, arg1, arg2);
-            if (isCSIExplanation < 0) {
-                Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
-                Py_DECREF(set); Py_DECREF(iterator);
-                return NULL;
-            }
-
-            if (isCSIExplanation) {
-                if (PyList_Append(explanations, set) < 0) {
-                    Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(candidate_arguments);
-                    Py_DECREF(set); Py_DECREF(iterator);
-                    return NULL;
-                }
-            }
-        }
-
-        Py_DECREF(set);
+{
+    // If strength consistent return a list with empty set
+    int strength_consistent = _QBAFramework_are_strength_consistent(self, other, arg1, arg2);
+    if (strength_consistent < 0) {
+        return NULL;
+    }
+    if (strength_consistent) {
+        return _QBAFramework_empty_explanation();
     }
 
-    Py_DECREF(iterator);
-    Py_DECREF(subsets);
-
+    PyObject *candidate_arguments = _QBAFramework_candidate_arguments(self, other, arg1, arg2);
+    if (candidate_arguments == NULL) {
+        return NULL;
+    }
 
+    // Find CSI Explanations trying with size from 1 to length of candidate_arguments
+    PyObject *explanations = _QBAFramework_minimal_explanations(self, other, arg1, arg2,
+                                                                candidate_arguments, NULL, 0,
+                                                                _QBAFramework_checkCSIExplanation);
     Py_DECREF(candidate_arguments);
 
     return explanations;
@@ -3540,6 +5823,61 @@ QBAFramework_minimalCSIExplanations(QBAFrameworkObject *self, PyObject *args, Py
     return _QBAFramework_minimalCSIExplanations(self, (QBAFrameworkObject*)other, arg1, arg2);
 }
 
+/**
+ * @brief Store in candidate_arguments (a new PyList) the union of the PyList of PySet minimalSSIExplanations,
+ * and in masks (a new array of count bitsets) every set of minimalSSIExplanations as a bitset over candidate_arguments.
+ * The NSI Explanations are the SSI Explanations that intersect every minimal SSI Explanation (every mask).
+ * Return 0 if succeeded, -1 if an error has occurred.
+ * 
+ * @param minimalSSIExplanations a PyList of PySet with the minimal SSI Explanations
+ * @param candidate_arguments a pointer where the new PyList is stored
+ * @param masks a pointer where the new array is stored (free it with PyMem_Free)
+ * @param count a pointer where the number of masks is stored
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+_QBAFramework_nsi_candidates(PyObject *minimalSSIExplanations, PyObject **candidate_arguments,
+                             QBAFBitsetWord **masks, Py_ssize_t *count)
+{
+    PyObject *minimalSSIExplanations_unionset = PyListOfPySet_Union(minimalSSIExplanations); // Union of all arguments in minimal SSI Explanations
+    if (minimalSSIExplanations_unionset == NULL) {
+        return -1;
+    }
+
+    *candidate_arguments = PySequence_List(minimalSSIExplanations_unionset);
+    Py_DECREF(minimalSSIExplanations_unionset);
+    if (*candidate_arguments == NULL) {
+        return -1;
+    }
+
+    PyObject *indices = QBAFBitset_Indices(*candidate_arguments);
+    if (indices == NULL) {
+        Py_DECREF(*candidate_arguments);
+        return -1;
+    }
+
+    // The minimal SSI Explanations as bitsets over candidate_arguments
+    *count = PyList_GET_SIZE(minimalSSIExplanations);
+    Py_ssize_t words = QBAFBitset_Words(PyList_GET_SIZE(*candidate_arguments));
+    *masks = PyMem_Calloc(*count > 0 ? *count * words : 1, sizeof(QBAFBitsetWord));
+    if (*masks == NULL) {
+        Py_DECREF(*candidate_arguments); Py_DECREF(indices);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (Py_ssize_t i = 0; i < *count; i++) {
+        if (QBAFBitset_FromSet(PyList_GET_ITEM(minimalSSIExplanations, i), indices, *masks + i * words) < 0) {
+            Py_DECREF(*candidate_arguments); Py_DECREF(indices);
+            PyMem_Free(*masks);
+            return -1;
+        }
+    }
+
+    Py_DECREF(indices);
+    return 0;
+}
+
 /**
  * @brief Return a list of all the sets of arguments that are minimal NSI Explanations of arg1 and arg2
  * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
@@ -3559,181 +5897,573 @@ _QBAFramework_minimalNSIExplanations(QBAFrameworkObject *self, QBAFrameworkObjec
         return NULL;
     }
     if (strength_consistent) {
-        PyObject *empty_set = PySet_New(NULL);
-        if (empty_set == NULL) {
-            return NULL;
-        }
-        PyObject *list = PyList_New(1);
-        if (list == NULL) {
-            Py_DECREF(empty_set);
-            return NULL;
-        }
-        PyList_SET_ITEM(list, 0, empty_set);
-        return list;
-    }
-
-    PyObject *explanations = PyList_New(0);
-    if (explanations == NULL) {
-        return NULL;
+        return _QBAFramework_empty_explanation();
     }
 
     PyObject *minimalSSIExplanations = _QBAFramework_minimalSSIExplanations(self, other, arg1, arg2);
     if (minimalSSIExplanations == NULL) {
-        Py_DECREF(explanations);
         return NULL;
     }
 
-    PyObject *minimalSSIExplanations_unionset = PyListOfPySet_Union(minimalSSIExplanations); // Union of all arguments in minimal SSI Explanations
-    if (minimalSSIExplanations_unionset == NULL) {
-        Py_DECREF(explanations); Py_DECREF(minimalSSIExplanations);
+    PyObject *candidate_arguments;
+    QBAFBitsetWord *masks;
+    Py_ssize_t count;
+    int nsi_candidates = _QBAFramework_nsi_candidates(minimalSSIExplanations, &candidate_arguments, &masks, &count);
+    Py_DECREF(minimalSSIExplanations);
+    if (nsi_candidates < 0) {
         return NULL;
     }
 
-    PyObject *subsets = PySet_PowersetWithoutEmptySet(minimalSSIExplanations_unionset);
-    Py_DECREF(minimalSSIExplanations_unionset);
-    if (subsets == NULL) {
-        Py_DECREF(minimalSSIExplanations); Py_DECREF(explanations);
+    // Find NSI Explanations: SSI Explanations that have a non-empty intersection with every minimal SSI Explanation
+    // (so no minimal SSI Explanation is a subset of self->arguments.union(other->arguments).difference(set))
+    PyObject *explanations = _QBAFramework_minimal_explanations(self, other, arg1, arg2,
+                                                                candidate_arguments, masks, count,
+                                                                _QBAFramework_checkSSIExplanation);
+    PyMem_Free(masks);
+    Py_DECREF(candidate_arguments);
+
+    return explanations;
+}
+
+/**
+ * @brief Return a list of all the sets of arguments that are minimal NSI Explanations of arg1 and arg2
+ * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args a tuple with arguments (other: QBAFramework, arg1: QBAFArgument, arg2: QBAFArgument)
+ * @param kwds name of the arguments args
+ * @return PyObject* new PyList, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_minimalNSIExplanations(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"other", "arg1", "arg2", NULL};
+    PyObject *other, *arg1, *arg2;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO|", kwlist,
+                                     &other, &arg1, &arg2))
         return NULL;
-    }
 
-    // Discard sets that have an empty intersection with at least one minimal SSI Explanation
-    PyObject *filtered_subsets = PyList_New(0);
-    if (filtered_subsets == NULL) {
-        Py_DECREF(minimalSSIExplanations); Py_DECREF(explanations);
-        Py_DECREF(subsets);
+    if (!PyObject_TypeCheck(other, Py_TYPE(self))) {
+        PyErr_SetString(PyExc_TypeError, "other must be an instance of QBAFramework");
         return NULL;
     }
 
-    PyObject *iterator = PyObject_GetIter(subsets);
-    PyObject *set;
-    if (iterator == NULL) {
-        Py_DECREF(minimalSSIExplanations); Py_DECREF(explanations);
-        Py_DECREF(subsets); Py_DECREF(filtered_subsets);
+    return _QBAFramework_minimalNSIExplanations(self, (QBAFrameworkObject*)other, arg1, arg2);
+}
+
+#define EXPLANATION_ITERATOR_BATCH 16   /* number of subsets checked at once by every thread of a QBAFExplanationIterator,
+                                           small so that its limits are checked often */
+
+/**
+ * @brief Struct that defines the iterator returned by QBAFramework.iter_minimal_ssi_explanations,
+ * QBAFramework.iter_minimal_csi_explanations and QBAFramework.iter_minimal_nsi_explanations.
+ * It yields the minimal explanations of a QBAFExplanationSearch as soon as they are found, until a limit is reached.
+ * The NSI Explanations are searched after all the minimal SSI Explanations have been found.
+ * 
+ */
+typedef struct {
+    PyObject_HEAD
+    QBAFrameworkObject    *self;            /* the framework that is reversed (QBF') */
+    QBAFrameworkObject    *other;           /* the framework it is reversed into (QBF) */
+    PyObject              *arg1;
+    PyObject              *arg2;
+    PyObject              *candidate_arguments;     /* the candidates of search */
+    PyObject              *ssi_explanations;        /* the minimal SSI Explanations found before searching
+                                                       the NSI Explanations, NULL if they are not searched */
+    QBAFBitsetWord        *masks;           /* the masks of search (NSI Explanations), NULL if there are none */
+    QBAFExplanationSearch *search;          /* NULL if the search has finished */
+    int                    empty;           /* 1 if the empty set must be yielded (arg1 and arg2 are strength consistent) */
+    Py_ssize_t             results;         /* number of explanations yielded */
+    Py_ssize_t             max_results;     /* maximum number of explanations yielded, -1 if unlimited */
+    int                    max_size;        /* maximum size of the explanations */
+    Py_ssize_t             max_evaluations; /* maximum number of sets checked, -1 if unlimited */
+    double                 deadline;        /* no set is checked after this time (_QBAFramework_monotonic_ms), -1.0 if unlimited */
+    Py_ssize_t             evaluations;     /* number of sets checked by the finished searches */
+    int                    exhaustive;      /* 1 if every minimal explanation has been yielded, 0 if the search has been
+                                               stopped by a limit, -1 if it has not finished */
+    int                    running;         /* 1 while a call to next has not returned (it can release the GIL
+                                               or call Python semantics), 0 if not */
+} QBAFExplanationIteratorObject;
+
+static int
+QBAFExplanationIterator_traverse(QBAFExplanationIteratorObject *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->self);
+    Py_VISIT(self->other);
+    Py_VISIT(self->arg1);
+    Py_VISIT(self->arg2);
+    Py_VISIT(self->candidate_arguments);
+    Py_VISIT(self->ssi_explanations);
+    return 0;
+}
+
+/**
+ * @brief Free the QBAFExplanationSearch of the iterator (and its masks), keeping the count of its evaluations.
+ * 
+ * @param self an instance of QBAFExplanationIterator
+ */
+static void
+QBAFExplanationIterator_free_search(QBAFExplanationIteratorObject *self)
+{
+    if (self->search != NULL) {
+        self->evaluations += self->search->evaluations;
+        _QBAFExplanationSearch_Free(self->search);
+        self->search = NULL;
+    }
+    PyMem_Free(self->masks);
+    self->masks = NULL;
+}
+
+/**
+ * @brief Free the QBAFExplanationSearch of the iterator, so it finishes (exhaustive if exhaustive is 1).
+ * 
+ * @param self an instance of QBAFExplanationIterator
+ * @param exhaustive 1 if every minimal explanation has been yielded, 0 if not
+ */
+static void
+QBAFExplanationIterator_finish(QBAFExplanationIteratorObject *self, int exhaustive)
+{
+    QBAFExplanationIterator_free_search(self);
+    self->empty = 0;
+    if (self->exhaustive < 0)
+        self->exhaustive = exhaustive;
+}
+
+static int
+QBAFExplanationIterator_clear(QBAFExplanationIteratorObject *self)
+{
+    QBAFExplanationIterator_finish(self, FALSE);    // The search refers to the frameworks
+    Py_CLEAR(self->self);
+    Py_CLEAR(self->other);
+    Py_CLEAR(self->arg1);
+    Py_CLEAR(self->arg2);
+    Py_CLEAR(self->candidate_arguments);
+    Py_CLEAR(self->ssi_explanations);
+    return 0;
+}
+
+static void
+QBAFExplanationIterator_dealloc(QBAFExplanationIteratorObject *self)
+{
+    PyObject_GC_UnTrack(self);
+    QBAFExplanationIterator_clear(self);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+/**
+ * @brief Start the search of the iterator for the minimal subsets of candidate_arguments (stolen reference)
+ * that are explanations according to check and intersect every mask of masks (stolen array, it can be NULL),
+ * with the limits of the iterator (except max_size if all_sizes is 1).
+ * Return 0 if succeeded, -1 if an error has occurred.
+ * 
+ * @param self an instance of QBAFExplanationIterator without search
+ * @param candidate_arguments a PyList of distinct QBAFArgument (stolen reference)
+ * @param masks an array of count bitsets (stolen), NULL if count is 0
+ * @param count the number of masks
+ * @param check the function that decides whether a set is an explanation
+ * @param all_sizes 1 if the subsets of every size are checked, 0 if only those of at most max_size
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFExplanationIterator_start(QBAFExplanationIteratorObject *self, PyObject *candidate_arguments,
+                              QBAFBitsetWord *masks, Py_ssize_t count, QBAFExplanationCheck check, int all_sizes)
+{
+    Py_XSETREF(self->candidate_arguments, candidate_arguments);
+    self->masks = masks;
+
+    self->search = _QBAFExplanationSearch_New(self->self, self->other, self->arg1, self->arg2,
+                                              candidate_arguments, masks, count, check,
+                                              Py_MIN(EXPLANATION_ITERATOR_BATCH * (Py_ssize_t) self->self->threads,
+                                                     EXPLANATION_BATCH));
+    if (self->search == NULL) {
+        return -1;
+    }
+    if (!all_sizes)
+        self->search->max_size = self->max_size;
+    if (self->max_evaluations >= 0)
+        self->search->max_evaluations = self->max_evaluations - self->evaluations;
+    self->search->deadline = self->deadline;
+
+    return 0;
+}
+
+/**
+ * @brief Return the next minimal explanation (a new PySet), NULL if there are no more or if an error has occurred.
+ * 
+ * @param self an instance of QBAFExplanationIterator that is not running
+ * @return PyObject* a new PySet of QBAFArgument, NULL if finished or if an error occurred
+ */
+static PyObject *
+QBAFExplanationIterator_advance(QBAFExplanationIteratorObject *self)
+{
+    if (self->exhaustive >= 0)
         return NULL;
+
+    if (self->max_results >= 0 && self->results >= self->max_results) {
+        QBAFExplanationIterator_finish(self, FALSE);
+        return NULL;
+    }
+
+    if (self->empty) {
+        QBAFExplanationIterator_finish(self, TRUE);
+        self->results++;
+        return PySet_New(NULL);
     }
 
-    while ((set = PyIter_Next(iterator))) {
-        int contains_disjoint = PyList_ContainsDisjoint(minimalSSIExplanations, set);
-        if (contains_disjoint < 0) {
-            Py_DECREF(minimalSSIExplanations); Py_DECREF(explanations);
-            Py_DECREF(subsets); Py_DECREF(filtered_subsets);
-            Py_DECREF(iterator); Py_DECREF(set);
+    for (;;) {
+        const QBAFBitsetWord *set;
+        int found = _QBAFExplanationSearch_Next(self->search, &set);
+        if (found < 0) {
+            QBAFExplanationIterator_finish(self, FALSE);
             return NULL;
         }
-        
-        if (!contains_disjoint) {
-            if (PyList_Append(filtered_subsets, set) < 0) {
-                Py_DECREF(minimalSSIExplanations); Py_DECREF(explanations);
-                Py_DECREF(subsets); Py_DECREF(filtered_subsets);
-                Py_DECREF(iterator); Py_DECREF(set);
+
+        if (found) {
+            PyObject *explanation = QBAFBitset_ToSet(set, self->candidate_arguments);
+            if (explanation == NULL) {
+                QBAFExplanationIterator_finish(self, FALSE);
+                return NULL;
+            }
+            if (self->ssi_explanations == NULL) {
+                self->results++;
+                return explanation;
+            }
+            // The minimal SSI Explanations that the NSI Explanations must intersect
+            int append = PyList_Append(self->ssi_explanations, explanation);
+            Py_DECREF(explanation);
+            if (append < 0) {
+                QBAFExplanationIterator_finish(self, FALSE);
                 return NULL;
             }
+            continue;
         }
 
-        Py_DECREF(set);
+        int stopped = self->search->stopped;
+        if (stopped || self->ssi_explanations == NULL) {
+            QBAFExplanationIterator_finish(self, !stopped);
+            return NULL;
+        }
+
+        // All the minimal SSI Explanations have been found, search the NSI Explanations
+        QBAFExplanationIterator_free_search(self);
+        PyObject *candidate_arguments, *ssi_explanations = self->ssi_explanations;
+        QBAFBitsetWord *masks;
+        Py_ssize_t count;
+        self->ssi_explanations = NULL;
+        int nsi_candidates = _QBAFramework_nsi_candidates(ssi_explanations, &candidate_arguments, &masks, &count);
+        Py_DECREF(ssi_explanations);
+        if (nsi_candidates < 0) {
+            QBAFExplanationIterator_finish(self, FALSE);
+            return NULL;
+        }
+        if (QBAFExplanationIterator_start(self, candidate_arguments, masks, count,
+                                          _QBAFramework_checkSSIExplanation, FALSE) < 0) {
+            QBAFExplanationIterator_finish(self, FALSE);
+            return NULL;
+        }
     }
-    Py_DECREF(iterator);
+}
+
+/**
+ * @brief Return the next minimal explanation (a new PySet), NULL if there are no more or if an error has occurred
+ * (ValueError if another call has not returned yet).
+ * 
+ * @param self an instance of QBAFExplanationIterator
+ * @return PyObject* a new PySet of QBAFArgument, NULL if finished or if an error occurred
+ */
+static PyObject *
+QBAFExplanationIterator_next(QBAFExplanationIteratorObject *self)
+{
+    if (self->running) {
+        PyErr_SetString(PyExc_ValueError, "iterator already executing");
+        return NULL;
+    }
+
+    self->running = 1;
+    PyObject *explanation = QBAFExplanationIterator_advance(self);
+    self->running = 0;
+
+    return explanation;
+}
+
+/**
+ * @brief Getter of the attribute exhaustive.
+ * 
+ * @param self an instance of QBAFExplanationIterator
+ * @param closure 
+ * @return PyObject* new reference to True, False or None
+ */
+static PyObject *
+QBAFExplanationIterator_getexhaustive(QBAFExplanationIteratorObject *self, void *closure)
+{
+    if (self->exhaustive < 0) {
+        Py_RETURN_NONE;
+    }
+    Py_RETURN_BOOL(self->exhaustive);
+}
+
+/**
+ * @brief Getter of the attribute evaluations.
+ * 
+ * @param self an instance of QBAFExplanationIterator
+ * @param closure 
+ * @return PyObject* new PyLong with the number of sets checked
+ */
+static PyObject *
+QBAFExplanationIterator_getevaluations(QBAFExplanationIteratorObject *self, void *closure)
+{
+    Py_ssize_t evaluations = self->evaluations;
+    if (self->search != NULL)
+        evaluations += self->search->evaluations;
+    return PyLong_FromSsize_t(evaluations);
+}
+
+PyDoc_STRVAR(exhaustive_doc,
+"Whether every minimal explanation has been yielded.\n"
+"\n"
+"Getter: Return None while the search has not finished, True if it has yielded every\n"
+"minimal explanation and False if it has been stopped by a limit (or an error)\n"
+"\n"
+"Type: bool or None\n"
+);
 
-    Py_DECREF(subsets);
-    subsets = filtered_subsets;
+PyDoc_STRVAR(evaluations_doc,
+"Number of sets of arguments that have been checked.\n"
+"\n"
+"Getter: Return the number of sets checked\n"
+"\n"
+"Type: int\n"
+);
+
+static PyGetSetDef QBAFExplanationIterator_getsetters[] = {
+    {"exhaustive", (getter) QBAFExplanationIterator_getexhaustive, NULL,
+     exhaustive_doc, NULL},
+    {"evaluations", (getter) QBAFExplanationIterator_getevaluations, NULL,
+     evaluations_doc, NULL},
+    {NULL}  /* Sentinel */
+};
+
+static PyTypeObject QBAFExplanationIteratorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "qbaf.QBAFExplanationIterator",
+    .tp_basicsize = sizeof(QBAFExplanationIteratorObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_dealloc = (destructor) QBAFExplanationIterator_dealloc,
+    .tp_traverse = (traverseproc) QBAFExplanationIterator_traverse,
+    .tp_clear = (inquiry) QBAFExplanationIterator_clear,
+    .tp_iter = PyObject_SelfIter,                                   // __iter__
+    .tp_iternext = (iternextfunc) QBAFExplanationIterator_next,     // __next__
+    .tp_getset = QBAFExplanationIterator_getsetters,
+};
+
+/**
+ * @brief Get the QBAFExplanationIteratorType object created above
+ * 
+ * @return PyTypeObject* a pointer to the QBAFExplanationIterator class definition
+ */
+PyTypeObject *get_QBAFExplanationIteratorType() {
+    return &QBAFExplanationIteratorType;
+}
+
+/**
+ * @brief Store in limit the value of the optional non-negative limit name (PyLong or None).
+ * Return 0 if succeeded, -1 if an error has occurred.
+ * 
+ * @param value a PyLong or None
+ * @param name the name of the limit
+ * @param limit a pointer where the limit is stored, -1 if value is None
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+_QBAFramework_parse_limit(PyObject *value, const char *name, Py_ssize_t *limit)
+{
+    if (value == Py_None) {
+        *limit = -1;
+        return 0;
+    }
+    if (!PyLong_Check(value)) {
+        PyErr_Format(PyExc_TypeError, "%s must be of type int or None", name);
+        return -1;
+    }
+    *limit = PyLong_AsSsize_t(value);
+    if (*limit == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (*limit < 0) {
+        PyErr_Format(PyExc_ValueError, "%s must be non-negative", name);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Types of explanations of a QBAFExplanationIterator.
+ * 
+ */
+typedef enum {
+    QBAF_SSI_EXPLANATIONS,
+    QBAF_CSI_EXPLANATIONS,
+    QBAF_NSI_EXPLANATIONS
+} QBAFExplanationKind;
+
+/**
+ * @brief Return a new QBAFExplanationIterator over the minimal explanations of type kind,
+ * NULL if an error has occurred.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args a tuple with arguments (other: QBAFramework, arg1: QBAFArgument, arg2: QBAFArgument,
+ * max_results: int, max_size: int, time_budget_ms: float, max_evaluations: int)
+ * @param kwds name of the arguments args
+ * @param kind the type of the explanations
+ * @return PyObject* new QBAFExplanationIterator, NULL if an error occurred
+ */
+static PyObject *
+_QBAFramework_iter_minimal_explanations(QBAFrameworkObject *self, PyObject *args, PyObject *kwds,
+                                        QBAFExplanationKind kind)
+{
+    static char *kwlist[] = {"other", "arg1", "arg2", "max_results", "max_size", "time_budget_ms", "max_evaluations", NULL};
+    PyObject *other, *arg1, *arg2;
+    PyObject *pymax_results = Py_None, *pymax_size = Py_None, *pytime_budget_ms = Py_None, *pymax_evaluations = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO|OOOO", kwlist,
+                                     &other, &arg1, &arg2,
+                                     &pymax_results, &pymax_size, &pytime_budget_ms, &pymax_evaluations))
+        return NULL;
+
+    if (!PyObject_TypeCheck(other, Py_TYPE(self))) {
+        PyErr_SetString(PyExc_TypeError, "other must be an instance of QBAFramework");
+        return NULL;
+    }
+
+    // The time budget starts now
+    double now = _QBAFramework_monotonic_ms();
+
+    Py_ssize_t max_results, max_size, max_evaluations;
+    if (_QBAFramework_parse_limit(pymax_results, "max_results", &max_results) < 0 ||
+        _QBAFramework_parse_limit(pymax_size, "max_size", &max_size) < 0 ||
+        _QBAFramework_parse_limit(pymax_evaluations, "max_evaluations", &max_evaluations) < 0) {
+        return NULL;
+    }
+    double deadline = -1.0;
+    if (pytime_budget_ms != Py_None) {
+        double time_budget_ms = PyFloat_AsDouble(pytime_budget_ms);
+        if (time_budget_ms == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (!(time_budget_ms >= 0.0)) {
+            PyErr_SetString(PyExc_ValueError, "time_budget_ms must be non-negative");
+            return NULL;
+        }
+        deadline = now + time_budget_ms;
+    }
 
-    // Find NSI Explanations
-    int contains_subset;
-    int isSSIExplanation;
-    int contains_subset_SSIExplanation;
+    int strength_consistent = _QBAFramework_are_strength_consistent(self, (QBAFrameworkObject*)other, arg1, arg2);
+    if (strength_consistent < 0) {
+        return NULL;
+    }
 
-    iterator = PyObject_GetIter(subsets);
+    QBAFExplanationIteratorObject *iterator = PyObject_GC_New(QBAFExplanationIteratorObject, &QBAFExplanationIteratorType);
     if (iterator == NULL) {
-        Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(minimalSSIExplanations);
         return NULL;
     }
-
-    while ((set = PyIter_Next(iterator))) {
-        contains_subset = PyList_ContainsSubset(explanations, set);
-        if (contains_subset < 0) {
-            Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(minimalSSIExplanations);
-            Py_DECREF(set); Py_DECREF(iterator);
+    Py_INCREF(self);
+    iterator->self = self;
+    Py_INCREF(other);
+    iterator->other = (QBAFrameworkObject*)other;
+    Py_INCREF(arg1);
+    iterator->arg1 = arg1;
+    Py_INCREF(arg2);
+    iterator->arg2 = arg2;
+    iterator->candidate_arguments = NULL;
+    iterator->ssi_explanations = NULL;
+    iterator->masks = NULL;
+    iterator->search = NULL;
+    iterator->empty = strength_consistent;      // If strength consistent the empty set is the only explanation
+    iterator->results = 0;
+    iterator->max_results = max_results;
+    iterator->max_size = max_size < 0 || max_size > INT_MAX ? INT_MAX : (int) max_size;
+    iterator->max_evaluations = max_evaluations;
+    iterator->deadline = deadline;
+    iterator->evaluations = 0;
+    iterator->exhaustive = -1;
+    iterator->running = 0;
+    PyObject_GC_Track(iterator);
+
+    if (!strength_consistent) {
+        PyObject *candidate_arguments = _QBAFramework_candidate_arguments(self, (QBAFrameworkObject*)other, arg1, arg2);
+        if (candidate_arguments == NULL) {
+            Py_DECREF(iterator);
             return NULL;
         }
-        
-        if (!contains_subset) { // If set is not a superset of any explanation
-            isSSIExplanation = _QBAFramework_isSSIExplanation(self, other, set, arg1, arg2);
-            if (isSSIExplanation < 0) {
-                Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(minimalSSIExplanations);
-                Py_DECREF(set); Py_DECREF(iterator);
+        if (kind == QBAF_NSI_EXPLANATIONS) {
+            iterator->ssi_explanations = PyList_New(0);
+            if (iterator->ssi_explanations == NULL) {
+                Py_DECREF(candidate_arguments);
+                Py_DECREF(iterator);
                 return NULL;
             }
-
-            if (isSSIExplanation) { // If set is SSI Explanation
-
-                PyObject *self_arguments_union_other_arguments = PySet_Union(self->arguments, other->arguments);
-                if (self_arguments_union_other_arguments == NULL) {
-                    Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(minimalSSIExplanations);
-                    Py_DECREF(set); Py_DECREF(iterator);
-                    return NULL;
-                }
-                PyObject *self_arguments_union_other_arguments_difference_set = PySet_Difference(self_arguments_union_other_arguments, set);
-                Py_DECREF(self_arguments_union_other_arguments);
-                if (self_arguments_union_other_arguments_difference_set == NULL) {
-                    Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(minimalSSIExplanations);
-                    Py_DECREF(set); Py_DECREF(iterator);
-                    return NULL;
-                }
-
-                contains_subset_SSIExplanation = PyList_ContainsSubset(minimalSSIExplanations, self_arguments_union_other_arguments_difference_set);
-                Py_DECREF(self_arguments_union_other_arguments_difference_set);
-                if (contains_subset_SSIExplanation < 0) {
-                    Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(minimalSSIExplanations);
-                    Py_DECREF(set); Py_DECREF(iterator);
-                    return NULL;
-                }
-
-                if (!contains_subset_SSIExplanation) { // If it does not exist a SSI Explanation that is subset of self->arguments.union(other->arguments).difference(set)
-                    if (PyList_Append(explanations, set) < 0) {
-                        Py_DECREF(explanations); Py_DECREF(subsets); Py_DECREF(minimalSSIExplanations);
-                        Py_DECREF(set); Py_DECREF(iterator);
-                        return NULL;
-                    }
-                }
-            }
         }
-
-        Py_DECREF(set);
+        // The NSI Explanations need every minimal SSI Explanation, whatever its size
+        if (QBAFExplanationIterator_start(iterator, candidate_arguments, NULL, 0,
+                                          kind == QBAF_CSI_EXPLANATIONS ? _QBAFramework_checkCSIExplanation
+                                                                        : _QBAFramework_checkSSIExplanation,
+                                          kind == QBAF_NSI_EXPLANATIONS) < 0) {
+            Py_DECREF(iterator);
+            return NULL;
+        }
     }
 
-    Py_DECREF(iterator);
-    Py_DECREF(subsets);
-
-    Py_DECREF(minimalSSIExplanations);
-
-    return explanations;
+    return (PyObject *) iterator;
 }
 
 /**
- * @brief Return a list of all the sets of arguments that are minimal NSI Explanations of arg1 and arg2
+ * @brief Return an iterator over the sets of arguments that are minimal SSI Explanations of arg1 and arg2
  * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
  * 
  * @param self an instance of QBAFramework
- * @param args a tuple with arguments (other: QBAFramework, arg1: QBAFArgument, arg2: QBAFArgument)
+ * @param args a tuple with arguments (other: QBAFramework, arg1: QBAFArgument, arg2: QBAFArgument,
+ * max_results: int, max_size: int, time_budget_ms: float, max_evaluations: int)
  * @param kwds name of the arguments args
- * @return PyObject* new PyList, NULL if an error occurred
+ * @return PyObject* new QBAFExplanationIterator, NULL if an error occurred
  */
 static PyObject *
-QBAFramework_minimalNSIExplanations(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+QBAFramework_iter_minimal_ssi_explanations(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"other", "arg1", "arg2", NULL};
-    PyObject *other, *arg1, *arg2;
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO|", kwlist,
-                                     &other, &arg1, &arg2))
-        return NULL;
+    return _QBAFramework_iter_minimal_explanations(self, args, kwds, QBAF_SSI_EXPLANATIONS);
+}
 
-    if (!PyObject_TypeCheck(other, Py_TYPE(self))) {
-        PyErr_SetString(PyExc_TypeError, "other must be an instance of QBAFramework");
-        return NULL;
-    }
+/**
+ * @brief Return an iterator over the sets of arguments that are minimal CSI Explanations of arg1 and arg2
+ * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args a tuple with arguments (other: QBAFramework, arg1: QBAFArgument, arg2: QBAFArgument,
+ * max_results: int, max_size: int, time_budget_ms: float, max_evaluations: int)
+ * @param kwds name of the arguments args
+ * @return PyObject* new QBAFExplanationIterator, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_iter_minimal_csi_explanations(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    return _QBAFramework_iter_minimal_explanations(self, args, kwds, QBAF_CSI_EXPLANATIONS);
+}
 
-    return _QBAFramework_minimalNSIExplanations(self, (QBAFrameworkObject*)other, arg1, arg2);
+/**
+ * @brief Return an iterator over the sets of arguments that are minimal NSI Explanations of arg1 and arg2
+ * w.r.t. QBAFramework self (QBF') and QBAFramework other (QBF), NULL if an error was encountered.
+ * 
+ * @param self an instance of QBAFramework
+ * @param args a tuple with arguments (other: QBAFramework, arg1: QBAFArgument, arg2: QBAFArgument,
+ * max_results: int, max_size: int, time_budget_ms: float, max_evaluations: int)
+ * @param kwds name of the arguments args
+ * @return PyObject* new QBAFExplanationIterator, NULL if an error occurred
+ */
+static PyObject *
+QBAFramework_iter_minimal_nsi_explanations(QBAFrameworkObject *self, PyObject *args, PyObject *kwds)
+{
+    return _QBAFramework_iter_minimal_explanations(self, args, kwds, QBAF_NSI_EXPLANATIONS);
 }
 
 /**
@@ -3834,20 +6564,24 @@ _QBAFramework_change_info(QBAFrameworkObject *self, QBAFrameworkObject *other, P
         }
         
         // Update added_attack_relations and removed_attack_relations
-        PyObject *self_attacked = _QBAFARelations_patients_set((QBAFARelationsObject*)self->attack_relations, argument); // Borrowed reference
+        PyObject *self_attacked = _QBAFARelations_patients_set((QBAFARelationsObject*)self->attack_relations, argument); // New reference
         if (self_attacked == NULL) {
             Py_DECREF(tuple); Py_DECREF(iterator);
             return NULL;
         }
-        PyObject *other_attacked = _QBAFARelations_patients_set((QBAFARelationsObject*)other->attack_relations, argument); // Borrowed reference
+        PyObject *other_attacked = _QBAFARelations_patients_set((QBAFARelationsObject*)other->attack_relations, argument); // New reference
         if (other_attacked == NULL) {
             Py_DECREF(tuple); Py_DECREF(iterator);
+            Py_DECREF(self_attacked);
             return NULL;
         }
         
         PyObject *added_attacked_arguments = PySet_Difference(self_attacked, other_attacked);
-        if (added_attacked_arguments == NULL) {
+        PyObject *removed_attacked_arguments = PySet_Difference(other_attacked, self_attacked);
+        Py_DECREF(self_attacked); Py_DECREF(other_attacked);
+        if (added_attacked_arguments == NULL || removed_attacked_arguments == NULL) {
             Py_DECREF(tuple); Py_DECREF(iterator);
+            Py_XDECREF(added_attacked_arguments); Py_XDECREF(removed_attacked_arguments);
             return NULL;
         }
 
@@ -3882,12 +6616,6 @@ _QBAFramework_change_info(QBAFrameworkObject *self, QBAFrameworkObject *other, P
         Py_DECREF(attacked_iterator);
         Py_DECREF(added_attacked_arguments);
 
-        PyObject *removed_attacked_arguments = PySet_Difference(other_attacked, self_attacked);
-        if (removed_attacked_arguments == NULL) {
-            Py_DECREF(tuple); Py_DECREF(iterator);
-            return NULL;
-        }
-
         attacked_iterator = PyObject_GetIter(removed_attacked_arguments);
 
         if (attacked_iterator == NULL) {
@@ -3919,20 +6647,24 @@ _QBAFramework_change_info(QBAFrameworkObject *self, QBAFrameworkObject *other, P
         Py_DECREF(removed_attacked_arguments);
         
         // Update added_support_relations and removed_support_relations
-        PyObject *self_supported = _QBAFARelations_patients_set((QBAFARelationsObject*)self->support_relations, argument); // Borrowed reference
+        PyObject *self_supported = _QBAFARelations_patients_set((QBAFARelationsObject*)self->support_relations, argument); // New reference
         if (self_supported == NULL) {
             Py_DECREF(tuple); Py_DECREF(iterator);
             return NULL;
         }
-        PyObject *other_supported = _QBAFARelations_patients_set((QBAFARelationsObject*)other->support_relations, argument); // Borrowed reference
+        PyObject *other_supported = _QBAFARelations_patients_set((QBAFARelationsObject*)other->support_relations, argument); // New reference
         if (other_supported == NULL) {
             Py_DECREF(tuple); Py_DECREF(iterator);
+            Py_DECREF(self_supported);
             return NULL;
         }
         
         PyObject *added_supported_arguments = PySet_Difference(self_supported, other_supported);
-        if (added_supported_arguments == NULL) {
+        PyObject *removed_supported_arguments = PySet_Difference(other_supported, self_supported);
+        Py_DECREF(self_supported); Py_DECREF(other_supported);
+        if (added_supported_arguments == NULL || removed_supported_arguments == NULL) {
             Py_DECREF(tuple); Py_DECREF(iterator);
+            Py_XDECREF(added_supported_arguments); Py_XDECREF(removed_supported_arguments);
             return NULL;
         }
 
@@ -3967,12 +6699,6 @@ _QBAFramework_change_info(QBAFrameworkObject *self, QBAFrameworkObject *other, P
         Py_DECREF(supported_iterator);
         Py_DECREF(added_supported_arguments);
 
-        PyObject *removed_supported_arguments = PySet_Difference(other_supported, self_supported);
-        if (removed_supported_arguments == NULL) {
-            Py_DECREF(tuple); Py_DECREF(iterator);
-            return NULL;
-        }
-
         supported_iterator = PyObject_GetIter(removed_supported_arguments);
 
         if (supported_iterator == NULL) {
@@ -4168,10 +6894,44 @@ PyDoc_STRVAR(final_strengths_doc,
 "Getter: Calculate and return the QBAFramework's final strengths.\n"
 "    If the Framework has not been modified since last time they were calculated,\n"
 "    a copy of the previously calculated final strengths is returned.\n"
+"    If the Framework is acyclic and its arguments have not changed, only the arguments\n"
+"    whose initial strength or attackers/supporters have been modified, and the arguments\n"
+"    whose final strength depends on them, are calculated again.\n"
+"    If the Framework is not acyclic, they are approximated with solve() (default parameters)\n"
+"    and RuntimeError is raised if the approximation does not converge.\n"
 "\n"
 "Type: dict of QBAFArgument: float\n"
 );
 
+PyDoc_STRVAR(evaluation_order_doc,
+"Topological levels in which the final strengths of the Framework are calculated.\n"
+"The arguments of a level are only attacked/supported by arguments of previous levels.\n"
+"\n"
+"Getter: Return a list with the arguments of every level.\n"
+"    Raise ValueError if the Framework is not acyclic.\n"
+"\n"
+"Type: list of list of QBAFArgument\n"
+);
+
+PyDoc_STRVAR(indexed_arguments_doc,
+"Arguments of the Framework in the order of the columns of evaluate_batch().\n"
+"The order only changes when the Framework is modified.\n"
+"\n"
+"Getter: Return a list with the arguments of the Framework.\n"
+"\n"
+"Type: list of QBAFArgument\n"
+);
+
+PyDoc_STRVAR(argument_index_doc,
+"Index of every argument of the Framework: its position in final_strengths_array(),\n"
+"initial_strengths_array(), indexed_arguments and the columns of evaluate_batch().\n"
+"The indices only change when an argument or a relation is added or removed.\n"
+"\n"
+"Getter: Return a dict with the index of every argument.\n"
+"\n"
+"Type: dict of QBAFArgument: int\n"
+);
+
 PyDoc_STRVAR(disjoint_relations_doc,
 "True if the attack/support relations must be disjoint, False if they do not have to.\n"
 "\n"
@@ -4182,6 +6942,32 @@ PyDoc_STRVAR(disjoint_relations_doc,
 "Type: bool\n"
 );
 
+PyDoc_STRVAR(threads_doc,
+"Number of threads used to calculate the final strengths of an acyclic Framework\n"
+"and to search the minimal explanations.\n"
+"With built-in semantics and more than one thread, every topological level is evaluated\n"
+"in parallel without holding the GIL, and so are the candidate explanations of the same size.\n"
+"Meanwhile, any other thread that reads or modifies the compiled Framework gets a RuntimeError.\n"
+"\n"
+"Getter: Return the number of threads\n"
+"\n"
+"Setter: Set the number of threads (at least 1)\n"
+"\n"
+"Type: int\n"
+);
+
+PyDoc_STRVAR(fast_math_doc,
+"Whether the built-in semantics may use a vectorized approximation of exp (EulerBased models).\n"
+"It is within 2 ULP of the correctly rounded result, but the final strengths then depend on\n"
+"the instruction set of the CPU. By default the exact exp of the C library is used.\n"
+"\n"
+"Getter: Return True if the approximation is used, False if not\n"
+"\n"
+"Setter: Set whether the approximation is used (the final strengths are calculated again)\n"
+"\n"
+"Type: bool\n"
+);
+
 PyDoc_STRVAR(semantics_doc,
 "The name of the semantics used to calculate the final strengths of the Framework.\n"
 "If the semantics are custom (not predefined) then its value is None.\n"
@@ -4222,8 +7008,18 @@ static PyGetSetDef QBAFramework_getsetters[] = {
      support_relations_doc, NULL},
     {"final_strengths", (getter) QBAFramework_getfinal_strengths, NULL,
      final_strengths_doc, NULL},
+    {"evaluation_order", (getter) QBAFramework_getevaluation_order, NULL,
+     evaluation_order_doc, NULL},
+    {"indexed_arguments", (getter) QBAFramework_getindexed_arguments, NULL,
+     indexed_arguments_doc, NULL},
+    {"argument_index", (getter) QBAFramework_getargument_index, NULL,
+     argument_index_doc, NULL},
     {"disjoint_relations", (getter) QBAFramework_getdisjoint_relations, (setter) QBAFramework_setdisjoint_relations,
      disjoint_relations_doc, NULL},
+    {"threads", (getter) QBAFramework_getthreads, (setter) QBAFramework_setthreads,
+     threads_doc, NULL},
+    {"fast_math", (getter) QBAFramework_getfast_math, (setter) QBAFramework_setfast_math,
+     fast_math_doc, NULL},
     {"semantics", (getter) QBAFramework_getsemantics, NULL,
      semantics_doc, NULL},
     {"min_strength", (getter) QBAFramework_getmin_strength, NULL,
@@ -4238,6 +7034,7 @@ PyDoc_STRVAR(modify_initial_strength_doc,
 "--\n"
 "\n"
 "Modify the initial strength of the argument.\n"
+"It raises a ValueError if the argument is not contained in the framework.\n"
 "\n"
 "Args:\n"
 "    argument (QBAFArgument): the argument to be modified\n"
@@ -4294,16 +7091,24 @@ PyDoc_STRVAR(remove_argument_doc,
 );
 
 PyDoc_STRVAR(add_attack_relation_doc,
-"add_attack_relation(self, attacker, attacked)\n"
+"add_attack_relation(self, attacker, attacked, require_acyclic=False)\n"
 "--\n"
 "\n"
 "Add the Attack relation (attacker, attacked) to the Framework.\n"
 "The relation's arguments must be contained in the Framework's arguments.\n"
 "If the Attack relation already exists, this method does nothing.\n"
+"If require_acyclic is True, a relation that would create a cycle is rejected. The Framework then\n"
+"maintains a topological order of its arguments that is updated by every added relation,\n"
+"visiting only the arguments between the attacker and the attacked in that order (Pearce-Kelly).\n"
+"While it is maintained, isacyclic() returns True without compiling the Framework.\n"
 "\n"
 "Args:\n"
 "    attacker (QBAFArgument): the argument that is attacking\n"
 "    attacked (QBAFArgument): the argument that is being attacked\n"
+"    require_acyclic (bool): True if the relation must not create a cycle. Defaults to False.\n"
+"\n"
+"Raises:\n"
+"    ValueError: if require_acyclic and the Framework is not acyclic or the relation would create a cycle\n"
 );
 
 PyDoc_STRVAR(remove_attack_relation_doc,
@@ -4319,16 +7124,24 @@ PyDoc_STRVAR(remove_attack_relation_doc,
 );
 
 PyDoc_STRVAR(add_support_relation_doc,
-"add_support_relation(self, supporter, supported)\n"
+"add_support_relation(self, supporter, supported, require_acyclic=False)\n"
 "--\n"
 "\n"
 "Add the Support relation (supporter, supported) to the Framework.\n"
 "The relation's arguments must be contained in the Framework's arguments.\n"
 "If the Support relation already exists, this method does nothing.\n"
+"If require_acyclic is True, a relation that would create a cycle is rejected. The Framework then\n"
+"maintains a topological order of its arguments that is updated by every added relation,\n"
+"visiting only the arguments between the supporter and the supported in that order (Pearce-Kelly).\n"
+"While it is maintained, isacyclic() returns True without compiling the Framework.\n"
 "\n"
 "Args:\n"
 "    supporter (QBAFArgument): the argument that is supporting\n"
 "    supported (QBAFArgument): the argument that is being supported\n"
+"    require_acyclic (bool): True if the relation must not create a cycle. Defaults to False.\n"
+"\n"
+"Raises:\n"
+"    ValueError: if require_acyclic and the Framework is not acyclic or the relation would create a cycle\n"
 );
 
 PyDoc_STRVAR(remove_support_relation_doc,
@@ -4463,6 +7276,246 @@ PyDoc_STRVAR(isacyclic_doc,
 "    bool: True if acyclic, False if not acyclic\n"
 );
 
+PyDoc_STRVAR(find_cycle_doc,
+"find_cycle(self)\n"
+"--\n"
+"\n"
+"Return a cycle of the Attack/Support relations of the Framework: a list of arguments such that\n"
+"every argument attacks or supports the next one, and the last one attacks or supports the first one.\n"
+"The result is calculated in linear time and the compiled relations are reused until the next modification.\n"
+"\n"
+"Returns:\n"
+"    list: the arguments of a cycle, None if the Framework is acyclic\n"
+);
+
+PyDoc_STRVAR(strongly_connected_components_doc,
+"strongly_connected_components(self)\n"
+"--\n"
+"\n"
+"Return the strongly connected components of the Attack/Support relations of the Framework\n"
+"(Tarjan's algorithm) in topological order: the attackers/supporters of an argument belong\n"
+"to its component or to previous ones. They are cached until the next modification.\n"
+"\n"
+"Returns:\n"
+"    list of list of QBAFArgument: the components\n"
+);
+
+PyDoc_STRVAR(from_arrays_doc,
+"from_arrays(cls, names, initial_strengths, att_src, att_dst, sup_src, sup_dst,\n"
+"    disjoint_relations=True, semantics=None, aggregation_function=None, influence_function=None,\n"
+"    min_strength=-1.7976931348623157e+308, max_strength=1.7976931348623157e+308)\n"
+"--\n"
+"\n"
+"Create a Framework from the names of its arguments and arrays of indices within names.\n"
+"The relation i is (names[att_src[i]], names[att_dst[i]]) for the Attack relations\n"
+"and (names[sup_src[i]], names[sup_dst[i]]) for the Support relations.\n"
+"The relations are loaded in a single pass without hashing the arguments,\n"
+"and the Framework is compiled right away.\n"
+"The rest of the parameters are the same as in QBAFramework().\n"
+"\n"
+"Args:\n"
+"    names (Sequence): a sequence of distinct QBAFArgument\n"
+"    initial_strengths (Union[buffer,Sequence]): a 1-D buffer of float64 or a sequence of numbers,\n"
+"        the initial strength of every argument of names\n"
+"    att_src (Union[buffer,Sequence]): a 1-D buffer of integers or a sequence of int with the indices of the attackers\n"
+"    att_dst (Union[buffer,Sequence]): the indices of the attacked arguments, with the same length as att_src\n"
+"    sup_src (Union[buffer,Sequence]): the indices of the supporters\n"
+"    sup_dst (Union[buffer,Sequence]): the indices of the supported arguments, with the same length as sup_src\n"
+"\n"
+"Returns:\n"
+"    QBAFramework: a new Framework\n"
+);
+
+PyDoc_STRVAR(save_doc,
+"save(self, path)\n"
+"--\n"
+"\n"
+"Save the Framework in a versioned binary file: a header, the initial strengths,\n"
+"the compiled Attack/Support relations (CSR arrays), their topological schedule and a string table\n"
+"with the arguments. The file can be opened with QBAFramework.mmap.\n"
+"Only frameworks with predefined semantics whose arguments are str, int or QBAFArgument can be saved.\n"
+"\n"
+"Args:\n"
+"    path (Union[str,bytes,os.PathLike]): the path of the file\n"
+);
+
+PyDoc_STRVAR(load_doc,
+"load(cls, source, format=None,\n"
+"    disjoint_relations=True, semantics=None, aggregation_function=None, influence_function=None,\n"
+"    min_strength=-1.7976931348623157e+308, max_strength=1.7976931348623157e+308)\n"
+"--\n"
+"\n"
+"Create a Framework from a JSON or CSV source. The source is read in chunks and every\n"
+"argument and relation is inserted as soon as it is parsed, so the memory used besides\n"
+"the Framework itself does not depend on the size of the source.\n"
+"The names of the arguments are str (or int in JSON). Every argument must be declared\n"
+"before it is used in a relation.\n"
+"\n"
+"JSON: {\"arguments\": [[name, initial_strength], ...], \"attacks\": [[attacker, attacked], ...],\n"
+"\"supports\": [[supporter, supported], ...]}. An argument can also be written as\n"
+"{\"name\": name, \"initial_strength\": initial_strength}. Other keys are ignored.\n"
+"\n"
+"CSV: one row per argument or relation: 'argument,name,initial_strength',\n"
+"'attack,attacker,attacked' or 'support,supporter,supported'. The fields can be quoted.\n"
+"A first row starting with 'kind' (a header), empty rows and rows starting with '#' are skipped.\n"
+"The rest of the parameters are the same as in QBAFramework().\n"
+"\n"
+"Args:\n"
+"    source (Union[str,bytes,os.PathLike,io.IOBase]): a path or an object with a read method\n"
+"        that returns bytes or str\n"
+"    format (str): 'json' or 'csv'. If None, it is inferred from the extension of the path\n"
+"\n"
+"Raises:\n"
+"    ValueError: with the line and the column if the source is malformed\n"
+"        or a relation uses an unknown argument\n"
+"\n"
+"Returns:\n"
+"    QBAFramework: a new Framework\n"
+);
+
+PyDoc_STRVAR(__reduce_ex___doc,
+"__reduce_ex__(self, protocol, /)\n"
+"--\n"
+"\n"
+"Helper for pickle. The state is the compiled binary image of the Framework (the same layout\n"
+"as QBAFramework.save) and its final strengths if they are up to date. With protocol 5 they are\n"
+"PickleBuffer objects, so they can be transferred out-of-band (buffer_callback) and the restored\n"
+"Framework evaluates its strengths directly from the received buffers without copying them.\n"
+"The arguments and a custom aggregation_function and influence_function are pickled normally.\n"
+);
+
+PyDoc_STRVAR(_from_state_doc,
+"_from_state(cls, state)\n"
+"--\n"
+"\n"
+"Create a Framework from the state returned by __reduce_ex__ (used by pickle).\n"
+);
+
+PyDoc_STRVAR(mmap_doc,
+"mmap(cls, path)\n"
+"--\n"
+"\n"
+"Open a Framework saved with QBAFramework.save by mapping its file into memory (read-only).\n"
+"The compiled relations and the initial strengths are not copied: the final strengths are\n"
+"evaluated directly from the mapped pages, which are shared through the page cache\n"
+"by every process that maps the same file. Modifying the Framework does not modify the file.\n"
+"\n"
+"Args:\n"
+"    path (Union[str,bytes,os.PathLike]): the path of the file\n"
+"\n"
+"Returns:\n"
+"    QBAFramework: a new Framework\n"
+);
+
+PyDoc_STRVAR(solve_doc,
+"solve(self, method='jacobi', tolerance=1e-10, max_iterations=10000, damping=1.0, step_size=0.1)\n"
+"--\n"
+"\n"
+"Approximate the final strengths of the Framework with an iterative method starting\n"
+"from the initial strengths. It can be used with frameworks that are not acyclic.\n"
+"If the method converges, the result is stored as the final strengths of the Framework.\n"
+"Otherwise, a RuntimeWarning is issued and the final strengths are not modified.\n"
+"The final strengths of an acyclic Framework are calculated exactly instead (in 0 iterations).\n"
+"\n"
+"Args:\n"
+"    method (str): 'jacobi' or 'gauss_seidel' (discrete sweeps),\n"
+"        'euler' or 'rk4' (integration of the continuous-time model ds/dt = f(s) - s)\n"
+"    tolerance (float): it has converged when the maximum change of a strength is lower than tolerance\n"
+"    max_iterations (int): maximum number of iterations\n"
+"    damping (float): weight in (0, 1] of the new strengths in 'jacobi' and 'gauss_seidel' sweeps\n"
+"    step_size (float): time step of 'euler' and 'rk4'\n"
+"\n"
+"Returns:\n"
+"    tuple: (converged: bool, iterations: int)\n"
+);
+
+PyDoc_STRVAR(evaluate_batch_doc,
+"evaluate_batch(self, initial_strengths)\n"
+"--\n"
+"\n"
+"Calculate the final strengths of the acyclic Framework for many vectors of initial strengths at once,\n"
+"reusing its compiled topology. The Framework itself is not modified.\n"
+"The columns of both matrices follow the order of indexed_arguments.\n"
+"With built-in semantics the rows are evaluated in blocks without Python objects,\n"
+"and in parallel without holding the GIL if threads is greater than 1.\n"
+"\n"
+"Args:\n"
+"    initial_strengths: a 2-D C-contiguous buffer of float64 (e.g. a numpy array) or a sequence of\n"
+"        sequences of numbers, with a row for every vector and a column for every argument\n"
+"\n"
+"Returns:\n"
+"    memoryview: a 2-D memoryview of float64 with the final strengths of every row\n"
+"\n"
+"Raises:\n"
+"    ValueError: if the Framework is not acyclic, the shape is not valid or a strength is out of range\n"
+);
+
+PyDoc_STRVAR(final_strengths_array_doc,
+"final_strengths_array(self)\n"
+"--\n"
+"\n"
+"Return a snapshot of the final strengths of the Framework, as a read-only memoryview\n"
+"of float64 indexed like argument_index (e.g. numpy.asarray(qbf.final_strengths_array())).\n"
+"The snapshot is not copied: it shares memory with the Framework (and its copies) until\n"
+"the Framework modifies the strengths, which are copied first (copy-on-write).\n"
+"Later modifications of the Framework do not change it.\n"
+"\n"
+"Returns:\n"
+"    memoryview: the final strengths\n"
+);
+
+PyDoc_STRVAR(initial_strengths_array_doc,
+"initial_strengths_array(self)\n"
+"--\n"
+"\n"
+"Return a snapshot of the initial strengths of the Framework, as a read-only memoryview\n"
+"of float64 indexed like argument_index.\n"
+"The snapshot is not copied: it shares memory with the Framework (and its copies) until\n"
+"the Framework modifies the strengths, which are copied first (copy-on-write).\n"
+"Later modifications of the Framework do not change it.\n"
+"\n"
+"Returns:\n"
+"    memoryview: the initial strengths\n"
+);
+
+PyDoc_STRVAR(gradient_doc,
+"gradient(self, topic)\n"
+"--\n"
+"\n"
+"Return the derivative of the final strength of topic w.r.t. the initial strength of every argument\n"
+"of the acyclic Framework, calculated exactly with a single backward sweep (reverse mode).\n"
+"It is only available with built-in semantics. Where the semantics are not differentiable\n"
+"the right derivative is used, except for tied strongest agents of 'top', which have derivative 0\n"
+"(lowering one of them does not change the maximum).\n"
+"\n"
+"Args:\n"
+"    topic (QBAFArgument): an argument of the Framework\n"
+"\n"
+"Returns:\n"
+"    dict of QBAFArgument: float: the partial derivatives\n"
+"\n"
+"Raises:\n"
+"    ValueError: if the Framework is not acyclic or the semantics are custom\n"
+);
+
+PyDoc_STRVAR(tangent_doc,
+"tangent(self, argument)\n"
+"--\n"
+"\n"
+"Return the derivative of the final strength of every argument w.r.t. the initial strength of argument\n"
+"in the acyclic Framework, calculated exactly with a single forward sweep (forward mode).\n"
+"It is only available with built-in semantics (see gradient()).\n"
+"\n"
+"Args:\n"
+"    argument (QBAFArgument): an argument of the Framework\n"
+"\n"
+"Returns:\n"
+"    dict of QBAFArgument: float: the partial derivatives\n"
+"\n"
+"Raises:\n"
+"    ValueError: if the Framework is not acyclic or the semantics are custom\n"
+);
+
 PyDoc_STRVAR(are_strength_consistent_doc,
 "are_strength_consistent(self, other, arg1, arg2)\n"
 "--\n"
@@ -4604,6 +7657,83 @@ PyDoc_STRVAR(minimalNSIExplanations_doc,
 "    list: list of set of arguments\n"
 );
 
+PyDoc_STRVAR(iter_minimal_ssi_explanations_doc,
+"iter_minimal_ssi_explanations(self, other, arg1, arg2, max_results=None, max_size=None, time_budget_ms=None, max_evaluations=None)\n"
+"--\n"
+"\n"
+"Return an iterator over the sets of arguments that are a subset-minimal SSI Explanation\n"
+"of the argument arg1 and the argument arg2 w.r.t. the Framework self and the Framework other.\n"
+"Both arguments must be contained in both Frameworks.\n"
+"The explanations are yielded by increasing size as soon as they are found to be minimal,\n"
+"until one of the limits is reached. The attribute exhaustive of the iterator tells\n"
+"whether every minimal explanation has been yielded once it has finished.\n"
+"\n"
+"Args:\n"
+"    other (QBAFramework): a Framework\n"
+"    arg1 (QBAFArgument): first argument\n"
+"    arg2 (QBAFArgument): second argument\n"
+"    max_results (int): maximum number of explanations yielded. Defaults to None (unlimited)\n"
+"    max_size (int): maximum size of the explanations. Defaults to None (unlimited)\n"
+"    time_budget_ms (float): milliseconds from the call after which no more sets are checked.\n"
+"        Defaults to None (unlimited)\n"
+"    max_evaluations (int): maximum number of sets checked. Defaults to None (unlimited)\n"
+"\n"
+"Returns:\n"
+"    QBAFExplanationIterator: iterator of set of arguments\n"
+);
+
+PyDoc_STRVAR(iter_minimal_csi_explanations_doc,
+"iter_minimal_csi_explanations(self, other, arg1, arg2, max_results=None, max_size=None, time_budget_ms=None, max_evaluations=None)\n"
+"--\n"
+"\n"
+"Return an iterator over the sets of arguments that are a subset-minimal CSI Explanation\n"
+"of the argument arg1 and the argument arg2 w.r.t. the Framework self and the Framework other.\n"
+"Both arguments must be contained in both Frameworks.\n"
+"The explanations are yielded by increasing size as soon as they are found to be minimal,\n"
+"until one of the limits is reached. The attribute exhaustive of the iterator tells\n"
+"whether every minimal explanation has been yielded once it has finished.\n"
+"\n"
+"Args:\n"
+"    other (QBAFramework): a Framework\n"
+"    arg1 (QBAFArgument): first argument\n"
+"    arg2 (QBAFArgument): second argument\n"
+"    max_results (int): maximum number of explanations yielded. Defaults to None (unlimited)\n"
+"    max_size (int): maximum size of the explanations. Defaults to None (unlimited)\n"
+"    time_budget_ms (float): milliseconds from the call after which no more sets are checked.\n"
+"        Defaults to None (unlimited)\n"
+"    max_evaluations (int): maximum number of sets checked. Defaults to None (unlimited)\n"
+"\n"
+"Returns:\n"
+"    QBAFExplanationIterator: iterator of set of arguments\n"
+);
+
+PyDoc_STRVAR(iter_minimal_nsi_explanations_doc,
+"iter_minimal_nsi_explanations(self, other, arg1, arg2, max_results=None, max_size=None, time_budget_ms=None, max_evaluations=None)\n"
+"--\n"
+"\n"
+"Return an iterator over the sets of arguments that are a subset-minimal NSI Explanation\n"
+"of the argument arg1 and the argument arg2 w.r.t. the Framework self and the Framework other.\n"
+"Both arguments must be contained in both Frameworks.\n"
+"The explanations are yielded by increasing size as soon as they are found to be minimal,\n"
+"until one of the limits is reached. The attribute exhaustive of the iterator tells\n"
+"whether every minimal explanation has been yielded once it has finished.\n"
+"All the minimal SSI Explanations are searched (within the limits of time and evaluations)\n"
+"before the first NSI Explanation is yielded.\n"
+"\n"
+"Args:\n"
+"    other (QBAFramework): a Framework\n"
+"    arg1 (QBAFArgument): first argument\n"
+"    arg2 (QBAFArgument): second argument\n"
+"    max_results (int): maximum number of explanations yielded. Defaults to None (unlimited)\n"
+"    max_size (int): maximum size of the explanations. Defaults to None (unlimited)\n"
+"    time_budget_ms (float): milliseconds from the call after which no more sets are checked.\n"
+"        Defaults to None (unlimited)\n"
+"    max_evaluations (int): maximum number of sets checked. Defaults to None (unlimited)\n"
+"\n"
+"Returns:\n"
+"    QBAFExplanationIterator: iterator of set of arguments\n"
+);
+
 PyDoc_STRVAR(change_info_doc,
 "change_info(self, other, explanation)\n"
 "--\n"
@@ -4626,6 +7756,24 @@ PyDoc_STRVAR(change_info_doc,
  * 
  */
 static PyMethodDef QBAFramework_methods[] = {
+    {"from_arrays", (PyCFunction) QBAFramework_from_arrays, METH_VARARGS | METH_KEYWORDS | METH_CLASS,
+    from_arrays_doc
+    },
+    {"save", (PyCFunction) QBAFramework_save, METH_VARARGS | METH_KEYWORDS,
+    save_doc
+    },
+    {"load", (PyCFunction) QBAFramework_load, METH_VARARGS | METH_KEYWORDS | METH_CLASS,
+    load_doc
+    },
+    {"__reduce_ex__", (PyCFunction) QBAFramework_reduce_ex, METH_VARARGS,
+    __reduce_ex___doc
+    },
+    {"_from_state", (PyCFunction) QBAFramework_from_state, METH_O | METH_CLASS,
+    _from_state_doc
+    },
+    {"mmap", (PyCFunction) QBAFramework_mmap, METH_VARARGS | METH_KEYWORDS | METH_CLASS,
+    mmap_doc
+    },
     {"modify_initial_strength", (PyCFunction) QBAFramework_modify_initial_strengths, METH_VARARGS | METH_KEYWORDS,
     modify_initial_strength_doc
     },
@@ -4683,6 +7831,30 @@ static PyMethodDef QBAFramework_methods[] = {
     {"isacyclic", (PyCFunction) QBAFramework_isacyclic, METH_NOARGS,
     isacyclic_doc
     },
+    {"find_cycle", (PyCFunction) QBAFramework_find_cycle, METH_NOARGS,
+    find_cycle_doc
+    },
+    {"strongly_connected_components", (PyCFunction) QBAFramework_strongly_connected_components, METH_NOARGS,
+    strongly_connected_components_doc
+    },
+    {"solve", (PyCFunction) QBAFramework_solve, METH_VARARGS | METH_KEYWORDS,
+    solve_doc
+    },
+    {"evaluate_batch", (PyCFunction) QBAFramework_evaluate_batch, METH_VARARGS | METH_KEYWORDS,
+    evaluate_batch_doc
+    },
+    {"final_strengths_array", (PyCFunction) QBAFramework_final_strengths_array, METH_NOARGS,
+    final_strengths_array_doc
+    },
+    {"initial_strengths_array", (PyCFunction) QBAFramework_initial_strengths_array, METH_NOARGS,
+    initial_strengths_array_doc
+    },
+    {"gradient", (PyCFunction) QBAFramework_gradient, METH_VARARGS | METH_KEYWORDS,
+    gradient_doc
+    },
+    {"tangent", (PyCFunction) QBAFramework_tangent, METH_VARARGS | METH_KEYWORDS,
+    tangent_doc
+    },
     {"are_strength_consistent", (PyCFunction) QBAFramework_are_strength_consistent, METH_VARARGS | METH_KEYWORDS,
     are_strength_consistent_doc
     },
@@ -4707,6 +7879,15 @@ static PyMethodDef QBAFramework_methods[] = {
     {"minimalNSIExplanations", (PyCFunction) QBAFramework_minimalNSIExplanations, METH_VARARGS | METH_KEYWORDS,
     minimalNSIExplanations_doc
     },
+    {"iter_minimal_ssi_explanations", (PyCFunction) QBAFramework_iter_minimal_ssi_explanations, METH_VARARGS | METH_KEYWORDS,
+    iter_minimal_ssi_explanations_doc
+    },
+    {"iter_minimal_csi_explanations", (PyCFunction) QBAFramework_iter_minimal_csi_explanations, METH_VARARGS | METH_KEYWORDS,
+    iter_minimal_csi_explanations_doc
+    },
+    {"iter_minimal_nsi_explanations", (PyCFunction) QBAFramework_iter_minimal_nsi_explanations, METH_VARARGS | METH_KEYWORDS,
+    iter_minimal_nsi_explanations_doc
+    },
     {"change_info", (PyCFunction) QBAFramework_change_info, METH_VARARGS | METH_KEYWORDS,
     change_info_doc
     },
@@ -0,0 +1,726 @@
+/**
+ * @file qbaf_file.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the binary file format of a compiled QBAFramework (qbaf_file.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "qbaf_file.h"
+
+#define NAME_STR        's'     /* the argument is a str: its UTF-8 bytes follow */
+#define NAME_INT        'i'     /* the argument is an int: its decimal representation follows */
+#define NAME_ARGUMENT   'a'     /* the argument is a QBAFArgument: a uint32 with the size of its name, its name and its description follow */
+
+/**
+ * @brief A growable array of bytes.
+ *
+ */
+typedef struct {
+    char       *data;
+    Py_ssize_t  size;
+    Py_ssize_t  capacity;
+} QBAFFileBytes;
+
+/**
+ * @brief Append size bytes of source to the QBAFFileBytes bytes.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ */
+static int
+QBAFFileBytes_append(QBAFFileBytes *bytes, const void *source, Py_ssize_t size)
+{
+    if (bytes->size + size > bytes->capacity) {
+        Py_ssize_t capacity = bytes->capacity < 64 ? 64 : bytes->capacity;
+        while (capacity < bytes->size + size)
+            capacity *= 2;
+        char *data = PyMem_Realloc(bytes->data, capacity);
+        if (data == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        bytes->data = data;
+        bytes->capacity = capacity;
+    }
+    memcpy(bytes->data + bytes->size, source, size);
+    bytes->size += size;
+    return 0;
+}
+
+/**
+ * @brief Append the UTF-8 bytes of the PyUnicode string to the QBAFFileBytes bytes.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFFileBytes_append_unicode(QBAFFileBytes *bytes, PyObject *string)
+{
+    Py_ssize_t size;
+    const char *utf8 = PyUnicode_AsUTF8AndSize(string, &size);
+    if (utf8 == NULL) {
+        return -1;
+    }
+    return QBAFFileBytes_append(bytes, utf8, size);
+}
+
+/**
+ * @brief Append the encoding of the argument to the QBAFFileBytes names.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param names the string table
+ * @param argument a str, an int or a QBAFArgument
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFFile_encode_name(QBAFFileBytes *names, PyObject *argument)
+{
+    char kind;
+
+    if (PyUnicode_CheckExact(argument)) {
+        kind = NAME_STR;
+        if (QBAFFileBytes_append(names, &kind, 1) < 0)
+            return -1;
+        return QBAFFileBytes_append_unicode(names, argument);
+    }
+
+    if (PyLong_CheckExact(argument)) {
+        PyObject *string = PyObject_Str(argument);
+        if (string == NULL)
+            return -1;
+        kind = NAME_INT;
+        int result = QBAFFileBytes_append(names, &kind, 1) < 0 ? -1 : QBAFFileBytes_append_unicode(names, string);
+        Py_DECREF(string);
+        return result;
+    }
+
+    if (Py_TYPE(argument) == get_QBAFArgumentType()) {
+        PyObject *name = PyObject_GetAttrString(argument, "name");
+        if (name == NULL)
+            return -1;
+        PyObject *description = PyObject_GetAttrString(argument, "description");
+        if (description == NULL) {
+            Py_DECREF(name);
+            return -1;
+        }
+        Py_ssize_t name_size;
+        int result = -1;
+        if (PyUnicode_AsUTF8AndSize(name, &name_size) != NULL) {
+            uint32_t size = (uint32_t) name_size;
+            kind = NAME_ARGUMENT;
+            if (name_size > UINT32_MAX)
+                PyErr_SetString(PyExc_OverflowError, "the name of an argument is too long");
+            else if (QBAFFileBytes_append(names, &kind, 1) == 0 &&
+                     QBAFFileBytes_append(names, &size, sizeof(uint32_t)) == 0 &&
+                     QBAFFileBytes_append_unicode(names, name) == 0 &&
+                     QBAFFileBytes_append_unicode(names, description) == 0)
+                result = 0;
+        }
+        Py_DECREF(name);
+        Py_DECREF(description);
+        return result;
+    }
+
+    PyErr_Format(PyExc_TypeError,
+                 "only arguments of type str, int or QBAFArgument can be saved, not '%.200s'",
+                 Py_TYPE(argument)->tp_name);
+    return -1;
+}
+
+/**
+ * @brief Return a new argument decoded from the size bytes of data, NULL if an error has occurred.
+ *
+ * @param data the encoding of the argument
+ * @param size the number of bytes of the encoding
+ * @return PyObject* a new str, int or QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFFile_decode_name(const char *data, Py_ssize_t size)
+{
+    if (size < 1) {
+        PyErr_SetString(PyExc_ValueError, "the file contains an empty argument");
+        return NULL;
+    }
+
+    switch (data[0]) {
+        case NAME_STR:
+            return PyUnicode_DecodeUTF8(data + 1, size - 1, "strict");
+        case NAME_INT: {
+            PyObject *string = PyUnicode_DecodeUTF8(data + 1, size - 1, "strict");
+            if (string == NULL)
+                return NULL;
+            PyObject *integer = PyLong_FromUnicodeObject(string, 10);
+            Py_DECREF(string);
+            return integer;
+        }
+        case NAME_ARGUMENT: {
+            uint32_t name_size;
+            if (size < 1 + (Py_ssize_t) sizeof(uint32_t)) {
+                break;
+            }
+            memcpy(&name_size, data + 1, sizeof(uint32_t));
+            Py_ssize_t start = 1 + sizeof(uint32_t);
+            if ((Py_ssize_t) name_size > size - start) {
+                break;
+            }
+            return PyObject_CallFunction((PyObject *) get_QBAFArgumentType(), "s#s#",
+                                         data + start, (Py_ssize_t) name_size,
+                                         data + start + name_size, size - start - (Py_ssize_t) name_size);
+        }
+    }
+
+    PyErr_SetString(PyExc_ValueError, "the file contains an argument with an incorrect encoding");
+    return NULL;
+}
+
+/**
+ * @brief Write count elements of size bytes of source to the file. Return 0 if succeeded, -1 if not.
+ */
+static inline int
+QBAFFile_write(FILE *file, const void *source, size_t size, size_t count)
+{
+    return count == 0 || fwrite(source, size, count, file) == count ? 0 : -1;
+}
+
+/**
+ * @brief Fill the header and list the sections (pointer and number of bytes) of the binary image of the QBAFGraph graph.
+ * The string table is encoded in names and name_offsets, which must be freed with PyMem_Free (also if an error occurred).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a compiled QBAFGraph (not NULL)
+ * @param semantics the name of a predefined semantics ("" if it is not predefined)
+ * @param disjoint_relations 1 if the Attack and Support relations must be disjoint, 0 if not
+ * @param external_names 1 if the string table is left empty (QBAF_FILE_EXTERNAL_NAMES), 0 if not
+ * @param header the header to fill
+ * @param name_offsets a pointer where the new array of name offsets is stored
+ * @param names the string table
+ * @param sections the address of every section (the header first)
+ * @param sizes the number of bytes of every section
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFFile_sections(QBAFGraph *graph, const char *semantics, int disjoint_relations, int external_names,
+                  QBAFFileHeader *header, int64_t **name_offsets, QBAFFileBytes *names,
+                  const void *sections[QBAF_FILE_SECTIONS], size_t sizes[QBAF_FILE_SECTIONS])
+{
+    if (sizeof(Py_ssize_t) != sizeof(int64_t)) {
+        PyErr_SetString(PyExc_NotImplementedError, "the binary format requires a 64-bit platform");
+        return -1;
+    }
+    if (strlen(semantics) >= QBAF_FILE_SEMANTICS_SIZE) {
+        PyErr_SetString(PyExc_ValueError, "the name of the semantics is too long");
+        return -1;
+    }
+
+    Py_ssize_t size = graph->size;
+
+    // Encode the string table
+    *name_offsets = PyMem_Calloc(size + 1, sizeof(int64_t));
+    if (*name_offsets == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (Py_ssize_t index = 0; !external_names && index < size; index++) {
+        if (QBAFFile_encode_name(names, PyList_GET_ITEM(graph->arguments, index)) < 0) {
+            return -1;
+        }
+        (*name_offsets)[index + 1] = names->size;
+    }
+
+    memset(header, 0, sizeof(QBAFFileHeader));
+    memcpy(header->magic, QBAF_FILE_MAGIC, sizeof(header->magic));
+    header->version = QBAF_FILE_VERSION;
+    header->flags = (disjoint_relations ? QBAF_FILE_DISJOINT_RELATIONS : 0) |
+                    (external_names ? QBAF_FILE_EXTERNAL_NAMES : 0);
+    header->byte_order = QBAF_FILE_BYTE_ORDER;
+    header->size = size;
+    header->attacks = graph->attackers_offsets[size];
+    header->supports = graph->supporters_offsets[size];
+    header->ordered = graph->ordered;
+    header->levels = graph->levels;
+    header->names_size = names->size;
+    strcpy(header->semantics, semantics);
+
+    const void *addresses[QBAF_FILE_SECTIONS] = {
+        header, graph->initial_strengths,
+        graph->attackers_offsets, graph->attackers, graph->supporters_offsets, graph->supporters,
+        graph->dependents_offsets, graph->dependents, graph->order, graph->positions, graph->level_offsets,
+        *name_offsets, names->data
+    };
+    size_t counts[QBAF_FILE_SECTIONS] = {
+        sizeof(QBAFFileHeader), 8 * size,
+        8 * (size + 1), 8 * header->attacks, 8 * (size + 1), 8 * header->supports,
+        8 * (size + 1), 8 * (header->attacks + header->supports), 8 * graph->ordered, 8 * size, 8 * (graph->levels + 1),
+        8 * (size + 1), names->size
+    };
+    memcpy(sections, addresses, sizeof(addresses));
+    memcpy(sizes, counts, sizeof(counts));
+    return 0;
+}
+
+int
+QBAFFile_Save(PyObject *path, QBAFGraph *graph, const char *semantics, int disjoint_relations)
+{
+    QBAFFileHeader header;
+    QBAFFileBytes names = {NULL, 0, 0};
+    int64_t *name_offsets = NULL;
+    const void *sections[QBAF_FILE_SECTIONS];
+    size_t sizes[QBAF_FILE_SECTIONS];
+
+    // Encode the string table before opening the file
+    if (QBAFFile_sections(graph, semantics, disjoint_relations, 0, &header, &name_offsets, &names, sections, sizes) < 0) {
+        PyMem_Free(name_offsets); PyMem_Free(names.data);
+        return -1;
+    }
+
+    PyObject *bytes_path;
+    if (!PyUnicode_FSConverter(path, &bytes_path)) {
+        PyMem_Free(name_offsets); PyMem_Free(names.data);
+        return -1;
+    }
+
+    int failed, error = 0;
+    FILE *file;
+    Py_BEGIN_ALLOW_THREADS
+    file = fopen(PyBytes_AS_STRING(bytes_path), "wb");
+    failed = file == NULL;
+    for (int section = 0; !failed && section < QBAF_FILE_SECTIONS; section++) {
+        failed = QBAFFile_write(file, sections[section], 1, sizes[section]) < 0;
+    }
+    if (failed)
+        error = errno;
+    if (file != NULL && fclose(file) != 0 && !failed) {
+        failed = 1;
+        error = errno;
+    }
+    Py_END_ALLOW_THREADS
+
+    PyMem_Free(name_offsets);
+    PyMem_Free(names.data);
+    Py_DECREF(bytes_path);
+
+    if (failed) {
+        errno = error;
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        return -1;
+    }
+    return 0;
+}
+
+PyObject *
+QBAFFile_Dumps(QBAFGraph *graph, const char *semantics, int disjoint_relations, int external_names)
+{
+    QBAFFileHeader header;
+    QBAFFileBytes names = {NULL, 0, 0};
+    int64_t *name_offsets = NULL;
+    const void *sections[QBAF_FILE_SECTIONS];
+    size_t sizes[QBAF_FILE_SECTIONS];
+    PyObject *image = NULL;
+
+    if (QBAFFile_sections(graph, semantics, disjoint_relations, external_names,
+                          &header, &name_offsets, &names, sections, sizes) == 0) {
+        Py_ssize_t length = 0;
+        for (int section = 0; section < QBAF_FILE_SECTIONS; section++)
+            length += sizes[section];
+        image = PyBytes_FromStringAndSize(NULL, length);
+        if (image != NULL) {
+            char *data = PyBytes_AS_STRING(image);
+            for (int section = 0; section < QBAF_FILE_SECTIONS; section++) {
+                if (sizes[section] > 0)
+                    memcpy(data, sections[section], sizes[section]);
+                data += sizes[section];
+            }
+        }
+    }
+
+    PyMem_Free(name_offsets);
+    PyMem_Free(names.data);
+    return image;
+}
+
+/**
+ * @brief Return 1 if offsets (rows + 1 elements) are non-decreasing from 0 to count
+ * and every element of indices (count elements) is within [0, size), 0 if not.
+ */
+static int
+QBAFFile_valid_csr(const int64_t *offsets, const int64_t *indices, int64_t rows, int64_t count, int64_t size)
+{
+    if (offsets[0] != 0 || offsets[rows] != count)
+        return 0;
+    for (int64_t row = 0; row < rows; row++) {
+        if (offsets[row + 1] < offsets[row])
+            return 0;
+    }
+    for (int64_t position = 0; position < count; position++) {
+        if (indices != NULL && (indices[position] < 0 || indices[position] >= size))
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Return 1 if the dependents of the QBAFGraph graph are exactly those built by QBAFGraph_New from its
+ * (valid) attackers and supporters, 0 if not, and -1 (with the corresponding exception) if there is no memory left.
+ * For every argument, in increasing order, it is a dependent of its attackers and then of its supporters.
+ *
+ * @param graph a QBAFGraph whose CSR arrays are within bounds
+ * @return int 1 if valid, 0 if not, -1 if an error occurred
+ */
+static int
+QBAFFile_valid_dependents(QBAFGraph *graph)
+{
+    Py_ssize_t size = graph->size;
+    Py_ssize_t *cursors = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    if (cursors == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memcpy(cursors, graph->dependents_offsets, size * sizeof(Py_ssize_t));
+
+    // As many dependents as agents, so every cursor reaches the end of its argument if all of them match
+    int valid = 1;
+    for (Py_ssize_t index = 0; valid && index < size; index++) {
+        const Py_ssize_t *offsets[2] = {graph->attackers_offsets, graph->supporters_offsets};
+        const Py_ssize_t *agents[2] = {graph->attackers, graph->supporters};
+        for (int relation = 0; valid && relation < 2; relation++) {
+            for (Py_ssize_t position = offsets[relation][index]; valid && position < offsets[relation][index + 1]; position++) {
+                Py_ssize_t agent = agents[relation][position];
+                valid = cursors[agent] < graph->dependents_offsets[agent + 1] && graph->dependents[cursors[agent]++] == index;
+            }
+        }
+    }
+
+    PyMem_Free(cursors);
+    return valid;
+}
+
+/**
+ * @brief Return 1 if order is a topological schedule of the QBAFGraph graph, 0 if not:
+ * positions is its inverse (-1 for the arguments that are not scheduled), and every agent of a scheduled
+ * argument is scheduled in a previous level. Then the graph is acyclic if every argument is scheduled.
+ *
+ * @param graph a QBAFGraph whose CSR arrays, order and level offsets are within bounds
+ * @return int 1 if valid, 0 if not
+ */
+static int
+QBAFFile_valid_schedule(QBAFGraph *graph)
+{
+    for (Py_ssize_t position = 0; position < graph->ordered; position++) {
+        if (graph->positions[graph->order[position]] != position)
+            return 0;
+    }
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        Py_ssize_t position = graph->positions[index];
+        if (position != -1 && (position < 0 || position >= graph->ordered || graph->order[position] != index))
+            return 0;
+    }
+
+    for (Py_ssize_t level = 0; level < graph->levels; level++) {
+        Py_ssize_t start = graph->level_offsets[level];
+        for (Py_ssize_t position = start; position < graph->level_offsets[level + 1]; position++) {
+            Py_ssize_t index = graph->order[position];
+            const Py_ssize_t *offsets[2] = {graph->attackers_offsets, graph->supporters_offsets};
+            const Py_ssize_t *agents[2] = {graph->attackers, graph->supporters};
+            for (int relation = 0; relation < 2; relation++) {
+                for (Py_ssize_t agent = offsets[relation][index]; agent < offsets[relation][index + 1]; agent++) {
+                    Py_ssize_t agent_position = graph->positions[agents[relation][agent]];
+                    if (agent_position < 0 || agent_position >= start)
+                        return 0;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Return a new memoryview of the binary file at path mapped into memory (read-only),
+ * NULL if an error has occurred.
+ *
+ * @param path a path-like object
+ * @return PyObject* a new memoryview of bytes, NULL if an error occurred
+ */
+static PyObject *
+QBAFFile_mmap(PyObject *path)
+{
+    PyObject *io = PyImport_ImportModule("io");
+    if (io == NULL) {
+        return NULL;
+    }
+    PyObject *file = PyObject_CallMethod(io, "open", "Os", path, "rb");
+    Py_DECREF(io);
+    if (file == NULL) {
+        return NULL;
+    }
+
+    PyObject *mapped = NULL;
+    PyObject *mmap = PyImport_ImportModule("mmap");
+    PyObject *fileno = PyObject_CallMethod(file, "fileno", NULL);
+    if (mmap != NULL && fileno != NULL) {
+        PyObject *access = PyObject_GetAttrString(mmap, "ACCESS_READ");
+        PyObject *constructor = PyObject_GetAttrString(mmap, "mmap");
+        if (access != NULL && constructor != NULL) {
+            PyObject *args = Py_BuildValue("(Oi)", fileno, 0);
+            PyObject *kwargs = Py_BuildValue("{sO}", "access", access);
+            if (args != NULL && kwargs != NULL)
+                mapped = PyObject_Call(constructor, args, kwargs);
+            Py_XDECREF(args);
+            Py_XDECREF(kwargs);
+        }
+        Py_XDECREF(access);
+        Py_XDECREF(constructor);
+    }
+    Py_XDECREF(mmap);
+    Py_XDECREF(fileno);
+
+    // The mapping stays valid after closing the file
+    PyObject *closed = PyObject_CallMethod(file, "close", NULL);
+    Py_DECREF(file);
+    if (closed == NULL) {
+        Py_XDECREF(mapped);
+        return NULL;
+    }
+    Py_DECREF(closed);
+    if (mapped == NULL) {
+        return NULL;
+    }
+
+    // The memoryview keeps an export of the mmap, so it cannot be closed while it is used
+    PyObject *mapping = PyMemoryView_FromObject(mapped);
+    Py_DECREF(mapped);
+    return mapping;
+}
+
+/**
+ * @brief Return a new QBAFGraph whose CSR arrays, schedule and initial strengths are read directly from
+ * the binary image in the memoryview mapping (8-byte aligned), which is owned by the graph from now on.
+ * The header of the image is copied into header. Return NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param mapping a C-contiguous memoryview of bytes (stolen reference)
+ * @param arguments a PyList with the arguments if the string table is empty (QBAF_FILE_EXTERNAL_NAMES), NULL if not
+ * @param header a pointer where the header of the image is copied
+ * @return QBAFGraph* a new QBAFGraph, NULL if an error occurred
+ */
+static QBAFGraph *
+QBAFFile_graph(PyObject *mapping, PyObject *arguments, QBAFFileHeader *header)
+{
+    const char *data = PyMemoryView_GET_BUFFER(mapping)->buf;
+    Py_ssize_t length = PyMemoryView_GET_BUFFER(mapping)->len;
+
+    // Check the header and that the size of the file matches its sections
+    if (length < (Py_ssize_t) sizeof(QBAFFileHeader)) {
+        PyErr_SetString(PyExc_ValueError, "the file is not a QBAF binary file");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+    memcpy(header, data, sizeof(QBAFFileHeader));
+    if (memcmp(header->magic, QBAF_FILE_MAGIC, sizeof(header->magic)) != 0) {
+        PyErr_SetString(PyExc_ValueError, "the file is not a QBAF binary file");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+    if (header->version != QBAF_FILE_VERSION) {
+        PyErr_Format(PyExc_ValueError, "unsupported version %u of the QBAF binary file", header->version);
+        Py_DECREF(mapping);
+        return NULL;
+    }
+    if (header->byte_order != QBAF_FILE_BYTE_ORDER) {
+        PyErr_SetString(PyExc_ValueError, "the QBAF binary file was saved with a different byte order");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+    if ((arguments != NULL) != ((header->flags & QBAF_FILE_EXTERNAL_NAMES) != 0)) {
+        PyErr_SetString(PyExc_ValueError, arguments == NULL ? "the QBAF binary file does not contain its arguments"
+                                                            : "the QBAF binary file already contains its arguments");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+    if (arguments != NULL && PyList_GET_SIZE(arguments) != header->size) {
+        PyErr_SetString(PyExc_ValueError, "the number of arguments does not match the QBAF binary file");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+    int64_t words = length / 8;     // No count can be greater than the number of words of the file
+    if (header->size < 0 || header->size > words || header->attacks < 0 || header->attacks > words ||
+        header->supports < 0 || header->supports > words || header->ordered < 0 || header->ordered > header->size ||
+        header->levels < 0 || header->levels > header->size || header->names_size < 0 || header->names_size > length ||
+        memchr(header->semantics, '\0', QBAF_FILE_SEMANTICS_SIZE) == NULL) {
+        PyErr_SetString(PyExc_ValueError, "the header of the QBAF binary file is corrupted");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+    int64_t size = header->size, edges = header->attacks + header->supports;
+    int64_t expected = sizeof(QBAFFileHeader) + 8 * (size + (size + 1) + header->attacks + (size + 1) + header->supports +
+                                                     (size + 1) + edges + header->ordered + size + (header->levels + 1) +
+                                                     (size + 1)) + header->names_size;
+    if (expected != length) {
+        PyErr_SetString(PyExc_ValueError, "the size of the QBAF binary file does not match its header");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+
+    QBAFGraph *graph = PyMem_Calloc(1, sizeof(QBAFGraph));
+    if (graph == NULL) {
+        Py_DECREF(mapping);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    graph->mapping = mapping;   // From now on, the graph owns the mapping
+
+    // Point every section to the mapped pages
+    Py_ssize_t offset = sizeof(QBAFFileHeader);
+    graph->size = size;
+    Py_ssize_t initial_strengths_offset = offset;
+    graph->initial_strengths = (double *) (data + offset);              offset += 8 * size;
+    graph->attackers_offsets = (Py_ssize_t *) (data + offset);          offset += 8 * (size + 1);
+    graph->attackers = (Py_ssize_t *) (data + offset);                  offset += 8 * header->attacks;
+    graph->supporters_offsets = (Py_ssize_t *) (data + offset);         offset += 8 * (size + 1);
+    graph->supporters = (Py_ssize_t *) (data + offset);                 offset += 8 * header->supports;
+    graph->dependents_offsets = (Py_ssize_t *) (data + offset);         offset += 8 * (size + 1);
+    graph->dependents = (Py_ssize_t *) (data + offset);                 offset += 8 * edges;
+    graph->order = (Py_ssize_t *) (data + offset);                      offset += 8 * header->ordered;
+    graph->positions = (Py_ssize_t *) (data + offset);                  offset += 8 * size;
+    graph->level_offsets = (Py_ssize_t *) (data + offset);              offset += 8 * (header->levels + 1);
+    const int64_t *name_offsets = (const int64_t *) (data + offset);    offset += 8 * (size + 1);
+    const char *names = data + offset;
+    graph->ordered = header->ordered;
+    graph->levels = header->levels;
+
+    // A corrupted file must not lead to reading out of the mapping
+    int valid = QBAFFile_valid_csr((const int64_t *) graph->attackers_offsets, (const int64_t *) graph->attackers,
+                                   size, header->attacks, size) &&
+                QBAFFile_valid_csr((const int64_t *) graph->supporters_offsets, (const int64_t *) graph->supporters,
+                                   size, header->supports, size) &&
+                QBAFFile_valid_csr((const int64_t *) graph->dependents_offsets, (const int64_t *) graph->dependents,
+                                   size, edges, size) &&
+                QBAFFile_valid_csr((const int64_t *) graph->level_offsets, (const int64_t *) graph->order,
+                                   header->levels, header->ordered, size) &&
+                QBAFFile_valid_csr(name_offsets, NULL, size, header->names_size, 0);
+    valid = valid && QBAFFile_valid_schedule(graph);
+    if (valid) {
+        valid = QBAFFile_valid_dependents(graph);
+        if (valid < 0) {
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+    }
+    if (!valid) {
+        PyErr_SetString(PyExc_ValueError, "the QBAF binary file is corrupted");
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+
+    // The initial strengths are exported as a slice of the mapping (QBAFGraph_Unshare copies them before any change)
+    graph->initial_strengths_buffer = PySequence_GetSlice(mapping, initial_strengths_offset, initial_strengths_offset + 8 * size);
+    graph->final_strengths_buffer = PyByteArray_FromStringAndSize(NULL, size * sizeof(double));
+    graph->arguments = PyList_New(size);
+    graph->indices = PyDict_New();
+    graph->dirty = PyMem_Calloc(size + 1, sizeof(char));
+    graph->dirty_first = size;
+    if (graph->initial_strengths_buffer == NULL || graph->final_strengths_buffer == NULL ||
+        graph->arguments == NULL || graph->indices == NULL || graph->dirty == NULL) {
+        if (!PyErr_Occurred())
+            PyErr_NoMemory();
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+    graph->final_strengths = (double *) PyByteArray_AS_STRING(graph->final_strengths_buffer);
+    memset(graph->final_strengths, 0, size * sizeof(double));
+
+    // Decode the arguments (or take them from arguments)
+    for (Py_ssize_t index = 0; index < size; index++) {
+        PyObject *argument;
+        if (arguments != NULL) {
+            argument = PyList_GET_ITEM(arguments, index);
+            Py_INCREF(argument);
+        } else {
+            argument = QBAFFile_decode_name(names + name_offsets[index], name_offsets[index + 1] - name_offsets[index]);
+        }
+        if (argument == NULL) {
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+        PyList_SET_ITEM(graph->arguments, index, argument);
+
+        PyObject *pyindex = PyLong_FromSsize_t(index);
+        if (pyindex == NULL || PyDict_SetItem(graph->indices, argument, pyindex) < 0) {
+            Py_XDECREF(pyindex);
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+        Py_DECREF(pyindex);
+    }
+    if (PyDict_GET_SIZE(graph->indices) != size) {
+        PyErr_SetString(PyExc_ValueError, "the QBAF binary file contains repeated arguments");
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+
+    // Allocate the scratch array for the agents of any argument
+    for (Py_ssize_t index = 0; index < size; index++) {
+        Py_ssize_t agents = (graph->attackers_offsets[index + 1] - graph->attackers_offsets[index]) +
+                            (graph->supporters_offsets[index + 1] - graph->supporters_offsets[index]);
+        if (agents > graph->max_agents)
+            graph->max_agents = agents;
+    }
+    graph->buffer = PyMem_Malloc(graph->max_agents * sizeof(double) + 1);
+    if (graph->buffer == NULL) {
+        QBAFGraph_Free(graph);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    return graph;
+}
+
+QBAFGraph *
+QBAFFile_Map(PyObject *path, QBAFFileHeader *header)
+{
+    if (sizeof(Py_ssize_t) != sizeof(int64_t)) {
+        PyErr_SetString(PyExc_NotImplementedError, "the binary format requires a 64-bit platform");
+        return NULL;
+    }
+
+    PyObject *mapping = QBAFFile_mmap(path);
+    if (mapping == NULL) {
+        return NULL;
+    }
+    return QBAFFile_graph(mapping, NULL, header);
+}
+
+QBAFGraph *
+QBAFFile_Loads(PyObject *image, PyObject *arguments, QBAFFileHeader *header)
+{
+    if (sizeof(Py_ssize_t) != sizeof(int64_t)) {
+        PyErr_SetString(PyExc_NotImplementedError, "the binary format requires a 64-bit platform");
+        return NULL;
+    }
+
+    PyObject *mapping = PyMemoryView_FromObject(image);
+    if (mapping == NULL) {
+        return NULL;
+    }
+    Py_buffer *view = PyMemoryView_GET_BUFFER(mapping);
+    if (!PyBuffer_IsContiguous(view, 'C') || view->itemsize != 1) {
+        PyErr_SetString(PyExc_ValueError, "the QBAF binary image must be a contiguous buffer of bytes");
+        Py_DECREF(mapping);
+        return NULL;
+    }
+
+    // The sections are used in place (once validated), so they are copied unless they are 8-byte aligned
+    // and immutable: a writable or read-only view of a mutable object could change them after validation
+    if ((uintptr_t) view->buf % 8 != 0 || view->obj == NULL || !PyBytes_CheckExact(view->obj)) {
+        PyObject *copy = PyByteArray_FromStringAndSize(view->buf, view->len);
+        Py_DECREF(mapping);
+        if (copy == NULL) {
+            return NULL;
+        }
+        mapping = PyMemoryView_FromObject(copy);
+        Py_DECREF(copy);
+        if (mapping == NULL) {
+            return NULL;
+        }
+    }
+    return QBAFFile_graph(mapping, arguments, header);
+}
@@ -6,6 +6,7 @@
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <string.h>
 
 #include "qbaf_functions.h"
 
@@ -176,6 +177,82 @@ double top(PyObject *attacker_strengths, PyObject *supporter_strengths)
     return supporters_aggregation - attackers_aggregation;
 }
 
+/**
+ * @brief Given the final strengths of attackers and supporters, return the result of the aggregation function 'sum'.
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @return double the result of the aggregation function 'sum'
+ */
+double sum_array(const double *attacker_strengths, Py_ssize_t attackers_size,
+                 const double *supporter_strengths, Py_ssize_t supporters_size)
+{
+    double attackers_aggregation = 0;
+    double supporters_aggregation = 0;
+
+    for (Py_ssize_t i = 0; i < attackers_size; i++)
+        attackers_aggregation = attackers_aggregation + attacker_strengths[i];
+
+    for (Py_ssize_t i = 0; i < supporters_size; i++)
+        supporters_aggregation = supporters_aggregation + supporter_strengths[i];
+
+    return supporters_aggregation - attackers_aggregation;
+}
+
+/**
+ * @brief Given the final strengths of attackers and supporters, return the result of the aggregation function 'product'.
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @return double the result of the aggregation function 'product'
+ */
+double product_array(const double *attacker_strengths, Py_ssize_t attackers_size,
+                     const double *supporter_strengths, Py_ssize_t supporters_size)
+{
+    double attackers_aggregation = 1;
+    double supporters_aggregation = 1;
+
+    for (Py_ssize_t i = 0; i < attackers_size; i++)
+        attackers_aggregation = attackers_aggregation * (1 - attacker_strengths[i]);
+
+    for (Py_ssize_t i = 0; i < supporters_size; i++)
+        supporters_aggregation = supporters_aggregation * (1 - supporter_strengths[i]);
+
+    return attackers_aggregation - supporters_aggregation;
+}
+
+/**
+ * @brief Given the final strengths of attackers and supporters, return the result of the aggregation function 'top'.
+ * As top, it returns -1 if the strength of an attacker is not in [-1, 1].
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @return double the result of the aggregation function 'top'
+ */
+double top_array(const double *attacker_strengths, Py_ssize_t attackers_size,
+                 const double *supporter_strengths, Py_ssize_t supporters_size)
+{
+    double attackers_aggregation = 0;
+    double supporters_aggregation = 0;
+
+    for (Py_ssize_t i = 0; i < attackers_size; i++) {
+        if (attacker_strengths[i] > 1 || attacker_strengths[i] < -1)
+            return -1;
+        attackers_aggregation = max(attackers_aggregation, attacker_strengths[i]);
+    }
+
+    for (Py_ssize_t i = 0; i < supporters_size; i++)
+        supporters_aggregation = max(supporters_aggregation, supporter_strengths[i]);
+
+    return supporters_aggregation - attackers_aggregation;
+}
+
 /**
  * @brief Return the influence result of the basic model.
  * 
@@ -228,6 +305,7 @@ double euler_based(double w, double s)
 
 /**
  * @brief Support function for p_max_k.
+ * The square is computed as a multiplication, like in the vector kernels (pow may round it differently).
  * 
  * @param x a double
  * @param p a natural number
@@ -236,7 +314,9 @@ double euler_based(double w, double s)
 static inline
 double h(double x, uint32_t p)
 {
-    return pow(max(0, x), p) / (1 + pow(max(0, x), p));
+    double power = max(0, x);
+    power = p == 2 ? power * power : pow(power, p);
+    return power / (1 + power);
 }
 
 /**
@@ -276,4 +356,441 @@ double max_2_1(double w, double s)
 double max_1_1(double w, double s)
 {
     return p_max_k(w, s, 1, 1);
-}
\ No newline at end of file
+}
+/*
+ * Batched influence functions.
+ * On x86 (GCC/Clang) they are vectorized with AVX2 or AVX-512, chosen at runtime.
+ * Otherwise, they call the scalar influence functions.
+ */
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define QBAF_SIMD
+#endif
+
+#ifdef QBAF_SIMD
+
+#define EXP_MAX_INPUT 710.0
+#define EXP_MIN_INPUT -746.0
+#define EXP_LOG2E 1.4426950408889634
+#define EXP_LN2_HI 6.93147180369123816490e-01     /* ln(2) with the 21 lowest bits set to 0 */
+#define EXP_LN2_LO 1.90821492927058770002e-10     /* ln(2) - EXP_LN2_HI */
+#define EXP_ROUND_MAGIC 6755399441055744.0          /* 1.5 * 2^52 */
+#define EXP_ROUND_MAGIC_BITS 0x4338000000000000LL
+#define EXP_C2 (1.0 / 2)
+#define EXP_C3 (1.0 / 6)
+#define EXP_C4 (1.0 / 24)
+#define EXP_C5 (1.0 / 120)
+#define EXP_C6 (1.0 / 720)
+#define EXP_C7 (1.0 / 5040)
+#define EXP_C8 (1.0 / 40320)
+#define EXP_C9 (1.0 / 362880)
+#define EXP_C10 (1.0 / 3628800)
+#define EXP_C11 (1.0 / 39916800)
+#define EXP_C12 (1.0 / 479001600)
+#define EXP_C13 (1.0 / 6227020800)
+
+// AVX2
+typedef double qbaf_v4df __attribute__((vector_size(32)));
+typedef long long qbaf_v4di __attribute__((vector_size(32)));
+#define QBAF_VD qbaf_v4df
+#define QBAF_VI qbaf_v4di
+#define QBAF_WIDTH 4
+#define QBAF_TARGET __attribute__((target("avx2")))
+#define QBAF_NAME(name) name##_avx2
+#include "qbaf_simd_kernels.h"
+#undef QBAF_VD
+#undef QBAF_VI
+#undef QBAF_WIDTH
+#undef QBAF_TARGET
+#undef QBAF_NAME
+
+// AVX-512
+typedef double qbaf_v8df __attribute__((vector_size(64)));
+typedef long long qbaf_v8di __attribute__((vector_size(64)));
+#define QBAF_VD qbaf_v8df
+#define QBAF_VI qbaf_v8di
+#define QBAF_WIDTH 8
+#define QBAF_TARGET __attribute__((target("avx512f")))
+#define QBAF_NAME(name) name##_avx512
+#include "qbaf_simd_kernels.h"
+#undef QBAF_VD
+#undef QBAF_VI
+#undef QBAF_WIDTH
+#undef QBAF_TARGET
+#undef QBAF_NAME
+
+#endif
+
+/**
+ * @brief Define the scalar batched version of the influence function function.
+ */
+#define QBAF_DEFINE_SCALAR_BATCH(function)                                                  \
+static void                                                                                 \
+function##_scalar(const double *w, const double *s, double *result, Py_ssize_t size)       \
+{                                                                                           \
+    for (Py_ssize_t i = 0; i < size; i++)                                                   \
+        result[i] = function(w[i], s[i]);                                                   \
+}
+
+QBAF_DEFINE_SCALAR_BATCH(simple_influence)
+QBAF_DEFINE_SCALAR_BATCH(linear_1)
+QBAF_DEFINE_SCALAR_BATCH(euler_based)
+QBAF_DEFINE_SCALAR_BATCH(max_2_1)
+QBAF_DEFINE_SCALAR_BATCH(max_1_1)
+
+#undef QBAF_DEFINE_SCALAR_BATCH
+
+/**
+ * @brief Return 2 if the CPU supports AVX-512, 1 if it supports AVX2, 0 otherwise.
+ * 
+ * @return int the widest supported instruction set
+ */
+static int
+simd_level(void)
+{
+    static int level = -1;
+
+    if (level < 0) {
+#ifdef QBAF_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            level = 2;
+        else if (__builtin_cpu_supports("avx2"))
+            level = 1;
+        else
+            level = 0;
+#else
+        level = 0;
+#endif
+    }
+
+    return level;
+}
+
+/**
+ * @brief Define the batched influence function that dispatches to the widest supported instruction set.
+ */
+#ifdef QBAF_SIMD
+#define QBAF_DEFINE_DISPATCH(function)                                                      \
+void function##_batch(const double *w, const double *s, double *result, Py_ssize_t size)   \
+{                                                                                           \
+    switch (simd_level()) {                                                                 \
+        case 2: function##_avx512(w, s, result, size); break;                               \
+        case 1: function##_avx2(w, s, result, size); break;                                 \
+        default: function##_scalar(w, s, result, size);                                     \
+    }                                                                                       \
+}
+#else
+#define QBAF_DEFINE_DISPATCH(function)                                                      \
+void function##_batch(const double *w, const double *s, double *result, Py_ssize_t size)   \
+{                                                                                           \
+    function##_scalar(w, s, result, size);                                                  \
+}
+#endif
+
+QBAF_DEFINE_DISPATCH(simple_influence)
+QBAF_DEFINE_DISPATCH(linear_1)
+QBAF_DEFINE_DISPATCH(euler_based)
+QBAF_DEFINE_DISPATCH(max_2_1)
+QBAF_DEFINE_DISPATCH(max_1_1)
+
+#undef QBAF_DEFINE_DISPATCH
+
+/**
+ * @brief Return the batched version of a built-in influence function, NULL if influence is not built-in.
+ * The batched euler_based is only vectorized if approximate is 1, otherwise it uses the exp of libm.
+ * 
+ * @param influence an influence function
+ * @param approximate 1 if the vectorized approximation of exp may be used, 0 if not
+ * @return QBAFBatchInfluence the batched influence function, NULL if there is none
+ */
+QBAFBatchInfluence batch_influence_function(double (*influence)(double, double), int approximate)
+{
+    if (influence == simple_influence)
+        return simple_influence_batch;
+    if (influence == linear_1)
+        return linear_1_batch;
+    if (influence == euler_based)
+        return approximate ? euler_based_batch : euler_based_scalar;
+    if (influence == max_2_1)
+        return max_2_1_batch;
+    if (influence == max_1_1)
+        return max_1_1_batch;
+    return NULL;
+}
+
+/*
+ * Partial derivatives of the aggregation functions over arrays and the influence functions.
+ */
+
+/**
+ * @brief Store in attacker_derivatives and supporter_derivatives the partial derivatives of sum_array.
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @param attacker_derivatives array (size attackers_size) where the derivatives w.r.t. the attackers are stored
+ * @param supporter_derivatives array (size supporters_size) where the derivatives w.r.t. the supporters are stored
+ */
+void sum_array_derivative(const double *attacker_strengths, Py_ssize_t attackers_size,
+                          const double *supporter_strengths, Py_ssize_t supporters_size,
+                          double *attacker_derivatives, double *supporter_derivatives)
+{
+    for (Py_ssize_t i = 0; i < attackers_size; i++)
+        attacker_derivatives[i] = -1;
+
+    for (Py_ssize_t i = 0; i < supporters_size; i++)
+        supporter_derivatives[i] = 1;
+}
+
+/**
+ * @brief Store in derivatives[i] the product of (1 - strengths[j]) for every j != i multiplied by sign.
+ * 
+ * @param strengths array of strengths
+ * @param size number of strengths
+ * @param sign 1 or -1
+ * @param derivatives array (size size) where the result is stored
+ */
+static inline
+void product_derivative(const double *strengths, Py_ssize_t size, double sign, double *derivatives)
+{
+    // Prefix products first, then they are multiplied by the suffix products
+    double product = sign;
+    for (Py_ssize_t i = 0; i < size; i++) {
+        derivatives[i] = product;
+        product = product * (1 - strengths[i]);
+    }
+    product = 1;
+    for (Py_ssize_t i = size - 1; i >= 0; i--) {
+        derivatives[i] = derivatives[i] * product;
+        product = product * (1 - strengths[i]);
+    }
+}
+
+/**
+ * @brief Store in attacker_derivatives and supporter_derivatives the partial derivatives of product_array
+ * (computed with prefix and suffix products, so no division is needed).
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @param attacker_derivatives array (size attackers_size) where the derivatives w.r.t. the attackers are stored
+ * @param supporter_derivatives array (size supporters_size) where the derivatives w.r.t. the supporters are stored
+ */
+void product_array_derivative(const double *attacker_strengths, Py_ssize_t attackers_size,
+                              const double *supporter_strengths, Py_ssize_t supporters_size,
+                              double *attacker_derivatives, double *supporter_derivatives)
+{
+    product_derivative(attacker_strengths, attackers_size, -1, attacker_derivatives);
+    product_derivative(supporter_strengths, supporters_size, 1, supporter_derivatives);
+}
+
+/**
+ * @brief Store in derivatives the derivatives of max(0, strengths...) multiplied by sign:
+ * sign for the maximum strength if it is positive and unique, 0 for the rest.
+ * 
+ * @param strengths array of strengths
+ * @param size number of strengths
+ * @param sign 1 or -1
+ * @param derivatives array (size size) where the result is stored
+ */
+static inline
+void top_derivative(const double *strengths, Py_ssize_t size, double sign, double *derivatives)
+{
+    Py_ssize_t strongest = -1;
+    double aggregation = 0;
+    int tied = 0;
+
+    for (Py_ssize_t i = 0; i < size; i++) {
+        derivatives[i] = 0;
+        if (strengths[i] > aggregation) {
+            aggregation = strengths[i];
+            strongest = i;
+            tied = 0;
+        }
+        else if (strongest >= 0 && strengths[i] == aggregation) {
+            tied = 1;
+        }
+    }
+
+    if (strongest >= 0 && !tied)
+        derivatives[strongest] = sign;
+}
+
+/**
+ * @brief Store in attacker_derivatives and supporter_derivatives the partial derivatives of top_array.
+ * Only the strongest attacker/supporter has a non-zero derivative. If several of them are tied,
+ * the derivative of all of them is 0 (decreasing one of them does not change the maximum).
+ * 
+ * @param attacker_strengths array of attackers' final strengths
+ * @param attackers_size number of attackers
+ * @param supporter_strengths array of supporters' final strengths
+ * @param supporters_size number of supporters
+ * @param attacker_derivatives array (size attackers_size) where the derivatives w.r.t. the attackers are stored
+ * @param supporter_derivatives array (size supporters_size) where the derivatives w.r.t. the supporters are stored
+ */
+void top_array_derivative(const double *attacker_strengths, Py_ssize_t attackers_size,
+                          const double *supporter_strengths, Py_ssize_t supporters_size,
+                          double *attacker_derivatives, double *supporter_derivatives)
+{
+    top_derivative(attacker_strengths, attackers_size, -1, attacker_derivatives);
+    top_derivative(supporter_strengths, supporters_size, 1, supporter_derivatives);
+}
+
+/**
+ * @brief Store in dw and ds the partial derivatives of simple_influence.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void simple_influence_derivative(double w, double s, double *dw, double *ds)
+{
+    *dw = 1;
+    *ds = 1;
+}
+
+/**
+ * @brief Store in dw and ds the partial derivatives of linear(k).
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param k a double
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+static inline
+void linear_k_derivative(double w, double s, double k, double *dw, double *ds)
+{
+    *dw = 1 - max(0, -s) / k - max(0, s) / k;
+    *ds = s >= 0 ? (1-w) / k : w / k;
+}
+
+/**
+ * @brief Store in dw and ds the partial derivatives of linear_1.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void linear_1_derivative(double w, double s, double *dw, double *ds)
+{
+    linear_k_derivative(w, s, 1, dw, ds);
+}
+
+/**
+ * @brief Store in dw and ds the partial derivatives of euler_based.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void euler_based_derivative(double w, double s, double *dw, double *ds)
+{
+    double e = exp(s);
+    double denominator = (1 + w*e) * (1 + w*e);
+    *dw = (2*w * (1 + w*e) + (1 - w*w) * e) / denominator;
+    *ds = (1 - w*w) * w*e / denominator;
+}
+
+/**
+ * @brief Derivative of the support function h of p_max_k (right derivative at 0).
+ * 
+ * @param x a double
+ * @param p a natural number
+ * @return double the result
+ */
+static inline
+double h_derivative(double x, uint32_t p)
+{
+    if (x < 0)
+        return 0;
+    return p * pow(x, p - 1) / ((1 + pow(x, p)) * (1 + pow(x, p)));
+}
+
+/**
+ * @brief Store in dw and ds the partial derivatives of p-Max(k).
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param p a natural number
+ * @param k a double
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+static inline
+void p_max_k_derivative(double w, double s, uint32_t p, double k, double *dw, double *ds)
+{
+    *dw = 1 - h(-s/k, p) - h(s/k, p);
+    *ds = s >= 0 ? (1-w) * h_derivative(s/k, p) / k : w * h_derivative(-s/k, p) / k;
+}
+
+/**
+ * @brief Store in dw and ds the partial derivatives of max_2_1.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void max_2_1_derivative(double w, double s, double *dw, double *ds)
+{
+    p_max_k_derivative(w, s, 2, 1, dw, ds);
+}
+
+/**
+ * @brief Store in dw and ds the partial derivatives of max_1_1.
+ * 
+ * @param w the initial strength
+ * @param s the result of applying the aggregation function to all attackers and supporters
+ * @param dw where the derivative w.r.t. w is stored
+ * @param ds where the derivative w.r.t. s is stored
+ */
+void max_1_1_derivative(double w, double s, double *dw, double *ds)
+{
+    p_max_k_derivative(w, s, 1, 1, dw, ds);
+}
+
+/**
+ * @brief Return the partial derivatives of the aggregation function over arrays aggregation,
+ * NULL if there are none.
+ * 
+ * @param aggregation an aggregation function over arrays
+ * @return QBAFArrayAggregationDerivative the derivatives, NULL if there are none
+ */
+QBAFArrayAggregationDerivative aggregation_derivative_function(QBAFArrayAggregation aggregation)
+{
+    if (aggregation == sum_array)
+        return sum_array_derivative;
+    if (aggregation == product_array)
+        return product_array_derivative;
+    if (aggregation == top_array)
+        return top_array_derivative;
+    return NULL;
+}
+
+/**
+ * @brief Return the partial derivatives of the influence function influence, NULL if there are none.
+ * 
+ * @param influence an influence function
+ * @return QBAFInfluenceDerivative the derivatives, NULL if there are none
+ */
+QBAFInfluenceDerivative influence_derivative_function(double (*influence)(double, double))
+{
+    if (influence == simple_influence)
+        return simple_influence_derivative;
+    if (influence == linear_1)
+        return linear_1_derivative;
+    if (influence == euler_based)
+        return euler_based_derivative;
+    if (influence == max_2_1)
+        return max_2_1_derivative;
+    if (influence == max_1_1)
+        return max_1_1_derivative;
+    return NULL;
+}
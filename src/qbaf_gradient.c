@@ -0,0 +1,165 @@
+/**
+ * @file qbaf_gradient.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the derivatives of the final strengths of a QBAFGraph (qbaf_gradient.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string.h>
+
+#include "qbaf_gradient.h"
+
+/**
+ * @brief Return the agents (attackers followed by supporters) of the argument with index index gathered in strengths,
+ * and store in derivatives the partial derivatives of the influence function w.r.t. every one of them
+ * (chain rule through the aggregation). The derivative w.r.t. the initial strength is stored in dw.
+ *
+ * @param graph an evaluated QBAFGraph
+ * @param index the index of the argument
+ * @param aggregation an aggregation function over arrays
+ * @param aggregation_derivative the partial derivatives of aggregation
+ * @param influence_derivative the partial derivatives of the influence function
+ * @param strengths a scratch array of size graph->max_agents
+ * @param derivatives an array of size graph->max_agents where the derivatives are stored
+ * @param dw where the derivative w.r.t. the initial strength is stored
+ */
+static inline void
+QBAFGradient_local(QBAFGraph *graph, Py_ssize_t index, QBAFArrayAggregation aggregation,
+                   QBAFArrayAggregationDerivative aggregation_derivative,
+                   QBAFInfluenceDerivative influence_derivative,
+                   double *strengths, double *derivatives, double *dw)
+{
+    Py_ssize_t attackers_size = graph->attackers_offsets[index + 1] - graph->attackers_offsets[index];
+    Py_ssize_t supporters_size = graph->supporters_offsets[index + 1] - graph->supporters_offsets[index];
+    double ds;
+
+    double s = QBAFGraph_Aggregate(graph, index, graph->final_strengths, aggregation, strengths);
+    influence_derivative(graph->initial_strengths[index], s, dw, &ds);
+    aggregation_derivative(strengths, attackers_size, strengths + attackers_size, supporters_size,
+                           derivatives, derivatives + attackers_size);
+    for (Py_ssize_t agent = 0; agent < attackers_size + supporters_size; agent++)
+        derivatives[agent] = ds * derivatives[agent];
+}
+
+/**
+ * @brief Return the index of the agent in position agent of the attackers followed by the supporters
+ * of the argument with index index.
+ *
+ * @param graph a QBAFGraph
+ * @param index the index of the argument
+ * @param agent a position in [0, attackers + supporters)
+ * @return Py_ssize_t the index of the agent
+ */
+static inline Py_ssize_t
+QBAFGradient_agent(QBAFGraph *graph, Py_ssize_t index, Py_ssize_t agent)
+{
+    Py_ssize_t attackers_size = graph->attackers_offsets[index + 1] - graph->attackers_offsets[index];
+    if (agent < attackers_size)
+        return graph->attackers[graph->attackers_offsets[index] + agent];
+    return graph->supporters[graph->supporters_offsets[index] + agent - attackers_size];
+}
+
+/**
+ * @brief Store in gradient[i] the derivative of the final strength of the argument with index topic
+ * w.r.t. the initial strength of the argument with index i, for every argument (reverse mode:
+ * a single backward sweep of the topological order).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic and evaluated QBAFGraph (not NULL)
+ * @param topic the index of the topic argument
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param aggregation_derivative the partial derivatives of aggregation
+ * @param influence_derivative the partial derivatives of the influence function
+ * @param gradient an array of size graph->size where the result is stored
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFGradient_Reverse(QBAFGraph *graph, Py_ssize_t topic, QBAFArrayAggregation aggregation,
+                     QBAFArrayAggregationDerivative aggregation_derivative,
+                     QBAFInfluenceDerivative influence_derivative, double *gradient)
+{
+    // adjoints[i] is the derivative of the final strength of topic w.r.t. the final strength of i
+    double *adjoints = PyMem_Calloc(graph->size + 1, sizeof(double));
+    double *derivatives = PyMem_Malloc(graph->max_agents * sizeof(double) + 1);
+    if (adjoints == NULL || derivatives == NULL) {
+        PyMem_Free(adjoints);
+        PyMem_Free(derivatives);
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(gradient, 0, graph->size * sizeof(double));
+
+    // The adjoint of an argument is complete once all the arguments that depend on it have been visited
+    adjoints[topic] = 1;
+    for (Py_ssize_t position = graph->positions[topic]; position >= 0; position--) {
+        Py_ssize_t index = graph->order[position];
+        if (adjoints[index] == 0)
+            continue;
+
+        double dw;
+        QBAFGradient_local(graph, index, aggregation, aggregation_derivative, influence_derivative,
+                           graph->buffer, derivatives, &dw);
+        gradient[index] = adjoints[index] * dw;
+
+        Py_ssize_t agents = (graph->attackers_offsets[index + 1] - graph->attackers_offsets[index]) +
+                            (graph->supporters_offsets[index + 1] - graph->supporters_offsets[index]);
+        for (Py_ssize_t agent = 0; agent < agents; agent++)
+            adjoints[QBAFGradient_agent(graph, index, agent)] += adjoints[index] * derivatives[agent];
+    }
+
+    PyMem_Free(adjoints);
+    PyMem_Free(derivatives);
+    return 0;
+}
+
+/**
+ * @brief Store in tangent[i] the derivative of the final strength of the argument with index i
+ * w.r.t. the initial strength of the argument with index argument, for every argument (forward mode:
+ * a single forward sweep of the topological order).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic and evaluated QBAFGraph (not NULL)
+ * @param argument the index of the perturbed argument
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param aggregation_derivative the partial derivatives of aggregation
+ * @param influence_derivative the partial derivatives of the influence function
+ * @param tangent an array of size graph->size where the result is stored
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFGradient_Forward(QBAFGraph *graph, Py_ssize_t argument, QBAFArrayAggregation aggregation,
+                     QBAFArrayAggregationDerivative aggregation_derivative,
+                     QBAFInfluenceDerivative influence_derivative, double *tangent)
+{
+    double *derivatives = PyMem_Malloc(graph->max_agents * sizeof(double) + 1);
+    if (derivatives == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(tangent, 0, graph->size * sizeof(double));
+
+    // The arguments before argument in the topological order do not depend on it
+    for (Py_ssize_t position = graph->positions[argument]; position < graph->ordered; position++) {
+        Py_ssize_t index = graph->order[position];
+        Py_ssize_t agents = (graph->attackers_offsets[index + 1] - graph->attackers_offsets[index]) +
+                            (graph->supporters_offsets[index + 1] - graph->supporters_offsets[index]);
+
+        int perturbed = index == argument;
+        for (Py_ssize_t agent = 0; agent < agents && !perturbed; agent++)
+            perturbed = tangent[QBAFGradient_agent(graph, index, agent)] != 0;
+        if (!perturbed)
+            continue;
+
+        double dw;
+        QBAFGradient_local(graph, index, aggregation, aggregation_derivative, influence_derivative,
+                           graph->buffer, derivatives, &dw);
+        double derivative = index == argument ? dw : 0;
+        for (Py_ssize_t agent = 0; agent < agents; agent++)
+            derivative += derivatives[agent] * tangent[QBAFGradient_agent(graph, index, agent)];
+        tangent[index] = derivative;
+    }
+
+    PyMem_Free(derivatives);
+    return 0;
+}
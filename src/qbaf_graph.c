@@ -0,0 +1,1048 @@
+/**
+ * @file qbaf_graph.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the compiled representation of a QBAFramework (qbaf_graph.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string.h>
+
+#include "qbaf_graph.h"
+#include "qbaf_utils.h"
+#include "qbaf_module.h"
+
+/**
+ * @brief Return a new QBAFGraph with every pointer set to NULL, NULL if there is no memory left.
+ *
+ * @return QBAFGraph* a new QBAFGraph
+ */
+static inline QBAFGraph *
+QBAFGraph_Alloc(void)
+{
+    QBAFGraph *graph = PyMem_Calloc(1, sizeof(QBAFGraph));
+    if (graph == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    return graph;
+}
+
+/**
+ * @brief Return a new bytearray that can store size doubles, with a copy of source if it is not NULL.
+ * NULL if an error has occurred.
+ *
+ * @param source an array of size doubles, or NULL
+ * @param size the number of doubles
+ * @return PyObject* a new bytearray, NULL if an error occurred
+ */
+static PyObject *
+QBAFGraph_strengths_buffer(const double *source, Py_ssize_t size)
+{
+    return PyByteArray_FromStringAndSize((const char *) source, size * sizeof(double));
+}
+
+/**
+ * @brief Fill the CSR arrays offsets and agents with the agents of every argument of the graph
+ * w.r.t. the relations relations. Return 0 if succeeded, -1 if an error has occurred.
+ * The agents are translated from the ids of the relations to indices of the graph
+ * with an array, so only the arguments of the graph are looked up in the symbol table.
+ *
+ * @param graph a QBAFGraph whose arguments and indices have been initialized
+ * @param relations a QBAFARelations
+ * @param offsets a pointer where the new array of offsets (size graph->size + 1) is stored
+ * @param agents a pointer where the new array of agent indices is stored
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFGraph_compile_agents(QBAFGraph *graph, QBAFARelationsObject *relations, Py_ssize_t **offsets, Py_ssize_t **agents)
+{
+    Py_ssize_t size = graph->size;
+    Py_ssize_t symbols = PyList_GET_SIZE(relations->arguments);
+
+    *offsets = PyMem_Malloc((size + 1) * sizeof(Py_ssize_t));
+    // ids[i]: id of the argument with index i (-1 if it has no id), indices[id]: index of the argument with id id
+    Py_ssize_t *ids = PyMem_Malloc((size + symbols) * sizeof(Py_ssize_t) + 1);
+    if (*offsets == NULL || ids == NULL) {
+        PyMem_Free(ids);
+        PyErr_NoMemory();
+        return -1;
+    }
+    Py_ssize_t *indices = ids + size;
+    for (Py_ssize_t id = 0; id < symbols; id++)
+        indices[id] = -1;
+
+    // Count the agents of every argument
+    (*offsets)[0] = 0;
+    for (Py_ssize_t index = 0; index < size; index++) {
+        ids[index] = QBAFARelations_IdOf(relations, PyList_GET_ITEM(graph->arguments, index));
+        if (ids[index] < -1) {
+            PyMem_Free(ids);
+            return -1;
+        }
+        if (ids[index] >= 0)
+            indices[ids[index]] = index;
+        (*offsets)[index + 1] = (*offsets)[index] + (ids[index] < 0 ? 0 : QBAFARelations_AgentIds(relations, ids[index])->size);
+    }
+
+    *agents = PyMem_Malloc((*offsets)[size] * sizeof(Py_ssize_t) + 1);
+    if (*agents == NULL) {
+        PyMem_Free(ids);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    // Store the index of every agent
+    for (Py_ssize_t index = 0; index < size; index++) {
+        if (ids[index] < 0)
+            continue;
+
+        const QBAFIdVector *vector = QBAFARelations_AgentIds(relations, ids[index]);
+        Py_ssize_t position = (*offsets)[index];
+        for (int32_t i = 0; i < vector->size; i++) {
+            Py_ssize_t agent_index = indices[vector->ids[i]];
+            if (agent_index < 0) {
+                PyErr_SetString(PyExc_ValueError, "all relation components must be in arguments");
+                PyMem_Free(ids);
+                return -1;
+            }
+            (*agents)[position] = agent_index;
+            position++;
+        }
+    }
+
+    PyMem_Free(ids);
+    return 0;
+}
+
+/**
+ * @brief Fill the CSR arrays dependents_offsets and dependents of the QBAFGraph graph
+ * (the arguments attacked/supported by every argument). Return 0 if succeeded, -1 if an error has occurred.
+ *
+ * @param graph a QBAFGraph whose attackers and supporters have been compiled
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFGraph_compile_dependents(QBAFGraph *graph)
+{
+    Py_ssize_t size = graph->size;
+
+    graph->dependents_offsets = PyMem_Calloc(size + 1, sizeof(Py_ssize_t));
+    if (graph->dependents_offsets == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    graph->dependents = PyMem_Malloc((graph->attackers_offsets[size] + graph->supporters_offsets[size]) * sizeof(Py_ssize_t) + 1);
+    if (graph->dependents == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    // Count the dependents of every argument (shifted by one)
+    for (Py_ssize_t position = 0; position < graph->attackers_offsets[size]; position++)
+        graph->dependents_offsets[graph->attackers[position] + 1]++;
+    for (Py_ssize_t position = 0; position < graph->supporters_offsets[size]; position++)
+        graph->dependents_offsets[graph->supporters[position] + 1]++;
+    for (Py_ssize_t index = 0; index < size; index++)
+        graph->dependents_offsets[index + 1] += graph->dependents_offsets[index];
+
+    // Store the dependents, using the offsets of the following argument as a cursor
+    for (Py_ssize_t index = 0; index < size; index++) {
+        for (Py_ssize_t position = graph->attackers_offsets[index]; position < graph->attackers_offsets[index + 1]; position++) {
+            Py_ssize_t agent = graph->attackers[position];
+            graph->dependents[graph->dependents_offsets[agent]++] = index;
+        }
+        for (Py_ssize_t position = graph->supporters_offsets[index]; position < graph->supporters_offsets[index + 1]; position++) {
+            Py_ssize_t agent = graph->supporters[position];
+            graph->dependents[graph->dependents_offsets[agent]++] = index;
+        }
+    }
+    // Restore the offsets
+    for (Py_ssize_t index = size; index > 0; index--)
+        graph->dependents_offsets[index] = graph->dependents_offsets[index - 1];
+    graph->dependents_offsets[0] = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Schedule the arguments of the QBAFGraph graph in topological levels with Kahn's algorithm.
+ * The arguments that are in a cycle (or depend on one) are not scheduled.
+ * Return 0 if succeeded, -1 if an error has occurred.
+ *
+ * @param graph a QBAFGraph whose dependents have been compiled
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFGraph_schedule(QBAFGraph *graph)
+{
+    Py_ssize_t size = graph->size;
+
+    graph->order = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    graph->positions = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    graph->level_offsets = PyMem_Malloc((size + 1) * sizeof(Py_ssize_t));
+    Py_ssize_t *indegrees = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    if (graph->order == NULL || graph->positions == NULL || graph->level_offsets == NULL || indegrees == NULL) {
+        PyMem_Free(indegrees);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    // The first level are the arguments without attackers and supporters
+    graph->ordered = 0;
+    for (Py_ssize_t index = 0; index < size; index++) {
+        indegrees[index] = (graph->attackers_offsets[index + 1] - graph->attackers_offsets[index]) +
+                           (graph->supporters_offsets[index + 1] - graph->supporters_offsets[index]);
+        if (indegrees[index] == 0)
+            graph->order[graph->ordered++] = index;
+    }
+
+    // Every following level are the arguments whose agents have all been scheduled
+    graph->levels = 0;
+    graph->level_offsets[0] = 0;
+    Py_ssize_t start = 0;
+    while (start < graph->ordered) {
+        Py_ssize_t end = graph->ordered;
+        for (Py_ssize_t position = start; position < end; position++) {
+            Py_ssize_t index = graph->order[position];
+            for (Py_ssize_t dependent = graph->dependents_offsets[index]; dependent < graph->dependents_offsets[index + 1]; dependent++) {
+                Py_ssize_t patient = graph->dependents[dependent];
+                if (--indegrees[patient] == 0)
+                    graph->order[graph->ordered++] = patient;
+            }
+        }
+        graph->levels++;
+        graph->level_offsets[graph->levels] = end;
+        start = end;
+    }
+
+    PyMem_Free(indegrees);
+
+    for (Py_ssize_t index = 0; index < size; index++)
+        graph->positions[index] = -1;
+    for (Py_ssize_t position = 0; position < graph->ordered; position++)
+        graph->positions[graph->order[position]] = position;
+
+    return 0;
+}
+
+/**
+ * @brief Return a new QBAFGraph compiled from the components of a QBAFramework,
+ * NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param arguments a PySet of QBAFArgument
+ * @param initial_strengths a PyDict of (QBAFArgument, PyFloat) containing every argument
+ * @param attack_relations a QBAFARelations whose arguments are contained in arguments
+ * @param support_relations a QBAFARelations whose arguments are contained in arguments
+ * @return QBAFGraph* a new QBAFGraph, NULL if an error occurred
+ */
+QBAFGraph *
+QBAFGraph_New(PyObject *arguments, PyObject *initial_strengths,
+              QBAFARelationsObject *attack_relations, QBAFARelationsObject *support_relations)
+{
+    QBAFGraph *graph = QBAFGraph_Alloc();
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    graph->size = PySet_GET_SIZE(arguments);
+
+    graph->arguments = PyList_Copy(arguments, graph->size);
+    if (graph->arguments == NULL) {
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+
+    graph->indices = PyDict_New();
+    if (graph->indices == NULL) {
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+
+    graph->initial_strengths_buffer = QBAFGraph_strengths_buffer(NULL, graph->size);
+    graph->final_strengths_buffer = QBAFGraph_strengths_buffer(NULL, graph->size);
+    if (graph->initial_strengths_buffer == NULL || graph->final_strengths_buffer == NULL) {
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+    graph->initial_strengths = (double *) PyByteArray_AS_STRING(graph->initial_strengths_buffer);
+    graph->final_strengths = (double *) PyByteArray_AS_STRING(graph->final_strengths_buffer);
+
+    graph->dirty = PyMem_Calloc(graph->size + 1, sizeof(char));
+    graph->dirty_first = graph->size;
+    if (graph->dirty == NULL) {
+        QBAFGraph_Free(graph);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // Assign an index and an initial strength to every argument
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        PyObject *argument = PyList_GET_ITEM(graph->arguments, index);  // Borrowed reference
+
+        PyObject *pyindex = PyLong_FromSsize_t(index);
+        if (pyindex == NULL) {
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+        if (PyDict_SetItem(graph->indices, argument, pyindex) < 0) {
+            Py_DECREF(pyindex);
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+        Py_DECREF(pyindex);
+
+        PyObject *initial_strength = PyDict_GetItemWithError(initial_strengths, argument);  // Borrowed reference
+        if (initial_strength == NULL) {
+            if (!PyErr_Occurred())
+                PyErr_SetString(PyExc_KeyError, "every argument must have an initial strength");
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+        graph->initial_strengths[index] = PyFloat_AsDouble(initial_strength);
+        if (graph->initial_strengths[index] == -1.0 && PyErr_Occurred()) {
+            QBAFGraph_Free(graph);
+            return NULL;
+        }
+    }
+
+    // Compile attackers and supporters
+    if (QBAFGraph_compile_agents(graph, attack_relations, &graph->attackers_offsets, &graph->attackers) < 0) {
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+    if (QBAFGraph_compile_agents(graph, support_relations, &graph->supporters_offsets, &graph->supporters) < 0) {
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+
+    // Schedule the evaluation
+    if (QBAFGraph_compile_dependents(graph) < 0 || QBAFGraph_schedule(graph) < 0) {
+        QBAFGraph_Free(graph);
+        return NULL;
+    }
+
+    // Allocate the scratch array for the agents of any argument
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        Py_ssize_t agents = (graph->attackers_offsets[index + 1] - graph->attackers_offsets[index]) +
+                            (graph->supporters_offsets[index + 1] - graph->supporters_offsets[index]);
+        if (agents > graph->max_agents)
+            graph->max_agents = agents;
+    }
+    graph->buffer = PyMem_Malloc(graph->max_agents * sizeof(double) + 1);
+    if (graph->buffer == NULL) {
+        QBAFGraph_Free(graph);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    return graph;
+}
+
+/**
+ * @brief Return a new array with a copy of the first size elements of the array source,
+ * NULL if there is no memory left.
+ *
+ * @param source an array
+ * @param size the size in bytes of the array
+ * @return void* a new array, NULL if an error occurred
+ */
+static inline void *
+PyMem_Duplicate(const void *source, size_t size)
+{
+    void *copy = PyMem_Malloc(size + 1);
+    if (copy == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    memcpy(copy, source, size);
+    return copy;
+}
+
+/**
+ * @brief Return a deep copy of the QBAFGraph graph (the QBAFArgument objects are shared),
+ * NULL (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return QBAFGraph* a new QBAFGraph, NULL if an error occurred
+ */
+QBAFGraph *
+QBAFGraph_Copy(QBAFGraph *graph)
+{
+    QBAFGraph *copy = QBAFGraph_Alloc();
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    Py_ssize_t size = graph->size;
+    Py_ssize_t edges = graph->attackers_offsets[size] + graph->supporters_offsets[size];
+    copy->size = size;
+    copy->ordered = graph->ordered;
+    copy->levels = graph->levels;
+    copy->evaluated = graph->evaluated;
+    copy->dirty_count = graph->dirty_count;
+    copy->dirty_first = graph->dirty_first;
+    copy->max_agents = graph->max_agents;
+
+    copy->arguments = PyList_GetSlice(graph->arguments, 0, size);
+    if (copy->arguments == NULL) {
+        QBAFGraph_Free(copy);
+        return NULL;
+    }
+    copy->indices = PyDict_Copy(graph->indices);
+    if (copy->indices == NULL) {
+        QBAFGraph_Free(copy);
+        return NULL;
+    }
+
+    // The strengths are shared until one of the graphs modifies them (see QBAFGraph_Unshare)
+    Py_INCREF(graph->initial_strengths_buffer);
+    Py_INCREF(graph->final_strengths_buffer);
+    copy->initial_strengths_buffer = graph->initial_strengths_buffer;
+    copy->final_strengths_buffer = graph->final_strengths_buffer;
+    copy->initial_strengths = graph->initial_strengths;
+    copy->final_strengths = graph->final_strengths;
+
+    // The arrays borrowed from a mapping are shared, since they are never modified
+    if (graph->mapping != NULL) {
+        Py_INCREF(graph->mapping);
+        copy->mapping = graph->mapping;
+        copy->attackers_offsets = graph->attackers_offsets;
+        copy->attackers = graph->attackers;
+        copy->supporters_offsets = graph->supporters_offsets;
+        copy->supporters = graph->supporters;
+        copy->dependents_offsets = graph->dependents_offsets;
+        copy->dependents = graph->dependents;
+        copy->order = graph->order;
+        copy->positions = graph->positions;
+        copy->level_offsets = graph->level_offsets;
+    }
+    else if ((copy->attackers_offsets = PyMem_Duplicate(graph->attackers_offsets, (size + 1) * sizeof(Py_ssize_t))) == NULL ||
+        (copy->attackers = PyMem_Duplicate(graph->attackers, graph->attackers_offsets[size] * sizeof(Py_ssize_t))) == NULL ||
+        (copy->supporters_offsets = PyMem_Duplicate(graph->supporters_offsets, (size + 1) * sizeof(Py_ssize_t))) == NULL ||
+        (copy->supporters = PyMem_Duplicate(graph->supporters, graph->supporters_offsets[size] * sizeof(Py_ssize_t))) == NULL ||
+        (copy->dependents_offsets = PyMem_Duplicate(graph->dependents_offsets, (size + 1) * sizeof(Py_ssize_t))) == NULL ||
+        (copy->dependents = PyMem_Duplicate(graph->dependents, edges * sizeof(Py_ssize_t))) == NULL ||
+        (copy->order = PyMem_Duplicate(graph->order, graph->ordered * sizeof(Py_ssize_t))) == NULL ||
+        (copy->positions = PyMem_Duplicate(graph->positions, size * sizeof(Py_ssize_t))) == NULL ||
+        (copy->level_offsets = PyMem_Duplicate(graph->level_offsets, (graph->levels + 1) * sizeof(Py_ssize_t))) == NULL) {
+        QBAFGraph_Free(copy);
+        return NULL;
+    }
+
+    if ((copy->dirty = PyMem_Duplicate(graph->dirty, size * sizeof(char))) == NULL ||
+        (copy->buffer = PyMem_Malloc(graph->max_agents * sizeof(double) + 1)) == NULL) {
+        if (!PyErr_Occurred())
+            PyErr_NoMemory();
+        QBAFGraph_Free(copy);
+        return NULL;
+    }
+
+    if (graph->components != NULL) {
+        copy->component_count = graph->component_count;
+        if ((copy->components = PyMem_Duplicate(graph->components, size * sizeof(Py_ssize_t))) == NULL ||
+            (copy->component_offsets = PyMem_Duplicate(graph->component_offsets, (graph->component_count + 1) * sizeof(Py_ssize_t))) == NULL ||
+            (copy->component_members = PyMem_Duplicate(graph->component_members, size * sizeof(Py_ssize_t))) == NULL) {
+            QBAFGraph_Free(copy);
+            return NULL;
+        }
+    }
+
+    return copy;
+}
+
+/**
+ * @brief Free the memory of a QBAFGraph and release its references. It does nothing if graph is NULL.
+ *
+ * @param graph a QBAFGraph
+ */
+void
+QBAFGraph_Free(QBAFGraph *graph)
+{
+    if (graph == NULL)
+        return;
+
+    Py_XDECREF(graph->arguments);
+    Py_XDECREF(graph->indices);
+    if (graph->mapping == NULL) {
+        PyMem_Free(graph->attackers_offsets);
+        PyMem_Free(graph->attackers);
+        PyMem_Free(graph->supporters_offsets);
+        PyMem_Free(graph->supporters);
+        PyMem_Free(graph->dependents_offsets);
+        PyMem_Free(graph->dependents);
+        PyMem_Free(graph->order);
+        PyMem_Free(graph->positions);
+        PyMem_Free(graph->level_offsets);
+    }
+    Py_XDECREF(graph->mapping);
+    Py_XDECREF(graph->initial_strengths_buffer);
+    Py_XDECREF(graph->final_strengths_buffer);
+    PyMem_Free(graph->dirty);
+    PyMem_Free(graph->components);
+    PyMem_Free(graph->component_offsets);
+    PyMem_Free(graph->component_members);
+    PyMem_Free(graph->buffer);
+    PyMem_Free(graph);
+}
+
+/**
+ * @brief Make sure that the strengths of the QBAFGraph graph are not shared with another graph
+ * or an exported snapshot before modifying them (copy-on-write).
+ * The strengths are shared while the object that owns them is referenced by anything but the graph,
+ * since the copies of the graph and the snapshots (QBAFGraph_FinalStrengthsView) hold a reference to it.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFGraph_Unshare(QBAFGraph *graph)
+{
+    // The initial strengths may also be borrowed from a read-only mapping (they are not in a bytearray)
+    if (Py_REFCNT(graph->initial_strengths_buffer) > 1 || !PyByteArray_CheckExact(graph->initial_strengths_buffer)) {
+        PyObject *buffer = QBAFGraph_strengths_buffer(graph->initial_strengths, graph->size);
+        if (buffer == NULL) {
+            return -1;
+        }
+        Py_SETREF(graph->initial_strengths_buffer, buffer);
+        graph->initial_strengths = (double *) PyByteArray_AS_STRING(buffer);
+    }
+    if (Py_REFCNT(graph->final_strengths_buffer) > 1) {
+        PyObject *buffer = QBAFGraph_strengths_buffer(graph->final_strengths, graph->size);
+        if (buffer == NULL) {
+            return -1;
+        }
+        Py_SETREF(graph->final_strengths_buffer, buffer);
+        graph->final_strengths = (double *) PyByteArray_AS_STRING(buffer);
+    }
+    return 0;
+}
+
+/**
+ * @brief Struct that defines a read-only snapshot of the strengths of a QBAFGraph.
+ * It keeps a reference to the object that owns the strengths, so the QBAFGraph copies them
+ * before modifying them (QBAFGraph_Unshare), and it only exports them as a read-only buffer
+ * (unlike a memoryview over the owner, whose attribute obj would give access to a writable bytearray).
+ *
+ */
+typedef struct {
+    PyObject_HEAD
+    PyObject   *owner;      /* object that owns the strengths (a bytearray or a mapping) */
+    double     *strengths;  /* the strengths */
+    Py_ssize_t  size;       /* number of strengths (the shape of the buffer) */
+    Py_ssize_t  stride;     /* sizeof(double) (the strides of the buffer) */
+} QBAFStrengthsObject;
+
+/**
+ * @brief Deallocate the memory of a QBAFStrengths.
+ *
+ * @param self an instance of QBAFStrengths
+ */
+static void
+QBAFStrengths_dealloc(QBAFStrengthsObject *self)
+{
+    Py_XDECREF(self->owner);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+/**
+ * @brief Fill view with a read-only buffer of float64 over the strengths of the QBAFStrengths self.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if the buffer cannot be exported.
+ *
+ * @param self an instance of QBAFStrengths
+ * @param view the buffer to fill
+ * @param flags the requested features of the buffer
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFStrengths_getbuffer(QBAFStrengthsObject *self, Py_buffer *view, int flags)
+{
+    if (PyBuffer_FillInfo(view, (PyObject *) self, self->strengths, self->size * self->stride, 1, flags) < 0) {
+        return -1;
+    }
+    view->itemsize = self->stride;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? "d" : NULL;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &self->size : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &self->stride : NULL;
+    return 0;
+}
+
+static PyBufferProcs QBAFStrengths_as_buffer = {
+    .bf_getbuffer = (getbufferproc) QBAFStrengths_getbuffer,
+};
+
+static PyTypeObject QBAFStrengthsType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "qbaf.QBAFStrengths",
+    .tp_basicsize = sizeof(QBAFStrengthsObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor) QBAFStrengths_dealloc,
+    .tp_as_buffer = &QBAFStrengths_as_buffer,
+};
+
+/**
+ * @brief Get the QBAFStrengthsType object created above
+ *
+ * @return PyTypeObject* a pointer to the QBAFStrengths class definition
+ */
+PyTypeObject *get_QBAFStrengthsType() {
+    return &QBAFStrengthsType;
+}
+
+/**
+ * @brief Return a new read-only memoryview of float64 over the size strengths owned by owner,
+ * NULL if an error has occurred.
+ *
+ * @param owner the object that owns the strengths
+ * @param strengths an array of size doubles
+ * @param size the number of strengths
+ * @return PyObject* a new memoryview, NULL if an error occurred
+ */
+static PyObject *
+QBAFGraph_view(PyObject *owner, double *strengths, Py_ssize_t size)
+{
+    QBAFStrengthsObject *snapshot = PyObject_New(QBAFStrengthsObject, &QBAFStrengthsType);
+    if (snapshot == NULL) {
+        return NULL;
+    }
+    Py_INCREF(owner);
+    snapshot->owner = owner;
+    snapshot->strengths = strengths;
+    snapshot->size = size;
+    snapshot->stride = sizeof(double);
+
+    PyObject *view = PyMemoryView_FromObject((PyObject *) snapshot);
+    Py_DECREF(snapshot);
+    return view;
+}
+
+/**
+ * @brief Return a new read-only memoryview of doubles over the initial strengths of the QBAFGraph graph
+ * (without copying them), NULL if an error has occurred. It is a snapshot: it keeps a reference
+ * to the strengths, so the graph copies them before modifying them (see QBAFGraph_Unshare).
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new memoryview, NULL if an error occurred
+ */
+PyObject *
+QBAFGraph_InitialStrengthsView(QBAFGraph *graph)
+{
+    return QBAFGraph_view(graph->initial_strengths_buffer, graph->initial_strengths, graph->size);
+}
+
+/**
+ * @brief Return a new read-only memoryview of doubles over the final strengths of the QBAFGraph graph
+ * (without copying them), NULL if an error has occurred. It is a snapshot: it keeps a reference
+ * to the strengths, so the graph copies them before modifying them (see QBAFGraph_Unshare).
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new memoryview, NULL if an error occurred
+ */
+PyObject *
+QBAFGraph_FinalStrengthsView(QBAFGraph *graph)
+{
+    return QBAFGraph_view(graph->final_strengths_buffer, graph->final_strengths, graph->size);
+}
+
+/**
+ * @brief Return the index of the argument in the QBAFGraph graph,
+ * -1 if it is not contained, and -2 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param argument a QBAFArgument
+ * @return Py_ssize_t the index of the argument, -1 if not contained, -2 if an error occurred
+ */
+Py_ssize_t
+QBAFGraph_IndexOf(QBAFGraph *graph, PyObject *argument)
+{
+    PyObject *pyindex = PyDict_GetItemWithError(graph->indices, argument);    // Borrowed reference
+    if (pyindex == NULL) {
+        return PyErr_Occurred() ? -2 : -1;
+    }
+    return PyLong_AsSsize_t(pyindex);
+}
+
+/**
+ * @brief Return a new PyDict of (QBAFArgument, PyFloat) with the values of strengths (an array of size graph->size),
+ * NULL if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param strengths an array of doubles indexed like the arguments of the graph
+ * @return PyObject* a new PyDict, NULL if an error occurred
+ */
+PyObject *
+QBAFGraph_StrengthsAsDict(QBAFGraph *graph, const double *strengths)
+{
+    PyObject *dict = PyDict_New();
+    if (dict == NULL) {
+        return NULL;
+    }
+
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        PyObject *strength = PyFloat_FromDouble(strengths[index]);    // New reference
+        if (strength == NULL) {
+            Py_DECREF(dict);
+            return NULL;
+        }
+        if (PyDict_SetItem(dict, PyList_GET_ITEM(graph->arguments, index), strength) < 0) {
+            Py_DECREF(strength);
+            Py_DECREF(dict);
+            return NULL;
+        }
+        Py_DECREF(strength);
+    }
+
+    return dict;
+}
+
+/**
+ * @brief Return the result of applying the aggregation function to the strengths of the attackers
+ * and supporters of the argument with index index. The strengths are gathered in buffer.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param index the index of the argument
+ * @param strengths the strengths of the arguments (size graph->size)
+ * @param aggregation an aggregation function over arrays
+ * @param buffer a scratch array of size graph->max_agents
+ * @return double the result of the aggregation function
+ */
+double
+QBAFGraph_Aggregate(QBAFGraph *graph, Py_ssize_t index, const double *strengths,
+                    QBAFArrayAggregation aggregation, double *buffer)
+{
+    return QBAFGraph_AggregateStrided(graph, index, strengths, 1, aggregation, buffer);
+}
+
+/**
+ * @brief Return the result of applying the aggregation function to the strengths of the attackers
+ * and supporters of the argument with index index, where the strength of argument i is strengths[i * stride].
+ * The strengths are gathered in buffer.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param index the index of the argument
+ * @param strengths the strengths of the arguments (size graph->size * stride)
+ * @param stride the distance between the strengths of consecutive arguments
+ * @param aggregation an aggregation function over arrays
+ * @param buffer a scratch array of size graph->max_agents
+ * @return double the result of the aggregation function
+ */
+double
+QBAFGraph_AggregateStrided(QBAFGraph *graph, Py_ssize_t index, const double *strengths, Py_ssize_t stride,
+                           QBAFArrayAggregation aggregation, double *buffer)
+{
+    Py_ssize_t attackers_size = 0, supporters_size = 0;
+
+    for (Py_ssize_t position = graph->attackers_offsets[index]; position < graph->attackers_offsets[index + 1]; position++)
+        buffer[attackers_size++] = strengths[graph->attackers[position] * stride];
+
+    double *supporter_strengths = buffer + attackers_size;
+    for (Py_ssize_t position = graph->supporters_offsets[index]; position < graph->supporters_offsets[index + 1]; position++)
+        supporter_strengths[supporters_size++] = strengths[graph->supporters[position] * stride];
+
+    return aggregation(buffer, attackers_size, supporter_strengths, supporters_size);
+}
+
+/**
+ * @brief Mark the argument with index index as dirty, i.e. its final strength must be recalculated.
+ * If the graph is not acyclic, the final strengths of all the arguments are invalidated instead.
+ * It does nothing if the final strengths have not been calculated.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @param index the index of the argument
+ */
+void
+QBAFGraph_MarkDirty(QBAFGraph *graph, Py_ssize_t index)
+{
+    if (!graph->evaluated || graph->dirty[index])
+        return;
+
+    // The final strengths of a cyclic graph are approximated all at once
+    if (!QBAFGraph_IsAcyclic(graph)) {
+        graph->evaluated = 0;
+        return;
+    }
+
+    graph->dirty[index] = 1;
+    graph->dirty_count++;
+    if (graph->positions[index] < graph->dirty_first)
+        graph->dirty_first = graph->positions[index];
+}
+
+/**
+ * @brief Unmark every dirty argument of the QBAFGraph graph.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ */
+void
+QBAFGraph_ClearDirty(QBAFGraph *graph)
+{
+    if (graph->dirty_count > 0)
+        memset(graph->dirty, 0, graph->size * sizeof(char));
+    graph->dirty_count = 0;
+    graph->dirty_first = graph->size;
+}
+
+/**
+ * @brief Return 1 if the argument with index index has the same agents in the CSR arrays
+ * (offsets, agents) of graph and (previous_offsets, previous_agents) of previous, 0 if not.
+ *
+ * @param offsets the offsets of graph
+ * @param agents the agents of graph
+ * @param previous_offsets the offsets of previous
+ * @param previous_agents the agents of previous
+ * @param index the index of the argument
+ * @return int 1 if the agents are the same, 0 if not
+ */
+static inline int
+QBAFGraph_same_agents(const Py_ssize_t *offsets, const Py_ssize_t *agents,
+                      const Py_ssize_t *previous_offsets, const Py_ssize_t *previous_agents, Py_ssize_t index)
+{
+    Py_ssize_t size = offsets[index + 1] - offsets[index];
+    if (size != previous_offsets[index + 1] - previous_offsets[index])
+        return 0;
+    return memcmp(agents + offsets[index], previous_agents + previous_offsets[index], size * sizeof(Py_ssize_t)) == 0;
+}
+
+/**
+ * @brief Reuse the final strengths of the QBAFGraph previous (compiled before a change of the framework) in graph.
+ * It is only possible if both graphs are acyclic and have the same arguments with the same indices.
+ * Then, every argument whose initial strength, attackers or supporters have changed
+ * (or that was already dirty in previous) is marked as dirty. Otherwise, it does nothing.
+ *
+ * @param graph a new QBAFGraph (not NULL) that has not been evaluated
+ * @param previous a QBAFGraph, or NULL
+ */
+void
+QBAFGraph_Inherit(QBAFGraph *graph, QBAFGraph *previous)
+{
+    if (previous == NULL || !previous->evaluated || previous->size != graph->size ||
+        !QBAFGraph_IsAcyclic(previous) || !QBAFGraph_IsAcyclic(graph))
+        return;
+
+    // The arguments are compared by identity, the same set usually yields the same order
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        if (PyList_GET_ITEM(graph->arguments, index) != PyList_GET_ITEM(previous->arguments, index))
+            return;
+    }
+
+    memcpy(graph->final_strengths, previous->final_strengths, graph->size * sizeof(double));
+    graph->evaluated = 1;
+
+    for (Py_ssize_t index = 0; index < graph->size; index++) {
+        if (previous->dirty[index] ||
+            memcmp(&graph->initial_strengths[index], &previous->initial_strengths[index], sizeof(double)) != 0 ||
+            !QBAFGraph_same_agents(graph->attackers_offsets, graph->attackers,
+                                   previous->attackers_offsets, previous->attackers, index) ||
+            !QBAFGraph_same_agents(graph->supporters_offsets, graph->supporters,
+                                   previous->supporters_offsets, previous->supporters, index))
+            QBAFGraph_MarkDirty(graph, index);
+    }
+}
+
+/**
+ * @brief Return a new PyList with a PyList of QBAFArgument for every topological level of the QBAFGraph graph,
+ * NULL if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new PyList of PyList, NULL if an error occurred
+ */
+PyObject *
+QBAFGraph_LevelsAsList(QBAFGraph *graph)
+{
+    PyObject *levels = PyList_New(graph->levels);
+    if (levels == NULL) {
+        return NULL;
+    }
+
+    for (Py_ssize_t level = 0; level < graph->levels; level++) {
+        Py_ssize_t start = graph->level_offsets[level];
+        PyObject *list = PyList_New(graph->level_offsets[level + 1] - start);
+        if (list == NULL) {
+            Py_DECREF(levels);
+            return NULL;
+        }
+        for (Py_ssize_t position = start; position < graph->level_offsets[level + 1]; position++) {
+            PyObject *argument = PyList_GET_ITEM(graph->arguments, graph->order[position]);
+            Py_INCREF(argument);
+            PyList_SET_ITEM(list, position - start, argument);
+        }
+        PyList_SET_ITEM(levels, level, list);
+    }
+
+    return levels;
+}
+
+/**
+ * @brief Compute the strongly connected components of the QBAFGraph graph (w.r.t. the attack and support relations)
+ * with an iterative version of Tarjan's algorithm, if they have not been computed yet.
+ * The components are numbered in topological order: the agents of an argument of a component
+ * belong to the same component or to previous ones.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFGraph_ComputeComponents(QBAFGraph *graph)
+{
+    if (graph->components != NULL)
+        return 0;
+
+    Py_ssize_t size = graph->size;
+    Py_ssize_t *workspace = PyMem_Malloc(5 * size * sizeof(Py_ssize_t) + 1);
+    char *on_stack = PyMem_Calloc(size + 1, sizeof(char));
+    Py_ssize_t *components = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    Py_ssize_t *component_offsets = PyMem_Calloc(size + 2, sizeof(Py_ssize_t));
+    Py_ssize_t *component_members = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    if (workspace == NULL || on_stack == NULL || components == NULL ||
+        component_offsets == NULL || component_members == NULL) {
+        PyMem_Free(workspace);
+        PyMem_Free(on_stack);
+        PyMem_Free(components);
+        PyMem_Free(component_offsets);
+        PyMem_Free(component_members);
+        PyErr_NoMemory();
+        return -1;
+    }
+    Py_ssize_t *numbers = workspace;                // visiting order, -1 if not visited
+    Py_ssize_t *lowlinks = workspace + size;
+    Py_ssize_t *cursors = workspace + 2 * size;     // next dependent to be explored
+    Py_ssize_t *stack = workspace + 3 * size;       // Tarjan's stack
+    Py_ssize_t *calls = workspace + 4 * size;       // explicit recursion stack
+
+    Py_ssize_t visited = 0, stack_size = 0, calls_size = 0, found = 0;
+    for (Py_ssize_t index = 0; index < size; index++)
+        numbers[index] = -1;
+
+    for (Py_ssize_t root = 0; root < size; root++) {
+        if (numbers[root] >= 0)
+            continue;
+
+        numbers[root] = lowlinks[root] = visited++;
+        cursors[root] = graph->dependents_offsets[root];
+        stack[stack_size++] = root;
+        on_stack[root] = 1;
+        calls[calls_size++] = root;
+
+        while (calls_size > 0) {
+            Py_ssize_t index = calls[calls_size - 1];
+
+            if (cursors[index] < graph->dependents_offsets[index + 1]) {
+                Py_ssize_t dependent = graph->dependents[cursors[index]++];
+                if (numbers[dependent] < 0) {   // Visit the dependent
+                    numbers[dependent] = lowlinks[dependent] = visited++;
+                    cursors[dependent] = graph->dependents_offsets[dependent];
+                    stack[stack_size++] = dependent;
+                    on_stack[dependent] = 1;
+                    calls[calls_size++] = dependent;
+                }
+                else if (on_stack[dependent] && numbers[dependent] < lowlinks[index]) {
+                    lowlinks[index] = numbers[dependent];
+                }
+                continue;
+            }
+
+            // All the dependents have been explored: return to the caller
+            calls_size--;
+            if (calls_size > 0 && lowlinks[index] < lowlinks[calls[calls_size - 1]])
+                lowlinks[calls[calls_size - 1]] = lowlinks[index];
+
+            if (lowlinks[index] == numbers[index]) {    // index is the root of a component
+                Py_ssize_t member;
+                do {
+                    member = stack[--stack_size];
+                    on_stack[member] = 0;
+                    components[member] = found;
+                } while (member != index);
+                found++;
+            }
+        }
+    }
+
+    // Tarjan's algorithm finds the components in reverse topological order
+    for (Py_ssize_t index = 0; index < size; index++) {
+        components[index] = found - 1 - components[index];
+        component_offsets[components[index] + 1]++;
+    }
+    for (Py_ssize_t component = 0; component < found; component++)
+        component_offsets[component + 1] += component_offsets[component];
+    for (Py_ssize_t index = 0; index < size; index++)
+        component_members[component_offsets[components[index]]++] = index;
+    for (Py_ssize_t component = found; component > 0; component--)
+        component_offsets[component] = component_offsets[component - 1];
+    component_offsets[0] = 0;
+
+    PyMem_Free(workspace);
+    PyMem_Free(on_stack);
+
+    graph->components = components;
+    graph->component_offsets = component_offsets;
+    graph->component_members = component_members;
+    graph->component_count = found;
+
+    return 0;
+}
+
+/**
+ * @brief Return a new PyList with the arguments of a cycle of the QBAFGraph graph (every argument attacks
+ * or supports the next one, and the last one attacks or supports the first one), Py_None if it is acyclic,
+ * NULL if an error has occurred.
+ *
+ * @param graph a QBAFGraph (not NULL)
+ * @return PyObject* a new PyList of QBAFArgument or Py_None, NULL if an error occurred
+ */
+PyObject *
+QBAFGraph_FindCycle(QBAFGraph *graph)
+{
+    if (QBAFGraph_IsAcyclic(graph))
+        Py_RETURN_NONE;
+
+    Py_ssize_t *steps = PyMem_Malloc(graph->size * sizeof(Py_ssize_t) + 1);    // position of every argument in the walk
+    Py_ssize_t *walk = PyMem_Malloc(graph->size * sizeof(Py_ssize_t) + 1);
+    if (steps == NULL || walk == NULL) {
+        PyMem_Free(steps);
+        PyMem_Free(walk);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (Py_ssize_t index = 0; index < graph->size; index++)
+        steps[index] = -1;
+
+    // Every argument that has not been scheduled has an agent that has not been scheduled either,
+    // so walking backwards through them must repeat an argument
+    Py_ssize_t index = 0;
+    while (graph->positions[index] >= 0)
+        index++;
+    Py_ssize_t length = 0;
+    while (steps[index] < 0) {
+        steps[index] = length;
+        walk[length++] = index;
+        Py_ssize_t next = -1;
+        for (Py_ssize_t position = graph->attackers_offsets[index]; next < 0 && position < graph->attackers_offsets[index + 1]; position++) {
+            if (graph->positions[graph->attackers[position]] < 0)
+                next = graph->attackers[position];
+        }
+        for (Py_ssize_t position = graph->supporters_offsets[index]; next < 0 && position < graph->supporters_offsets[index + 1]; position++) {
+            if (graph->positions[graph->supporters[position]] < 0)
+                next = graph->supporters[position];
+        }
+        index = next;
+    }
+
+    // The cycle is walk[steps[index]:length] in reverse order
+    Py_ssize_t start = steps[index];
+    PyObject *cycle = PyList_New(length - start);
+    if (cycle != NULL) {
+        for (Py_ssize_t step = length - 1; step >= start; step--) {
+            PyObject *argument = PyList_GET_ITEM(graph->arguments, walk[step]);
+            Py_INCREF(argument);
+            PyList_SET_ITEM(cycle, length - 1 - step, argument);
+        }
+    }
+
+    PyMem_Free(steps);
+    PyMem_Free(walk);
+    return cycle;
+}
@@ -0,0 +1,1099 @@
+/**
+ * @file qbaf_loader.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the streaming JSON and CSV loader of a QBAFramework (qbaf_loader.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "qbaf_loader.h"
+
+#define QBAF_READER_CHUNK       65536   /* number of bytes (or characters) requested in every call to read */
+#define QBAF_READER_EOF         -1      /* returned by QBAFReader_peek at the end of the source */
+#define QBAF_READER_ERROR       -2      /* returned by QBAFReader_peek if an error has occurred */
+#define QBAF_JSON_MAX_DEPTH     512     /* maximum nesting of the ignored JSON values */
+
+/**
+ * @brief A source read in chunks, with the line and the column of the next byte.
+ *
+ */
+typedef struct {
+    PyObject   *read;       /* the read method of the source */
+    PyObject   *chunk;      /* PyBytes with the current chunk */
+    const char *data;       /* the bytes of chunk */
+    Py_ssize_t  size;       /* number of bytes of chunk */
+    Py_ssize_t  position;   /* position of the next byte in chunk */
+    Py_ssize_t  line;       /* line of the next byte (starting at 1) */
+    Py_ssize_t  column;     /* column of the next byte (starting at 1) */
+    int         eof;        /* 1 if read has returned an empty chunk */
+    int         error;      /* 1 if read has raised an exception (it is not called again) */
+} QBAFReader;
+
+/**
+ * @brief A growable array of bytes, reused by every token.
+ *
+ */
+typedef struct {
+    char       *data;
+    Py_ssize_t  size;
+    Py_ssize_t  capacity;
+} QBAFToken;
+
+/**
+ * @brief Request the next chunk of the QBAFReader reader.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFReader_fill(QBAFReader *reader)
+{
+    Py_CLEAR(reader->chunk);
+    reader->data = NULL;
+    reader->size = reader->position = 0;
+
+    PyObject *chunk = PyObject_CallFunction(reader->read, "n", (Py_ssize_t)QBAF_READER_CHUNK);
+    if (chunk == NULL) {
+        return -1;
+    }
+    if (PyUnicode_Check(chunk)) {
+        Py_SETREF(chunk, PyUnicode_AsUTF8String(chunk));
+        if (chunk == NULL) {
+            return -1;
+        }
+    }
+    else if (!PyBytes_Check(chunk)) {
+        Py_SETREF(chunk, PyBytes_FromObject(chunk));
+        if (chunk == NULL) {
+            PyErr_SetString(PyExc_TypeError, "read() must return bytes or str");
+            return -1;
+        }
+    }
+
+    reader->chunk = chunk;
+    reader->data = PyBytes_AS_STRING(chunk);
+    reader->size = PyBytes_GET_SIZE(chunk);
+    reader->eof = reader->size == 0;
+    return 0;
+}
+
+/**
+ * @brief Return the next byte of the QBAFReader reader without consuming it,
+ * QBAF_READER_EOF at the end of the source, QBAF_READER_ERROR (with the corresponding exception) if an error has occurred.
+ */
+static inline int
+QBAFReader_peek(QBAFReader *reader)
+{
+    if (reader->position == reader->size) {
+        if (reader->eof) {
+            return QBAF_READER_EOF;
+        }
+        if (reader->error || QBAFReader_fill(reader) < 0) {
+            reader->error = 1;
+            return QBAF_READER_ERROR;
+        }
+        if (reader->eof) {
+            return QBAF_READER_EOF;
+        }
+    }
+    return (unsigned char)reader->data[reader->position];
+}
+
+/**
+ * @brief Consume the byte returned by QBAFReader_peek (which must not be QBAF_READER_EOF nor QBAF_READER_ERROR).
+ */
+static inline void
+QBAFReader_advance(QBAFReader *reader)
+{
+    if (reader->data[reader->position++] == '\n') {
+        reader->line++;
+        reader->column = 1;
+    } else {
+        reader->column++;
+    }
+}
+
+/**
+ * @brief Raise a ValueError with the message format, prefixed with the line and the column. Return -1.
+ */
+static int
+QBAFReader_error(Py_ssize_t line, Py_ssize_t column, const char *format, ...)
+{
+    va_list vargs;
+    va_start(vargs, format);
+    PyObject *message = PyUnicode_FromFormatV(format, vargs);
+    va_end(vargs);
+    if (message == NULL) {
+        return -1;
+    }
+    PyErr_Format(PyExc_ValueError, "line %zd, column %zd: %U", line, column, message);
+    Py_DECREF(message);
+    return -1;
+}
+
+/**
+ * @brief Raise a ValueError describing the byte c (QBAF_READER_EOF included) found where expected was expected.
+ * Return -1 (c may also be QBAF_READER_ERROR, whose exception is kept).
+ */
+static int
+QBAFReader_unexpected(QBAFReader *reader, int c, const char *expected)
+{
+    if (c == QBAF_READER_ERROR) {
+        return -1;
+    }
+    if (c == QBAF_READER_EOF) {
+        return QBAFReader_error(reader->line, reader->column, "expected %s, found the end of the input", expected);
+    }
+    if (c < 0x20 || c >= 0x7F) {
+        return QBAFReader_error(reader->line, reader->column, "expected %s, found byte 0x%02x", expected, c);
+    }
+    return QBAFReader_error(reader->line, reader->column, "expected %s, found '%c'", expected, c);
+}
+
+/**
+ * @brief Append the byte c to the QBAFToken token.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ */
+static int
+QBAFToken_append(QBAFToken *token, char c)
+{
+    if (token->size == token->capacity) {
+        Py_ssize_t capacity = token->capacity < 64 ? 64 : token->capacity * 2;
+        char *data = PyMem_Realloc(token->data, capacity + 1);     // +1 for the terminating NUL
+        if (data == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        token->data = data;
+        token->capacity = capacity;
+    }
+    token->data[token->size++] = c;
+    return 0;
+}
+
+/**
+ * @brief Terminate the QBAFToken token with a NUL byte (not counted in its size) and return its bytes.
+ */
+static inline const char *
+QBAFToken_cstring(QBAFToken *token)
+{
+    if (token->data == NULL) {      // Nothing has been appended yet
+        if (QBAFToken_append(token, '\0') < 0) {
+            return NULL;
+        }
+        token->size = 0;
+    }
+    token->data[token->size] = '\0';
+    return token->data;
+}
+
+/**
+ * @brief Parse the QBAFToken token as an initial strength.
+ * Return 0 if succeeded, -1 (with a ValueError at line and column) if it is not a real number,
+ * if it is NaN or if it overflows a double.
+ */
+static int
+QBAFLoader_strength(QBAFToken *token, Py_ssize_t line, Py_ssize_t column, double *strength)
+{
+    const char *string = QBAFToken_cstring(token);
+    if (string == NULL) {
+        return -1;
+    }
+    char *end;
+    *strength = PyOS_string_to_double(string, &end, PyExc_OverflowError);
+    if (*strength == -1.0 && PyErr_Occurred()) {
+        int overflow = PyErr_ExceptionMatches(PyExc_OverflowError);
+        PyErr_Clear();
+        if (overflow) {
+            return QBAFReader_error(line, column, "initial strength '%s' is out of range", string);
+        }
+        end = (char *)string;
+    }
+    while (*end == ' ' || *end == '\t')
+        end++;
+    if (token->size == 0 || end == string || *end != '\0' || isnan(*strength)) {
+        return QBAFReader_error(line, column, "incorrect initial strength '%s'", string);
+    }
+    return 0;
+}
+
+/**
+ * @brief Insert the argument with its initial strength in the QBAFLoaderTarget target.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param target the storage of a QBAFramework
+ * @param argument a QBAFArgument
+ * @param strength its initial strength
+ * @param line the line where the argument is declared
+ * @param column the column where the argument is declared
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFLoader_add_argument(QBAFLoaderTarget *target, PyObject *argument, double strength,
+                        Py_ssize_t line, Py_ssize_t column)
+{
+    int contains = PySet_Contains(target->arguments, argument);
+    if (contains < 0) {
+        return -1;
+    }
+    if (contains) {
+        return QBAFReader_error(line, column, "argument %R is declared twice", argument);
+    }
+
+    PyObject *value = PyFloat_FromDouble(strength);
+    if (value == NULL) {
+        return -1;
+    }
+    if (PyDict_SetItem(target->initial_strengths, argument, value) < 0) {
+        Py_DECREF(value);
+        return -1;
+    }
+    Py_DECREF(value);
+
+    if (PySet_Add(target->arguments, argument) < 0) {
+        return -1;
+    }
+    if (QBAFARelations_Intern(target->attack_relations, argument) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Return the id of the declared argument in the symbol table of the QBAFLoaderTarget target,
+ * -1 (with the corresponding exception) if an error has occurred or the argument has not been declared.
+ */
+static Py_ssize_t
+QBAFLoader_declared(QBAFLoaderTarget *target, PyObject *argument, Py_ssize_t line, Py_ssize_t column)
+{
+    Py_ssize_t id = QBAFARelations_IdOf(target->attack_relations, argument);
+    if (id == -1) {
+        QBAFReader_error(line, column, "unknown argument %R", argument);
+    }
+    return id < 0 ? -1 : id;
+}
+
+/**
+ * @brief Insert the relation between two declared arguments in the QBAFLoaderTarget target.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param target the storage of a QBAFramework
+ * @param support 1 if it is a Support relation, 0 if it is an Attack relation
+ * @param agent the agent
+ * @param patient the patient
+ * @param lines the lines of the agent and the patient
+ * @param columns the columns of the agent and the patient
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFLoader_add_relation(QBAFLoaderTarget *target, int support, PyObject *agent, PyObject *patient,
+                        Py_ssize_t lines[2], Py_ssize_t columns[2])
+{
+    Py_ssize_t agent_id = QBAFLoader_declared(target, agent, lines[0], columns[0]);
+    if (agent_id < 0) {
+        return -1;
+    }
+    Py_ssize_t patient_id = QBAFLoader_declared(target, patient, lines[1], columns[1]);
+    if (patient_id < 0) {
+        return -1;
+    }
+    return QBAFARelations_AddIds(support ? target->support_relations : target->attack_relations,
+                                 agent_id, patient_id);
+}
+
+/**
+ * @brief Read the next CSV field (RFC 4180: it may be quoted, with "" as an escaped quote) into the QBAFToken field.
+ * The spaces around an unquoted field are not included.
+ * Return 1 if the field ends its row, 0 if more fields follow, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_csv_field(QBAFReader *reader, QBAFToken *field)
+{
+    field->size = 0;
+    int c = QBAFReader_peek(reader);
+
+    while (c == ' ' || c == '\t') {
+        QBAFReader_advance(reader);
+        c = QBAFReader_peek(reader);
+    }
+
+    if (c == '"') {
+        Py_ssize_t line = reader->line, column = reader->column;
+        QBAFReader_advance(reader);
+        for (;;) {
+            c = QBAFReader_peek(reader);
+            if (c == QBAF_READER_ERROR) {
+                return -1;
+            }
+            if (c == QBAF_READER_EOF) {
+                return QBAFReader_error(line, column, "unterminated quoted field");
+            }
+            QBAFReader_advance(reader);
+            if (c == '"') {
+                if (QBAFReader_peek(reader) != '"')
+                    break;
+                QBAFReader_advance(reader);
+            }
+            if (QBAFToken_append(field, (char)c) < 0) {
+                return -1;
+            }
+        }
+        c = QBAFReader_peek(reader);
+        while (c == ' ' || c == '\t') {
+            QBAFReader_advance(reader);
+            c = QBAFReader_peek(reader);
+        }
+    }
+    else {
+        Py_ssize_t trimmed = 0;
+        while (c >= 0 && c != ',' && c != '\n' && c != '\r') {
+            if (QBAFToken_append(field, (char)c) < 0) {
+                return -1;
+            }
+            if (c != ' ' && c != '\t')
+                trimmed = field->size;
+            QBAFReader_advance(reader);
+            c = QBAFReader_peek(reader);
+        }
+        field->size = trimmed;
+    }
+
+    switch (c) {
+        case ',':
+            QBAFReader_advance(reader);
+            return 0;
+        case '\r':
+            QBAFReader_advance(reader);
+            c = QBAFReader_peek(reader);
+            if (c == '\n')
+                QBAFReader_advance(reader);
+            return c == QBAF_READER_ERROR ? -1 : 1;
+        case '\n':
+            QBAFReader_advance(reader);
+            return 1;
+        case QBAF_READER_EOF:
+            return 1;
+        default:
+            return QBAFReader_unexpected(reader, c, "',' or the end of the row");
+    }
+}
+
+/**
+ * @brief Load the CSV rows of the QBAFReader reader into the QBAFLoaderTarget target.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_csv(QBAFReader *reader, QBAFLoaderTarget *target)
+{
+    QBAFToken fields[3] = {{NULL, 0, 0}, {NULL, 0, 0}, {NULL, 0, 0}};
+    int result = -1;
+
+    int first = 1;     // The header can only be the first row
+    for (;;) {
+        int c = QBAFReader_peek(reader);
+        if (c == QBAF_READER_ERROR) {
+            goto end;
+        }
+        if (c == QBAF_READER_EOF) {
+            break;
+        }
+        if (c == '#') {     // A comment
+            while (c >= 0 && c != '\n') {
+                QBAFReader_advance(reader);
+                c = QBAFReader_peek(reader);
+            }
+            if (c == QBAF_READER_ERROR) {
+                goto end;
+            }
+            if (c == '\n')
+                QBAFReader_advance(reader);
+            continue;
+        }
+
+        Py_ssize_t lines[3], columns[3];
+        int nfields = 0, last = 0;
+        while (!last) {
+            if (nfields == 3) {
+                QBAFReader_error(reader->line, reader->column, "too many fields (expected 3)");
+                goto end;
+            }
+            lines[nfields] = reader->line;
+            columns[nfields] = reader->column;
+            last = QBAFLoader_csv_field(reader, &fields[nfields]);
+            if (last < 0) {
+                goto end;
+            }
+            nfields++;
+        }
+
+        if (nfields == 1 && fields[0].size == 0) {  // An empty row
+            continue;
+        }
+        const char *kind = QBAFToken_cstring(&fields[0]);
+        if (kind == NULL) {
+            goto end;
+        }
+        int header = first && strcmp(kind, "kind") == 0;
+        first = 0;
+        if (header) {
+            continue;
+        }
+        if (nfields != 3) {
+            QBAFReader_error(lines[0], columns[0], "expected 3 fields, found %d", nfields);
+            goto end;
+        }
+
+        int support = strcmp(kind, "support") == 0;
+        if (strcmp(kind, "argument") == 0) {
+            double strength;
+            if (QBAFLoader_strength(&fields[2], lines[2], columns[2], &strength) < 0) {
+                goto end;
+            }
+            PyObject *argument = PyUnicode_DecodeUTF8(fields[1].data, fields[1].size, NULL);
+            if (argument == NULL) {
+                goto end;
+            }
+            int added = QBAFLoader_add_argument(target, argument, strength, lines[1], columns[1]);
+            Py_DECREF(argument);
+            if (added < 0) {
+                goto end;
+            }
+        }
+        else if (support || strcmp(kind, "attack") == 0) {
+            PyObject *agent = PyUnicode_DecodeUTF8(fields[1].data, fields[1].size, NULL);
+            if (agent == NULL) {
+                goto end;
+            }
+            PyObject *patient = PyUnicode_DecodeUTF8(fields[2].data, fields[2].size, NULL);
+            if (patient == NULL) {
+                Py_DECREF(agent);
+                goto end;
+            }
+            int added = QBAFLoader_add_relation(target, support, agent, patient, &lines[1], &columns[1]);
+            Py_DECREF(agent);
+            Py_DECREF(patient);
+            if (added < 0) {
+                goto end;
+            }
+        }
+        else {
+            QBAFReader_error(lines[0], columns[0], "unknown kind '%s' (expected 'argument', 'attack' or 'support')", kind);
+            goto end;
+        }
+    }
+    result = 0;
+
+end:
+    for (int i = 0; i < 3; i++)
+        PyMem_Free(fields[i].data);
+    return result;
+}
+
+/**
+ * @brief Skip the JSON whitespace and return the next byte of the QBAFReader reader without consuming it
+ * (see QBAFReader_peek).
+ */
+static int
+QBAFLoader_json_skip(QBAFReader *reader)
+{
+    int c = QBAFReader_peek(reader);
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        QBAFReader_advance(reader);
+        c = QBAFReader_peek(reader);
+    }
+    return c;
+}
+
+/**
+ * @brief Skip the JSON whitespace and consume the byte expected.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if another byte was found.
+ */
+static int
+QBAFLoader_json_expect(QBAFReader *reader, char expected)
+{
+    int c = QBAFLoader_json_skip(reader);
+    if (c != (unsigned char)expected) {
+        char description[4] = {'\'', expected, '\'', '\0'};
+        return QBAFReader_unexpected(reader, c, description);
+    }
+    QBAFReader_advance(reader);
+    return 0;
+}
+
+/**
+ * @brief Read 4 hexadecimal digits of a \\u escape.
+ * Return the code unit, -1 (with the corresponding exception) if an error has occurred.
+ */
+static long
+QBAFLoader_json_hex(QBAFReader *reader)
+{
+    long value = 0;
+    for (int i = 0; i < 4; i++) {
+        int c = QBAFReader_peek(reader);
+        int digit = ('0' <= c && c <= '9') ? c - '0' :
+                    ('a' <= c && c <= 'f') ? c - 'a' + 10 :
+                    ('A' <= c && c <= 'F') ? c - 'A' + 10 : -1;
+        if (digit < 0) {
+            return QBAFReader_unexpected(reader, c, "a hexadecimal digit");
+        }
+        QBAFReader_advance(reader);
+        value = value * 16 + digit;
+    }
+    return value;
+}
+
+/**
+ * @brief Read a JSON string (the opening quote is the next byte) into the QBAFToken token, encoded in UTF-8.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json_string(QBAFReader *reader, QBAFToken *token)
+{
+    Py_ssize_t line = reader->line, column = reader->column;
+    token->size = 0;
+    QBAFReader_advance(reader);
+
+    for (;;) {
+        int c = QBAFReader_peek(reader);
+        if (c == QBAF_READER_ERROR) {
+            return -1;
+        }
+        if (c == QBAF_READER_EOF) {
+            return QBAFReader_error(line, column, "unterminated string");
+        }
+        if (c < 0x20) {
+            return QBAFReader_unexpected(reader, c, "a character of a string");
+        }
+        QBAFReader_advance(reader);
+        if (c == '"') {
+            return 0;
+        }
+        if (c != '\\') {
+            if (QBAFToken_append(token, (char)c) < 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        c = QBAFReader_peek(reader);
+        char escaped;
+        switch (c) {
+            case '"':  escaped = '"';  break;
+            case '\\': escaped = '\\'; break;
+            case '/':  escaped = '/';  break;
+            case 'b':  escaped = '\b'; break;
+            case 'f':  escaped = '\f'; break;
+            case 'n':  escaped = '\n'; break;
+            case 'r':  escaped = '\r'; break;
+            case 't':  escaped = '\t'; break;
+            case 'u':  escaped = '\0'; break;
+            default:
+                return QBAFReader_unexpected(reader, c, "an escape sequence");
+        }
+        QBAFReader_advance(reader);
+        if (c != 'u') {
+            if (QBAFToken_append(token, escaped) < 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        long code = QBAFLoader_json_hex(reader);
+        if (code < 0) {
+            return -1;
+        }
+        if (0xD800 <= code && code < 0xDC00) {  // A surrogate pair
+            if (QBAFReader_peek(reader) != '\\') {
+                return QBAFReader_unexpected(reader, QBAFReader_peek(reader), "a low surrogate");
+            }
+            QBAFReader_advance(reader);
+            if (QBAFReader_peek(reader) != 'u') {
+                return QBAFReader_unexpected(reader, QBAFReader_peek(reader), "a low surrogate");
+            }
+            QBAFReader_advance(reader);
+            long low = QBAFLoader_json_hex(reader);
+            if (low < 0) {
+                return -1;
+            }
+            if (low < 0xDC00 || low >= 0xE000) {
+                return QBAFReader_error(reader->line, reader->column - 6, "expected a low surrogate");
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if (0xDC00 <= code && code < 0xE000) {
+            return QBAFReader_error(reader->line, reader->column - 6, "unpaired low surrogate");
+        }
+
+        char utf8[4];
+        int length;
+        if (code < 0x80) {
+            utf8[0] = (char)code; length = 1;
+        } else if (code < 0x800) {
+            utf8[0] = (char)(0xC0 | (code >> 6)); utf8[1] = (char)(0x80 | (code & 0x3F)); length = 2;
+        } else if (code < 0x10000) {
+            utf8[0] = (char)(0xE0 | (code >> 12)); utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+            utf8[2] = (char)(0x80 | (code & 0x3F)); length = 3;
+        } else {
+            utf8[0] = (char)(0xF0 | (code >> 18)); utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+            utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F)); utf8[3] = (char)(0x80 | (code & 0x3F)); length = 4;
+        }
+        for (int i = 0; i < length; i++) {
+            if (QBAFToken_append(token, utf8[i]) < 0) {
+                return -1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Read the bytes of a JSON number or literal (true, false, null) into the QBAFToken token.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json_scalar(QBAFReader *reader, QBAFToken *token)
+{
+    token->size = 0;
+    int c = QBAFReader_peek(reader);
+    while (('0' <= c && c <= '9') || ('a' <= c && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E') {
+        if (QBAFToken_append(token, (char)c) < 0) {
+            return -1;
+        }
+        QBAFReader_advance(reader);
+        c = QBAFReader_peek(reader);
+    }
+    if (c == QBAF_READER_ERROR) {
+        return -1;
+    }
+    if (token->size == 0) {
+        return QBAFReader_unexpected(reader, c, "a value");
+    }
+    return 0;
+}
+
+/**
+ * @brief Read a JSON name of an argument (a string or an integer) and return it as a new str or int.
+ * Its line and column are stored in line and column.
+ * Return NULL (with the corresponding exception) if an error has occurred.
+ */
+static PyObject *
+QBAFLoader_json_name(QBAFReader *reader, QBAFToken *token, Py_ssize_t *line, Py_ssize_t *column)
+{
+    int c = QBAFLoader_json_skip(reader);
+    *line = reader->line;
+    *column = reader->column;
+
+    if (c == '"') {
+        if (QBAFLoader_json_string(reader, token) < 0) {
+            return NULL;
+        }
+        PyObject *name = PyUnicode_DecodeUTF8(token->data, token->size, NULL);
+        if (name == NULL) {
+            PyErr_Clear();
+            QBAFReader_error(*line, *column, "the string is not valid UTF-8");
+        }
+        return name;
+    }
+
+    if (c == '-' || ('0' <= c && c <= '9')) {
+        if (QBAFLoader_json_scalar(reader, token) < 0) {
+            return NULL;
+        }
+        const char *string = QBAFToken_cstring(token);
+        if (string == NULL) {
+            return NULL;
+        }
+        Py_ssize_t start = string[0] == '-';
+        int integer = token->size > start;
+        for (Py_ssize_t i = start; i < token->size; i++) {
+            if (string[i] < '0' || string[i] > '9')
+                integer = 0;
+        }
+        if (!integer) {
+            QBAFReader_error(*line, *column, "the name of an argument must be a string or an integer, not '%s'", string);
+            return NULL;
+        }
+        return PyLong_FromString(string, NULL, 10);
+    }
+
+    QBAFReader_unexpected(reader, c, "the name of an argument (a string or an integer)");
+    return NULL;
+}
+
+/**
+ * @brief Read a JSON number as an initial strength.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json_strength(QBAFReader *reader, QBAFToken *token, double *strength)
+{
+    int c = QBAFLoader_json_skip(reader);
+    Py_ssize_t line = reader->line, column = reader->column;
+    if (c != '-' && (c < '0' || c > '9')) {
+        return QBAFReader_unexpected(reader, c, "an initial strength (a number)");
+    }
+    if (QBAFLoader_json_scalar(reader, token) < 0) {
+        return -1;
+    }
+    return QBAFLoader_strength(token, line, column, strength);
+}
+
+/**
+ * @brief Read the separator after an element of a JSON array or object.
+ * Return 1 if it was the last element, 0 if more elements follow, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json_next(QBAFReader *reader, char close)
+{
+    int c = QBAFLoader_json_skip(reader);
+    if (c == ',') {
+        QBAFReader_advance(reader);
+        return 0;
+    }
+    if (c == (unsigned char)close) {
+        QBAFReader_advance(reader);
+        return 1;
+    }
+    return QBAFReader_unexpected(reader, c, close == ']' ? "',' or ']'" : "',' or '}'");
+}
+
+/**
+ * @brief Skip a JSON value of any type.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json_ignore(QBAFReader *reader, QBAFToken *token, int depth)
+{
+    int c = QBAFLoader_json_skip(reader);
+    if (c == '"') {
+        return QBAFLoader_json_string(reader, token);
+    }
+    if (c != '[' && c != '{') {
+        return QBAFLoader_json_scalar(reader, token);
+    }
+    if (depth == QBAF_JSON_MAX_DEPTH) {
+        return QBAFReader_error(reader->line, reader->column, "the input is too deeply nested");
+    }
+
+    char close = c == '[' ? ']' : '}';
+    QBAFReader_advance(reader);
+    if (QBAFLoader_json_skip(reader) == (unsigned char)close) {
+        QBAFReader_advance(reader);
+        return 0;
+    }
+    for (;;) {
+        if (close == '}') {
+            c = QBAFLoader_json_skip(reader);
+            if (c != '"') {
+                return QBAFReader_unexpected(reader, c, "a key");
+            }
+            if (QBAFLoader_json_string(reader, token) < 0 || QBAFLoader_json_expect(reader, ':') < 0) {
+                return -1;
+            }
+        }
+        if (QBAFLoader_json_ignore(reader, token, depth + 1) < 0) {
+            return -1;
+        }
+        int last = QBAFLoader_json_next(reader, close);
+        if (last != 0) {
+            return last < 0 ? -1 : 0;
+        }
+    }
+}
+
+/**
+ * @brief Read a JSON argument: [name, initial_strength] or {"name": name, "initial_strength": initial_strength},
+ * and insert it in the QBAFLoaderTarget target.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json_argument(QBAFReader *reader, QBAFToken *token, QBAFLoaderTarget *target)
+{
+    PyObject *argument = NULL;
+    double strength = 0.0;
+    Py_ssize_t line = reader->line, column = reader->column;
+    int c = QBAFLoader_json_skip(reader);
+
+    if (c == '[') {
+        QBAFReader_advance(reader);
+        argument = QBAFLoader_json_name(reader, token, &line, &column);
+        if (argument == NULL) {
+            return -1;
+        }
+        if (QBAFLoader_json_expect(reader, ',') < 0 ||
+            QBAFLoader_json_strength(reader, token, &strength) < 0 ||
+            QBAFLoader_json_expect(reader, ']') < 0) {
+            Py_DECREF(argument);
+            return -1;
+        }
+    }
+    else if (c == '{') {
+        Py_ssize_t object_line = reader->line, object_column = reader->column;
+        int has_strength = 0;
+        QBAFReader_advance(reader);
+        int last = QBAFLoader_json_skip(reader) == '}';
+        if (last)
+            QBAFReader_advance(reader);
+        while (!last) {
+            c = QBAFLoader_json_skip(reader);
+            if (c != '"') {
+                Py_XDECREF(argument);
+                return QBAFReader_unexpected(reader, c, "a key");
+            }
+            if (QBAFLoader_json_string(reader, token) < 0 || QBAFLoader_json_expect(reader, ':') < 0) {
+                Py_XDECREF(argument);
+                return -1;
+            }
+            int error;
+            const char *key = QBAFToken_cstring(token);
+            if (key == NULL) {
+                error = -1;
+            } else if (strcmp(key, "name") == 0) {
+                Py_XDECREF(argument);
+                argument = QBAFLoader_json_name(reader, token, &line, &column);
+                error = argument == NULL ? -1 : 0;
+            } else if (strcmp(key, "initial_strength") == 0) {
+                error = QBAFLoader_json_strength(reader, token, &strength);
+                has_strength = 1;
+            } else {
+                error = QBAFLoader_json_ignore(reader, token, 1);
+            }
+            if (error < 0 || (last = QBAFLoader_json_next(reader, '}')) < 0) {
+                Py_XDECREF(argument);
+                return -1;
+            }
+        }
+        if (argument == NULL || !has_strength) {
+            Py_XDECREF(argument);
+            return QBAFReader_error(object_line, object_column,
+                                    "an argument must have a \"name\" and an \"initial_strength\"");
+        }
+    }
+    else {
+        return QBAFReader_unexpected(reader, c, "an argument ('[' or '{')");
+    }
+
+    int result = QBAFLoader_add_argument(target, argument, strength, line, column);
+    Py_DECREF(argument);
+    return result;
+}
+
+/**
+ * @brief Read a JSON relation: [agent, patient], and insert it in the QBAFLoaderTarget target.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json_relation(QBAFReader *reader, QBAFToken *token, QBAFLoaderTarget *target, int support)
+{
+    Py_ssize_t lines[2], columns[2];
+    if (QBAFLoader_json_expect(reader, '[') < 0) {
+        return -1;
+    }
+    PyObject *agent = QBAFLoader_json_name(reader, token, &lines[0], &columns[0]);
+    if (agent == NULL) {
+        return -1;
+    }
+    if (QBAFLoader_json_expect(reader, ',') < 0) {
+        Py_DECREF(agent);
+        return -1;
+    }
+    PyObject *patient = QBAFLoader_json_name(reader, token, &lines[1], &columns[1]);
+    if (patient == NULL) {
+        Py_DECREF(agent);
+        return -1;
+    }
+    int result = QBAFLoader_json_expect(reader, ']');
+    if (result == 0) {
+        result = QBAFLoader_add_relation(target, support, agent, patient, lines, columns);
+    }
+    Py_DECREF(agent);
+    Py_DECREF(patient);
+    return result;
+}
+
+/**
+ * @brief Load the JSON object of the QBAFReader reader into the QBAFLoaderTarget target.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ */
+static int
+QBAFLoader_json(QBAFReader *reader, QBAFLoaderTarget *target)
+{
+    QBAFToken token = {NULL, 0, 0};
+    int result = -1;
+
+    if (QBAFLoader_json_expect(reader, '{') < 0) {
+        goto end;
+    }
+    int last = QBAFLoader_json_skip(reader) == '}';
+    if (last)
+        QBAFReader_advance(reader);
+    while (!last) {
+        int c = QBAFLoader_json_skip(reader);
+        if (c != '"') {
+            QBAFReader_unexpected(reader, c, "a key");
+            goto end;
+        }
+        if (QBAFLoader_json_string(reader, &token) < 0 || QBAFLoader_json_expect(reader, ':') < 0) {
+            goto end;
+        }
+        const char *key = QBAFToken_cstring(&token);
+        if (key == NULL) {
+            goto end;
+        }
+        int kind = strcmp(key, "arguments") == 0 ? 0 :
+                   strcmp(key, "attacks") == 0 ? 1 :
+                   strcmp(key, "supports") == 0 ? 2 : -1;
+
+        if (kind < 0) {
+            if (QBAFLoader_json_ignore(reader, &token, 1) < 0) {
+                goto end;
+            }
+        }
+        else {
+            if (QBAFLoader_json_expect(reader, '[') < 0) {
+                goto end;
+            }
+            int last_item = QBAFLoader_json_skip(reader) == ']';
+            if (last_item)
+                QBAFReader_advance(reader);
+            while (!last_item) {
+                if ((kind == 0 ? QBAFLoader_json_argument(reader, &token, target)
+                               : QBAFLoader_json_relation(reader, &token, target, kind == 2)) < 0) {
+                    goto end;
+                }
+                last_item = QBAFLoader_json_next(reader, ']');
+                if (last_item < 0) {
+                    goto end;
+                }
+            }
+        }
+
+        last = QBAFLoader_json_next(reader, '}');
+        if (last < 0) {
+            goto end;
+        }
+    }
+
+    int c = QBAFLoader_json_skip(reader);
+    if (c != QBAF_READER_EOF) {
+        QBAFReader_unexpected(reader, c, "the end of the input");
+        goto end;
+    }
+    result = 0;
+
+end:
+    PyMem_Free(token.data);
+    return result;
+}
+
+/**
+ * @brief Infer the format from the extension of the path source.
+ * Return "json" or "csv", NULL (with the corresponding exception) if it cannot be inferred.
+ */
+static const char *
+QBAFLoader_format(PyObject *source)
+{
+    const char *format = NULL;
+    PyObject *path = PyOS_FSPath(source);   // New reference
+    if (path == NULL) {
+        PyErr_Clear();
+    }
+    else {
+        PyObject *lower = PyObject_CallMethod(path, "lower", NULL);
+        if (lower == NULL) {
+            Py_DECREF(path);
+            return NULL;
+        }
+        const char *extensions[2] = {".json", ".csv"};
+        for (int i = 0; i < 2 && format == NULL; i++) {
+            PyObject *extension = PyBytes_Check(lower) ? PyBytes_FromString(extensions[i])
+                                                       : PyUnicode_FromString(extensions[i]);
+            if (extension == NULL) {
+                Py_DECREF(lower); Py_DECREF(path);
+                return NULL;
+            }
+            PyObject *matches = PyObject_CallMethod(lower, "endswith", "O", extension);
+            Py_DECREF(extension);
+            if (matches == NULL) {
+                Py_DECREF(lower); Py_DECREF(path);
+                return NULL;
+            }
+            if (matches == Py_True)
+                format = extensions[i] + 1;
+            Py_DECREF(matches);
+        }
+        Py_DECREF(lower);
+        Py_DECREF(path);
+    }
+
+    if (format == NULL) {
+        PyErr_SetString(PyExc_ValueError, "the format cannot be inferred, format must be 'json' or 'csv'");
+    }
+    return format;
+}
+
+int
+QBAFLoader_Load(PyObject *source, const char *format, QBAFLoaderTarget *target)
+{
+    QBAFReader reader = {NULL, NULL, NULL, 0, 0, 1, 1, 0, 0};
+    PyObject *file = NULL;
+    int result = -1;
+
+    if (format == NULL) {
+        format = QBAFLoader_format(source);
+        if (format == NULL) {
+            return -1;
+        }
+    }
+    int json = strcmp(format, "json") == 0;
+    if (!json && strcmp(format, "csv") != 0) {
+        PyErr_SetString(PyExc_ValueError, "format must be 'json' or 'csv'");
+        return -1;
+    }
+
+    reader.read = PyObject_GetAttrString(source, "read");
+    if (reader.read == NULL) {  // A path
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+            return -1;
+        }
+        PyErr_Clear();
+        PyObject *io = PyImport_ImportModule("io");
+        if (io == NULL) {
+            return -1;
+        }
+        file = PyObject_CallMethod(io, "open", "Os", source, "rb");
+        Py_DECREF(io);
+        if (file == NULL) {
+            return -1;
+        }
+        reader.read = PyObject_GetAttrString(file, "read");
+        if (reader.read == NULL) {
+            goto end;
+        }
+    }
+
+    result = json ? QBAFLoader_json(&reader, target) : QBAFLoader_csv(&reader, target);
+
+end:
+    Py_XDECREF(reader.read);
+    Py_XDECREF(reader.chunk);
+    if (file != NULL) {
+        PyObject *type, *value, *traceback;
+        PyErr_Fetch(&type, &value, &traceback);
+        PyObject *closed = PyObject_CallMethod(file, "close", NULL);
+        if (closed == NULL) {
+            if (type == NULL) {
+                result = -1;
+            } else {
+                PyErr_Clear();
+            }
+        }
+        Py_XDECREF(closed);
+        if (type != NULL)
+            PyErr_Restore(type, value, traceback);
+        Py_DECREF(file);
+    }
+    return result;
+}
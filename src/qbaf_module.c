@@ -8,6 +8,18 @@
 #include <Python.h>
 
 #include "qbaf_module.h"
+#include "argument.h"
+
+/**
+ * @brief Free the memory that the module keeps for reuse when it is deallocated.
+ * 
+ * @param module the module QBAF
+ */
+static void
+QBAFmodule_free(void *module)
+{
+    QBAFArgument_ClearFreeList();
+}
 
 /**
  * @brief Definition of the module QBAF
@@ -18,6 +30,7 @@ static PyModuleDef QBAFmodule = {
     .m_name = "qbaf",
     .m_doc = "Module that creates a QBAFArgument type.",
     .m_size = -1,
+    .m_free = QBAFmodule_free,
 };
 
 /**
@@ -46,6 +59,15 @@ PyInit_qbaf(void)
     if (PyType_Ready(QBAFrameworkType) < 0)
         return NULL;
 
+    if (PyType_Ready(get_QBAFANeighboursIteratorType()) < 0)
+        return NULL;
+
+    if (PyType_Ready(get_QBAFExplanationIteratorType()) < 0)
+        return NULL;
+
+    if (PyType_Ready(get_QBAFStrengthsType()) < 0)
+        return NULL;
+
     PyObject *m = PyModule_Create(&QBAFmodule);
     if (m == NULL)
         return NULL;
@@ -0,0 +1,341 @@
+/**
+ * @file qbaf_order.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the online topological order of an acyclic QBAFramework (qbaf_order.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "qbaf_order.h"
+
+/**
+ * @brief Struct that defines an argument visited by a search: its id and its rank.
+ *
+ */
+typedef struct {
+    Py_ssize_t rank;    /* rank of the argument */
+    Py_ssize_t id;      /* id of the argument */
+} QBAFOrderItem;
+
+/**
+ * @brief Growable array of QBAFOrderItem.
+ *
+ */
+typedef struct {
+    QBAFOrderItem *items;       /* the items */
+    Py_ssize_t     size;        /* number of items */
+    Py_ssize_t     capacity;    /* number of allocated items */
+} QBAFOrderItems;
+
+/**
+ * @brief Make sure that the QBAFOrder order has a rank for every id lower than capacity.
+ * The new ranks are -1 (not ordered).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ *
+ * @param order a QBAFOrder
+ * @param capacity the required number of ranks
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFOrder_reserve(QBAFOrder *order, Py_ssize_t capacity)
+{
+    if (capacity <= order->capacity)
+        return 0;
+
+    Py_ssize_t new_capacity = order->capacity < 8 ? 8 : order->capacity;
+    while (new_capacity < capacity)
+        new_capacity *= 2;
+
+    Py_ssize_t *ranks = PyMem_Realloc(order->ranks, new_capacity * sizeof(Py_ssize_t));
+    if (ranks == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    order->ranks = ranks;
+    char *marks = PyMem_Realloc(order->marks, new_capacity * sizeof(char));
+    if (marks == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    order->marks = marks;
+
+    for (Py_ssize_t id = order->capacity; id < new_capacity; id++) {
+        order->ranks[id] = -1;
+        order->marks[id] = 0;
+    }
+    order->capacity = new_capacity;
+    return 0;
+}
+
+QBAFOrder *
+QBAFOrder_New(QBAFGraph *graph, QBAFARelationsObject *relations)
+{
+    QBAFOrder *order = PyMem_Calloc(1, sizeof(QBAFOrder));
+    if (order == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    for (Py_ssize_t position = 0; position < graph->ordered; position++) {
+        Py_ssize_t id = QBAFARelations_Intern(relations, PyList_GET_ITEM(graph->arguments, graph->order[position]));
+        if (id < 0 || QBAFOrder_reserve(order, id + 1) < 0) {
+            QBAFOrder_Free(order);
+            return NULL;
+        }
+        order->ranks[id] = position;
+    }
+    order->next = graph->ordered;
+
+    return order;
+}
+
+QBAFOrder *
+QBAFOrder_Copy(QBAFOrder *order)
+{
+    QBAFOrder *copy = PyMem_Calloc(1, sizeof(QBAFOrder));
+    if (copy == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    if (QBAFOrder_reserve(copy, order->capacity) < 0) {
+        QBAFOrder_Free(copy);
+        return NULL;
+    }
+    if (order->capacity > 0) {
+        memcpy(copy->ranks, order->ranks, order->capacity * sizeof(Py_ssize_t));
+    }
+    copy->next = order->next;
+
+    return copy;
+}
+
+void
+QBAFOrder_Free(QBAFOrder *order)
+{
+    if (order == NULL)
+        return;
+
+    PyMem_Free(order->ranks);
+    PyMem_Free(order->marks);
+    PyMem_Free(order);
+}
+
+int
+QBAFOrder_AddArgument(QBAFOrder *order, QBAFARelationsObject *relations, PyObject *argument)
+{
+    Py_ssize_t id = QBAFARelations_Intern(relations, argument);
+    if (id < 0 || QBAFOrder_reserve(order, id + 1) < 0) {
+        return -1;
+    }
+    order->ranks[id] = order->next;
+    order->next++;
+
+    return 0;
+}
+
+int
+QBAFOrder_RemoveArgument(QBAFOrder *order, QBAFARelationsObject *relations, PyObject *argument)
+{
+    Py_ssize_t id = QBAFARelations_IdOf(relations, argument);
+    if (id < -1) {
+        return -1;
+    }
+    if (id >= 0 && id < order->capacity) {
+        order->ranks[id] = -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Return the id of the argument in relations if it is ranked in the QBAFOrder order,
+ * -1 (with the corresponding exception) if it is not or an error has occurred.
+ *
+ * @param order a QBAFOrder
+ * @param relations the relations of the framework
+ * @param argument a QBAFArgument
+ * @return Py_ssize_t the id, -1 if an error occurred
+ */
+static Py_ssize_t
+QBAFOrder_id(QBAFOrder *order, QBAFARelationsObject *relations, PyObject *argument)
+{
+    Py_ssize_t id = QBAFARelations_IdOf(relations, argument);
+    if (id < -1) {
+        return -1;
+    }
+    if (id == -1 || id >= order->capacity || order->ranks[id] < 0) {
+        PyErr_SetObject(PyExc_KeyError, argument);
+        return -1;
+    }
+    return id;
+}
+
+/**
+ * @brief Append the argument with id id to the QBAFOrderItems items and mark it as visited in the QBAFOrder order.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ *
+ * @param order a QBAFOrder
+ * @param items a QBAFOrderItems
+ * @param id the id of a ranked argument
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFOrder_visit(QBAFOrder *order, QBAFOrderItems *items, Py_ssize_t id)
+{
+    if (items->size == items->capacity) {
+        Py_ssize_t capacity = items->capacity < 16 ? 16 : 2 * items->capacity;
+        QBAFOrderItem *new_items = PyMem_Realloc(items->items, capacity * sizeof(QBAFOrderItem));
+        if (new_items == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        items->items = new_items;
+        items->capacity = capacity;
+    }
+    items->items[items->size].rank = order->ranks[id];
+    items->items[items->size].id = id;
+    items->size++;
+    order->marks[id] = 1;
+    return 0;
+}
+
+/**
+ * @brief Visit the arguments reachable from start through the relations (forward: from the agents
+ * to the patients, backward: from the patients to the agents) whose rank is in the open interval (lower, upper),
+ * and append them to visited (start included). The visited arguments are unmarked before returning.
+ * Return 1 if an argument with rank upper is reached, 0 if not, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param order a QBAFOrder
+ * @param relations an array with the Attack and the Support relations
+ * @param forward 1 if the relations are followed from the agents to the patients, 0 if backwards
+ * @param start the id of the argument where the search starts
+ * @param lower the lower bound of the ranks (exclusive)
+ * @param upper the upper bound of the ranks (exclusive), the rank that closes a cycle
+ * @param visited an empty QBAFOrderItems where the visited arguments are appended
+ * @return int 1 if the rank upper is reached, 0 if not, -1 if an error occurred
+ */
+static int
+QBAFOrder_search(QBAFOrder *order, QBAFARelationsObject *relations[2], int forward, Py_ssize_t start,
+                 Py_ssize_t lower, Py_ssize_t upper, QBAFOrderItems *visited)
+{
+    int reached = 0;
+    if (QBAFOrder_visit(order, visited, start) < 0) {
+        reached = -1;
+    }
+
+    // The visited arguments are also the queue of arguments whose neighbours must be visited
+    for (Py_ssize_t next = 0; reached == 0 && next < visited->size; next++) {
+        Py_ssize_t id = visited->items[next].id;
+        for (int relation = 0; reached == 0 && relation < 2; relation++) {
+            const QBAFIdVector *vector = forward ? QBAFARelations_PatientIds(relations[relation], id)
+                                                 : QBAFARelations_AgentIds(relations[relation], id);
+            for (int32_t position = 0; position < vector->size; position++) {
+                int32_t neighbour = vector->ids[position];
+                Py_ssize_t rank = neighbour < order->capacity ? order->ranks[neighbour] : -1;
+                if (rank == upper) {
+                    reached = 1;
+                    break;
+                }
+                if (lower < rank && rank < upper && !order->marks[neighbour]) {
+                    if (QBAFOrder_visit(order, visited, neighbour) < 0) {
+                        reached = -1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    for (Py_ssize_t i = 0; i < visited->size; i++) {
+        order->marks[visited->items[i].id] = 0;
+    }
+    return reached;
+}
+
+/**
+ * @brief Compare two QBAFOrderItem by rank (for qsort).
+ */
+static int
+QBAFOrder_compare_items(const void *a, const void *b)
+{
+    Py_ssize_t x = ((const QBAFOrderItem *)a)->rank, y = ((const QBAFOrderItem *)b)->rank;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Compare two ranks (for qsort).
+ */
+static int
+QBAFOrder_compare(const void *a, const void *b)
+{
+    Py_ssize_t x = *(const Py_ssize_t *)a, y = *(const Py_ssize_t *)b;
+    return (x > y) - (x < y);
+}
+
+int
+QBAFOrder_AddRelation(QBAFOrder *order, QBAFARelationsObject *attack_relations,
+                      QBAFARelationsObject *support_relations, PyObject *agent, PyObject *patient)
+{
+    Py_ssize_t agent_id = QBAFOrder_id(order, attack_relations, agent);
+    if (agent_id < 0) {
+        return -1;
+    }
+    Py_ssize_t patient_id = QBAFOrder_id(order, attack_relations, patient);
+    if (patient_id < 0) {
+        return -1;
+    }
+    Py_ssize_t upper = order->ranks[agent_id], lower = order->ranks[patient_id];
+    if (upper == lower) {   // A relation of an argument with itself
+        return 0;
+    }
+    if (upper < lower) {    // The order is still topological
+        return 1;
+    }
+
+    int result = -1;
+    Py_ssize_t *ranks = NULL;
+    QBAFOrderItems forward = {NULL, 0, 0}, backward = {NULL, 0, 0};
+
+    // Arguments that depend on patient and must be moved after agent (a cycle if it reaches agent)
+    QBAFARelationsObject *relations[2] = {attack_relations, support_relations};
+    int reached = QBAFOrder_search(order, relations, 1, patient_id, lower - 1, upper, &forward);
+    if (reached != 0) {
+        result = reached < 0 ? -1 : 0;
+        goto end;
+    }
+
+    // Arguments on which agent depends and must be moved before patient
+    if (QBAFOrder_search(order, relations, 0, agent_id, lower, upper + 1, &backward) < 0) {
+        goto end;
+    }
+
+    // Both groups keep their relative order, and they reuse their ranks: first backward, then forward
+    qsort(forward.items, forward.size, sizeof(QBAFOrderItem), QBAFOrder_compare_items);
+    qsort(backward.items, backward.size, sizeof(QBAFOrderItem), QBAFOrder_compare_items);
+    Py_ssize_t total = backward.size + forward.size;
+    ranks = PyMem_Malloc(total * sizeof(Py_ssize_t));
+    if (ranks == NULL) {
+        PyErr_NoMemory();
+        goto end;
+    }
+    for (Py_ssize_t i = 0; i < total; i++) {
+        ranks[i] = i < backward.size ? backward.items[i].rank : forward.items[i - backward.size].rank;
+    }
+    qsort(ranks, total, sizeof(Py_ssize_t), QBAFOrder_compare);
+
+    for (Py_ssize_t i = 0; i < total; i++) {
+        Py_ssize_t id = i < backward.size ? backward.items[i].id : forward.items[i - backward.size].id;
+        order->ranks[id] = ranks[i];
+    }
+    result = 1;
+
+end:
+    PyMem_Free(ranks);
+    PyMem_Free(forward.items);
+    PyMem_Free(backward.items);
+    return result;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file qbaf_overlay.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the evaluation of reversals without building them (qbaf_overlay.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string.h>
+
+#include "qbaf_overlay.h"
+
+/**
+ * @brief Allocate the arrays of the reversals of the QBAFOverlay overlay, whose graphs and indices are already set.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ */
+static int
+QBAFOverlay_allocate(QBAFOverlay *overlay)
+{
+    QBAFGraph *self = overlay->self, *other = overlay->other;
+    Py_ssize_t size = overlay->size;
+    Py_ssize_t attacks = self->attackers_offsets[self->size] + other->attackers_offsets[other->size];
+    Py_ssize_t supports = self->supporters_offsets[self->size] + other->supporters_offsets[other->size];
+    overlay->from_other = PyMem_Malloc(size + 1);
+    overlay->present = PyMem_Malloc(size + 1);
+    overlay->state = PyMem_Malloc(size + 1);
+    overlay->initial_strengths = PyMem_Malloc(size * sizeof(double) + 1);
+    overlay->final_strengths = PyMem_Malloc(size * sizeof(double) + 1);
+    overlay->order = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    overlay->cursor = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    overlay->stack = PyMem_Malloc(size * sizeof(Py_ssize_t) + 1);
+    overlay->view.size = size;
+    overlay->view.attackers_offsets = PyMem_Calloc(size + 1, sizeof(Py_ssize_t));
+    overlay->view.attackers = PyMem_Malloc(attacks * sizeof(Py_ssize_t) + 1);
+    overlay->view.supporters_offsets = PyMem_Calloc(size + 1, sizeof(Py_ssize_t));
+    overlay->view.supporters = PyMem_Malloc(supports * sizeof(Py_ssize_t) + 1);
+    overlay->view.max_agents = self->max_agents + other->max_agents;
+    overlay->view.buffer = PyMem_Malloc(overlay->view.max_agents * sizeof(double) + 1);
+    if (overlay->from_other == NULL || overlay->present == NULL || overlay->state == NULL ||
+        overlay->initial_strengths == NULL || overlay->final_strengths == NULL ||
+        overlay->order == NULL || overlay->cursor == NULL || overlay->stack == NULL ||
+        overlay->view.attackers_offsets == NULL || overlay->view.attackers == NULL ||
+        overlay->view.supporters_offsets == NULL || overlay->view.supporters == NULL || overlay->view.buffer == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(overlay->present, 0, size);
+
+    return 0;
+}
+
+QBAFOverlay *
+QBAFOverlay_New(QBAFGraph *self, QBAFGraph *other)
+{
+    QBAFOverlay *overlay = PyMem_Calloc(1, sizeof(QBAFOverlay));
+    if (overlay == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    overlay->self = QBAFGraph_Copy(self);
+    overlay->other = QBAFGraph_Copy(other);
+    if (overlay->self == NULL || overlay->other == NULL) {
+        QBAFOverlay_Free(overlay);
+        return NULL;
+    }
+    self = overlay->self;
+    other = overlay->other;
+
+    // Index the union of the arguments: those of self first, then those only in other
+    Py_ssize_t capacity = self->size + other->size;
+    overlay->other_of = PyMem_Malloc(capacity * sizeof(Py_ssize_t) + 1);
+    overlay->other_indices = PyMem_Malloc(other->size * sizeof(Py_ssize_t) + 1);
+    if (overlay->other_of == NULL || overlay->other_indices == NULL) {
+        QBAFOverlay_Free(overlay);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    for (Py_ssize_t index = 0; index < self->size; index++) {
+        Py_ssize_t other_index = QBAFGraph_IndexOf(other, PyList_GET_ITEM(self->arguments, index));
+        if (other_index < -1) {
+            QBAFOverlay_Free(overlay);
+            return NULL;
+        }
+        overlay->other_of[index] = other_index;
+    }
+    overlay->size = self->size;
+    for (Py_ssize_t other_index = 0; other_index < other->size; other_index++) {
+        Py_ssize_t index = QBAFGraph_IndexOf(self, PyList_GET_ITEM(other->arguments, other_index));
+        if (index < -1) {
+            QBAFOverlay_Free(overlay);
+            return NULL;
+        }
+        if (index == -1) {
+            index = overlay->size++;
+            overlay->other_of[index] = other_index;
+        }
+        overlay->other_indices[other_index] = index;
+    }
+
+    if (QBAFOverlay_allocate(overlay) < 0) {
+        QBAFOverlay_Free(overlay);
+        return NULL;
+    }
+
+    return overlay;
+}
+
+QBAFOverlay *
+QBAFOverlay_Fork(QBAFOverlay *overlay)
+{
+    QBAFOverlay *fork = PyMem_Calloc(1, sizeof(QBAFOverlay));
+    if (fork == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    fork->base = overlay->base != NULL ? overlay->base : overlay;
+    fork->size = overlay->size;
+    fork->self = overlay->self;
+    fork->other = overlay->other;
+    fork->other_of = overlay->other_of;
+    fork->other_indices = overlay->other_indices;
+    if (QBAFOverlay_allocate(fork) < 0) {
+        QBAFOverlay_Free(fork);
+        return NULL;
+    }
+
+    return fork;
+}
+
+void
+QBAFOverlay_Free(QBAFOverlay *overlay)
+{
+    if (overlay == NULL)
+        return;
+
+    if (overlay->base == NULL) {
+        QBAFGraph_Free(overlay->self);
+        QBAFGraph_Free(overlay->other);
+        PyMem_Free(overlay->other_of);
+        PyMem_Free(overlay->other_indices);
+    }
+    PyMem_Free(overlay->from_other);
+    PyMem_Free(overlay->present);
+    PyMem_Free(overlay->state);
+    PyMem_Free(overlay->initial_strengths);
+    PyMem_Free(overlay->final_strengths);
+    PyMem_Free(overlay->order);
+    PyMem_Free(overlay->cursor);
+    PyMem_Free(overlay->stack);
+    PyMem_Free(overlay->view.attackers_offsets);
+    PyMem_Free(overlay->view.attackers);
+    PyMem_Free(overlay->view.supporters_offsets);
+    PyMem_Free(overlay->view.supporters);
+    PyMem_Free(overlay->view.buffer);
+    PyMem_Free(overlay);
+}
+
+Py_ssize_t
+QBAFOverlay_IndexOf(QBAFOverlay *overlay, PyObject *argument)
+{
+    Py_ssize_t index = QBAFGraph_IndexOf(overlay->self, argument);
+    if (index != -1) {
+        return index;
+    }
+    index = QBAFGraph_IndexOf(overlay->other, argument);
+    if (index < 0) {
+        return index;
+    }
+    return overlay->other_indices[index];
+}
+
+/**
+ * @brief Store in agents the agents of the argument with index index in the selected reversal,
+ * given the agents of the argument in self and in other (CSR arrays), and return the next free position of agents.
+ * The agents that remain from self keep their order and the agents taken from other follow them,
+ * like the relations of a reversal built by QBAFramework.reversal.
+ */
+static Py_ssize_t
+QBAFOverlay_agents(QBAFOverlay *overlay, Py_ssize_t index, Py_ssize_t *agents, Py_ssize_t position,
+                   const Py_ssize_t *self_offsets, const Py_ssize_t *self_agents,
+                   const Py_ssize_t *other_offsets, const Py_ssize_t *other_agents)
+{
+    Py_ssize_t other_index = overlay->other_of[index];
+
+    // The relations of self, except those of arguments taken from other towards arguments of other
+    if (index < overlay->self->size) {
+        for (Py_ssize_t i = self_offsets[index]; i < self_offsets[index + 1]; i++) {
+            Py_ssize_t agent = self_agents[i];
+            if (overlay->present[agent] && (!overlay->from_other[agent] || other_index < 0))
+                agents[position++] = agent;
+        }
+    }
+
+    // The relations of other from the arguments taken from other
+    if (other_index >= 0) {
+        for (Py_ssize_t i = other_offsets[other_index]; i < other_offsets[other_index + 1]; i++) {
+            Py_ssize_t agent = overlay->other_indices[other_agents[i]];
+            if (overlay->present[agent] && overlay->from_other[agent])
+                agents[position++] = agent;
+        }
+    }
+
+    return position;
+}
+
+void
+QBAFOverlay_Select(QBAFOverlay *overlay, const Py_ssize_t *members, Py_ssize_t count, int complement)
+{
+    QBAFGraph *self = overlay->self, *other = overlay->other;
+    Py_ssize_t size = overlay->size;
+
+    memset(overlay->from_other, complement ? 1 : 0, size);
+    for (Py_ssize_t i = 0; i < count; i++)
+        overlay->from_other[members[i]] = complement ? 0 : 1;
+
+    // Arguments and initial strengths
+    for (Py_ssize_t index = 0; index < size; index++) {
+        if (overlay->from_other[index]) {
+            Py_ssize_t other_index = overlay->other_of[index];
+            overlay->present[index] = other_index >= 0;
+            if (other_index >= 0)
+                overlay->initial_strengths[index] = other->initial_strengths[other_index];
+        } else {
+            overlay->present[index] = index < self->size;
+            if (index < self->size)
+                overlay->initial_strengths[index] = self->initial_strengths[index];
+        }
+    }
+
+    // Attackers and supporters
+    QBAFGraph *view = &overlay->view;
+    Py_ssize_t attackers = 0, supporters = 0;
+    for (Py_ssize_t index = 0; index < size; index++) {
+        view->attackers_offsets[index] = attackers;
+        view->supporters_offsets[index] = supporters;
+        if (!overlay->present[index])
+            continue;
+        attackers = QBAFOverlay_agents(overlay, index, view->attackers, attackers,
+                                       self->attackers_offsets, self->attackers,
+                                       other->attackers_offsets, other->attackers);
+        supporters = QBAFOverlay_agents(overlay, index, view->supporters, supporters,
+                                        self->supporters_offsets, self->supporters,
+                                        other->supporters_offsets, other->supporters);
+    }
+    view->attackers_offsets[size] = attackers;
+    view->supporters_offsets[size] = supporters;
+}
+
+/**
+ * @brief Return the agent with position position among the attackers and supporters (in this order)
+ * of the argument with index index in the selected reversal.
+ */
+static inline Py_ssize_t
+QBAFOverlay_agent(QBAFGraph *view, Py_ssize_t index, Py_ssize_t position)
+{
+    Py_ssize_t attackers = view->attackers_offsets[index + 1] - view->attackers_offsets[index];
+    if (position < attackers)
+        return view->attackers[view->attackers_offsets[index] + position];
+    return view->supporters[view->supporters_offsets[index] + position - attackers];
+}
+
+int
+QBAFOverlay_Schedule(QBAFOverlay *overlay, const Py_ssize_t *roots, Py_ssize_t count)
+{
+    QBAFGraph *view = &overlay->view;
+    Py_ssize_t size = overlay->size;
+
+    memset(overlay->state, 0, size);
+    overlay->ordered = 0;
+
+    // Depth-first search through the agents: first from the roots (recording the post-order),
+    // then from the remaining arguments only to find cycles
+    for (Py_ssize_t start = 0; start < count + size; start++) {
+        Py_ssize_t argument = start < count ? roots[start] : start - count;
+        int record = start < count;
+        if (overlay->state[argument] || !overlay->present[argument])
+            continue;
+
+        Py_ssize_t top = 0;
+        overlay->stack[top++] = argument;
+        overlay->state[argument] = 1;
+        overlay->cursor[argument] = 0;
+
+        while (top > 0) {
+            Py_ssize_t index = overlay->stack[top - 1];
+            Py_ssize_t agents = (view->attackers_offsets[index + 1] - view->attackers_offsets[index]) +
+                                (view->supporters_offsets[index + 1] - view->supporters_offsets[index]);
+
+            if (overlay->cursor[index] < agents) {
+                Py_ssize_t agent = QBAFOverlay_agent(view, index, overlay->cursor[index]++);
+                if (overlay->state[agent] == 1)     // A cycle
+                    return 0;
+                if (overlay->state[agent] == 0) {
+                    overlay->stack[top++] = agent;
+                    overlay->state[agent] = 1;
+                    overlay->cursor[agent] = 0;
+                }
+                continue;
+            }
+
+            top--;
+            overlay->state[index] = 2;
+            if (record)
+                overlay->order[overlay->ordered++] = index;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,680 @@
+/**
+ * @file qbaf_parallel.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the native (and parallel) evaluation of a QBAFGraph (qbaf_parallel.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "qbaf_parallel.h"
+#include "qbaf_functions.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <stdatomic.h>
+#define QBAF_THREADS
+#endif
+
+#define max(a,b) (((a)>(b))?(a):(b))
+
+/* Number of arguments of a level that a thread claims each time */
+#define CHUNK_SIZE 64
+
+/* Maximum number of bytes of the final strengths of a block of rows of a batch (per thread) */
+#define BLOCK_MEMORY (1 << 22)
+
+/**
+ * @brief Calculate the final strengths of the arguments order[start:end] of the QBAFGraph graph,
+ * which must belong to the same level and be at least 1 and at most CHUNK_SIZE.
+ * The aggregations are gathered first, so the influence function is applied to the whole range
+ * at once with its batched (SIMD) version if there is one.
+ *
+ * @param graph a QBAFGraph
+ * @param aggregation an aggregation function over arrays
+ * @param influence an influence function
+ * @param batch the batched version of influence, NULL if there is none
+ * @param buffer a scratch array of size graph->max_agents
+ * @param start first position (included)
+ * @param end last position (excluded)
+ */
+static inline void
+QBAFParallel_evaluate_range(QBAFGraph *graph, QBAFArrayAggregation aggregation,
+                            double (*influence)(double, double), QBAFBatchInfluence batch,
+                            double *buffer, Py_ssize_t start, Py_ssize_t end)
+{
+    double w[CHUNK_SIZE], s[CHUNK_SIZE], result[CHUNK_SIZE];
+    Py_ssize_t size = end - start, k = 0;
+
+    // The range is never empty, so every element passed to batch is initialized
+    do {
+        Py_ssize_t index = graph->order[start + k];
+        w[k] = graph->initial_strengths[index];
+        s[k] = QBAFGraph_Aggregate(graph, index, graph->final_strengths, aggregation, buffer);
+    } while (++k < size);
+
+    if (batch != NULL) {
+        batch(w, s, result, size);
+    }
+    else {
+        for (Py_ssize_t k = 0; k < size; k++)
+            result[k] = influence(w[k], s[k]);
+    }
+
+    for (Py_ssize_t k = 0; k < size; k++)
+        graph->final_strengths[graph->order[start + k]] = result[k];
+}
+
+/**
+ * @brief Calculate the final strengths of a block of rows rows of a batch of initial strengths.
+ * The final strengths of the block are stored column by column in columns (the rows strengths
+ * of an argument are contiguous), so the influence function is applied to all of them at once.
+ *
+ * @param graph an acyclic QBAFGraph
+ * @param aggregation an aggregation function over arrays
+ * @param influence an influence function
+ * @param batch the batched version of influence, NULL if there is none
+ * @param initial_strengths the initial strengths of the block (rows x graph->size, row-major)
+ * @param final_strengths where the final strengths of the block are stored (rows x graph->size, row-major)
+ * @param rows the number of rows of the block (at most CHUNK_SIZE)
+ * @param columns a scratch array of size graph->size * rows
+ * @param buffer a scratch array of size graph->max_agents
+ */
+static inline void
+QBAFParallel_evaluate_block(QBAFGraph *graph, QBAFArrayAggregation aggregation,
+                            double (*influence)(double, double), QBAFBatchInfluence batch,
+                            const double *initial_strengths, double *final_strengths, Py_ssize_t rows,
+                            double *columns, double *buffer)
+{
+    Py_ssize_t size = graph->size;
+    double w[CHUNK_SIZE], s[CHUNK_SIZE];
+
+    for (Py_ssize_t position = 0; position < graph->ordered; position++) {
+        Py_ssize_t index = graph->order[position];
+        double *result = columns + index * rows;
+
+        for (Py_ssize_t row = 0; row < rows; row++) {
+            w[row] = initial_strengths[row * size + index];
+            s[row] = QBAFGraph_AggregateStrided(graph, index, columns + row, rows, aggregation, buffer);
+        }
+
+        if (batch != NULL) {
+            batch(w, s, result, rows);
+        }
+        else {
+            for (Py_ssize_t row = 0; row < rows; row++)
+                result[row] = influence(w[row], s[row]);
+        }
+    }
+
+    for (Py_ssize_t row = 0; row < rows; row++) {
+        for (Py_ssize_t index = 0; index < size; index++)
+            final_strengths[row * size + index] = columns[index * rows + row];
+    }
+}
+
+#ifdef QBAF_THREADS
+
+/**
+ * @brief Struct that defines a reusable barrier (pthread_barrier_t is not available in every platform).
+ *
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  condition;
+    int             threads;        /* number of threads that must wait */
+    int             waiting;        /* number of threads waiting */
+    unsigned long   generation;     /* number of times the barrier has been opened */
+} QBAFBarrier;
+
+/**
+ * @brief Block the calling thread until all the threads of the barrier have called this function.
+ *
+ * @param barrier a QBAFBarrier
+ */
+static void
+QBAFBarrier_wait(QBAFBarrier *barrier)
+{
+    pthread_mutex_lock(&barrier->mutex);
+    unsigned long generation = barrier->generation;
+    if (++barrier->waiting == barrier->threads) {
+        barrier->waiting = 0;
+        barrier->generation++;
+        pthread_cond_broadcast(&barrier->condition);
+    }
+    else {
+        while (generation == barrier->generation)
+            pthread_cond_wait(&barrier->condition, &barrier->mutex);
+    }
+    pthread_mutex_unlock(&barrier->mutex);
+}
+
+/**
+ * @brief Struct that defines the state shared by the threads that evaluate a QBAFGraph.
+ *
+ */
+typedef struct {
+    QBAFGraph              *graph;
+    QBAFArrayAggregation    aggregation;
+    double                (*influence)(double, double);
+    QBAFBatchInfluence      batch;      /* batched version of influence, NULL if there is none */
+    atomic_size_t          *cursors;    /* next position of order to be claimed in every level */
+    QBAFBarrier             barrier;    /* threads wait for each other at the end of every level */
+} QBAFParallelTask;
+
+/**
+ * @brief Struct that defines the arguments of every thread that evaluates a QBAFGraph.
+ *
+ */
+typedef struct {
+    QBAFParallelTask *task;
+    double           *buffer;       /* scratch array of the thread (size graph->max_agents) */
+} QBAFParallelWorker;
+
+/**
+ * @brief Evaluate the levels of the graph of a QBAFParallelTask, claiming chunks of every level
+ * until it is exhausted and waiting for the other threads before the next level.
+ *
+ * @param arg a QBAFParallelWorker
+ * @return void* NULL
+ */
+static void *
+QBAFParallel_worker(void *arg)
+{
+    QBAFParallelTask *task = ((QBAFParallelWorker *) arg)->task;
+    double *buffer = ((QBAFParallelWorker *) arg)->buffer;
+    QBAFGraph *graph = task->graph;
+
+    for (Py_ssize_t level = 0; level < graph->levels; level++) {
+        Py_ssize_t end = graph->level_offsets[level + 1];
+        Py_ssize_t start;
+        while ((start = (Py_ssize_t) atomic_fetch_add(&task->cursors[level], CHUNK_SIZE)) < end) {
+            QBAFParallel_evaluate_range(graph, task->aggregation, task->influence, task->batch, buffer,
+                                        start, start + CHUNK_SIZE < end ? start + CHUNK_SIZE : end);
+        }
+        QBAFBarrier_wait(&task->barrier);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Struct that defines the state shared by the threads that evaluate a batch of initial strengths.
+ *
+ */
+typedef struct {
+    QBAFGraph              *graph;
+    QBAFArrayAggregation    aggregation;
+    double                (*influence)(double, double);
+    QBAFBatchInfluence      batch;
+    const double           *initial_strengths;  /* rows x graph->size, row-major */
+    double                 *final_strengths;    /* rows x graph->size, row-major */
+    Py_ssize_t              rows;               /* number of rows of the batch */
+    Py_ssize_t              block;              /* number of rows of every block */
+    atomic_size_t           cursor;             /* first row of the next block to be claimed */
+} QBAFBatchTask;
+
+/**
+ * @brief Struct that defines the arguments of every thread that evaluates a batch of initial strengths.
+ *
+ */
+typedef struct {
+    QBAFBatchTask *task;
+    double        *workspace;   /* scratch array of the thread (size graph->size * block + graph->max_agents) */
+} QBAFBatchWorker;
+
+/**
+ * @brief Evaluate the blocks of rows of a QBAFBatchTask until all of them have been claimed.
+ *
+ * @param arg a QBAFBatchWorker
+ * @return void* NULL
+ */
+static void *
+QBAFParallel_batch_worker(void *arg)
+{
+    QBAFBatchTask *task = ((QBAFBatchWorker *) arg)->task;
+    double *workspace = ((QBAFBatchWorker *) arg)->workspace;
+    Py_ssize_t size = task->graph->size;
+    Py_ssize_t start;
+
+    while ((start = (Py_ssize_t) atomic_fetch_add(&task->cursor, task->block)) < task->rows) {
+        Py_ssize_t rows = start + task->block < task->rows ? task->block : task->rows - start;
+        QBAFParallel_evaluate_block(task->graph, task->aggregation, task->influence, task->batch,
+                                    task->initial_strengths + start * size, task->final_strengths + start * size,
+                                    rows, workspace, workspace + size * task->block);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Struct that defines the state shared by the threads of a QBAFParallel_For loop.
+ *
+ */
+typedef struct {
+    QBAFParallelBody    body;
+    void               *task;       /* argument of body */
+    Py_ssize_t          size;       /* number of items */
+    Py_ssize_t          chunk;      /* number of items claimed each time */
+    atomic_size_t       cursor;     /* first item of the next chunk to be claimed */
+} QBAFForTask;
+
+/**
+ * @brief Process the chunks of items of a QBAFForTask until all of them have been claimed.
+ *
+ * @param task a QBAFForTask
+ * @param thread the number of the thread
+ */
+static void
+QBAFParallel_for_chunks(QBAFForTask *task, int thread)
+{
+    Py_ssize_t start;
+
+    while ((start = (Py_ssize_t) atomic_fetch_add(&task->cursor, task->chunk)) < task->size) {
+        task->body(task->task, thread, start, start + task->chunk < task->size ? start + task->chunk : task->size);
+    }
+}
+
+/**
+ * @brief Struct that defines the arguments of every worker of a QBAFParallelPool.
+ *
+ */
+typedef struct {
+    QBAFParallelPool   *pool;
+    int                 thread;         /* number of the thread */
+} QBAFPoolWorker;
+
+#endif
+
+/**
+ * @brief Struct that defines a pool of threads that run QBAFParallel_For loops (see qbaf_parallel.h).
+ *
+ */
+struct QBAFParallelPool {
+    int                 threads;        /* number of threads (the workers and the thread that runs the loops) */
+#ifdef QBAF_THREADS
+    pthread_t          *workers;        /* threads - 1 workers */
+    QBAFPoolWorker     *arguments;      /* arguments of every worker */
+    pthread_mutex_t     mutex;
+    pthread_cond_t      started;        /* signaled when a loop starts or the pool is stopped */
+    pthread_cond_t      finished;       /* signaled when the last worker finishes a loop */
+    unsigned long       generation;     /* number of loops that have been started */
+    int                 running;        /* number of workers that have not finished the current loop */
+    int                 stopped;        /* 1 if the workers must exit, 0 if not */
+    QBAFForTask         task;           /* the current loop */
+#endif
+};
+
+#ifdef QBAF_THREADS
+
+/**
+ * @brief Wait for the loops of a QBAFParallelPool and process their chunks until the pool is stopped.
+ *
+ * @param arg a QBAFPoolWorker
+ * @return void* NULL
+ */
+static void *
+QBAFParallel_pool_worker(void *arg)
+{
+    QBAFParallelPool *pool = ((QBAFPoolWorker *) arg)->pool;
+    int thread = ((QBAFPoolWorker *) arg)->thread;
+    unsigned long generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stopped && pool->generation == generation)
+            pthread_cond_wait(&pool->started, &pool->mutex);
+        if (pool->stopped)
+            break;
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        QBAFParallel_for_chunks(&pool->task, thread);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->running == 0)
+            pthread_cond_signal(&pool->finished);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+#endif
+
+/**
+ * @brief Calculate the final strengths of an acyclic QBAFGraph level by level with threads threads.
+ * The arguments of every level are distributed dynamically in chunks among the threads,
+ * and the influence function is applied to every chunk with its batched (SIMD) version if there is one.
+ * The GIL is only released if it is evaluated by more than one thread, so the graph must not be modified
+ * or freed concurrently then (see QBAFrameworkObject.busy). If threads cannot be created, it evaluates
+ * the graph with the threads that could be created.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic QBAFGraph (not NULL)
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param influence an influence function of qbaf_functions.h
+ * @param approximate 1 if the batched influence may approximate exp, 0 if not (see batch_influence_function)
+ * @param threads the number of threads (at least 1)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFParallel_Evaluate(QBAFGraph *graph, QBAFArrayAggregation aggregation,
+                      double (*influence)(double, double), int approximate, int threads)
+{
+    QBAFBatchInfluence batch = batch_influence_function(influence, approximate);
+
+#ifdef QBAF_THREADS
+    // There is no point in having more threads than arguments in the widest level
+    Py_ssize_t width = 0;
+    for (Py_ssize_t level = 0; level < graph->levels; level++)
+        width = max(width, graph->level_offsets[level + 1] - graph->level_offsets[level]);
+    if (threads > (width + CHUNK_SIZE - 1) / CHUNK_SIZE)
+        threads = (int) ((width + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    if (threads > 1) {
+        QBAFParallelTask task;
+        task.graph = graph;
+        task.aggregation = aggregation;
+        task.influence = influence;
+        task.batch = batch;
+        task.cursors = PyMem_Malloc(graph->levels * sizeof(atomic_size_t) + 1);
+        pthread_t *workers = PyMem_Malloc((threads - 1) * sizeof(pthread_t));
+        QBAFParallelWorker *arguments = PyMem_Malloc(threads * sizeof(QBAFParallelWorker));
+        double *buffers = PyMem_Malloc(threads * graph->max_agents * sizeof(double) + 1);
+        if (task.cursors == NULL || workers == NULL || arguments == NULL || buffers == NULL) {
+            PyMem_Free(task.cursors);
+            PyMem_Free(workers);
+            PyMem_Free(arguments);
+            PyMem_Free(buffers);
+            PyErr_NoMemory();
+            return -1;
+        }
+        for (Py_ssize_t level = 0; level < graph->levels; level++)
+            atomic_init(&task.cursors[level], (size_t) graph->level_offsets[level]);
+        for (int thread = 0; thread < threads; thread++) {
+            arguments[thread].task = &task;
+            arguments[thread].buffer = buffers + thread * graph->max_agents;
+        }
+
+        int created = 0;
+        Py_BEGIN_ALLOW_THREADS
+        pthread_mutex_init(&task.barrier.mutex, NULL);
+        pthread_cond_init(&task.barrier.condition, NULL);
+        task.barrier.waiting = 0;
+        task.barrier.generation = 0;
+        // The barrier is sized before creating the workers, it is resized if a creation fails
+        task.barrier.threads = threads;
+        for (created = 0; created < threads - 1; created++) {
+            if (pthread_create(&workers[created], NULL, QBAFParallel_worker, &arguments[created + 1]) != 0)
+                break;
+        }
+        if (created < threads - 1) {
+            // At most created workers are waiting, so the barrier cannot be complete yet
+            pthread_mutex_lock(&task.barrier.mutex);
+            task.barrier.threads = created + 1;
+            pthread_mutex_unlock(&task.barrier.mutex);
+        }
+        QBAFParallel_worker(&arguments[0]);   // The current thread also works
+        for (int worker = 0; worker < created; worker++)
+            pthread_join(workers[worker], NULL);
+        pthread_cond_destroy(&task.barrier.condition);
+        pthread_mutex_destroy(&task.barrier.mutex);
+        Py_END_ALLOW_THREADS
+
+        PyMem_Free(task.cursors);
+        PyMem_Free(workers);
+        PyMem_Free(arguments);
+        PyMem_Free(buffers);
+        return 0;
+    }
+#endif
+
+    // The GIL is kept, so no other thread can modify the graph
+    for (Py_ssize_t level = 0; level < graph->levels; level++) {
+        Py_ssize_t end = graph->level_offsets[level + 1];
+        for (Py_ssize_t start = graph->level_offsets[level]; start < end; start += CHUNK_SIZE)
+            QBAFParallel_evaluate_range(graph, aggregation, influence, batch, graph->buffer,
+                                        start, start + CHUNK_SIZE < end ? start + CHUNK_SIZE : end);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Calculate the final strengths of an acyclic QBAFGraph for every row of a batch of initial strengths
+ * (the initial strengths of the graph are ignored). The rows are evaluated in blocks, storing the strengths
+ * of a block column by column, and the blocks are distributed dynamically among threads threads.
+ * The GIL is only released if there is more than one thread, so the graph must not be modified
+ * or freed concurrently then (see QBAFrameworkObject.busy).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param graph an acyclic QBAFGraph (not NULL)
+ * @param aggregation an aggregation function over arrays of qbaf_functions.h
+ * @param influence an influence function of qbaf_functions.h
+ * @param approximate 1 if the batched influence may approximate exp, 0 if not (see batch_influence_function)
+ * @param initial_strengths the initial strengths of every row (rows x graph->size, row-major)
+ * @param final_strengths where the final strengths of every row are stored (rows x graph->size, row-major)
+ * @param rows the number of rows
+ * @param threads the number of threads (at least 1)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFParallel_EvaluateBatch(QBAFGraph *graph, QBAFArrayAggregation aggregation,
+                           double (*influence)(double, double), int approximate,
+                           const double *initial_strengths, double *final_strengths,
+                           Py_ssize_t rows, int threads)
+{
+    QBAFBatchInfluence batch = batch_influence_function(influence, approximate);
+    Py_ssize_t size = graph->size;
+
+    // The final strengths of a block should fit in the cache
+    Py_ssize_t block = BLOCK_MEMORY / (max(size, 1) * (Py_ssize_t) sizeof(double));
+    if (block > CHUNK_SIZE)
+        block = CHUNK_SIZE;
+    if (block > rows)
+        block = rows;
+    if (block < 1)
+        block = 1;
+
+    Py_ssize_t blocks = (rows + block - 1) / block;
+    if (threads > blocks)
+        threads = blocks > 0 ? (int) blocks : 1;
+
+    // The strengths of every row and the workspaces of the threads must fit in a Py_ssize_t of bytes
+    Py_ssize_t workspace_size = size * block + graph->max_agents;
+    if (rows > PY_SSIZE_T_MAX / (Py_ssize_t) sizeof(double) / max(size, 1) ||
+        workspace_size > PY_SSIZE_T_MAX / (Py_ssize_t) sizeof(double) / threads) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    double *workspaces = PyMem_Malloc(threads * workspace_size * sizeof(double) + 1);
+    if (workspaces == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+#ifdef QBAF_THREADS
+    if (threads > 1) {
+        QBAFBatchTask task;
+        task.graph = graph;
+        task.aggregation = aggregation;
+        task.influence = influence;
+        task.batch = batch;
+        task.initial_strengths = initial_strengths;
+        task.final_strengths = final_strengths;
+        task.rows = rows;
+        task.block = block;
+        atomic_init(&task.cursor, 0);
+        pthread_t *workers = PyMem_Malloc((threads - 1) * sizeof(pthread_t));
+        QBAFBatchWorker *arguments = PyMem_Malloc(threads * sizeof(QBAFBatchWorker));
+        if (workers == NULL || arguments == NULL) {
+            PyMem_Free(workers);
+            PyMem_Free(arguments);
+            PyMem_Free(workspaces);
+            PyErr_NoMemory();
+            return -1;
+        }
+        for (int thread = 0; thread < threads; thread++) {
+            arguments[thread].task = &task;
+            arguments[thread].workspace = workspaces + thread * workspace_size;
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        // The blocks are claimed dynamically, so the evaluation is complete even if some creation fails
+        int created;
+        for (created = 0; created < threads - 1; created++) {
+            if (pthread_create(&workers[created], NULL, QBAFParallel_batch_worker, &arguments[created + 1]) != 0)
+                break;
+        }
+        QBAFParallel_batch_worker(&arguments[0]);   // The current thread also works
+        for (int worker = 0; worker < created; worker++)
+            pthread_join(workers[worker], NULL);
+        Py_END_ALLOW_THREADS
+
+        PyMem_Free(workers);
+        PyMem_Free(arguments);
+        PyMem_Free(workspaces);
+        return 0;
+    }
+#endif
+
+    // The GIL is kept, so no other thread can modify the graph
+    for (Py_ssize_t start = 0; start < rows; start += block) {
+        Py_ssize_t block_rows = start + block < rows ? block : rows - start;
+        QBAFParallel_evaluate_block(graph, aggregation, influence, batch,
+                                    initial_strengths + start * size, final_strengths + start * size,
+                                    block_rows, workspaces, workspaces + size * block);
+    }
+
+    PyMem_Free(workspaces);
+    return 0;
+}
+
+/**
+ * @brief Return a new QBAFParallelPool of threads threads: the thread that calls QBAFParallel_For
+ * and threads - 1 workers. If workers cannot be created, the pool has the workers that could be created.
+ * Return NULL (with the corresponding exception) if there is no memory left.
+ *
+ * @param threads the number of threads (at least 1)
+ * @return QBAFParallelPool* a new QBAFParallelPool (free it with QBAFParallelPool_Free), NULL if an error occurred
+ */
+QBAFParallelPool *
+QBAFParallelPool_New(int threads)
+{
+    QBAFParallelPool *pool = PyMem_Calloc(1, sizeof(QBAFParallelPool));
+    if (pool == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    pool->threads = 1;
+
+#ifdef QBAF_THREADS
+    if (threads > 1) {
+        pool->workers = PyMem_Malloc((threads - 1) * sizeof(pthread_t));
+        pool->arguments = PyMem_Malloc((threads - 1) * sizeof(QBAFPoolWorker));
+        if (pool->workers == NULL || pool->arguments == NULL) {
+            PyMem_Free(pool->workers);
+            PyMem_Free(pool->arguments);
+            PyMem_Free(pool);
+            PyErr_NoMemory();
+            return NULL;
+        }
+        pthread_mutex_init(&pool->mutex, NULL);
+        pthread_cond_init(&pool->started, NULL);
+        pthread_cond_init(&pool->finished, NULL);
+
+        // The chunks are claimed dynamically, so the loops are complete even if some creation fails
+        for (int thread = 1; thread < threads; thread++) {
+            pool->arguments[thread - 1].pool = pool;
+            pool->arguments[thread - 1].thread = thread;
+            if (pthread_create(&pool->workers[thread - 1], NULL, QBAFParallel_pool_worker,
+                               &pool->arguments[thread - 1]) != 0)
+                break;
+            pool->threads++;
+        }
+    }
+#endif
+
+    return pool;
+}
+
+/**
+ * @brief Stop the workers of the QBAFParallelPool pool and free its memory. It does nothing if pool is NULL.
+ * It must not be called during a loop of the pool.
+ *
+ * @param pool a QBAFParallelPool
+ */
+void
+QBAFParallelPool_Free(QBAFParallelPool *pool)
+{
+    if (pool == NULL)
+        return;
+
+#ifdef QBAF_THREADS
+    if (pool->workers != NULL) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->stopped = 1;
+        pthread_cond_broadcast(&pool->started);
+        pthread_mutex_unlock(&pool->mutex);
+        for (int worker = 0; worker < pool->threads - 1; worker++)
+            pthread_join(pool->workers[worker], NULL);
+        pthread_cond_destroy(&pool->finished);
+        pthread_cond_destroy(&pool->started);
+        pthread_mutex_destroy(&pool->mutex);
+        PyMem_Free(pool->workers);
+        PyMem_Free(pool->arguments);
+    }
+#endif
+
+    PyMem_Free(pool);
+}
+
+/**
+ * @brief Call body on the items [0, size) of task in chunks of at most chunk items,
+ * which are distributed dynamically among the threads of the QBAFParallelPool pool. The GIL is released during the loop.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ *
+ * @param pool the QBAFParallelPool that runs the loop (one loop at a time)
+ * @param body the function that processes a chunk of items
+ * @param task the argument of body
+ * @param size the number of items
+ * @param chunk the number of items that a thread claims each time (at least 1)
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFParallel_For(QBAFParallelPool *pool, QBAFParallelBody body, void *task, Py_ssize_t size, Py_ssize_t chunk)
+{
+#ifdef QBAF_THREADS
+    if (pool->threads > 1 && size > chunk) {
+        Py_BEGIN_ALLOW_THREADS
+        pthread_mutex_lock(&pool->mutex);
+        pool->task.body = body;
+        pool->task.task = task;
+        pool->task.size = size;
+        pool->task.chunk = chunk;
+        atomic_store(&pool->task.cursor, 0);
+        pool->running = pool->threads - 1;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->started);
+        pthread_mutex_unlock(&pool->mutex);
+
+        QBAFParallel_for_chunks(&pool->task, 0);    // The current thread also works
+
+        pthread_mutex_lock(&pool->mutex);
+        while (pool->running > 0)
+            pthread_cond_wait(&pool->finished, &pool->mutex);
+        pthread_mutex_unlock(&pool->mutex);
+        Py_END_ALLOW_THREADS
+
+        return 0;
+    }
+#endif
+
+    Py_BEGIN_ALLOW_THREADS
+    if (size > 0)
+        body(task, 0, 0, size);
+    Py_END_ALLOW_THREADS
+
+    return 0;
+}
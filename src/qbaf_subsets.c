@@ -0,0 +1,336 @@
+/**
+ * @file qbaf_subsets.c
+ * @author Jose Ruiz Alarcon
+ * @brief Implementation of the lazy enumeration of subsets of candidate arguments (qbaf_subsets.h)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <limits.h>
+#include <string.h>
+
+#include "qbaf_subsets.h"
+
+/**
+ * @brief Append a new node with the given bit and no children to the QBAFSetTrie trie.
+ * Return its index, -1 (with the corresponding exception) if there is no memory left.
+ */
+static Py_ssize_t
+QBAFSetTrie_node(QBAFSetTrie *trie, int bit)
+{
+    if (trie->size == trie->capacity) {
+        Py_ssize_t capacity = trie->capacity < 16 ? 16 : trie->capacity * 2;
+        QBAFSetTrieNode *nodes = PyMem_Realloc(trie->nodes, capacity * sizeof(QBAFSetTrieNode));
+        if (nodes == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        trie->nodes = nodes;
+        trie->capacity = capacity;
+    }
+    QBAFSetTrieNode *node = &trie->nodes[trie->size];
+    node->bit = bit;
+    node->terminal = 0;
+    node->child = -1;
+    node->sibling = -1;
+    return trie->size++;
+}
+
+int
+QBAFSetTrie_Init(QBAFSetTrie *trie, Py_ssize_t words)
+{
+    trie->nodes = NULL;
+    trie->size = trie->capacity = trie->count = 0;
+    trie->words = words;
+    return QBAFSetTrie_node(trie, -1) < 0 ? -1 : 0;   // The root
+}
+
+void
+QBAFSetTrie_Free(QBAFSetTrie *trie)
+{
+    PyMem_Free(trie->nodes);
+    trie->nodes = NULL;
+    trie->size = trie->capacity = trie->count = 0;
+}
+
+int
+QBAFSetTrie_Insert(QBAFSetTrie *trie, const QBAFBitsetWord *set)
+{
+    Py_ssize_t node = 0;
+
+    for (Py_ssize_t word = 0; word < trie->words; word++) {
+        QBAFBitsetWord bits = set[word];
+        for (int bit = (int) (word * QBAF_BITSET_WORD_BITS); bits != 0; bit++, bits >>= 1) {
+            if (!(bits & 1))
+                continue;
+
+            // Find the child with this bit, or the position where it must be linked to keep the order
+            Py_ssize_t previous = -1, child = trie->nodes[node].child;
+            while (child >= 0 && trie->nodes[child].bit < bit) {
+                previous = child;
+                child = trie->nodes[child].sibling;
+            }
+
+            if (child < 0 || trie->nodes[child].bit != bit) {
+                Py_ssize_t new_child = QBAFSetTrie_node(trie, bit);     // trie->nodes may be moved
+                if (new_child < 0) {
+                    return -1;
+                }
+                trie->nodes[new_child].sibling = child;
+                if (previous < 0)
+                    trie->nodes[node].child = new_child;
+                else
+                    trie->nodes[previous].sibling = new_child;
+                child = new_child;
+            }
+
+            node = child;
+        }
+    }
+
+    if (!trie->nodes[node].terminal) {
+        trie->nodes[node].terminal = 1;
+        trie->count++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Return 1 if a path from node of the QBAFSetTrie trie that ends in a stored set is contained in set, 0 if not.
+ * last is the greatest index of set.
+ */
+static int
+QBAFSetTrie_contains_subset_of(const QBAFSetTrie *trie, Py_ssize_t node, const QBAFBitsetWord *set, int last)
+{
+    for (Py_ssize_t child = trie->nodes[node].child; child >= 0; child = trie->nodes[child].sibling) {
+        int bit = trie->nodes[child].bit;
+        if (bit > last)     // The remaining siblings have greater bits than any element of set
+            return 0;
+        if (QBAFBitset_Contains(set, bit)) {
+            if (trie->nodes[child].terminal || QBAFSetTrie_contains_subset_of(trie, child, set, last))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+int
+QBAFSetTrie_ContainsSubsetOf(const QBAFSetTrie *trie, const QBAFBitsetWord *set)
+{
+    if (trie->nodes[0].terminal)    // The empty set is stored
+        return 1;
+
+    Py_ssize_t word = trie->words - 1;
+    while (word >= 0 && set[word] == 0)
+        word--;
+    if (word < 0)
+        return 0;
+    int last = (int) (word * QBAF_BITSET_WORD_BITS);
+    for (QBAFBitsetWord bits = set[word] >> 1; bits != 0; bits >>= 1)
+        last++;
+
+    return QBAFSetTrie_contains_subset_of(trie, 0, set, last);
+}
+
+int
+QBAFSubsets_Init(QBAFSubsets *subsets, Py_ssize_t size, const QBAFBitsetWord *masks, Py_ssize_t count)
+{
+    if (size > INT_MAX) {
+        PyErr_Format(PyExc_OverflowError, "too many candidate arguments (%zd)", size);
+        return -1;
+    }
+    Py_ssize_t words = QBAFBitset_Words(size);
+    subsets->size = (int) size;
+    subsets->cardinality = 0;
+    subsets->depth = -1;
+    subsets->words = words;
+    subsets->masks = masks;
+    subsets->count = count;
+
+    subsets->indices = PyMem_New(int, size > 0 ? size : 1);
+    subsets->prefixes = NULL;   // Allocated as the cardinality grows (QBAFSubsets_advance)
+    subsets->depths = 0;
+    subsets->reach = PyMem_New(QBAFBitsetWord, words);
+    subsets->current = PyMem_Calloc(words, sizeof(QBAFBitsetWord));
+    subsets->accepted.nodes = NULL;
+    if (subsets->indices == NULL || subsets->reach == NULL || subsets->current == NULL) {
+        QBAFSubsets_Free(subsets);
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (QBAFSetTrie_Init(&subsets->accepted, words) < 0) {
+        QBAFSubsets_Free(subsets);
+        return -1;
+    }
+    return 0;
+}
+
+void
+QBAFSubsets_Free(QBAFSubsets *subsets)
+{
+    PyMem_Free(subsets->indices);
+    PyMem_Free(subsets->prefixes);
+    PyMem_Free(subsets->reach);
+    PyMem_Free(subsets->current);
+    subsets->indices = NULL;
+    subsets->prefixes = subsets->reach = subsets->current = NULL;
+    QBAFSetTrie_Free(&subsets->accepted);
+}
+
+/**
+ * @brief Advance the QBAFSubsets subsets to the next subset (see QBAFSubsets_Next),
+ * without advancing to a greater size if same_size is 1.
+ */
+static int
+QBAFSubsets_advance(QBAFSubsets *subsets, int same_size)
+{
+    int size = subsets->size;
+    int cardinality = subsets->cardinality;
+    int depth = subsets->depth;     // Position of indices to advance
+    Py_ssize_t words = subsets->words;
+    QBAFBitsetWord *reach = subsets->reach;
+
+    for (;;) {
+        if (depth < 0) {    // The subsets of this cardinality are exhausted
+            if (cardinality == size || same_size) {
+                subsets->cardinality = cardinality;
+                subsets->depth = -1;
+                memset(subsets->current, 0, words * sizeof(QBAFBitsetWord));
+                return 0;
+            }
+            cardinality++;
+            if (cardinality > subsets->depths) {
+                Py_ssize_t depths = Py_MIN(2 * (Py_ssize_t) cardinality, (Py_ssize_t) size);
+                QBAFBitsetWord *prefixes = PyMem_Resize(subsets->prefixes, QBAFBitsetWord, depths * words);
+                if (prefixes == NULL) {
+                    PyErr_NoMemory();
+                    return -1;
+                }
+                subsets->prefixes = prefixes;
+                subsets->depths = depths;
+            }
+            depth = 0;
+            subsets->indices[0] = -1;
+        }
+
+        // Advance the index at depth, backtrack if it leaves no room for the remaining positions
+        int index = ++subsets->indices[depth];
+        if (index > size - (cardinality - depth)) {
+            depth--;
+            continue;
+        }
+
+        // The prefixes of the lower depths are not changed by the greater ones
+        QBAFBitsetWord *prefix = subsets->prefixes + depth * words;
+        if (depth > 0)
+            memcpy(prefix, prefix - words, words * sizeof(QBAFBitsetWord));
+        else
+            memset(prefix, 0, words * sizeof(QBAFBitsetWord));
+        QBAFBitset_Add(prefix, index);
+
+        // If the prefix and the greater indices miss a mask, so do the subsets with a greater index at depth
+        Py_ssize_t word = index / QBAF_BITSET_WORD_BITS;
+        memcpy(reach, prefix, word * sizeof(QBAFBitsetWord));
+        reach[word] = prefix[word] | ~(((QBAFBitsetWord) 2 << (index % QBAF_BITSET_WORD_BITS)) - 1);
+        for (Py_ssize_t greater = word + 1; greater < words; greater++)
+            reach[greater] = ~(QBAFBitsetWord) 0;
+        if (!QBAFBitset_IntersectsAll(reach, subsets->masks, subsets->count, words)) {
+            depth--;
+            continue;
+        }
+
+        // If the prefix contains an accepted subset, so does every subset that extends it
+        if (QBAFSetTrie_ContainsSubsetOf(&subsets->accepted, prefix))
+            continue;
+
+        if (depth == cardinality - 1) {
+            if (!QBAFBitset_IntersectsAll(prefix, subsets->masks, subsets->count, words))
+                continue;
+            subsets->cardinality = cardinality;
+            subsets->depth = depth;
+            memcpy(subsets->current, prefix, words * sizeof(QBAFBitsetWord));
+            return 1;
+        }
+
+        depth++;
+        subsets->indices[depth] = index;
+    }
+}
+
+int
+QBAFSubsets_Next(QBAFSubsets *subsets)
+{
+    return QBAFSubsets_advance(subsets, 0);
+}
+
+int
+QBAFSubsets_NextOfSize(QBAFSubsets *subsets)
+{
+    return QBAFSubsets_advance(subsets, 1);
+}
+
+int
+QBAFSubsets_Accept(QBAFSubsets *subsets, const QBAFBitsetWord *set)
+{
+    return QBAFSetTrie_Insert(&subsets->accepted, set);
+}
+
+PyObject *
+QBAFBitset_ToSet(const QBAFBitsetWord *set, PyObject *candidates)
+{
+    PyObject *result = PySet_New(NULL);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (Py_ssize_t index = 0; index < PyList_GET_SIZE(candidates); index++) {
+        if (QBAFBitset_Contains(set, index) && PySet_Add(result, PyList_GET_ITEM(candidates, index)) < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+    return result;
+}
+
+int
+QBAFBitset_FromSet(PyObject *set, PyObject *indices, QBAFBitsetWord *result)
+{
+    PyObject *iterator = PyObject_GetIter(set);
+    if (iterator == NULL) {
+        return -1;
+    }
+
+    PyObject *item;
+    while ((item = PyIter_Next(iterator))) {
+        PyObject *index = PyDict_GetItemWithError(indices, item);   // Borrowed reference
+        if (index == NULL) {
+            if (!PyErr_Occurred())
+                PyErr_SetObject(PyExc_KeyError, item);
+            Py_DECREF(item); Py_DECREF(iterator);
+            return -1;
+        }
+        QBAFBitset_Add(result, PyLong_AsSsize_t(index));
+        Py_DECREF(item);
+    }
+    Py_DECREF(iterator);
+
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+PyObject *
+QBAFBitset_Indices(PyObject *candidates)
+{
+    PyObject *indices = PyDict_New();
+    if (indices == NULL) {
+        return NULL;
+    }
+    for (Py_ssize_t index = 0; index < PyList_GET_SIZE(candidates); index++) {
+        PyObject *pyindex = PyLong_FromSsize_t(index);
+        if (pyindex == NULL || PyDict_SetItem(indices, PyList_GET_ITEM(candidates, index), pyindex) < 0) {
+            Py_XDECREF(pyindex);
+            Py_DECREF(indices);
+            return NULL;
+        }
+        Py_DECREF(pyindex);
+    }
+    return indices;
+}
@@ -7,6 +7,7 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include "structmember.h"
+#include <string.h>
 
 #include "relations.h"
 #include "qbaf_utils.h"
@@ -17,12 +18,503 @@
  */
 //typedef struct {
 //    PyObject_HEAD
-//    PyObject *relations;        /* set of tuples (Agent: QBAFArgument, Patient: QBAFArgument) */
-//    PyObject *agent_patients;   /* dictonary of (key, value) = (Agent, set of Patients) */
-//    PyObject *patient_agents;   /* dictonary of (key, value) = (Patient, set of Agents) */
+//    PyObject     *symbols;      /* dictionary of (key, value) = (QBAFArgument, id: PyLong), it may be shared */
+//    PyObject     *arguments;    /* PyList of QBAFArgument, the position of every argument is its id (shared like symbols) */
+//    QBAFIdVector *patients;     /* patients[id] are the patients of the argument id (only if id < capacity) */
+//    QBAFIdVector *agents;       /* agents[id] are the agents of the argument id (only if id < capacity) */
+//    Py_ssize_t    capacity;     /* number of allocated vectors in patients and agents */
+//    uint64_t     *table;        /* open addressing hash set of the relations (agent id << 32 | patient id) */
+//    Py_ssize_t    table_size;   /* number of slots of table (0 or a power of 2) */
+//    Py_ssize_t    size;         /* number of relations */
 //    int modifiable;             /* 1 if this object can be modified through python, 0 otherwise */
 //} QBAFARelationsObject;
 
+#define EMPTY_SLOT UINT64_MAX       /* value of the empty slots of the hash set of relations */
+#define MIN_TABLE_SIZE 8            /* minimum number of slots of the hash set of relations */
+#define MIN_VECTOR_CAPACITY 4       /* minimum number of allocated ids of a QBAFIdVector */
+
+const QBAFIdVector QBAFIdVector_Empty = {NULL, 0, 0};
+
+/**
+ * @brief Make sure that the QBAFIdVector vector can store at least capacity ids.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ * 
+ * @param vector a QBAFIdVector
+ * @param capacity the required capacity
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static inline int
+QBAFIdVector_reserve(QBAFIdVector *vector, Py_ssize_t capacity)
+{
+    if (capacity <= vector->capacity)
+        return 0;
+
+    Py_ssize_t new_capacity = vector->capacity < MIN_VECTOR_CAPACITY ? MIN_VECTOR_CAPACITY : vector->capacity;
+    while (new_capacity < capacity)
+        new_capacity *= 2;
+    if (new_capacity > INT32_MAX)
+        new_capacity = INT32_MAX;
+
+    int32_t *ids = PyMem_Realloc(vector->ids, new_capacity * sizeof(int32_t));
+    if (ids == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    vector->ids = ids;
+    vector->capacity = (int32_t) new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Remove the id from the QBAFIdVector vector (keeping the order of the rest). It does nothing if it is not contained.
+ * 
+ * @param vector a QBAFIdVector
+ * @param id the id of an argument
+ */
+static inline void
+QBAFIdVector_discard(QBAFIdVector *vector, int32_t id)
+{
+    for (int32_t position = 0; position < vector->size; position++) {
+        if (vector->ids[position] == id) {
+            memmove(&vector->ids[position], &vector->ids[position + 1], (vector->size - position - 1) * sizeof(int32_t));
+            vector->size--;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Return the key of the relation (agent, patient) in the hash set of relations.
+ * 
+ * @param agent the id of the agent
+ * @param patient the id of the patient
+ * @return uint64_t the key
+ */
+static inline uint64_t
+QBAFARelations_key(Py_ssize_t agent, Py_ssize_t patient)
+{
+    return ((uint64_t) agent << 32) | (uint64_t) patient;
+}
+
+/**
+ * @brief Return the hash of a key of the hash set of relations (the finalizer of SplitMix64).
+ * 
+ * @param key a key
+ * @return size_t the hash
+ */
+static inline size_t
+QBAFARelations_hash(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return (size_t) key;
+}
+
+/**
+ * @brief Return the slot of the hash set of relations of self that contains the key,
+ * or the empty slot where it would be inserted (linear probing). The hash set must have slots.
+ * 
+ * @param self instance of QBAFARelations
+ * @param key a key
+ * @return Py_ssize_t the slot
+ */
+static inline Py_ssize_t
+QBAFARelations_slot(QBAFARelationsObject *self, uint64_t key)
+{
+    size_t mask = (size_t) self->table_size - 1;
+    size_t slot = QBAFARelations_hash(key) & mask;
+    while (self->table[slot] != EMPTY_SLOT && self->table[slot] != key)
+        slot = (slot + 1) & mask;
+    return (Py_ssize_t) slot;
+}
+
+/**
+ * @brief Return 1 if the hash set of relations of self contains the key, 0 if not.
+ * 
+ * @param self instance of QBAFARelations
+ * @param key a key
+ * @return int 1 if contained, 0 if not contained
+ */
+static inline int
+QBAFARelations_table_contains(QBAFARelationsObject *self, uint64_t key)
+{
+    if (self->table_size == 0)
+        return 0;
+    return self->table[QBAFARelations_slot(self, key)] == key;
+}
+
+/**
+ * @brief Make sure that the hash set of relations of self can contain size keys with a load factor of at most 1/2.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ * 
+ * @param self instance of QBAFARelations
+ * @param size the number of keys
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFARelations_table_reserve(QBAFARelationsObject *self, Py_ssize_t size)
+{
+    if (2 * size <= self->table_size)
+        return 0;
+
+    Py_ssize_t table_size = self->table_size < MIN_TABLE_SIZE ? MIN_TABLE_SIZE : self->table_size;
+    while (table_size < 2 * size)
+        table_size *= 2;
+
+    uint64_t *table = PyMem_Malloc(table_size * sizeof(uint64_t));
+    if (table == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(table, 0xff, table_size * sizeof(uint64_t));     // Every slot is EMPTY_SLOT
+
+    uint64_t *old_table = self->table;
+    Py_ssize_t old_size = self->table_size;
+    self->table = table;
+    self->table_size = table_size;
+    for (Py_ssize_t slot = 0; slot < old_size; slot++) {
+        if (old_table[slot] != EMPTY_SLOT)
+            self->table[QBAFARelations_slot(self, old_table[slot])] = old_table[slot];
+    }
+    PyMem_Free(old_table);
+
+    return 0;
+}
+
+/**
+ * @brief Remove the key from the hash set of relations of self (backward shift deletion).
+ * It does nothing if it is not contained.
+ * 
+ * @param self instance of QBAFARelations
+ * @param key a key
+ */
+static void
+QBAFARelations_table_discard(QBAFARelationsObject *self, uint64_t key)
+{
+    if (self->table_size == 0)
+        return;
+
+    size_t mask = (size_t) self->table_size - 1;
+    size_t hole = (size_t) QBAFARelations_slot(self, key);
+    if (self->table[hole] != key)
+        return;
+
+    // Move back the following keys of the cluster that would not be found after the hole
+    for (size_t slot = (hole + 1) & mask; self->table[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+        size_t home = QBAFARelations_hash(self->table[slot]) & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            self->table[hole] = self->table[slot];
+            hole = slot;
+        }
+    }
+    self->table[hole] = EMPTY_SLOT;
+}
+
+/**
+ * @brief Make sure that self has a vector of patients and a vector of agents for every id lower than capacity.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ * 
+ * @param self instance of QBAFARelations
+ * @param capacity the required number of vectors
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFARelations_reserve(QBAFARelationsObject *self, Py_ssize_t capacity)
+{
+    if (capacity <= self->capacity)
+        return 0;
+
+    Py_ssize_t new_capacity = self->capacity < MIN_VECTOR_CAPACITY ? MIN_VECTOR_CAPACITY : self->capacity;
+    while (new_capacity < capacity)
+        new_capacity *= 2;
+
+    QBAFIdVector *patients = PyMem_Realloc(self->patients, new_capacity * sizeof(QBAFIdVector));
+    if (patients == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    self->patients = patients;
+    memset(&self->patients[self->capacity], 0, (new_capacity - self->capacity) * sizeof(QBAFIdVector));
+
+    QBAFIdVector *agents = PyMem_Realloc(self->agents, new_capacity * sizeof(QBAFIdVector));
+    if (agents == NULL) {
+        PyErr_NoMemory();
+        return -1;      // The new vectors of patients are empty, so they can stay
+    }
+    self->agents = agents;
+    memset(&self->agents[self->capacity], 0, (new_capacity - self->capacity) * sizeof(QBAFIdVector));
+
+    self->capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * @brief Reserve memory in self for the vectors of the ids lower than arguments and for a total of relations relations.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ * 
+ * @param self instance of QBAFARelations
+ * @param arguments the number of ids
+ * @param relations the number of relations
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFARelations_Reserve(QBAFARelationsObject *self, Py_ssize_t arguments, Py_ssize_t relations)
+{
+    if (QBAFARelations_reserve(self, arguments) < 0 ||
+        QBAFARelations_table_reserve(self, relations) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Free the vectors and the hash set of relations of self, so that it has no relations.
+ * 
+ * @param self instance of QBAFARelations
+ */
+static void
+QBAFARelations_free_relations(QBAFARelationsObject *self)
+{
+    for (Py_ssize_t id = 0; id < self->capacity; id++) {
+        PyMem_Free(self->patients[id].ids);
+        PyMem_Free(self->agents[id].ids);
+    }
+    PyMem_Free(self->patients);
+    PyMem_Free(self->agents);
+    PyMem_Free(self->table);
+    self->patients = NULL;
+    self->agents = NULL;
+    self->capacity = 0;
+    self->table = NULL;
+    self->table_size = 0;
+    self->size = 0;
+}
+
+Py_ssize_t
+QBAFARelations_IdOf(QBAFARelationsObject *self, PyObject *argument)
+{
+    PyObject *id = PyDict_GetItemWithError(self->symbols, argument);   // Borrowed reference
+    if (id == NULL) {
+        return PyErr_Occurred() ? -2 : -1;
+    }
+    return PyLong_AsSsize_t(id);
+}
+
+/**
+ * @brief Return the id of the argument in the symbol table of self, adding it if it has not been interned yet.
+ * Return -1 (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @param argument a QBAFArgument
+ * @return Py_ssize_t the id, -1 if an error occurred
+ */
+Py_ssize_t
+QBAFARelations_Intern(QBAFARelationsObject *self, PyObject *argument)
+{
+    Py_ssize_t id = QBAFARelations_IdOf(self, argument);
+    if (id != -1) {
+        return id < 0 ? -1 : id;
+    }
+
+    // The id of a released argument is reused (the last one released first)
+    Py_ssize_t released = PyList_GET_SIZE(self->released);
+    if (released > 0) {
+        PyObject *pyid = PyList_GET_ITEM(self->released, released - 1);
+        Py_INCREF(pyid);
+        if (PyList_SetSlice(self->released, released - 1, released, NULL) < 0) {
+            Py_DECREF(pyid);
+            return -1;
+        }
+        if (PyDict_SetItem(self->symbols, argument, pyid) < 0) {
+            PyList_Append(self->released, pyid);    // It was removed, so there is room for it
+            Py_DECREF(pyid);
+            return -1;
+        }
+        id = PyLong_AsSsize_t(pyid);
+        Py_DECREF(pyid);
+        Py_INCREF(argument);
+        PyList_SetItem(self->arguments, id, argument);      // It steals the reference to argument (and frees None)
+        return id;
+    }
+
+    id = PyList_GET_SIZE(self->arguments);
+    if (id >= INT32_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "too many arguments in the relations");
+        return -1;
+    }
+    PyObject *pyid = PyLong_FromSsize_t(id);
+    if (pyid == NULL) {
+        return -1;
+    }
+    if (PyList_Append(self->arguments, argument) < 0) {
+        Py_DECREF(pyid);
+        return -1;
+    }
+    if (PyDict_SetItem(self->symbols, argument, pyid) < 0) {
+        Py_DECREF(pyid);
+        PyList_SetSlice(self->arguments, id, id + 1, NULL);
+        return -1;
+    }
+    Py_DECREF(pyid);
+
+    return id;
+}
+
+int
+QBAFARelations_Release(QBAFARelationsObject *self, PyObject *argument)
+{
+    Py_ssize_t id = QBAFARelations_IdOf(self, argument);
+    if (id < 0) {
+        return id < -1 ? -1 : 0;
+    }
+
+    PyObject *pyid = PyLong_FromSsize_t(id);
+    if (pyid == NULL) {
+        return -1;
+    }
+    int appended = PyList_Append(self->released, pyid);
+    Py_DECREF(pyid);
+    if (appended < 0) {
+        return -1;
+    }
+    if (PyDict_DelItem(self->symbols, argument) < 0) {
+        Py_ssize_t released = PyList_GET_SIZE(self->released);
+        PyList_SetSlice(self->released, released - 1, released, NULL);
+        return -1;
+    }
+    Py_INCREF(Py_None);
+    return PyList_SetItem(self->arguments, id, Py_None);   // It steals the reference to Py_None
+}
+
+/**
+ * @brief Drop the argument with id id from the symbol table of self if it is not part of any relation of self.
+ * The symbol table must not be shared (self can be modified from python).
+ * Return 0 if succeeded, -1 (with the corresponding exception) if an error has occurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @param id the id of an interned argument
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+static int
+QBAFARelations_release_unused(QBAFARelationsObject *self, Py_ssize_t id)
+{
+    if (QBAFARelations_AgentIds(self, id)->size > 0 || QBAFARelations_PatientIds(self, id)->size > 0)
+        return 0;
+
+    PyObject *argument = QBAFARelations_ArgumentOf(self, id);
+    Py_INCREF(argument);
+    int result = QBAFARelations_Release(self, argument);
+    Py_DECREF(argument);
+    return result;
+}
+
+/**
+ * @brief Add the relation between the interned arguments agent and patient to self. It does nothing if it is contained.
+ * Return 0 if succeeded, -1 (with the corresponding exception) if there is no memory left.
+ * 
+ * @param self instance of QBAFARelations
+ * @param agent the id of the agent
+ * @param patient the id of the patient
+ * @return int 0 if succeeded, -1 if an error occurred
+ */
+int
+QBAFARelations_AddIds(QBAFARelationsObject *self, Py_ssize_t agent, Py_ssize_t patient)
+{
+    uint64_t key = QBAFARelations_key(agent, patient);
+    if (QBAFARelations_table_contains(self, key))
+        return 0;
+
+    // Allocate everything before modifying self
+    if (QBAFARelations_reserve(self, (agent > patient ? agent : patient) + 1) < 0 ||
+        QBAFARelations_table_reserve(self, self->size + 1) < 0 ||
+        QBAFIdVector_reserve(&self->patients[agent], self->patients[agent].size + 1) < 0 ||
+        QBAFIdVector_reserve(&self->agents[patient], self->agents[patient].size + 1) < 0) {
+        return -1;
+    }
+
+    self->table[QBAFARelations_slot(self, key)] = key;
+    self->patients[agent].ids[self->patients[agent].size++] = (int32_t) patient;
+    self->agents[patient].ids[self->agents[patient].size++] = (int32_t) agent;
+    self->size++;
+
+    return 0;
+}
+
+/**
+ * @brief Return a new PyList with the arguments whose ids are in the QBAFIdVector vector, NULL if an error occurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @param vector a QBAFIdVector of self
+ * @return PyObject* new PyList of QBAFArgument, NULL if an error occurred
+ */
+static PyObject *
+QBAFARelations_vector_list(QBAFARelationsObject *self, const QBAFIdVector *vector)
+{
+    PyObject *list = PyList_New(vector->size);
+    if (list == NULL) {
+        return NULL;
+    }
+    for (int32_t position = 0; position < vector->size; position++) {
+        PyObject *argument = QBAFARelations_ArgumentOf(self, vector->ids[position]);
+        Py_INCREF(argument);
+        PyList_SET_ITEM(list, position, argument);
+    }
+    return list;
+}
+
+/**
+ * @brief Return a new PyList with every relation of self as a tuple (Agent, Patient), NULL if an error occurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @return PyObject* new PyList of tuples, NULL if an error occurred
+ */
+static PyObject *
+QBAFARelations_list(QBAFARelationsObject *self)
+{
+    PyObject *list = PyList_New(self->size);
+    if (list == NULL) {
+        return NULL;
+    }
+
+    Py_ssize_t index = 0;
+    for (Py_ssize_t agent = 0; agent < self->capacity; agent++) {
+        const QBAFIdVector *patients = &self->patients[agent];
+        for (int32_t position = 0; position < patients->size; position++) {
+            PyObject *tuple = PyTuple_Pack(2, QBAFARelations_ArgumentOf(self, agent),
+                                           QBAFARelations_ArgumentOf(self, patients->ids[position]));
+            if (tuple == NULL) {
+                Py_DECREF(list);
+                return NULL;
+            }
+            PyList_SET_ITEM(list, index, tuple);
+            index++;
+        }
+    }
+
+    return list;
+}
+
+/**
+ * @brief Return a new PySet with every relation of self as a tuple (Agent, Patient), NULL if an error occurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @return PyObject* new PySet of tuples, NULL if an error occurred
+ */
+static PyObject *
+QBAFARelations_set(QBAFARelationsObject *self)
+{
+    PyObject *list = QBAFARelations_list(self);
+    if (list == NULL) {
+        return NULL;
+    }
+    PyObject *set = PySet_New(list);
+    Py_DECREF(list);
+    return set;
+}
+
 /**
  * @brief This function is used by the garbage collector to detect reference cycles.
  * 
@@ -34,9 +526,9 @@
 static int
 QBAFARelations_traverse(QBAFARelationsObject *self, visitproc visit, void *arg)
 {
-    Py_VISIT(self->relations);
-    Py_VISIT(self->agent_patients);
-    Py_VISIT(self->patient_agents);
+    Py_VISIT(self->symbols);
+    Py_VISIT(self->arguments);
+    Py_VISIT(self->released);
     return 0;
 }
 
@@ -49,9 +541,10 @@ QBAFARelations_traverse(QBAFARelationsObject *self, visitproc visit, void *arg)
 static int
 QBAFARelations_clear(QBAFARelationsObject *self)
 {
-    Py_CLEAR(self->relations);
-    Py_CLEAR(self->agent_patients);
-    Py_CLEAR(self->patient_agents);
+    Py_CLEAR(self->symbols);
+    Py_CLEAR(self->arguments);
+    Py_CLEAR(self->released);
+    QBAFARelations_free_relations(self);
     return 0;
 }
 
@@ -82,21 +575,18 @@ QBAFARelations_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     QBAFARelationsObject *self;
     self = (QBAFARelationsObject *) type->tp_alloc(type, 0);
     if (self != NULL) {
-        self->relations = PySet_New(NULL);
-        if (self->relations == NULL) {
+        self->symbols = PyDict_New();
+        if (self->symbols == NULL) {
             Py_DECREF(self);
             return NULL;
         }
-        self->agent_patients = PyDict_New();
-        if (self->agent_patients == NULL) {
-            Py_DECREF(self->relations);
+        self->arguments = PyList_New(0);
+        if (self->arguments == NULL) {
             Py_DECREF(self);
             return NULL;
         }
-        self->patient_agents = PyDict_New();
-        if (self->patient_agents == NULL) {
-            Py_DECREF(self->relations);
-            Py_DECREF(self->agent_patients);
+        self->released = PyList_New(0);
+        if (self->released == NULL) {
             Py_DECREF(self);
             return NULL;
         }
@@ -106,74 +596,18 @@ QBAFARelations_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 }
 
 /**
- * @brief Return the object from dictionary dict which has a key key. If the key does not exist return a new set.
- * Return NULL with an exception set if an exception occurred.
- * 
- * @param dict the dictionary
- * @param key the key
- * @return PyObject* Borrowed reference
- */
-static inline PyObject *
-PyDict_GetItemDefaultPySet_New(PyObject *dict, PyObject *key)
-{
-    PyObject *set;
-    int contains = PyDict_Contains(dict, key);
-    if (contains < 0) { //PyDict_Contains returns -1 in case of error
-        return NULL;
-    }
-    if (!contains) {
-        set = PySet_New(NULL);      // Return new reference
-        if (set == NULL)
-            return NULL;
-        // Add a new set to the dictionary
-        if (PyDict_SetItem(dict, key, set) < 0) {
-            Py_DECREF(set);
-            return NULL;
-        }
-        Py_DECREF(set);
-        return set;
-    }
-    return PyDict_GetItemWithError(dict, key);
-}
-
-/**
- * @brief Initializer of a QBAFARelations. It is called right after the constructor by the python interpreter.
+ * @brief Add every relation of the iterable relations to self.
+ * Return -1 if an error has occurred, with its corresponding exception.
  * 
- * @param self the Object 
- * @param args the argument values that might be used by the initializator
- * @param kwds the names of the argument values
- * @return int 0 if it was executed with no errors. Otherwise, -1.
+ * @param self instance of QBAFARelations
+ * @param relations an iterable of tuples (Agent: QBAFArgument, Patient: QBAFArgument)
+ * @return int 0 if succeeded, -1 if an error occurred
  */
 static int
-QBAFARelations_init(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
+QBAFARelations_add_all(QBAFARelationsObject *self, PyObject *relations)
 {
-    static char *kwlist[] = {"relations", NULL};
-    PyObject *relations, *tmp;
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
-                                     &relations))
-        return -1;
-
-    if (!PySet_Check(relations) && !PyList_Check(relations)) {
-        PyErr_SetString(PyExc_TypeError,
-                        "relations parameter must be a set or a list");
-        return -1;
-    }
-
-    // Initialize relations
-    tmp = self->relations;
-    relations = PySet_New(relations);           // It creates a new reference
-    if (relations == NULL) { // If any item is not hashable it raises and error
-        return -1;
-    }
-    self->relations = relations;
-    Py_DECREF(tmp);                             // This instance stops owning the set created in the constructor
-
-    // Initialize agent_patients & patient_agents
-    PyObject *iterator = PyObject_GetIter(self->relations);
+    PyObject *iterator = PyObject_GetIter(relations);
     PyObject *item;
-    PyObject *agent, *patient;
-    PyObject *set;
 
     if (iterator == NULL) {
         /* propagate error */
@@ -181,7 +615,6 @@ QBAFARelations_init(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
     }
 
     while ((item = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        /* do something with item */
         if (!PyTuple_Check(item) || (PyTuple_Size(item) != 2)) {
             PyErr_SetString(PyExc_TypeError,
                         "every item of relations must be a tuple of size 2");
@@ -189,33 +622,11 @@ QBAFARelations_init(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
             break;
         }
 
-        agent = PyTuple_GetItem(item, 0);       // Returns borrowed reference. NULL if the index is wrong.
-        patient = PyTuple_GetItem(item, 1);     // Returns borrowed reference. NULL if the index is wrong.
-
+        int added = _QBAFARelations_add(self, PyTuple_GET_ITEM(item, 0), PyTuple_GET_ITEM(item, 1));
         Py_DECREF(item);
-
-        if (agent == NULL || patient == NULL) {
-            break;
-        }
-
-        set = PyDict_GetItemDefaultPySet_New(self->agent_patients, agent);  // Return borrowed reference
-        if (set == NULL) {
+        if (added < 0) {
             break;
         }
-        // Add patient to the set
-        if (PySet_Add(set, patient) < 0) {
-            break;
-        }
-
-        set = PyDict_GetItemDefaultPySet_New(self->patient_agents, patient);  // Return borrowed reference
-        if (set == NULL) {
-            break;
-        }
-        // Add agent to the set
-        if (PySet_Add(set, agent) < 0) {
-            break;
-        }
-        
     }
 
     Py_DECREF(iterator);
@@ -228,6 +639,36 @@ QBAFARelations_init(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
     return 0;
 }
 
+/**
+ * @brief Initializer of a QBAFARelations. It is called right after the constructor by the python interpreter.
+ * 
+ * @param self the Object 
+ * @param args the argument values that might be used by the initializator
+ * @param kwds the names of the argument values
+ * @return int 0 if it was executed with no errors. Otherwise, -1.
+ */
+static int
+QBAFARelations_init(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"relations", NULL};
+    PyObject *relations;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &relations))
+        return -1;
+
+    if (!PySet_Check(relations) && !PyList_Check(relations)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "relations parameter must be a set or a list");
+        return -1;
+    }
+
+    // Initialize the relations (the symbol table is kept)
+    QBAFARelations_free_relations(self);
+
+    return QBAFARelations_add_all(self, relations);
+}
+
 /**
  * @brief Getter of the attribute relations.
  * 
@@ -238,7 +679,7 @@ QBAFARelations_init(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
 static PyObject *
 QBAFArgument_getrelations(QBAFARelationsObject *self, void *closure)
 {
-    return PySet_New(self->relations);
+    return QBAFARelations_set(self);
 }
 
 /**
@@ -250,7 +691,13 @@ QBAFArgument_getrelations(QBAFARelationsObject *self, void *closure)
 static PyObject *
 QBAFARelations___str__(QBAFARelationsObject *self)
 {
-    return PyUnicode_FromFormat("QBAFARelations%S", self->relations);
+    PyObject *relations = QBAFARelations_set(self);
+    if (relations == NULL) {
+        return NULL;
+    }
+    PyObject *str = PyUnicode_FromFormat("QBAFARelations%S", relations);
+    Py_DECREF(relations);
+    return str;
 }
 
 /**
@@ -262,7 +709,7 @@ QBAFARelations___str__(QBAFARelationsObject *self)
 static Py_ssize_t
 QBAFARelations___len__(QBAFARelationsObject *self)
 {
-    return PySet_Size(self->relations);
+    return self->size;
 }
 
 /**
@@ -281,7 +728,7 @@ QBAFARelations___contains__(QBAFARelationsObject *self, PyObject *key)
         return -1;
     }
 
-    return PySet_Contains(self->relations, key);
+    return _QBAFARelations_contains(self, PyTuple_GET_ITEM(key, 0), PyTuple_GET_ITEM(key, 1));
 }
 
 /**
@@ -294,17 +741,13 @@ QBAFARelations___contains__(QBAFARelationsObject *self, PyObject *key)
  */
 PyObject *
 _QBAFARelations_patients(QBAFARelationsObject *self, PyObject *agent) {
-    PyObject *set, *list;
-    int contains = PyDict_Contains(self->agent_patients, agent);
-    if (contains < 0)
+    Py_ssize_t id = QBAFARelations_IdOf(self, agent);
+    if (id < -1)
         return NULL;
-    if (contains) {
-        set = PyDict_GetItem(self->agent_patients, agent);
-        list = PyList_Copy(set, PySet_GET_SIZE(set));
-        return list;
-    }
+    if (id == -1)
+        return PyList_New(0);
 
-    return PyList_New(0);
+    return QBAFARelations_vector_list(self, QBAFARelations_PatientIds(self, id));
 }
 
 /**
@@ -339,17 +782,13 @@ QBAFARelations_patients(QBAFARelationsObject *self, PyObject *args, PyObject *kw
  */
 PyObject *
 _QBAFARelations_agents(QBAFARelationsObject *self, PyObject *patient) {
-    PyObject *set, *list;
-    int contains = PyDict_Contains(self->patient_agents, patient);
-    if (contains < 0)
+    Py_ssize_t id = QBAFARelations_IdOf(self, patient);
+    if (id < -1)
         return NULL;
-    if (contains) {
-        set = PyDict_GetItem(self->patient_agents, patient);
-        list = PyList_Copy(set, PySet_GET_SIZE(set));
-        return list;
-    }
+    if (id == -1)
+        return PyList_New(0);
 
-    return PyList_New(0);
+    return QBAFARelations_vector_list(self, QBAFARelations_AgentIds(self, id));
 }
 
 /**
@@ -374,6 +813,209 @@ QBAFARelations_agents(QBAFARelationsObject *self, PyObject *args, PyObject *kwds
     return _QBAFARelations_agents(self, patient);
 }
 
+int
+QBAFANeighbours_Init(QBAFANeighbours *view, QBAFARelationsObject *relations, PyObject *argument, int patients)
+{
+    Py_ssize_t id = QBAFARelations_IdOf(relations, argument);
+    if (id < -1)
+        return -1;
+
+    view->relations = relations;
+    view->id = id;
+    view->patients = patients;
+    view->position = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Struct that defines the iterator returned by QBAFARelations.patients_view and QBAFARelations.agents_view.
+ * It keeps a reference to the relations and walks them with a QBAFANeighbours view.
+ * 
+ */
+typedef struct {
+    PyObject_HEAD
+    QBAFANeighbours view;       /* the view, whose relations are owned by this object (or NULL if cleared) */
+    Py_ssize_t      size;       /* number of relations when the iterator was created */
+} QBAFANeighboursIteratorObject;
+
+static int
+QBAFANeighboursIterator_traverse(QBAFANeighboursIteratorObject *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->view.relations);
+    return 0;
+}
+
+static int
+QBAFANeighboursIterator_clear(QBAFANeighboursIteratorObject *self)
+{
+    Py_CLEAR(self->view.relations);
+    self->view.id = -1;
+    return 0;
+}
+
+static void
+QBAFANeighboursIterator_dealloc(QBAFANeighboursIteratorObject *self)
+{
+    PyObject_GC_UnTrack(self);
+    QBAFANeighboursIterator_clear(self);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+/**
+ * @brief Return the next patient/agent (new reference), NULL if there are no more or if an error has occurred.
+ * It raises RuntimeError if the relations have changed their size during the iteration.
+ * 
+ * @param self an instance of QBAFANeighboursIterator
+ * @return PyObject* a new reference to a QBAFArgument, NULL if exhausted or if an error occurred
+ */
+static PyObject *
+QBAFANeighboursIterator_next(QBAFANeighboursIteratorObject *self)
+{
+    if (self->view.relations == NULL)
+        return NULL;
+
+    if (self->view.relations->size != self->size) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "QBAFARelations changed size during iteration");
+        QBAFANeighboursIterator_clear(self);
+        return NULL;
+    }
+
+    PyObject *argument = QBAFANeighbours_Next(&self->view);
+    if (argument == NULL) {
+        QBAFANeighboursIterator_clear(self);
+        return NULL;
+    }
+
+    Py_INCREF(argument);
+    return argument;
+}
+
+/**
+ * @brief Return the number of patients/agents that have not been returned yet.
+ * 
+ * @param self an instance of QBAFANeighboursIterator
+ * @param Py_UNUSED 
+ * @return PyObject* a PyLong
+ */
+static PyObject *
+QBAFANeighboursIterator_length_hint(QBAFANeighboursIteratorObject *self, PyObject *Py_UNUSED(ignored))
+{
+    Py_ssize_t remaining = 0;
+    if (self->view.relations != NULL && self->view.id >= 0) {
+        const QBAFIdVector *vector = self->view.patients ? QBAFARelations_PatientIds(self->view.relations, self->view.id)
+                                                         : QBAFARelations_AgentIds(self->view.relations, self->view.id);
+        if (vector->size > self->view.position)
+            remaining = vector->size - self->view.position;
+    }
+    return PyLong_FromSsize_t(remaining);
+}
+
+static PyMethodDef QBAFANeighboursIterator_methods[] = {
+    {"__length_hint__", (PyCFunction) QBAFANeighboursIterator_length_hint, METH_NOARGS,
+    "Private method returning an estimate of len(list(it))."
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyTypeObject QBAFANeighboursIteratorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "qbaf.QBAFANeighboursIterator",
+    .tp_basicsize = sizeof(QBAFANeighboursIteratorObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_dealloc = (destructor) QBAFANeighboursIterator_dealloc,
+    .tp_traverse = (traverseproc) QBAFANeighboursIterator_traverse,
+    .tp_clear = (inquiry) QBAFANeighboursIterator_clear,
+    .tp_iter = PyObject_SelfIter,                                   // __iter__
+    .tp_iternext = (iternextfunc) QBAFANeighboursIterator_next,     // __next__
+    .tp_methods = QBAFANeighboursIterator_methods,
+};
+
+/**
+ * @brief Get the QBAFANeighboursIteratorType object created above
+ * 
+ * @return PyTypeObject* a pointer to the QBAFANeighboursIterator class definition
+ */
+PyTypeObject *get_QBAFANeighboursIteratorType() {
+    return &QBAFANeighboursIteratorType;
+}
+
+/**
+ * @brief Return a new QBAFANeighboursIterator over the patients (if patients is 1) or the agents (if patients is 0)
+ * of the argument. Return NULL if an error has ocurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @param argument instance of QBAFArgument
+ * @param patients 1 to iterate the patients, 0 to iterate the agents
+ * @return PyObject* new QBAFANeighboursIterator, NULL if an error occurred
+ */
+static PyObject *
+QBAFARelations_neighbours_view(QBAFARelationsObject *self, PyObject *argument, int patients)
+{
+    QBAFANeighboursIteratorObject *iterator = PyObject_GC_New(QBAFANeighboursIteratorObject, &QBAFANeighboursIteratorType);
+    if (iterator == NULL) {
+        return NULL;
+    }
+    iterator->view.relations = NULL;
+    iterator->size = self->size;
+
+    if (QBAFANeighbours_Init(&iterator->view, self, argument, patients) < 0) {
+        iterator->view.relations = NULL;
+        Py_DECREF(iterator);
+        return NULL;
+    }
+    Py_INCREF(self);
+    PyObject_GC_Track(iterator);
+
+    return (PyObject *) iterator;
+}
+
+/**
+ * @brief Return a lazy iterator over the patients of the agent, without copying them.
+ * Return NULL if an error has ocurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @param args the argument values (agent: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new QBAFANeighboursIterator
+ */
+static PyObject *
+QBAFARelations_patients_view(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"agent", NULL};
+    PyObject *agent;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &agent))
+        return NULL;
+
+    return QBAFARelations_neighbours_view(self, agent, 1);
+}
+
+/**
+ * @brief Return a lazy iterator over the agents of the patient, without copying them.
+ * Return NULL if an error has ocurred.
+ * 
+ * @param self instance of QBAFARelations
+ * @param args the argument values (patient: QBAFArgument)
+ * @param kwds the argument names
+ * @return PyObject* new QBAFANeighboursIterator
+ */
+static PyObject *
+QBAFARelations_agents_view(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"patient", NULL};
+    PyObject *patient;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|", kwlist,
+                                     &patient))
+        return NULL;
+
+    return QBAFARelations_neighbours_view(self, patient, 0);
+}
+
 /**
  * @brief Return whether or not exists the relation (agent, patient) in this instance.
  * Return -1 if an error has ocurred.
@@ -386,22 +1028,17 @@ QBAFARelations_agents(QBAFARelationsObject *self, PyObject *args, PyObject *kwds
 int
 _QBAFARelations_contains(QBAFARelationsObject *self, PyObject *agent, PyObject *patient)
 {
-    PyObject *tuple;
-
-    Py_INCREF(agent);
-    Py_INCREF(patient);
-    tuple = PyTuple_Pack(2, agent, patient);    // new reference
-    if (tuple == NULL) {
-        Py_DECREF(agent);
-        Py_DECREF(patient);
+    // Both arguments are looked up, so that an unhashable argument always raises an exception
+    Py_ssize_t agent_id = QBAFARelations_IdOf(self, agent);
+    if (agent_id < -1)
         return -1;
-    }
-    
-    int contains = PySet_Contains(self->relations, tuple); // QBAFARelations___contains__(self, tuple);
-
-    Py_DECREF(tuple);
+    Py_ssize_t patient_id = QBAFARelations_IdOf(self, patient);
+    if (patient_id < -1)
+        return -1;
+    if (agent_id == -1 || patient_id == -1)
+        return 0;
 
-    return contains;
+    return QBAFARelations_table_contains(self, QBAFARelations_key(agent_id, patient_id));
 }
 
 /**
@@ -445,54 +1082,16 @@ QBAFARelations_contains(QBAFARelationsObject *self, PyObject *args, PyObject *kw
 int
 _QBAFARelations_add(QBAFARelationsObject *self, PyObject *agent, PyObject *patient)
 {
-    PyObject *tuple, *set;
-
-    Py_INCREF(agent);
-    Py_INCREF(patient);
-    tuple = PyTuple_Pack(2, agent, patient);    // new reference
-    if (tuple == NULL) {
-        Py_DECREF(agent);
-        Py_DECREF(patient);
-        return -1;
-    }
-
-    int contains = PySet_Contains(self->relations, tuple);
-    if (contains < 0) {
-        Py_DECREF(tuple);
-        return -1;
-    }
-    if (contains) {
-        Py_DECREF(tuple);
-        return 0;
-    }
-
-    // If not contains it is inserted
-
-    if (PySet_Add(self->relations, tuple) < 0) {
-        Py_DECREF(tuple);
-        return -1;
-    }
-    Py_DECREF(tuple);
-
-    set = PyDict_GetItemDefaultPySet_New(self->agent_patients, agent);  // Return borrowed reference
-    if (set == NULL) {
-        return -1;
-    }
-    // Add patient to the set
-    if (PySet_Add(set, patient) < 0) {
+    Py_ssize_t agent_id = QBAFARelations_Intern(self, agent);
+    if (agent_id < 0) {
         return -1;
     }
-
-    set = PyDict_GetItemDefaultPySet_New(self->patient_agents, patient);  // Return borrowed reference
-    if (set == NULL) {
-        return -1;
-    }
-    // Add agent to the set
-    if (PySet_Add(set, agent) < 0) {
+    Py_ssize_t patient_id = QBAFARelations_Intern(self, patient);
+    if (patient_id < 0) {
         return -1;
     }
 
-    return 0;
+    return QBAFARelations_AddIds(self, agent_id, patient_id);
 }
 
 /**
@@ -537,53 +1136,24 @@ QBAFARelations_add(QBAFARelationsObject *self, PyObject *args, PyObject *kwds)
 int
 _QBAFARelations_remove(QBAFARelationsObject *self, PyObject *agent, PyObject *patient)
 {
-    PyObject *tuple, *set;
-
-    Py_INCREF(agent);
-    Py_INCREF(patient);
-    tuple = PyTuple_Pack(2, agent, patient);    // new reference
-    if (tuple == NULL) {
-        Py_DECREF(agent);
-        Py_DECREF(patient);
+    Py_ssize_t agent_id = QBAFARelations_IdOf(self, agent);
+    if (agent_id < -1)
         return -1;
-    }
-
-    int contains = PySet_Contains(self->relations, tuple);
-    if (contains < 0) {
-        Py_DECREF(tuple);
+    Py_ssize_t patient_id = QBAFARelations_IdOf(self, patient);
+    if (patient_id < -1)
         return -1;
-    }
-    if (!contains) {
-        Py_DECREF(tuple);
+    if (agent_id == -1 || patient_id == -1)
         return 0;
-    }
-
-    // If contains it is removed
-
-    if (PySet_Discard(self->relations, tuple) < 0) {
-        Py_DECREF(tuple);
-        return -1;
-    }
 
-    Py_DECREF(tuple);
-
-    set = PyDict_GetItem(self->agent_patients, agent);  // Return borrowed reference
-    if (set == NULL) {
-        return -1;
-    }
-    // Remove patient from the set
-    if (PySet_Discard(set, patient) < 0) {
-        return -1;
-    }
+    uint64_t key = QBAFARelations_key(agent_id, patient_id);
+    if (!QBAFARelations_table_contains(self, key))
+        return 0;
 
-    set = PyDict_GetItem(self->patient_agents, patient);  // Return borrowed reference
-    if (set == NULL) {
-        return -1;
-    }
-    // Remove agent from the set
-    if (PySet_Discard(set, agent) < 0) {
-        return -1;
-    }
+    // If contains it is removed
+    QBAFARelations_table_discard(self, key);
+    QBAFIdVector_discard(&self->patients[agent_id], (int32_t) patient_id);
+    QBAFIdVector_discard(&self->agents[patient_id], (int32_t) agent_id);
+    self->size--;
 
     return 0;
 }
@@ -616,12 +1186,88 @@ QBAFARelations_remove(QBAFARelationsObject *self, PyObject *args, PyObject *kwds
         return NULL;
     }
 
+    // The symbol table of a modifiable instance is not shared, so it drops the arguments without relations
+    Py_ssize_t agent_id = QBAFARelations_IdOf(self, agent);
+    if (agent_id < -1 || (agent_id >= 0 && QBAFARelations_release_unused(self, agent_id) < 0)) {
+        return NULL;
+    }
+    Py_ssize_t patient_id = QBAFARelations_IdOf(self, patient);
+    if (patient_id < -1 || (patient_id >= 0 && QBAFARelations_release_unused(self, patient_id) < 0)) {
+        return NULL;
+    }
+
     Py_RETURN_NONE;
 }
 
+/**
+ * @brief Return a copy of self with the symbol table of other, or with a copy of the symbol table of self
+ * if other is NULL. The symbol table of other must give the arguments of self the same ids (e.g. it is a copy of it).
+ * New references are created for the copy, except for the QBAFArgument objects.
+ * 
+ * @param self instance of QBAFARelations
+ * @param other instance of QBAFARelations, or NULL
+ * @return QBAFARelationsObject* new instance of QBAFARelations, NULL if an error occurred
+ */
+static QBAFARelationsObject *
+QBAFARelations_duplicate(QBAFARelationsObject *self, QBAFARelationsObject *other)
+{
+    QBAFARelationsObject *copy = (QBAFARelationsObject *) QBAFARelations_new(Py_TYPE(self), NULL, NULL);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    if (other != NULL) {
+        Py_INCREF(other->symbols);
+        Py_SETREF(copy->symbols, other->symbols);
+        Py_INCREF(other->arguments);
+        Py_SETREF(copy->arguments, other->arguments);
+        Py_INCREF(other->released);
+        Py_SETREF(copy->released, other->released);
+    }
+    else {
+        Py_SETREF(copy->symbols, PyDict_Copy(self->symbols));
+        Py_SETREF(copy->arguments, PyList_GetSlice(self->arguments, 0, PyList_GET_SIZE(self->arguments)));
+        Py_SETREF(copy->released, PyList_GetSlice(self->released, 0, PyList_GET_SIZE(self->released)));
+        if (copy->symbols == NULL || copy->arguments == NULL || copy->released == NULL) {
+            Py_DECREF(copy);
+            return NULL;
+        }
+    }
+
+    if (QBAFARelations_reserve(copy, self->capacity) < 0 ||
+        QBAFARelations_table_reserve(copy, self->size) < 0) {
+        Py_DECREF(copy);
+        return NULL;
+    }
+    for (Py_ssize_t id = 0; id < self->capacity; id++) {
+        if (QBAFIdVector_reserve(&copy->patients[id], self->patients[id].size) < 0 ||
+            QBAFIdVector_reserve(&copy->agents[id], self->agents[id].size) < 0) {
+            Py_DECREF(copy);
+            return NULL;
+        }
+        memcpy(copy->patients[id].ids, self->patients[id].ids, self->patients[id].size * sizeof(int32_t));
+        copy->patients[id].size = self->patients[id].size;
+        memcpy(copy->agents[id].ids, self->agents[id].ids, self->agents[id].size * sizeof(int32_t));
+        copy->agents[id].size = self->agents[id].size;
+    }
+    if (copy->table_size == self->table_size) {
+        memcpy(copy->table, self->table, self->table_size * sizeof(uint64_t));
+    }
+    else {
+        for (Py_ssize_t slot = 0; slot < self->table_size; slot++) {
+            if (self->table[slot] != EMPTY_SLOT)
+                copy->table[QBAFARelations_slot(copy, self->table[slot])] = self->table[slot];
+        }
+    }
+    copy->size = self->size;
+
+    return copy;
+}
+
 /**
  * @brief Return a copy of this instance.
  * New references are created for the copy, except for the QBAFArgument objects.
+ * The copy has its own copy of the symbol table of this instance.
  * 
  * @param self instance of QBAFARelations
  * @param Py_UNUSED 
@@ -630,23 +1276,38 @@ QBAFARelations_remove(QBAFARelationsObject *self, PyObject *args, PyObject *kwds
 PyObject *
 QBAFARelations_copy(QBAFARelationsObject *self, PyObject *Py_UNUSED(ignored))
 {
-    PyObject *kwds = NULL;
-    PyObject *args = PyTuple_Pack(1, self->relations);
-    if (args == NULL)
-        return NULL;
+    return (PyObject *) QBAFARelations_duplicate(self, NULL);
+}
 
-    QBAFARelationsObject *copy = QBAFARelations_new(Py_TYPE(self), args, kwds);
+PyObject *
+QBAFARelations_CopyWithSymbols(QBAFARelationsObject *self, QBAFARelationsObject *other)
+{
+    QBAFARelationsObject *copy = QBAFARelations_duplicate(self, other);
     if (copy == NULL) {
-        Py_DECREF(args);
         return NULL;
     }
-    if (QBAFARelations_init(copy, args, kwds) < 0) {
-        Py_DECREF(copy);
-        Py_DECREF(args);
+
+    copy->modifiable = 0;   // This instance cannot be modified from python
+
+    return (PyObject *) copy;
+}
+
+/**
+ * @brief Return the tuple (type(self), (relations,)) used by pickle, where relations is a list
+ * with the relations (agent, patient) of this instance.
+ * 
+ * @param self instance of QBAFARelations
+ * @param Py_UNUSED 
+ * @return PyObject* new PyTuple, NULL if an error occurred
+ */
+static PyObject *
+QBAFARelations_reduce(QBAFARelationsObject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *list = QBAFARelations_list(self);
+    if (list == NULL) {
         return NULL;
     }
-    Py_DECREF(args);
-    return copy;
+    return Py_BuildValue("(O(N))", (PyObject *) Py_TYPE(self), list);
 }
 
 /**
@@ -658,7 +1319,32 @@ QBAFARelations_copy(QBAFARelationsObject *self, PyObject *Py_UNUSED(ignored))
 PyObject *
 QBAFARelations_iter(QBAFARelationsObject *self)
 {
-    return PyObject_GetIter(self->relations);
+    PyObject *list = QBAFARelations_list(self);
+    if (list == NULL) {
+        return NULL;
+    }
+    PyObject *iterator = PyObject_GetIter(list);
+    Py_DECREF(list);
+    return iterator;
+}
+
+/**
+ * @brief Return 1 if the relation between the arguments with ids agent and patient in self
+ * is contained in other, 0 if not, and -1 if an error is encountered.
+ * 
+ * @param self a QBAFARelations instance
+ * @param other a QBAFARelations instance
+ * @param agent the id of the agent in self
+ * @param patient the id of the patient in self
+ * @return int 1 if contained, 0 if not contained, and -1 if an error is encountered
+ */
+static inline int
+QBAFARelations_other_contains(QBAFARelationsObject *self, QBAFARelationsObject *other, Py_ssize_t agent, Py_ssize_t patient)
+{
+    if (self->symbols == other->symbols) {  // Same ids
+        return QBAFARelations_table_contains(other, QBAFARelations_key(agent, patient));
+    }
+    return _QBAFARelations_contains(other, QBAFARelations_ArgumentOf(self, agent), QBAFARelations_ArgumentOf(self, patient));
 }
 
 /**
@@ -670,7 +1356,22 @@ QBAFARelations_iter(QBAFARelationsObject *self)
  */
 int
 _QBAFARelations_isDisjoint(QBAFARelationsObject *self, QBAFARelationsObject *other) {
-    return PySet_IsDisjoint(self->relations, other->relations);
+    if (self->size > other->size) {     // Iterate the smallest one
+        QBAFARelationsObject *tmp = self;
+        self = other;
+        other = tmp;
+    }
+
+    for (Py_ssize_t agent = 0; agent < self->capacity; agent++) {
+        const QBAFIdVector *patients = &self->patients[agent];
+        for (int32_t position = 0; position < patients->size; position++) {
+            int contains = QBAFARelations_other_contains(self, other, agent, patients->ids[position]);
+            if (contains != 0)
+                return contains < 0 ? -1 : 0;
+        }
+    }
+
+    return 1;
 }
 
 /**
@@ -704,8 +1405,34 @@ QBAFARelations_isDisjoint(QBAFARelationsObject *self, PyObject *args, PyObject *
     Py_RETURN_FALSE;
 }
 
+/**
+ * @brief Return 1 if every relation of self is contained in other, 0 if not, and -1 if an error is encountered.
+ * 
+ * @param self a QBAFARelations instance
+ * @param other a QBAFARelations instance
+ * @return int 1 if self is a subset of other, 0 if not, and -1 if an error is encountered
+ */
+static int
+QBAFARelations_issubset(QBAFARelationsObject *self, QBAFARelationsObject *other)
+{
+    if (self->size > other->size)
+        return 0;
+
+    for (Py_ssize_t agent = 0; agent < self->capacity; agent++) {
+        const QBAFIdVector *patients = &self->patients[agent];
+        for (int32_t position = 0; position < patients->size; position++) {
+            int contains = QBAFARelations_other_contains(self, other, agent, patients->ids[position]);
+            if (contains <= 0)
+                return contains;
+        }
+    }
+
+    return 1;
+}
+
 /**
  * @brief Return the comparison result between two QBAFARelations, NULL if an error has occurred.
+ * The relations are compared like sets (e.g. <= is subset).
  * 
  * @param self instance of QBAFARelations
  * @param other different instance of QBAFARelations
@@ -720,7 +1447,28 @@ QBAFARelations_richcompare(QBAFARelationsObject *self, PyObject *other, int op)
         return NULL;
     }
 
-    return PyObject_RichCompare(self->relations, ((QBAFARelationsObject *)other)->relations, op);
+    QBAFARelationsObject *relations = (QBAFARelationsObject *) other;
+    int result;
+    switch (op) {
+        case Py_EQ:
+        case Py_NE:
+            result = self->size == relations->size ? QBAFARelations_issubset(self, relations) : 0;
+            if (result >= 0 && op == Py_NE)
+                result = !result;
+            break;
+        case Py_LE:
+        case Py_LT:
+            result = (op == Py_LT && self->size == relations->size) ? 0 : QBAFARelations_issubset(self, relations);
+            break;
+        default:    // Py_GE, Py_GT
+            result = (op == Py_GT && self->size == relations->size) ? 0 : QBAFARelations_issubset(relations, self);
+            break;
+    }
+    if (result < 0) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(result);
 }
 
 /**
@@ -776,6 +1524,36 @@ PyDoc_STRVAR(agents_doc,
 "    list: The list of QBAFArgment that initiate the action\n"
 );
 
+PyDoc_STRVAR(patients_view_doc,
+"patients_view(self, agent)\n"
+"--\n"
+"\n"
+"Return a lazy iterator over the patients that undergo the effect of a certain action\n"
+"(e.g. attack, support) initiated by the agent, without copying them.\n"
+"The relations must not change their size while it is iterated.\n"
+"\n"
+"Args:\n"
+"    agent (QBAFArgument): The initiator of the action\n"
+"\n"
+"Returns:\n"
+"    iterator: An iterator of the QBAFArgument that undergo the action\n"
+);
+
+PyDoc_STRVAR(agents_view_doc,
+"agents_view(self, patient)\n"
+"--\n"
+"\n"
+"Return a lazy iterator over the agents that initiate a certain action\n"
+"(e.g. attack, support) which effects are undergone by the patient, without copying them.\n"
+"The relations must not change their size while it is iterated.\n"
+"\n"
+"Args:\n"
+"    patient (QBAFArgument): The entity undergoing the effect of the action\n"
+"\n"
+"Returns:\n"
+"    iterator: An iterator of the QBAFArgument that initiate the action\n"
+);
+
 PyDoc_STRVAR(contains_doc,
 "contains(self, agent, patient)\n"
 "--\n"
@@ -826,6 +1604,13 @@ PyDoc_STRVAR(copy_doc,
 "Return a shallow copy of self.\n"
 );
 
+PyDoc_STRVAR(__reduce___doc,
+"__reduce__(self, /)\n"
+"--\n"
+"\n"
+"Helper for pickle.\n"
+);
+
 PyDoc_STRVAR(isdisjoint_doc,
 "isdisjoint(self, other)\n"
 "--\n"
@@ -850,6 +1635,12 @@ static PyMethodDef QBAFARelations_methods[] = {
     {"agents", (PyCFunction) QBAFARelations_agents, METH_VARARGS | METH_KEYWORDS,
     agents_doc
     },
+    {"patients_view", (PyCFunction) QBAFARelations_patients_view, METH_VARARGS | METH_KEYWORDS,
+    patients_view_doc
+    },
+    {"agents_view", (PyCFunction) QBAFARelations_agents_view, METH_VARARGS | METH_KEYWORDS,
+    agents_view_doc
+    },
     {"contains", (PyCFunction) QBAFARelations_contains, METH_VARARGS | METH_KEYWORDS,
     contains_doc
     },
@@ -865,6 +1656,9 @@ static PyMethodDef QBAFARelations_methods[] = {
     {"copy", (PyCFunction) QBAFARelations_copy, METH_NOARGS,
     copy_doc
     },
+    {"__reduce__", (PyCFunction) QBAFARelations_reduce, METH_NOARGS,
+    __reduce___doc
+    },
     {"isdisjoint", (PyCFunction) QBAFARelations_isDisjoint, METH_VARARGS | METH_KEYWORDS, 
     isdisjoint_doc
     },
@@ -948,7 +1742,7 @@ QBAFARelations_Create(PyObject *relations)
     if (args == NULL)
         return NULL;
 
-    QBAFARelationsObject *new = QBAFARelations_new(&QBAFARelationsType, args, kwds);
+    QBAFARelationsObject *new = (QBAFARelationsObject *) QBAFARelations_new(&QBAFARelationsType, args, kwds);
     if (new == NULL) {
         Py_DECREF(args);
         return NULL;
@@ -966,6 +1760,46 @@ QBAFARelations_Create(PyObject *relations)
     return (PyObject*) new;
 }
 
+/**
+ * @brief Create a new object QBAFARelations that shares the symbol table of other. It cannot be modified from python.
+ * 
+ * @param relations a set/list of tuples (Agent: QBAFArgument, Patient QBAFArgument), or NULL
+ * @param other an instance of QBAFARelations
+ * @return PyObject* New reference
+ */
+PyObject *
+QBAFARelations_CreateWithSymbols(PyObject *relations, QBAFARelationsObject *other)
+{
+    QBAFARelationsObject *new = (QBAFARelationsObject *) QBAFARelations_new(&QBAFARelationsType, NULL, NULL);
+    if (new == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(other->symbols);
+    Py_SETREF(new->symbols, other->symbols);
+    Py_INCREF(other->arguments);
+    Py_SETREF(new->arguments, other->arguments);
+    Py_INCREF(other->released);
+    Py_SETREF(new->released, other->released);
+
+    if (relations != NULL) {
+        if (!PySet_Check(relations) && !PyList_Check(relations)) {
+            PyErr_SetString(PyExc_TypeError,
+                            "relations parameter must be a set or a list");
+            Py_DECREF(new);
+            return NULL;
+        }
+        if (QBAFARelations_add_all(new, relations) < 0) {
+            Py_DECREF(new);
+            return NULL;
+        }
+    }
+
+    new->modifiable = 0;    // This instance cannot be modified from python
+
+    return (PyObject*) new;
+}
+
 /**
  * @brief Return True if all the arguments of self are contained in arguments, if not False,
  *        and -1 if there is an error.
@@ -976,49 +1810,16 @@ QBAFARelations_Create(PyObject *relations)
  */
 int
 QBAFARelations_ArgsContained(QBAFARelationsObject *self, PyObject *arguments) {
-    PyObject *iterator = PyObject_GetIter(self->relations);
-    PyObject *item;
-    PyObject *agent, *patient;
-    int contains;
-
-    if (iterator == NULL) {
-        /* propagate error */
-        return -1;
-    }
-
-    while ((item = PyIter_Next(iterator))) {    // PyIter_Next returns a new reference
-        agent = PyTuple_GetItem(item, 0);       // Returns borrowed reference. NULL if the index is wrong.
-        patient = PyTuple_GetItem(item, 1);     // Returns borrowed reference. NULL if the index is wrong.
-        Py_DECREF(item);
-
-        if (agent == NULL || patient == NULL) {
-            Py_DECREF(iterator);
-            return -1;
-        }
-
-        contains = PySet_Contains(arguments, agent);
-        if (contains < 0) {
-            Py_DECREF(iterator);
-            return -1;
-        }
-        if (!contains) {
-            Py_DECREF(iterator);
-            return 0;   // return False
-        }
+    for (Py_ssize_t id = 0; id < self->capacity; id++) {
+        if (self->patients[id].size == 0 && self->agents[id].size == 0)
+            continue;
 
-        contains = PySet_Contains(arguments, patient);
-        if (contains < 0) {
-            Py_DECREF(iterator);
-            return -1;
-        }
-        if (!contains) {
-            Py_DECREF(iterator);
-            return 0;   // return False
+        int contains = PySet_Contains(arguments, QBAFARelations_ArgumentOf(self, id));
+        if (contains <= 0) {
+            return contains;    // return False or error
         }
     }
 
-    Py_DECREF(iterator);
-
     return 1;   // return True
 }
 
@@ -1031,34 +1832,13 @@ QBAFARelations_ArgsContained(QBAFARelationsObject *self, PyObject *arguments) {
  */
 int
 QBAFARelations_contains_argument(QBAFARelationsObject *self, PyObject *argument) {
-    PyObject *tuple, *list;
-
-    tuple = PyTuple_Pack(1, argument); // New reference
-
-    list = QBAFARelations_agents(self, tuple, NULL);
-    if (list == NULL) {
-        Py_DECREF(tuple);
-        return -1;
-    }
-    if (PyList_GET_SIZE(list) > 0) {
-        Py_DECREF(tuple);
-        return 1;   // return True
-    }
-
-    list = QBAFARelations_patients(self, tuple, NULL);
-    if (list == NULL) {
-        Py_DECREF(tuple);
+    Py_ssize_t id = QBAFARelations_IdOf(self, argument);
+    if (id < -1)
         return -1;
-    }
+    if (id == -1)
+        return 0;   // return False
 
-    if (PyList_GET_SIZE(list) > 0) {
-        Py_DECREF(tuple);
-        return 1;   // return True
-    }
-
-    Py_DECREF(tuple);
-
-    return 0;   // return False
+    return QBAFARelations_AgentIds(self, id)->size > 0 || QBAFARelations_PatientIds(self, id)->size > 0;
 }
 
 /**
@@ -1072,45 +1852,30 @@ QBAFARelations_contains_argument(QBAFARelationsObject *self, PyObject *argument)
 static inline int
 _QBAFARelations_remove_argument(QBAFARelationsObject *self, PyObject *argument)
 {
-    PyObject *list, *iterator, *agent, *patient;
-    
-    list = _QBAFARelations_agents(self, argument); // New reference
-    if (list == NULL) {
-        return -1;
-    }
-    iterator = PyObject_GetIter(list);
-    if (iterator == NULL) {
-        Py_DECREF(list);
+    Py_ssize_t id = QBAFARelations_IdOf(self, argument);
+    if (id < -1)
         return -1;
-    }
-    while ((agent = PyIter_Next(iterator))) {
-        if (_QBAFARelations_remove(self, agent, argument) < 0) {
-            Py_DECREF(list); Py_DECREF(iterator); Py_DECREF(agent);
-            return -1;
-        }
-        Py_DECREF(agent);
-    }
-    Py_DECREF(iterator);
-    Py_DECREF(list);
+    if (id == -1 || id >= self->capacity)
+        return 0;
 
-    list = _QBAFARelations_patients(self, argument); // New reference
-    if (list == NULL) {
-        return -1;
-    }
-    iterator = PyObject_GetIter(list);
-    if (iterator == NULL) {
-        Py_DECREF(list);
-        return -1;
+    // The relations are removed from the last one, so that the positions of the rest do not change
+    QBAFIdVector *agents = &self->agents[id];
+    while (agents->size > 0) {
+        int32_t agent = agents->ids[agents->size - 1];
+        QBAFARelations_table_discard(self, QBAFARelations_key(agent, id));
+        QBAFIdVector_discard(&self->patients[agent], (int32_t) id);
+        agents->size--;
+        self->size--;
     }
-    while ((patient = PyIter_Next(iterator))) {
-        if (_QBAFARelations_remove(self, argument, patient) < 0) {
-            Py_DECREF(list); Py_DECREF(iterator); Py_DECREF(patient);
-            return -1;
-        }
-        Py_DECREF(patient);
+
+    QBAFIdVector *patients = &self->patients[id];
+    while (patients->size > 0) {
+        int32_t patient = patients->ids[patients->size - 1];
+        QBAFARelations_table_discard(self, QBAFARelations_key(id, patient));
+        QBAFIdVector_discard(&self->agents[patient], (int32_t) id);
+        patients->size--;
+        self->size--;
     }
-    Py_DECREF(iterator);
-    Py_DECREF(list);
 
     return 0;
 }
@@ -1139,6 +1904,11 @@ _QBAFARelations_remove_arguments(QBAFARelationsObject *self, PyObject *iterable)
         }
         Py_DECREF(argument);
     }
+    Py_DECREF(iterator);
+
+    if (PyErr_Occurred()) {
+        return -1;
+    }
 
     return 0;
 }
@@ -1149,23 +1919,17 @@ _QBAFARelations_remove_arguments(QBAFARelationsObject *self, PyObject *iterable)
  * 
  * @param self instance of QBAFARelations
  * @param agent instance of QBAFArgument
- * @return PyObject* borrowed PySet of QBAFArgument, NULL if an error occurred
+ * @return PyObject* new PySet of QBAFArgument, NULL if an error occurred
  */
 PyObject *
 _QBAFARelations_patients_set(QBAFARelationsObject *self, PyObject *agent) {
-    int contains = PyDict_Contains(self->agent_patients, agent);
-    if (contains < 0)
+    PyObject *list = _QBAFARelations_patients(self, agent);
+    if (list == NULL)
         return NULL;
-    if (!contains) {
-        PyObject *set = PySet_New(NULL);
-        if (PyDict_SetItem(self->agent_patients, agent, set) < 0) {
-            Py_XDECREF(set);
-            return NULL;
-        }
-        Py_XDECREF(set);
-    }
 
-    return PyDict_GetItem(self->agent_patients, agent);
+    PyObject *set = PySet_New(list);
+    Py_DECREF(list);
+    return set;
 }
 
 /**
@@ -1180,13 +1944,23 @@ _QBAFARelations_patients_set(QBAFARelationsObject *self, PyObject *agent) {
 int
 _QBAFARelations_equal_patients(QBAFARelationsObject *self, QBAFARelationsObject *other, PyObject *agent)
 {
-    PyObject *self_patients = _QBAFARelations_patients_set(self, agent); // Borrowed reference
-    if (self_patients == NULL) {
+    Py_ssize_t self_id = QBAFARelations_IdOf(self, agent);
+    if (self_id < -1)
         return -1;
-    }
-    PyObject *other_patients = _QBAFARelations_patients_set(other, agent);  // Borrowed reference
-    if (other_patients == NULL) {
+    Py_ssize_t other_id = QBAFARelations_IdOf(other, agent);
+    if (other_id < -1)
         return -1;
+
+    const QBAFIdVector *self_patients = self_id < 0 ? &QBAFIdVector_Empty : QBAFARelations_PatientIds(self, self_id);
+    const QBAFIdVector *other_patients = other_id < 0 ? &QBAFIdVector_Empty : QBAFARelations_PatientIds(other, other_id);
+    if (self_patients->size != other_patients->size)
+        return 0;
+
+    for (int32_t position = 0; position < self_patients->size; position++) {
+        int contains = QBAFARelations_other_contains(self, other, self_id, self_patients->ids[position]);
+        if (contains <= 0)
+            return contains;
     }
-    return PyObject_RichCompareBool(self_patients, other_patients, Py_EQ);
-}
\ No newline at end of file
+
+    return 1;
+}
@@ -60,3 +60,26 @@ def test_equal_same_as_name():
 def test_hash():
     for x in range(20):
         assert hash(QBAFArgument(str(x), 'desc')) == hash(str(x))
+
+def test_pickle():
+    import pickle
+    argument = pickle.loads(pickle.dumps(QBAFArgument('a', 'desc')))
+    assert argument == QBAFArgument('a')
+    assert argument.description == 'desc'
+    assert argument.name is QBAFArgument('a').name
+
+def test_interned_name():
+    a, b = QBAFArgument(''.join(['a', 'b'])), QBAFArgument('ab', 'desc')
+    assert a.name is b.name
+    assert a == b and not a != b
+    assert a.description == '' and b.description == 'desc'
+    assert QBAFArgument('ab') != QBAFArgument('ac')
+    assert len({QBAFArgument(str(x % 10)) for x in range(100)}) == 10
+
+def test_subclass():
+    class Subclass(QBAFArgument):
+        pass
+    argument = Subclass('a', 'desc')
+    argument.cycle = argument
+    assert argument.name is QBAFArgument('a').name
+    assert hash(argument) == hash('a')
@@ -1,4 +1,5 @@
 import pytest
+import itertools
 from qbaf import QBAFramework, QBAFARelations
 
 # TEST INIT
@@ -109,6 +110,197 @@ def test_init_maxmin_strengths_DFQuAD():
     with pytest.raises(ValueError):
         qbf.modify_initial_strength('a', -5)
 
+def test_from_arrays():
+    from array import array
+    framework = QBAFramework.from_arrays(['a', 'b', 'c'], array('d', [1, 1, 5]),
+                                         array('q', [0]), array('i', [2]), [0], [1],
+                                         semantics='basic_model')
+    expected = QBAFramework(['a', 'b', 'c'], [1, 1, 5], [('a', 'c')], [('a', 'b')])
+    assert framework == expected
+    assert framework.initial_strengths == expected.initial_strengths
+    assert framework.final_strengths == expected.final_strengths
+    framework.add_argument('d')
+    framework.add_attack_relation('d', 'a')
+    assert framework.attackersOf('a') == ['d']
+
+def test_from_arrays_incorrect_input():
+    with pytest.raises(ValueError):
+        QBAFramework.from_arrays(['a', 'b'], [1, 1], [0], [2], [], [])
+    with pytest.raises(ValueError):
+        QBAFramework.from_arrays(['a', 'b'], [1, 1], [0, 1], [1], [], [])
+    with pytest.raises(ValueError):
+        QBAFramework.from_arrays(['a', 'a'], [1, 1], [], [], [], [])
+    with pytest.raises(ValueError):
+        QBAFramework.from_arrays(['a', 'b'], [1], [], [], [], [])
+    with pytest.raises(ValueError):
+        QBAFramework.from_arrays(['a', 'b'], [1, 1], [0], [1], [0], [1])
+    with pytest.raises(TypeError):
+        QBAFramework.from_arrays(['a', 'b'], [1, 1], [0.5], [1], [], [])
+    from array import array
+    for strength in (float('inf'), float('nan')):
+        with pytest.raises(ValueError):
+            QBAFramework.from_arrays(['a', 'b'], [strength, 0.1], [0], [1], [], [])
+        with pytest.raises(ValueError):
+            QBAFramework.from_arrays(['a', 'b'], array('d', [strength, 0.1]), [0], [1], [], [])
+
+def test_save_mmap(tmp_path):
+    from qbaf import QBAFArgument
+    path = tmp_path / 'framework.qbaf'
+    framework = QBAFramework(['a', 'b', 3, QBAFArgument('x', 'description')], [1, 2, 3, 0.5],
+                             [('a', 'b'), (3, 'b')], [(QBAFArgument('x', 'description'), 'a')],
+                             semantics='QuadraticEnergy_model')
+    framework.save(path)
+    mapped = QBAFramework.mmap(path)
+    assert mapped == framework
+    assert mapped.semantics == framework.semantics
+    assert mapped.initial_strengths == framework.initial_strengths
+    assert mapped.final_strengths == framework.final_strengths
+    mapped.modify_initial_strength('a', 5)
+    assert mapped.final_strengths != framework.final_strengths
+    assert QBAFramework.mmap(path).initial_strength('a') == 1
+
+def test_save_mmap_incorrect_input(tmp_path):
+    path = tmp_path / 'framework.qbaf'
+    with pytest.raises(ValueError):
+        QBAFramework(['a'], [1], [], [], aggregation_function=lambda a, s: 0,
+                     influence_function=lambda w, s: w).save(path)
+    with pytest.raises(TypeError):
+        QBAFramework([('a', 'b')], [1], [], []).save(path)
+    QBAFramework(['a', 'b'], [1, 1], [('a', 'b')], []).save(path)
+    data = path.read_bytes()
+    path.write_bytes(data[:-1])
+    with pytest.raises(ValueError):
+        QBAFramework.mmap(path)
+    path.write_bytes(b'x' * len(data))
+    with pytest.raises(ValueError):
+        QBAFramework.mmap(path)
+    # Sections of 0 -> 1 after the header (104 bytes): initial strengths [2], attackers offsets [3],
+    # attackers [1], supporters offsets [3], supporters [0], dependents offsets [3], dependents [1]
+    import struct
+    QBAFramework([0, 1], [1, 1], [(0, 1)], []).save(path)
+    data = path.read_bytes()
+    for offset, value in [(144, 1), (200, 0)]:   # 1 attacks itself (but it is scheduled), 0 depends on itself
+        forged = bytearray(data)
+        struct.pack_into('=q', forged, offset, value)
+        path.write_bytes(forged)
+        with pytest.raises(ValueError):
+            QBAFramework.mmap(path)
+    path.write_bytes(data)
+    assert QBAFramework.mmap(path) == QBAFramework([0, 1], [1, 1], [(0, 1)], [])
+
+def _aggregation(attackers, supporters):
+    return sum(supporters) - sum(attackers)
+
+def _influence(w, s):
+    return w + s
+
+def test_pickle():
+    import pickle
+    framework = QBAFramework(['a', 'b', ('c', 1), 'd'], [1, 0.5, 0.2, 0.3], [('a', 'b')], [(('c', 1), 'b')],
+                             semantics='QuadraticEnergy_model')
+    for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+        copy = pickle.loads(pickle.dumps(framework, protocol=protocol))
+        assert copy.arguments == framework.arguments
+        assert copy.initial_strengths == framework.initial_strengths
+        assert copy.attack_relations == framework.attack_relations
+        assert copy.support_relations == framework.support_relations
+        assert copy.semantics == framework.semantics
+        assert copy.final_strengths == framework.final_strengths
+    # Out-of-band buffers: the compiled graph and the final strengths
+    buffers = []
+    data = pickle.dumps(framework, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) == 2
+    copy = pickle.loads(data, buffers=buffers)
+    assert copy.final_strengths == framework.final_strengths
+    copy.modify_initial_strength('a', 0)
+    copy.add_argument('e', 1)
+    copy.add_support_relation('e', 'd')
+    assert copy.final_strength('b') > framework.final_strength('b')
+    assert copy.final_strength('d') > 0.3
+    assert framework.final_strength('d') == 0.3
+    # Writable buffers are copied, so modifying them does not affect the loaded Framework
+    buffers = [bytearray(buffer) for buffer in buffers]
+    copy = pickle.loads(data, buffers=buffers)
+    for buffer in buffers:
+        buffer[:] = b'\xff' * len(buffer)
+    assert copy.final_strengths == framework.final_strengths
+    assert copy.attack_relations == framework.attack_relations
+    copy.modify_initial_strength('a', 0)
+    assert copy.final_strength('b') > framework.final_strength('b')
+    # Custom semantics and modified frameworks
+    framework = QBAFramework(['a', 'b'], [1, 1], [('a', 'b')], [], aggregation_function=_aggregation,
+                             influence_function=_influence, min_strength=-5, max_strength=5)
+    framework.add_argument('c', 2)
+    framework.add_support_relation('c', 'b')
+    copy = pickle.loads(pickle.dumps(framework))
+    assert copy.semantics is None
+    assert copy.min_strength == -5 and copy.max_strength == 5
+    assert copy.final_strengths == framework.final_strengths == {'a': 1, 'b': 2, 'c': 2}
+    framework = QBAFramework(['a', 'b'], [1, 1], [('a', 'b'), ('b', 'a')], [], disjoint_relations=False)
+    copy = pickle.loads(pickle.dumps(framework))
+    assert not copy.isacyclic()
+    assert not copy.disjoint_relations
+    assert copy.attack_relations == framework.attack_relations
+
+def test_load(tmp_path):
+    import io
+    expected = QBAFramework(['a', 'b,c', 'd'], [1, 0.5, 0.2], [('a', 'b,c')], [('d', 'b,c')],
+                            semantics='QuadraticEnergy_model')
+    json = ('{"arguments": [["a", 1], {"name": "b,c", "initial_strength": 0.5}, ["d", 2e-1]],\n'
+            ' "attacks": [["a", "b,c"]], "supports": [["d", "b,c"]], "version": [1, {"x": null}]}')
+    csv = ('kind,agent,patient\n# a comment\nargument,a,1\nargument,"b,c",0.5\n\n'
+           'argument,d,0.2\r\nattack,a,"b,c"\nsupport, d , "b,c"\n')
+    (tmp_path / 'framework.json').write_text(json)
+    (tmp_path / 'framework.csv').write_text(csv)
+    for framework in [QBAFramework.load(io.StringIO(json), format='json', semantics='QuadraticEnergy_model'),
+                      QBAFramework.load(io.BytesIO(csv.encode()), format='csv', semantics='QuadraticEnergy_model'),
+                      QBAFramework.load(tmp_path / 'framework.json', semantics='QuadraticEnergy_model'),
+                      QBAFramework.load(str(tmp_path / 'framework.csv'), semantics='QuadraticEnergy_model')]:
+        assert framework.arguments == expected.arguments
+        assert framework.initial_strengths == expected.initial_strengths
+        assert framework.attack_relations == expected.attack_relations
+        assert framework.support_relations == expected.support_relations
+        assert framework.final_strengths == expected.final_strengths
+    # Tokens split across chunks
+    class OneByte:
+        def __init__(self, data):
+            self.data, self.position = data, 0
+        def read(self, size):
+            self.position += 1
+            return self.data[self.position - 1:self.position]
+    framework = QBAFramework.load(OneByte('{"arguments": [["\\u00e9", 1], [2, 0]], "attacks": [[2, "\\u00e9"]]}'),
+                                  format='json')
+    assert framework.attack_relations == QBAFARelations([(2, 'é')])
+
+def test_load_incorrect_input():
+    import io
+    for format, source, message in [('csv', 'argument,a,1\nattack,a,z\n', 'line 2, column 10: unknown argument'),
+                                    ('csv', 'argument,a,x\n', 'line 1, column 12: incorrect initial strength'),
+                                    ('csv', 'argument,a,1e400\n', 'line 1, column 12: initial strength .* out of range'),
+                                    ('csv', 'argument,a,nan\n', 'line 1, column 12: incorrect initial strength'),
+                                    ('csv', 'argument,a,1\nargument,a,2\n', 'line 2, column 10: argument'),
+                                    ('csv', 'argument,a,1,2\n', 'line 1, column 14: too many fields'),
+                                    ('csv', 'argument,a\n', 'line 1, column 1: expected 3 fields'),
+                                    ('csv', 'relation,a,a\n', 'line 1, column 1: unknown kind'),
+                                    ('csv', 'argument,"a,1\n', 'line 1, column 10: unterminated quoted field'),
+                                    ('json', '{"arguments": [["a", 1]],\n "attacks": [["a", "z"]]}', 'line 2, column 20: unknown argument'),
+                                    ('json', '{"arguments": [["a", 1]],\n "attacks": [["a" "a"]]}', "line 2, column 19: expected ','"),
+                                    ('json', '{"arguments": [["a", 1]', 'line 1, column 24: expected'),
+                                    ('json', '{"arguments": [[1.5, 1]]}', 'line 1, column 17: the name of an argument'),
+                                    ('json', '{"arguments": [["a", -1e400]]}', 'line 1, column 22: initial strength .* out of range'),
+                                    ('json', '{"arguments": [{"name": "a"}]}', 'line 1, column 16: an argument must have'),
+                                    ('json', '{} {}', 'line 1, column 4: expected the end of the input')]:
+        with pytest.raises(ValueError, match=message):
+            QBAFramework.load(io.StringIO(source), format=format)
+    with pytest.raises(ValueError):
+        QBAFramework.load(io.StringIO('{}'))
+    with pytest.raises(ValueError):
+        QBAFramework.load(io.StringIO('{}'), format='xml')
+    with pytest.raises(ValueError):
+        QBAFramework.load(io.StringIO('argument,a,1\nargument,b,1\nattack,a,b\nsupport,a,b\n'), format='csv')
+    with pytest.raises(TypeError):
+        QBAFramework.load(io.StringIO('{}'), format='json', semantics=1)
+
 # TEST SEMANTICS
 
 def test_custom_semantics_input():
@@ -229,6 +421,39 @@ def test_modify_arguments():
     assert qbf.contains_argument('a') and qbf.contains_argument('b') and qbf.contains_argument('c')
     assert not qbf.contains_argument('d')
 
+def test_remove_add_equal_argument():
+    from qbaf import QBAFArgument
+    a, d1, d2 = QBAFArgument('a'), QBAFArgument('d', 'd1'), QBAFArgument('d', 'd2')
+    qbf = QBAFramework([a, d1], [1, 1], [(a, d1)], [])
+    copy = qbf.copy()
+    qbf.remove_attack_relation(a, d1)
+    qbf.remove_argument(d1)
+    qbf.add_argument(d2, 1)
+    qbf.add_attack_relation(a, d2, require_acyclic=True)
+    assert qbf.attackersOf(d2)[0] is a and qbf.attackedBy(a)[0].description == 'd2'
+    assert copy.attackedBy(a)[0].description == 'd1'
+
+def test_add_remove_argument_bounded_memory():
+    import tracemalloc
+    qbf = QBAFramework(['a', 'b'], [1, 1], [('a', 'b')], [], semantics='QuadraticEnergy_model')
+    tracemalloc.start()
+    try:
+        for i in range(10100):
+            if i == 100:
+                before = tracemalloc.get_traced_memory()[0]
+            qbf.add_argument('c', 2)
+            qbf.add_support_relation('c', 'b', require_acyclic=True)
+            qbf.remove_support_relation('c', 'b')
+            qbf.remove_argument('c')
+        after = tracemalloc.get_traced_memory()[0]
+    finally:
+        tracemalloc.stop()
+    assert after - before < 10000
+    qbf.add_argument('d', 1)
+    qbf.add_attack_relation('d', 'a')
+    assert qbf.attackersOf('a') == ['d'] and qbf.isacyclic()
+    assert qbf.final_strengths['b'] > 0
+
 # TEST INITIAL STRENGTHS
 
 def test_access_initial_strength():
@@ -250,6 +475,15 @@ def test_modify_initial_strength():
     qbf.add_argument('a', 0.0)
     assert qbf.initial_strength('a') == 1.0
 
+    # Unknown arguments are rejected without modifying the framework, compiled or not
+    for compiled in (True, False):
+        if compiled:
+            qbf.final_strengths
+        with pytest.raises(ValueError):
+            qbf.modify_initial_strength('zz', 0.3)
+        assert 'zz' not in qbf.initial_strengths
+        qbf.add_argument('d', 1)
+
 # TEST ATTACK RELATIONS
 
 def test_access_attack_relations():
@@ -357,6 +591,33 @@ def test_modify_final_strength():
     qbf.add_argument('a', 0.0)
     assert qbf.final_strength('a') == 1.0
 
+def test_final_strengths_chain():
+    n = 2000
+    args = [str(i) for i in range(n)]
+    att = [(str(i), str(i+1)) for i in range(0, n-1, 2)]
+    supp = [(str(i), str(i+1)) for i in range(1, n-1, 2)]
+    qbf = QBAFramework(args, [1] * n, att, supp)
+    final_strengths = qbf.final_strengths
+    assert len(final_strengths) == n
+    assert final_strengths[str(n-1)] == 0.0
+    assert qbf.final_strength(str(n-2)) == 1.0
+
+def test_final_strengths_copy():
+    qbf = QBAFramework(['a', 'b', 'c'], [1, 1, 5], [('a', 'c')], [('a', 'b')])
+    assert qbf.final_strengths == {'a': 1.0, 'b': 2.0, 'c': 4.0}
+    copy = qbf.copy()
+    copy.modify_initial_strength('a', 2)
+    assert copy.final_strengths == {'a': 2.0, 'b': 3.0, 'c': 3.0}
+    assert qbf.final_strengths == {'a': 1.0, 'b': 2.0, 'c': 4.0}
+
+def test_deep_chain():
+    n = 100000
+    args = [str(i) for i in range(n)]
+    qbf = QBAFramework(args, [1] * n, [], [(str(i), str(i+1)) for i in range(n-1)])
+    assert qbf.isacyclic()
+    assert len(qbf.evaluation_order) == n
+    assert qbf.final_strength(str(n-1)) == float(n)
+
 # TEST ATTACKED/SUPPORTED BY AND ATTACKERS/SUPPORTERS OF
 
 def test_attackedBy_attackersOf_incorrect_input():
@@ -452,9 +713,365 @@ def test_isacyclic():
     assert qbf.isacyclic()
     qbf.add_attack_relation('c', 'a')
     assert not qbf.isacyclic()
-    with pytest.raises(NotImplementedError):
+    with pytest.raises(RuntimeError):
+        qbf.final_strengths
+
+def test_evaluation_order():
+    qbf = QBAFramework(['a', 'b', 'c', 'd'], [1, 1, 1, 1], [('a', 'b'), ('b', 'c')], [('a', 'c'), ('c', 'd')])
+    assert qbf.evaluation_order == [['a'], ['b'], ['c'], ['d']]
+    qbf.add_support_relation('d', 'a')
+    with pytest.raises(ValueError):
+        qbf.evaluation_order
+    qbf.remove_support_relation('d', 'a')
+    qbf.remove_attack_relation('b', 'c')
+    levels = qbf.evaluation_order
+    assert levels[0] == ['a'] and sorted(levels[1]) == ['b', 'c'] and levels[2] == ['d']
+
+def test_require_acyclic():
+    import random
+    rng = random.Random(1)
+    n = 40
+    args = [str(i) for i in range(n)]
+    qbf = QBAFramework(args, [1] * n, [], [])
+    for _ in range(400):
+        agent, patient = rng.sample(args, 2)
+        if qbf.contains_attack_relation(agent, patient) or qbf.contains_support_relation(agent, patient):
+            continue
+        att, supp = set(qbf.attack_relations.relations), set(qbf.support_relations.relations)
+        (att if rng.random() < 0.5 else supp).add((agent, patient))
+        acyclic = QBAFramework(args, [1] * n, att, supp).isacyclic()
+        try:
+            if (agent, patient) in att:
+                qbf.add_attack_relation(agent, patient, require_acyclic=True)
+            else:
+                qbf.add_support_relation(agent, patient, require_acyclic=True)
+            assert acyclic
+        except ValueError:
+            assert not acyclic
+        assert qbf.isacyclic()
+    assert qbf.copy().isacyclic()
+    qbf.add_argument('x')
+    qbf.add_attack_relation('x', '0', require_acyclic=True)
+    with pytest.raises(ValueError):
+        qbf.add_support_relation('x', 'x', require_acyclic=True)
+    qbf.add_support_relation('0', 'x')
+    assert not qbf.isacyclic()
+    with pytest.raises(ValueError):
+        qbf.add_attack_relation('1', '2', require_acyclic=True)
+    qbf.remove_support_relation('0', 'x')
+    qbf.add_argument('y')
+    qbf.add_attack_relation('x', 'y', require_acyclic=True)
+    qbf.add_support_relation('y', '0', require_acyclic=True)
+    assert qbf.isacyclic()
+
+def test_find_cycle():
+    qbf = QBAFramework(['a', 'b', 'c', 'd', 'e'], [1, 1, 1, 1, 1], [('a', 'b'), ('c', 'd')], [('b', 'c'), ('d', 'e')])
+    assert qbf.find_cycle() is None
+    assert qbf.strongly_connected_components() == [[arg] for arg in ['a', 'b', 'c', 'd', 'e']]
+    qbf.add_support_relation('d', 'b')
+    cycle = qbf.find_cycle()
+    assert sorted(cycle) == ['b', 'c', 'd']
+    relations = qbf.attack_relations.relations | qbf.support_relations.relations
+    for i in range(len(cycle)):
+        assert (cycle[i], cycle[(i + 1) % len(cycle)]) in relations
+    components = qbf.strongly_connected_components()
+    assert [sorted(component) for component in components] == [['a'], ['b', 'c', 'd'], ['e']]
+    qbf.add_attack_relation('e', 'e')
+    assert len(qbf.strongly_connected_components()) == 3
+    qbf.remove_support_relation('d', 'b')
+    assert qbf.find_cycle() == ['e']
+
+def test_find_cycle_long():
+    n = 100000
+    args = [str(i) for i in range(n)]
+    qbf = QBAFramework(args, [1] * n, [(str(n-1), '0')], [(str(i), str(i+1)) for i in range(n-1)])
+    assert not qbf.isacyclic()
+    assert len(qbf.find_cycle()) == n
+    assert len(qbf.strongly_connected_components()) == 1
+
+def test_solve():
+    qbf = QBAFramework(['a', 'b', 'c'], [0.5, 0.8, 0.3], [('a', 'b'), ('b', 'a')], [('c', 'a')],
+                       semantics="QuadraticEnergy_model")
+    final_strengths = qbf.final_strengths
+    for method in ['jacobi', 'gauss_seidel', 'euler', 'rk4']:
+        converged, iterations = qbf.solve(method=method)
+        assert converged and iterations > 0
+        for arg in qbf.arguments:
+            assert abs(qbf.final_strength(arg) - final_strengths[arg]) < 1e-8
+    with pytest.warns(RuntimeWarning):
+        assert qbf.solve(max_iterations=1) == (False, 1)
+    with pytest.raises(ValueError):
+        qbf.solve(method='newton')
+    with pytest.raises(ValueError):
+        qbf.solve(damping=0)
+
+def test_condensation():
+    n = 50
+    args = [str(i) for i in range(n)]
+    att = [(str(i), str(i + 1)) for i in range(0, n - 1, 2)] + [('20', '10'), ('41', '41')]
+    supp = [(str(i), str(i + 1)) for i in range(1, n - 1, 2)]
+    for semantics in ["QuadraticEnergy_model", "DFQuAD_model"]:
+        qbf = QBAFramework(args, [0.1 + 0.8 * i / n for i in range(n)], att, supp, semantics=semantics)
+        final_strengths = qbf.final_strengths
+        assert [sorted(c) for c in qbf.strongly_connected_components() if len(c) > 1] == [[str(i) for i in range(10, 21)]]
+        assert qbf.solve()[0]
+        for arg in args:
+            assert final_strengths[arg] == pytest.approx(qbf.final_strength(arg), abs=1e-8)
+        # The arguments before the cycle are evaluated directly
+        acyclic = QBAFramework(args[:10], [0.1 + 0.8 * i / n for i in range(10)],
+                               [r for r in att if int(r[1]) < 10], [r for r in supp if int(r[1]) < 10], semantics=semantics)
+        for arg in args[:10]:
+            assert final_strengths[arg] == acyclic.final_strength(arg)
+    qbf = QBAFramework(['a', 'b', 'c'], [1, 1, 1], [('c', 'a')], [('a', 'b'), ('b', 'a')])
+    with pytest.raises(RuntimeError):
         qbf.final_strengths
 
+def test_solve_acyclic():
+    qbf = QBAFramework(['a', 'b', 'c'], [1, 1, 5], [('a', 'c')], [('a', 'b')])
+    final_strengths = qbf.final_strengths
+    assert qbf.solve(method='gauss_seidel', damping=0.5) == (True, 0)
+    assert qbf.final_strengths == final_strengths
+    qbf.modify_initial_strength('a', 2)
+    assert qbf.solve() == (True, 0)
+    assert qbf.final_strengths == {'a': 2.0, 'b': 3.0, 'c': 3.0}
+
+def test_threads():
+    import random
+    rng = random.Random(0)
+    n = 3000
+    args = [str(i) for i in range(n)]
+    edges = set()
+    while len(edges) < 3 * n:
+        i, j = sorted(rng.sample(range(n), 2))
+        edges.add((str(i), str(j)))
+    edges = list(edges)
+    att, supp = edges[:len(edges)//2], edges[len(edges)//2:]
+    initial_strengths = [rng.random() for _ in range(n)]
+    for semantics in ["basic_model", "QuadraticEnergy_model", "SquaredDFQuAD_model",
+                      "EulerBasedTop_model", "EulerBased_model", "DFQuAD_model"]:
+        qbf = QBAFramework(args, initial_strengths, att, supp, semantics=semantics)
+        assert qbf.threads == 1
+        final_strengths = qbf.final_strengths
+        qbf.threads = 4
+        qbf.modify_initial_strength('0', initial_strengths[0])
+        assert qbf.final_strengths == final_strengths
+    with pytest.raises(ValueError):
+        qbf.threads = 0
+    with pytest.raises(TypeError):
+        qbf.threads = 1.5
+
+def test_threads_concurrent_modification():
+    import threading
+    n = 20000
+    args = [str(i) for i in range(n)]
+    qbf = QBAFramework(args, [0.5] * n, [(str(i), str(n - 1 - i)) for i in range(n // 2)], [],
+                       semantics="QuadraticEnergy_model")
+    qbf.threads = 4
+    failures = []
+
+    def modify():
+        for i in range(50):
+            try:
+                qbf.add_argument('new' + str(i))
+                qbf.modify_initial_strength('0', 0.25)
+            except RuntimeError:    # The framework is being evaluated by the other thread
+                pass
+            except Exception as e:
+                failures.append(e)
+
+    thread = threading.Thread(target=modify)
+    thread.start()
+    for _ in range(50):
+        try:
+            qbf.final_strengths_array()
+        except RuntimeError:
+            pass
+    thread.join()
+    assert failures == []
+    assert qbf.final_strength(str(n - 1)) == pytest.approx(0.5 * (1 - 0.25 ** 2 / (1 + 0.25 ** 2)))
+
+def test_semantics_modification():
+    # Python semantics that modify the framework they are evaluating
+    def framework(attack_relations):
+        def aggregation(attackers, supporters):
+            if 'new' not in qbf.arguments:    # The nested evaluation must not modify it again
+                qbf.add_argument('new')
+                qbf.final_strengths
+            return sum(supporters) - sum(attackers)
+        qbf = QBAFramework(['a', 'b'], [1, 1], attack_relations, [], disjoint_relations=False,
+                           aggregation_function=aggregation, influence_function=_influence)
+        return qbf
+
+    with pytest.raises(RuntimeError):
+        framework([('a', 'b')]).final_strengths
+    with pytest.raises(RuntimeError):
+        framework([('a', 'b')]).evaluate_batch([[1, 1]])
+    with pytest.raises(RuntimeError):
+        framework([('a', 'b'), ('b', 'a')]).final_strengths
+    with pytest.raises(RuntimeError):
+        framework([('a', 'b'), ('b', 'a')]).solve()
+
+def test_incremental_final_strengths():
+    import random
+    rng = random.Random(1)
+    n = 300
+    args = [str(i) for i in range(n)]
+    edges = set()
+    while len(edges) < 2 * n:
+        i, j = sorted(rng.sample(range(n), 2))
+        edges.add((str(i), str(j)))
+    edges = list(edges)
+    att, supp = edges[:len(edges)//2], edges[len(edges)//2:]
+    initial_strengths = [rng.random() for _ in range(n)]
+    for semantics in ["QuadraticEnergy_model", "EulerBased_model", "DFQuAD_model"]:
+        qbf = QBAFramework(args, initial_strengths, att, supp, semantics=semantics)
+        qbf.final_strengths
+        for step in range(20):
+            i, j = sorted(rng.sample(range(n), 2))
+            if step % 4 == 0:
+                qbf.modify_initial_strength(str(i), rng.random())
+            elif step % 4 == 1:
+                qbf.add_attack_relation(str(i), str(j))
+            elif step % 4 == 2:
+                qbf.remove_attack_relation(*rng.choice(list(qbf.attack_relations.relations)))
+            else:
+                qbf.add_support_relation(str(i), str(j)) if (str(i), str(j)) not in qbf.attack_relations \
+                    else qbf.remove_support_relation(*rng.choice(list(qbf.support_relations.relations)))
+            expected = QBAFramework(args, [qbf.initial_strength(arg) for arg in args],
+                                    qbf.attack_relations.relations, qbf.support_relations.relations,
+                                    semantics=semantics).final_strengths
+            final_strengths = qbf.final_strengths
+            for arg in qbf.arguments:
+                assert final_strengths[arg] == pytest.approx(expected[arg], rel=1e-12, abs=1e-12)
+    qbf = QBAFramework(['a', 'b'], [0.5, 0.5], [('a', 'b')], [], semantics="DFQuAD_model")
+    assert qbf.final_strength('b') == 0.25
+    qbf.modify_initial_strength('a', 1)
+    assert qbf.final_strength('b') == 0
+    qbf.add_support_relation('b', 'a')
+    assert not qbf.isacyclic()
+    qbf.remove_support_relation('b', 'a')
+    qbf.modify_initial_strength('a', 0.5)
+    assert qbf.final_strength('b') == 0.25
+
+def test_evaluate_batch():
+    import array
+    qbf = QBAFramework(['a', 'b', 'c', 'd'], [0.5, 0.5, 0.5, 0.5], [('a', 'b'), ('b', 'c')], [('a', 'c'), ('c', 'd')],
+                       semantics="DFQuAD_model")
+    arguments = qbf.indexed_arguments
+    assert sorted(arguments) == ['a', 'b', 'c', 'd']
+    rows = [[0.1 * (i + j) for j in range(4)] for i in range(7)]
+    result = qbf.evaluate_batch(rows)
+    assert result.shape == (7, 4)
+    flat = array.array('d', [x for row in rows for x in row])
+    qbf.threads = 2
+    assert qbf.evaluate_batch(memoryview(flat).cast('B').cast('d', (7, 4))).tolist() == result.tolist()
+    for i, row in enumerate(rows):
+        for argument, strength in zip(arguments, row):
+            qbf.modify_initial_strength(argument, strength)
+        assert [qbf.final_strength(argument) for argument in arguments] == result.tolist()[i]
+    with pytest.raises(ValueError):
+        qbf.evaluate_batch([[0.5, 0.5, 0.5]])
+    with pytest.raises(ValueError):
+        qbf.evaluate_batch([[0.5, 0.5, 0.5, 2]])
+    with pytest.raises(TypeError):
+        qbf.evaluate_batch([[0.5, 0.5, 0.5, '0.5']])
+    with pytest.raises(ValueError):
+        qbf.evaluate_batch([[0.5, 0.5, 0.5, float('nan')]])
+    # The default range is (-DBL_MAX, DBL_MAX)
+    unbounded = QBAFramework(['a', 'b'], [1, 1], [('a', 'b')], [])
+    with pytest.raises(ValueError, match='within range'):
+        unbounded.evaluate_batch([[float('inf'), 0.1]])
+    with pytest.raises(ValueError, match='within range'):
+        unbounded.modify_initial_strength('a', float('-inf'))
+    qbf.add_attack_relation('d', 'a')
+    with pytest.raises(ValueError):
+        qbf.evaluate_batch(rows)
+
+def test_strengths_array():
+    qbf = QBAFramework(['a', 'b', 'c'], [1, 1, 5], [('a', 'c')], [('a', 'b')])
+    index = qbf.argument_index
+    assert sorted(index.values()) == [0, 1, 2]
+    assert [qbf.indexed_arguments[i] for i in index.values()] == list(index.keys())
+    final_strengths = qbf.final_strengths_array()
+    initial_strengths = qbf.initial_strengths_array()
+    assert final_strengths.readonly and final_strengths.format == 'd'
+    for arg, i in index.items():
+        assert final_strengths[i] == qbf.final_strength(arg)
+        assert initial_strengths[i] == qbf.initial_strength(arg)
+    with pytest.raises(TypeError):
+        final_strengths[0] = 0
+    with pytest.raises(TypeError):
+        memoryview(final_strengths.obj)[0] = 0
+    assert final_strengths.obj.__class__.__name__ == 'QBAFStrengths'
+    # The exported arrays are snapshots
+    qbf.modify_initial_strength('a', 2)
+    assert final_strengths[index['c']] == 4 and initial_strengths[index['a']] == 1
+    assert qbf.final_strengths_array()[index['c']] == 3
+    copy = qbf.copy()
+    copy.modify_initial_strength('a', 3)
+    assert qbf.final_strength('c') == 3 and copy.final_strength('c') == 2
+    qbf.add_argument('d', 1)
+    assert len(qbf.final_strengths_array()) == 4 and len(final_strengths) == 3
+
+def test_batched_influence():
+    import math
+    n = 203
+    args = ['x'] + [str(i) for i in range(n)]
+    initial_strengths = [0.5] + [i / n for i in range(n)]
+    supp = [('x', str(i)) for i in range(n)]
+    influences = {
+        "basic_model": lambda w, s: w + s,
+        "QuadraticEnergy_model": lambda w, s: w - w * max(0, -s)**2 / (1 + max(0, -s)**2)
+                                              + (1 - w) * max(0, s)**2 / (1 + max(0, s)**2),
+        "SquaredDFQuAD_model": lambda w, s: w - w * max(0, -s) / (1 + max(0, -s))
+                                            + (1 - w) * max(0, s) / (1 + max(0, s)),
+        "EulerBased_model": lambda w, s: 1 - (1 - w * w) / (1 + w * math.exp(s)),
+        "DFQuAD_model": lambda w, s: w - w * max(0, -s) + (1 - w) * max(0, s),
+    }
+    for semantics, influence in influences.items():
+        qbf = QBAFramework(args, initial_strengths, [], supp, semantics=semantics)
+        s = qbf.final_strength('x')
+        for i in range(n):
+            assert qbf.final_strength(str(i)) == pytest.approx(influence(initial_strengths[i + 1], s), rel=1e-14)
+
+def test_fast_math():
+    import math, pickle
+    n = 203
+    args = ['x'] + [str(i) for i in range(n)]
+    initial_strengths = [0.5] + [i / n for i in range(n)]
+    supp = [('x', str(i)) for i in range(n)]
+    qbf = QBAFramework(args, initial_strengths, [], supp, semantics="EulerBased_model")
+    assert qbf.fast_math is False
+    s = qbf.final_strength('x')
+    # By default the exp of the C library is used, so the results are exact
+    for i in range(n):
+        assert qbf.final_strength(str(i)) == 1 - (1 - initial_strengths[i + 1] ** 2) / (1 + initial_strengths[i + 1] * math.exp(s))
+    qbf.fast_math = True
+    assert qbf.copy().fast_math and pickle.loads(pickle.dumps(qbf)).fast_math
+    for i in range(n):
+        assert qbf.final_strength(str(i)) == pytest.approx(1 - (1 - initial_strengths[i + 1] ** 2) / (1 + initial_strengths[i + 1] * math.exp(s)), rel=1e-14)
+    with pytest.raises(TypeError):
+        qbf.fast_math = 1
+
+def test_max_2_1_square():
+    import random
+    random.seed(1)
+    # pow(x, 2) and x * x are rounded differently for some inputs (e.g. 2.759)
+    values = [2.759, 1.6174868627108212, 2.7352828597938146] + [random.random() * 3 for _ in range(997)]
+    args, strengths, att, supp = [], [], [], []
+    for i, value in enumerate(values):
+        args += ['p%d' % i, 'a%d' % i, 's%d' % i]
+        strengths += [value, 0.25, 0.75]
+        att.append(('p%d' % i, 'a%d' % i))
+        supp.append(('p%d' % i, 's%d' % i))
+    qbf = QBAFramework(args, strengths, att, supp, semantics="QuadraticEnergy_model")
+    for i, value in enumerate(values):
+        h = value * value / (1 + value * value)
+        assert qbf.final_strength('a%d' % i) == 0.25 - 0.25 * h
+        assert qbf.final_strength('s%d' % i) == 0.75 + (1 - 0.75) * h
+        qbf.modify_initial_strength('a%d' % i, 0.5)
+        assert qbf.final_strength('a%d' % i) == 0.5 - 0.5 * h
+
 # TEST EQUALS
 
 def test_equals():
@@ -662,6 +1279,26 @@ def test_isCSIExplanation_output():
     for ns in [set(),{'a'},{'b'},{'c'},{'a','b'},{'a','c'},{'b','c'},{'a','b','c'}]:
         assert qbfa.isCSIExplanation(qbfe, ns.union({'e'}), 'b', 'c')
 
+def test_isExplanation_reversal():
+    qbf1 = QBAFramework(['a', 'b', 'c', 'd', 'x'], [0.5, 0.2, 0.6, 0.3, 0.9],
+                        [('a', 'b'), ('d', 'c'), ('x', 'a')], [('a', 'c'), ('d', 'b')],
+                        semantics='QuadraticEnergy_model')
+    qbf2 = QBAFramework(['a', 'b', 'c', 'd', 'y'], [0.1, 0.2, 0.6, 0.8, 0.4],
+                        [('a', 'c'), ('d', 'b'), ('y', 'd')], [('a', 'b'), ('y', 'c')],
+                        semantics='QuadraticEnergy_model')
+    union = {'a', 'b', 'c', 'd', 'x', 'y'}
+    assert not qbf1.are_strength_consistent(qbf2, 'a', 'b')
+
+    # The explanations are checked without building the reversals, but they must agree with them
+    for size in range(len(union) + 1):
+        for subset in itertools.combinations(sorted(union), size):
+            subset = set(subset)
+            csi = qbf1.reversal(qbf2, subset)
+            ssi = qbf1.reversal(qbf2, union - subset)
+            is_ssi = not qbf2.are_strength_consistent(ssi, 'a', 'b')
+            assert qbf1.isSSIExplanation(qbf2, subset, 'a', 'b') == is_ssi
+            assert qbf1.isCSIExplanation(qbf2, subset, 'a', 'b') == (is_ssi and qbf2.are_strength_consistent(csi, 'a', 'b'))
+
 # TEST IS NSI EXPLANATION
 
 def test_isNSIExplanation_input():
@@ -794,6 +1431,145 @@ def test_minimalNSIExplanations_output():
     assert qbf_.minimalNSIExplanations(qbfa, 'b', 'c') == [{'d', 'e'}]
     assert qbfa.minimalNSIExplanations(qbf_, 'b', 'c') == [{'e'}]
 
+def test_minimalExplanations_many_candidates():
+    qbfa = QBAFramework(['a', 'b', 'c'], [2, 1, 5], [('a', 'c')], [('a', 'b')])
+    def framework(n):
+        xs = ['x' + str(i) for i in range(n)]
+        return QBAFramework(['a', 'b', 'c'] + xs, [2, 1, 5] + [3] * n,
+                            [('a', 'c')] + [(x, 'c') for x in xs], [('a', 'b')])
+
+    xs = {'x' + str(i) for i in range(20)}
+    qbfx = framework(20)
+    explanations = qbfx.minimalSSIExplanations(qbfa, 'b', 'c')
+    assert len(explanations) == 20
+    assert all(len(explanation) == 1 for explanation in explanations)
+    assert set().union(*explanations) == xs
+
+    assert qbfx.minimalNSIExplanations(qbfa, 'b', 'c') == [xs]
+
+    xs = {'x' + str(i) for i in range(63)}
+    qbfx = framework(63)
+    assert len(qbfx.minimalSSIExplanations(qbfa, 'b', 'c')) == 63
+    assert qbfx.minimalNSIExplanations(qbfa, 'b', 'c') == [xs]
+
+    # The subsets of more than 64 candidates span several words
+    for n in [64, 70, 130]:
+        xs = {'x' + str(i) for i in range(n)}
+        qbfx = framework(n)
+        explanations = qbfx.minimalSSIExplanations(qbfa, 'b', 'c')
+        assert sorted(map(sorted, explanations)) == sorted([x] for x in xs)
+        assert qbfx.minimalNSIExplanations(qbfa, 'b', 'c') == [xs]
+        assert list(qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c')) == explanations
+        assert list(qbfx.iter_minimal_nsi_explanations(qbfa, 'b', 'c')) == [xs]
+
+def _explanation_frameworks():
+    # The SSI Explanations of qbfx w.r.t. qbfa are the sets of xs and ys whose attacks sum at least 4:
+    # pairs of xs, an x with a y, and triples of ys
+    qbfa = QBAFramework(['b', 'c'], [1, 5], [], [], semantics='basic_model')
+    xs = ['x' + str(i) for i in range(8)]
+    ys = ['y' + str(i) for i in range(8)]
+    qbfx = QBAFramework(['b', 'c'] + xs + ys, [1, 5] + [3] * 8 + [1.5] * 8,
+                        [(x, 'c') for x in xs + ys], [], semantics='basic_model')
+    return qbfa, qbfx
+
+def test_minimalExplanations_threads():
+    qbfa, qbfx = _explanation_frameworks()
+
+    explanations = qbfx.minimalSSIExplanations(qbfa, 'b', 'c')
+    assert sorted(len(explanation) for explanation in explanations) == [2] * (28 + 64) + [3] * 56
+
+    for method in ('minimalSSIExplanations', 'minimalCSIExplanations', 'minimalNSIExplanations'):
+        qbfx.threads = 1
+        expected = getattr(qbfx, method)(qbfa, 'b', 'c')
+        for threads in (2, 5):
+            qbfx.threads = threads
+            assert getattr(qbfx, method)(qbfa, 'b', 'c') == expected
+
+def test_iter_minimal_explanations():
+    qbfa, qbfx = _explanation_frameworks()
+
+    for kind in ('SSI', 'CSI', 'NSI'):
+        expected = getattr(qbfx, 'minimal' + kind + 'Explanations')(qbfa, 'b', 'c')
+        iterator = getattr(qbfx, 'iter_minimal_' + kind.lower() + '_explanations')(qbfa, 'b', 'c')
+        assert iterator.exhaustive is None
+        assert list(iterator) == expected
+        assert iterator.exhaustive is True
+
+    iterator = qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c', max_results=5)
+    assert list(iterator) == qbfx.minimalSSIExplanations(qbfa, 'b', 'c')[:5]
+    assert iterator.exhaustive is False
+
+    iterator = qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c', max_size=2)
+    assert sorted(len(explanation) for explanation in iterator) == [2] * (28 + 64)
+    assert iterator.exhaustive is False
+
+    iterator = qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c', max_evaluations=10)
+    assert all(len(explanation) == 2 for explanation in iterator)
+    assert iterator.exhaustive is False
+    assert iterator.evaluations == 10
+
+    iterator = qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c', time_budget_ms=0)
+    assert list(iterator) == []
+    assert iterator.exhaustive is False
+
+    iterator = qbfx.iter_minimal_nsi_explanations(qbfx, 'b', 'c')
+    assert list(iterator) == [set()]
+    assert iterator.exhaustive is True
+
+    with pytest.raises(ValueError):
+        qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c', max_results=-1)
+    with pytest.raises(TypeError):
+        qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c', max_size=1.5)
+    with pytest.raises(ValueError):
+        qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c', time_budget_ms=-1)
+    with pytest.raises(TypeError):
+        qbfx.iter_minimal_ssi_explanations(None, 'b', 'c')
+
+def test_iter_minimal_explanations_running():
+    # A Python semantics that calls next on the iterator that is checking a set
+    iterator = None
+    errors = []
+    def aggregation(attackers, supporters):
+        if iterator is not None:
+            try:
+                next(iterator)
+            except ValueError as error:
+                errors.append(str(error))
+        return _aggregation(attackers, supporters)
+
+    xs = ['x' + str(i) for i in range(4)]
+    qbfa = QBAFramework(['b', 'c'], [1, 5], [], [], aggregation_function=aggregation,
+                        influence_function=_influence, min_strength=-20, max_strength=20)
+    qbfx = QBAFramework(['b', 'c'] + xs, [1, 5] + [3] * 4, [(x, 'c') for x in xs], [],
+                        aggregation_function=aggregation, influence_function=_influence,
+                        min_strength=-20, max_strength=20)
+    iterator = qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c')
+    assert sorted(map(sorted, iterator)) == sorted(map(sorted, itertools.combinations(xs, 2)))
+    assert errors and all(error == 'iterator already executing' for error in errors)
+
+    # Concurrent calls of next while the threads check the sets without the GIL
+    import threading
+    qbfa, qbfx = _explanation_frameworks()
+    qbfx.threads = 4
+    expected = qbfx.minimalSSIExplanations(qbfa, 'b', 'c')
+    iterator = qbfx.iter_minimal_ssi_explanations(qbfa, 'b', 'c')
+    results = []
+    def consume():
+        while True:
+            try:
+                results.append(next(iterator))
+            except StopIteration:
+                return
+            except ValueError:
+                continue
+    consumers = [threading.Thread(target=consume) for _ in range(4)]
+    for consumer in consumers:
+        consumer.start()
+    for consumer in consumers:
+        consumer.join()
+    assert sorted(map(sorted, results)) == sorted(map(sorted, expected))
+    assert iterator.exhaustive is True
+
 # Test change_info
 
 def test_change_info():
@@ -1,3 +1,4 @@
+import pytest
 from qbaf import QBAFramework
 from qbaf_ctrbs.gradient import determine_gradient_ctrb
 
@@ -39,4 +40,54 @@ def test_gradient_top_edge_case():
     qbaf = QBAFramework(args, initial_strengths, atts, supps, semantics="EulerBasedTop_model")
     assert determine_gradient_ctrb('a', 'c', qbaf) == 0
     assert determine_gradient_ctrb('a', 'b', qbaf) == 0
-    
\ No newline at end of file
+    
+def test_gradient_exact():
+    args = ['a', 'b', 'c', 'd', 'e']
+    initial_strengths = [0.5, 0.2, 0.3, 0.4, 0.5]
+    atts = [('b', 'e'), ('c', 'e')]
+    supps = [('a', 'b'), ('a', 'c'), ('a', 'd'), ('d', 'e')]
+    epsilon = 1e-6
+    for semantics in ["basic_model", "QuadraticEnergy_model", "SquaredDFQuAD_model",
+                      "EulerBasedTop_model", "EulerBased_model", "DFQuAD_model"]:
+        qbaf = QBAFramework(args, initial_strengths, atts, supps, semantics=semantics)
+        gradient = qbaf.gradient('e')
+        for arg in args:
+            plus = qbaf.copy()
+            plus.modify_initial_strength(arg, qbaf.initial_strength(arg) + epsilon)
+            minus = qbaf.copy()
+            minus.modify_initial_strength(arg, qbaf.initial_strength(arg) - epsilon)
+            estimate = (plus.final_strength('e') - minus.final_strength('e')) / (2 * epsilon)
+            assert abs(gradient[arg] - estimate) < 1e-6
+            assert abs(qbaf.tangent(arg)['e'] - gradient[arg]) < 1e-12
+
+def test_gradient_errors():
+    qbaf = QBAFramework(['a', 'b'], [0.5, 0.5], [('a', 'b')], [('b', 'a')], semantics="DFQuAD_model")
+    with pytest.raises(ValueError):
+        qbaf.gradient('a')
+    qbaf = QBAFramework(['a', 'b'], [0.5, 0.5], [('a', 'b')], [],
+                        aggregation_function=lambda att, supp: sum(supp) - sum(att),
+                        influence_function=lambda w, s: w + s)
+    with pytest.raises(ValueError):
+        qbaf.tangent('a')
+
+def test_gradient_custom_semantics():
+    # The perturbations of all the contributors are evaluated in a single batch
+    qbaf = QBAFramework(['a', 'b', 'c', 'd'], [0.3, 1.0, 0.5, 0.2], [('a', 'c'), ('b', 'd')], [('c', 'd'), ('b', 'c')],
+                        aggregation_function=lambda att, supp: sum(supp) - sum(att),
+                        influence_function=lambda w, s: min(1.0, max(0.0, w + s / 2)),
+                        min_strength=0, max_strength=1)
+    assert determine_gradient_ctrb('d', 'a', qbaf) == pytest.approx(-0.25)
+    assert determine_gradient_ctrb('d', 'b', qbaf) == pytest.approx(-0.25)    # At max_strength
+    assert determine_gradient_ctrb('d', {'a', 'b', 'c'}, qbaf) == pytest.approx(0.5)
+    assert determine_gradient_ctrb('d', {'a', 'c'}, qbaf, aggregation_fn=sum) == pytest.approx(0.25)
+
+def test_gradient_top_tie():
+    # The tied strongest attackers of 'top' have derivative 0, the epsilon of the approximator is not used
+    qbaf = QBAFramework(['a', 'b', 'c', 'd'], [0.5, 0.5, 0.5, 0.2], [('b', 'a'), ('c', 'a'), ('d', 'a')], [],
+                        semantics="EulerBasedTop_model")
+    gradient = qbaf.gradient('a')
+    assert gradient['b'] == 0 and gradient['c'] == 0 and gradient['d'] == 0
+    assert determine_gradient_ctrb('a', 'b', qbaf, epsilon=0.1) == 0
+    qbaf.modify_initial_strength('c', 0.6)
+    gradient = qbaf.gradient('a')
+    assert gradient['b'] == 0 and gradient['c'] < 0 and gradient['d'] == 0
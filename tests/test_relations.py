@@ -161,6 +161,15 @@ def test_add_remove_contains():
     assert not relations.contains(b, a)
     assert not relations.contains(c, a)
 
+def test_add_remove_equal_argument():
+    a, d1, d2 = Arg('a'), Arg('d', 'd1'), Arg('d', 'd2')
+    relations = QBAFARelations([(a,d1)])
+    copy = relations.copy()
+    relations.remove(a,d1)
+    relations.add(a,d2)
+    assert relations.patients(a)[0].description == 'd2'
+    assert copy.patients(a)[0].description == 'd1'
+
 # TEST COPY
 
 def test_copy_relations():
@@ -195,6 +204,14 @@ def test_copy_contains():
     assert not copy.contains(b, a)
     assert not copy.contains(c, a)
 
+def test_pickle_relations():
+    import pickle
+    a, b, c = Arg('a'), Arg('b'), Arg('c')
+    relations = QBAFARelations([(a,b), (a,c)])
+    copy = pickle.loads(pickle.dumps(relations))
+    assert copy.relations == {(a,b), (a,c)}
+    assert set(copy.patients(a)) == {b, c}
+
 def test_copy_remove_relations():
     a, b, c = Arg('a'), Arg('b'), Arg('c')
     relations = QBAFARelations([(a,b), (a,c), (b,a), (c,a)])
@@ -327,4 +344,77 @@ def test___eq__():
     copy = relations.copy()
     assert relations == copy
     copy.remove(a,b)
-    assert relations != copy
\ No newline at end of file
+    assert relations != copy
+
+# TEST MANY RELATIONS
+
+def test_many_add_remove():
+    args = [Arg(str(i)) for i in range(50)]
+    relations = QBAFARelations([])
+    expected = set()
+    for i in range(2000):
+        agent, patient = args[(i * 7) % 50], args[(i * 13 + i // 50) % 50]
+        if i % 3 == 2 and expected:
+            relation = min(expected, key=lambda r: (r[0].name, r[1].name))
+            relations.remove(*relation)
+            expected.remove(relation)
+        elif (agent, patient) not in expected:
+            relations.add(agent, patient)
+            expected.add((agent, patient))
+    assert relations.relations == expected
+    assert len(relations) == len(expected)
+    for a in args:
+        assert set(relations.patients(a)) == {p for (x, p) in expected if x == a}
+        assert set(relations.agents(a)) == {x for (x, p) in expected if p == a}
+    copy = relations.copy()
+    for relation in list(expected)[:100]:
+        copy.remove(*relation)
+    assert copy.relations == set(list(expected)[100:])
+    assert relations.relations == expected
+
+def test_add_remove_bounded_memory():
+    import tracemalloc
+    relations = QBAFARelations([])
+    a, b = Arg('a'), Arg('b')
+    tracemalloc.start()
+    try:
+        for _ in range(100):
+            relations.add(a, b)
+            relations.remove(a, b)
+        before = tracemalloc.get_traced_memory()[0]
+        for _ in range(10000):
+            relations.add(Arg('a'), Arg('b'))
+            relations.remove(Arg('a'), Arg('b'))
+        after = tracemalloc.get_traced_memory()[0]
+    finally:
+        tracemalloc.stop()
+    assert after - before < 10000
+    assert len(relations) == 0
+
+# TEST VIEWS
+
+def test_views():
+    a, b, c = Arg('a'), Arg('b'), Arg('c')
+    relations = QBAFARelations([(a,b), (a,c), (c,b)])
+    assert list(relations.patients_view(a)) == relations.patients(a)
+    assert list(relations.agents_view(b)) == relations.agents(b)
+    assert list(relations.patients_view(b)) == []
+    assert list(relations.agents_view(Arg('d'))) == []
+    view = relations.patients_view(a)
+    assert view.__length_hint__() == 2
+    next(view)
+    assert view.__length_hint__() == 1
+
+def test_views_changed_size():
+    a, b, c = Arg('a'), Arg('b'), Arg('c')
+    relations = QBAFARelations([(a,b), (a,c)])
+    view = relations.patients_view(a)
+    next(view)
+    relations.remove(a, b)
+    with pytest.raises(RuntimeError):
+        next(view)
+
+def test_views_non_hashable():
+    relations = QBAFARelations([])
+    with pytest.raises(TypeError):
+        relations.patients_view([])